@@ -0,0 +1,12 @@
+// Entry point running the cpu benchmarks of src/cpubenchmarks.h on their own, so the cpu implementations can be
+// measured on any platform. It doesnt depend on d3d12, from the root of the repo:
+// g++ -std=c++14 -O2 -Isrc benchmarks/cpubenchmarks.cpp src/cpu*.cpp src/benchmark.cpp src/computegraph.cpp
+//     src/transientmemory.cpp src/resourcestatetracker.cpp src/parallelrecording.cpp src/residencypolicy.cpp
+//     src/texturelayout.cpp -lpthread && ./a.out
+#include "cpubenchmarks.h"
+
+int main()
+{
+    ComputeBasics::Cpu::RunBenchmarks();
+    return 0;
+}
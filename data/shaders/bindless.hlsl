@@ -0,0 +1,43 @@
+#define BindlessRootSig                                                                                 \
+    "RootFlags( 0 ),"                                                                                   \
+    "RootConstants( num32BitConstants = 5, b0 ),"                                                       \
+    "DescriptorTable( SRV(t0, space = 1, numDescriptors = unbounded, flags = DESCRIPTORS_VOLATILE),"    \
+    "                 UAV(u0, space = 2, numDescriptors = unbounded, offset = 0,"                       \
+    "                     flags = DESCRIPTORS_VOLATILE | DATA_VOLATILE),"                               \
+    "                 SRV(t0, space = 3, numDescriptors = unbounded, offset = 0,"                       \
+    "                     flags = DESCRIPTORS_VOLATILE),"                                               \
+    "                 UAV(u0, space = 4, numDescriptors = unbounded, offset = 0,"                       \
+    "                     flags = DESCRIPTORS_VOLATILE | DATA_VOLATILE) )"
+
+// Writes input * g_scale + g_bias to output, a thread per element, as data/shaders/scalebias.hlsl but with the
+// buffers found by their indices in the bindless heap of src/descriptors.h instead of bound as root parameters.
+// The single table covers the whole heap once per type, all the ranges start at its first descriptor, so
+// the index of a view is the same whatever its type.
+// Note the indices are uniform, they come from the root constants, so they dont need NonUniformResourceIndex.
+#define BINDLESS_GROUP_SIZE     64
+
+cbuffer BindlessConstants : register(b0)
+{
+    uint    g_inputIndex;
+    uint    g_outputIndex;
+    uint    g_elementsCount;
+    float   g_scale;
+    float   g_bias;
+}
+
+// Note raw views, so buffers of any type share the arrays
+ByteAddressBuffer       g_buffers[]     : register(t0, space1);
+RWByteAddressBuffer     g_rwBuffers[]   : register(u0, space2);
+Texture2D<float4>       g_textures[]    : register(t0, space3);
+RWTexture2D<float4>     g_rwTextures[]  : register(u0, space4);
+
+[numthreads( BINDLESS_GROUP_SIZE, 1, 1 )]
+void main(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+    const uint index = dispatchThreadId.x;
+    if (index >= g_elementsCount)
+        return;
+
+    const float value = asfloat(g_buffers[g_inputIndex].Load(index * 4));
+    g_rwBuffers[g_outputIndex].Store(index * 4, asuint(value * g_scale + g_bias));
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#define ColorPipelineRootSig                                \
+    "RootFlags( 0 ),"                                       \
+    "RootConstants( num32BitConstants = 16, b0 ),"          \
+    "DescriptorTable( SRV(t0), UAV(u0) )"
+
+// Applies the enabled steps of a color pipeline to the rgb of g_src and writes them to g_dst, a thread per texel.
+// Same steps and order than src/cpucolorpipeline.cpp: exposure, color matrix and tone curve. Alpha is kept as it
+// is. Every permutation fuses its steps, so the texel is read and written once whatever the steps are.
+// Permutations:
+//  COLOR_PIPELINE_EXPOSURE     scales the rgb by g_exposureScale
+//  COLOR_PIPELINE_COLOR_MATRIX multiplies the rgb by the rows in g_colorMatrix
+//  COLOR_PIPELINE_TONE_CURVE   0 none, 1 reinhard, 2 aces filmic
+#define COLOR_PIPELINE_GROUP_SIZE           8
+
+#define COLOR_PIPELINE_TONE_CURVE_NONE      0
+#define COLOR_PIPELINE_TONE_CURVE_REINHARD  1
+#define COLOR_PIPELINE_TONE_CURVE_ACES      2
+
+#ifndef COLOR_PIPELINE_EXPOSURE
+#define COLOR_PIPELINE_EXPOSURE 0
+#endif
+
+#ifndef COLOR_PIPELINE_COLOR_MATRIX
+#define COLOR_PIPELINE_COLOR_MATRIX 0
+#endif
+
+#ifndef COLOR_PIPELINE_TONE_CURVE
+#define COLOR_PIPELINE_TONE_CURVE COLOR_PIPELINE_TONE_CURVE_NONE
+#endif
+
+cbuffer ColorPipelineConstants : register(b0)
+{
+    uint2   g_size;
+    float   g_exposureScale;
+    uint    g_padding;
+    // Rows of the 3x3 matrix, w unused
+    float4  g_colorMatrix[3];
+}
+
+Texture2D<float4>   g_src   : register(t0);
+RWTexture2D<float4> g_dst   : register(u0);
+
+// Note negative values are clamped to 0 by the tone curves
+float3 ApplyToneCurve(float3 rgb)
+{
+    const float3 x = max(rgb, 0.0f);
+#if COLOR_PIPELINE_TONE_CURVE == COLOR_PIPELINE_TONE_CURVE_REINHARD
+    return x / (1.0f + x);
+#elif COLOR_PIPELINE_TONE_CURVE == COLOR_PIPELINE_TONE_CURVE_ACES
+    // Narkowicz fit of the aces filmic curve
+    return min(x * (2.51f * x + 0.03f) / (x * (2.43f * x + 0.59f) + 0.14f), 1.0f);
+#else
+    return rgb;
+#endif
+}
+
+[numthreads( COLOR_PIPELINE_GROUP_SIZE, COLOR_PIPELINE_GROUP_SIZE, 1 )]
+void main(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+    if (any(dispatchThreadId.xy >= g_size))
+        return;
+
+    float4 texel = g_src.Load(int3(dispatchThreadId.xy, 0));
+
+#if COLOR_PIPELINE_EXPOSURE
+    texel.rgb *= g_exposureScale;
+#endif
+
+#if COLOR_PIPELINE_COLOR_MATRIX
+    texel.rgb = float3(dot(g_colorMatrix[0].rgb, texel.rgb), dot(g_colorMatrix[1].rgb, texel.rgb),
+                       dot(g_colorMatrix[2].rgb, texel.rgb));
+#endif
+
+#if COLOR_PIPELINE_TONE_CURVE != COLOR_PIPELINE_TONE_CURVE_NONE
+    texel.rgb = ApplyToneCurve(texel.rgb);
+#endif
+
+    g_dst[dispatchThreadId.xy] = texel;
+}
@@ -0,0 +1,221 @@
+#define CompactionRootSig                                   \
+    "RootFlags( 0 ),"                                       \
+    "RootConstants( num32BitConstants = 4, b0 ),"           \
+    "DescriptorTable( SRV(t0), UAV(u0, numDescriptors = 3) )"
+
+// Writes the elements of g_input that survive the predicate to g_output in the same order, and the survivors
+// count to g_arguments. The input is split in partitions of COMPACTION_PARTITION_SIZE elements, one per group.
+//  COMPACTION_PASS_COUNT               every group counts the survivors of its partition
+//  COMPACTION_PASS_SCAN_PARTITIONS     a single group scans the partitions counts in place and writes the
+//                                      arguments
+//  COMPACTION_PASS_SCATTER             every group scans the predicate of its partition and writes the
+//                                      survivors from the partition offset
+// g_arguments holds D3D12_DISPATCH_ARGUMENTS to launch a thread per survivor with groups of
+// g_dispatchGroupSize threads, followed by the survivors count. So kernels working on the survivors can be
+// launched with ExecuteIndirect without reading the count back.
+// Permutations:
+//  COMPACTION_PASS                     which of the passes above the shader runs
+//  COMPACTION_PREDICATE                0 element != g_value, 1 element > g_value, 2 element < g_value
+//  COMPACTION_DATA_TYPE                0 float, 1 uint, 2 int
+//  COMPACTION_USE_WAVE_INTRINSICS      scans with the wave intrinsics instead of a groupshared tree.
+//                                      Needs cs_6_0.
+#define COMPACTION_GROUP_SIZE           256
+#define COMPACTION_ELEMENTS_PER_THREAD  8
+#define COMPACTION_PARTITION_SIZE       (COMPACTION_GROUP_SIZE * COMPACTION_ELEMENTS_PER_THREAD)
+// D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION
+#define COMPACTION_MAX_DISPATCH_GROUPS  65535
+
+#define COMPACTION_PASS_COUNT           0
+#define COMPACTION_PASS_SCAN_PARTITIONS 1
+#define COMPACTION_PASS_SCATTER         2
+
+#define COMPACTION_PREDICATE_NOT_EQUAL  0
+#define COMPACTION_PREDICATE_GREATER    1
+#define COMPACTION_PREDICATE_LESS       2
+
+#ifndef COMPACTION_PASS
+#define COMPACTION_PASS COMPACTION_PASS_COUNT
+#endif
+
+#ifndef COMPACTION_PREDICATE
+#define COMPACTION_PREDICATE COMPACTION_PREDICATE_NOT_EQUAL
+#endif
+
+#ifndef COMPACTION_DATA_TYPE
+#define COMPACTION_DATA_TYPE 0
+#endif
+
+#ifndef COMPACTION_USE_WAVE_INTRINSICS
+#define COMPACTION_USE_WAVE_INTRINSICS 0
+#endif
+
+#if COMPACTION_DATA_TYPE == 0
+#define DataType float
+#define AsDataType asfloat
+#elif COMPACTION_DATA_TYPE == 1
+#define DataType uint
+#define AsDataType asuint
+#else
+#define DataType int
+#define AsDataType asint
+#endif
+
+cbuffer CompactionConstants : register(b0)
+{
+    uint g_elementsCount;
+    uint g_partitionsCount;
+    // Bits of the value to compare with, as DataType
+    uint g_value;
+    uint g_dispatchGroupSize;
+}
+
+Buffer<DataType>            g_input             : register(t0);
+RWBuffer<DataType>          g_output            : register(u0);
+RWStructuredBuffer<uint>    g_partitionsCounts  : register(u1);
+RWByteAddressBuffer         g_arguments         : register(u2);
+
+groupshared uint gs_scan[COMPACTION_GROUP_SIZE];
+
+bool Survives(DataType element)
+{
+    const DataType value = AsDataType(g_value);
+#if COMPACTION_PREDICATE == COMPACTION_PREDICATE_GREATER
+    return element > value;
+#elif COMPACTION_PREDICATE == COMPACTION_PREDICATE_LESS
+    return element < value;
+#else
+    return element != value;
+#endif
+}
+
+// Exclusive scan of value across the group. The group total is returned in total.
+uint GroupExclusiveScan(uint value, uint groupIndex, out uint total)
+{
+#if COMPACTION_USE_WAVE_INTRINSICS
+    const uint lanesCount = WaveGetLaneCount();
+    const uint waveIndex = groupIndex / lanesCount;
+    const uint wavesCount = COMPACTION_GROUP_SIZE / lanesCount;
+
+    const uint exclusive = WavePrefixSum(value);
+    if (WaveGetLaneIndex() == lanesCount - 1)
+        gs_scan[waveIndex] = exclusive + value;
+    GroupMemoryBarrierWithGroupSync();
+
+    // Note small waves dont have a lane per wave sum
+    if (groupIndex == 0)
+    {
+        uint sum = 0;
+        for (uint i = 0; i < wavesCount; ++i)
+        {
+            const uint waveSum = gs_scan[i];
+            gs_scan[i] = sum;
+            sum += waveSum;
+        }
+        gs_scan[wavesCount] = sum;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint result = gs_scan[waveIndex] + exclusive;
+    total = gs_scan[wavesCount];
+#else
+    gs_scan[groupIndex] = value;
+    GroupMemoryBarrierWithGroupSync();
+
+    [unroll]
+    for (uint offset = 1; offset < COMPACTION_GROUP_SIZE; offset <<= 1)
+    {
+        const uint previous = groupIndex >= offset ? gs_scan[groupIndex - offset] : 0;
+        GroupMemoryBarrierWithGroupSync();
+        gs_scan[groupIndex] += previous;
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    const uint result = gs_scan[groupIndex] - value;
+    total = gs_scan[COMPACTION_GROUP_SIZE - 1];
+#endif
+    // Note gs_scan can be reused after this
+    GroupMemoryBarrierWithGroupSync();
+    return result;
+}
+
+#if COMPACTION_PASS == COMPACTION_PASS_COUNT
+
+[numthreads( COMPACTION_GROUP_SIZE, 1, 1 )]
+void main(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    const uint partitionStart = groupId.x * COMPACTION_PARTITION_SIZE;
+
+    uint threadCount = 0;
+    [unroll]
+    for (uint i = 0; i < COMPACTION_ELEMENTS_PER_THREAD; ++i)
+    {
+        const uint index = partitionStart + i * COMPACTION_GROUP_SIZE + groupIndex;
+        if (index < g_elementsCount && Survives(g_input[index]))
+            ++threadCount;
+    }
+
+    uint partitionCount;
+    GroupExclusiveScan(threadCount, groupIndex, partitionCount);
+    if (groupIndex == 0)
+        g_partitionsCounts[groupId.x] = partitionCount;
+}
+
+#elif COMPACTION_PASS == COMPACTION_PASS_SCAN_PARTITIONS
+
+// Every thread takes consecutive partitions
+[numthreads( COMPACTION_GROUP_SIZE, 1, 1 )]
+void main(uint groupIndex : SV_GroupIndex)
+{
+    const uint partitionsPerThread = (g_partitionsCount + COMPACTION_GROUP_SIZE - 1) / COMPACTION_GROUP_SIZE;
+    const uint begin = min(groupIndex * partitionsPerThread, g_partitionsCount);
+    const uint end = min(begin + partitionsPerThread, g_partitionsCount);
+
+    uint threadSum = 0;
+    for (uint i = begin; i < end; ++i)
+    {
+        threadSum += g_partitionsCounts[i];
+    }
+
+    uint survivorsCount;
+    uint prefix = GroupExclusiveScan(threadSum, groupIndex, survivorsCount);
+    for (uint j = begin; j < end; ++j)
+    {
+        const uint partitionCount = g_partitionsCounts[j];
+        g_partitionsCounts[j] = prefix;
+        prefix += partitionCount;
+    }
+
+    // Note the groups are clamped to the dispatch limit, kernels with more survivors have to loop
+    if (groupIndex == 0)
+    {
+        const uint groupsCount = min((survivorsCount + g_dispatchGroupSize - 1) / g_dispatchGroupSize,
+                                     COMPACTION_MAX_DISPATCH_GROUPS);
+        g_arguments.Store4(0, uint4(groupsCount, 1, 1, survivorsCount));
+    }
+}
+
+#elif COMPACTION_PASS == COMPACTION_PASS_SCATTER
+
+// Note every round covers consecutive elements so the survivors keep their order
+[numthreads( COMPACTION_GROUP_SIZE, 1, 1 )]
+void main(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    const uint partitionStart = groupId.x * COMPACTION_PARTITION_SIZE;
+    uint outputOffset = g_partitionsCounts[groupId.x];
+
+    [unroll]
+    for (uint i = 0; i < COMPACTION_ELEMENTS_PER_THREAD; ++i)
+    {
+        const uint index = partitionStart + i * COMPACTION_GROUP_SIZE + groupIndex;
+        const DataType element = index < g_elementsCount ? g_input[index] : 0;
+        const bool survives = index < g_elementsCount && Survives(element);
+
+        uint roundCount;
+        const uint roundOffset = GroupExclusiveScan(survives ? 1 : 0, groupIndex, roundCount);
+        if (survives)
+            g_output[outputOffset + roundOffset] = element;
+        outputOffset += roundCount;
+    }
+}
+
+#endif
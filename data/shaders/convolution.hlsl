@@ -0,0 +1,93 @@
+#define ConvolutionRootSig                                  \
+    "RootFlags( 0 ),"                                       \
+    "RootConstants( num32BitConstants = 3, b0 ),"           \
+    "DescriptorTable( SRV(t0, numDescriptors = 2), UAV(u0) )"
+
+// Convolves g_src with the 2 * g_radius + 1 g_weights along its rows or its columns. Edges are clamped.
+// Every group convolves CONVOLUTION_TILE_SIZE texels of a row or a column. It loads them with their apron of
+// g_radius texels at both sides to groupshared memory first, so every texel is read once from the texture instead of
+// once per tap.
+// Permutations:
+//  CONVOLUTION_DIRECTION   0 along the rows, 1 along the columns
+#define CONVOLUTION_TILE_SIZE   256
+#define CONVOLUTION_MAX_RADIUS  64
+#define CONVOLUTION_CACHE_SIZE  (CONVOLUTION_TILE_SIZE + 2 * CONVOLUTION_MAX_RADIUS)
+
+#define CONVOLUTION_DIRECTION_ROWS      0
+#define CONVOLUTION_DIRECTION_COLUMNS   1
+
+#ifndef CONVOLUTION_DIRECTION
+#define CONVOLUTION_DIRECTION CONVOLUTION_DIRECTION_ROWS
+#endif
+
+cbuffer ConvolutionConstants : register(b0)
+{
+    uint2   g_size;
+    uint    g_radius;
+}
+
+Texture2D<float4>   g_src       : register(t0);
+Buffer<float>       g_weights   : register(t1);
+RWTexture2D<float4> g_dst       : register(u0);
+
+// Note one array per channel to avoid bank conflicts
+groupshared float gs_r[CONVOLUTION_CACHE_SIZE];
+groupshared float gs_g[CONVOLUTION_CACHE_SIZE];
+groupshared float gs_b[CONVOLUTION_CACHE_SIZE];
+groupshared float gs_a[CONVOLUTION_CACHE_SIZE];
+groupshared float gs_weights[2 * CONVOLUTION_MAX_RADIUS + 1];
+
+void StoreTexel(uint index, float4 texel)
+{
+    gs_r[index] = texel.r;
+    gs_g[index] = texel.g;
+    gs_b[index] = texel.b;
+    gs_a[index] = texel.a;
+}
+
+float4 LoadTexel(uint index)
+{
+    return float4(gs_r[index], gs_g[index], gs_b[index], gs_a[index]);
+}
+
+uint2 ToTexel(uint position, uint lineIndex)
+{
+#if CONVOLUTION_DIRECTION == CONVOLUTION_DIRECTION_ROWS
+    return uint2(position, lineIndex);
+#else
+    return uint2(lineIndex, position);
+#endif
+}
+
+[numthreads( CONVOLUTION_TILE_SIZE, 1, 1 )]
+void main(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+#if CONVOLUTION_DIRECTION == CONVOLUTION_DIRECTION_ROWS
+    const uint lineSize = g_size.x;
+#else
+    const uint lineSize = g_size.y;
+#endif
+    const uint lineIndex = groupId.y;
+    const uint tileStart = groupId.x * CONVOLUTION_TILE_SIZE;
+
+    for (uint i = groupIndex; i < CONVOLUTION_TILE_SIZE + 2 * g_radius; i += CONVOLUTION_TILE_SIZE)
+    {
+        const int position = clamp(int(tileStart + i) - int(g_radius), 0, int(lineSize) - 1);
+        StoreTexel(i, g_src.Load(int3(ToTexel(position, lineIndex), 0)));
+    }
+
+    for (uint j = groupIndex; j < 2 * g_radius + 1; j += CONVOLUTION_TILE_SIZE)
+        gs_weights[j] = g_weights[j];
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint position = tileStart + groupIndex;
+    if (position >= lineSize)
+        return;
+
+    // Note same order than the cpu, from the first tap to the last one
+    float4 sum = 0.0f;
+    for (uint k = 0; k < 2 * g_radius + 1; ++k)
+        sum += gs_weights[k] * LoadTexel(groupIndex + k);
+
+    g_dst[ToTexel(position, lineIndex)] = sum;
+}
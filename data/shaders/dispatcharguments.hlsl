@@ -0,0 +1,33 @@
+#define DispatchArgumentsRootSig                            \
+    "RootFlags( 0 ),"                                       \
+    "RootConstants( num32BitConstants = 3, b0 ),"           \
+    "UAV( u0 ),"                                            \
+    "UAV( u1 )"
+
+// Writes to g_arguments the D3D12_DISPATCH_ARGUMENTS to launch a thread per element of a count written by
+// a previous dispatch, with groups of g_groupSize threads. Same than CalculateDispatchArguments in
+// src/cpuindirectdispatch.cpp.
+// Note the groups are clamped to the dispatch limit, kernels with more elements have to loop.
+// Offsets are in bytes.
+// D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION
+#define DISPATCH_ARGUMENTS_MAX_GROUPS   65535
+
+cbuffer DispatchArgumentsConstants : register(b0)
+{
+    uint g_countOffset;
+    uint g_argumentsOffset;
+    uint g_groupSize;
+}
+
+RWByteAddressBuffer g_counts    : register(u0);
+RWByteAddressBuffer g_arguments : register(u1);
+
+[numthreads( 1, 1, 1 )]
+void main()
+{
+    const uint count = g_counts.Load(g_countOffset);
+
+    // Note written so it doesnt overflow with counts close to the uint max
+    const uint groupsCount = count / g_groupSize + (count % g_groupSize != 0 ? 1 : 0);
+    g_arguments.Store3(g_argumentsOffset, uint3(min(groupsCount, DISPATCH_ARGUMENTS_MAX_GROUPS), 1, 1));
+}
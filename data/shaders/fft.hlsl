@@ -0,0 +1,317 @@
+#define FftRootSig                                          \
+    "RootFlags( 0 ),"                                       \
+    "RootConstants( num32BitConstants = 8, b0 ),"           \
+    "DescriptorTable( SRV(t0), UAV(u0, numDescriptors = 2) )"
+
+// Stockham fft of g_batchesCount transforms of g_size complex elements, same stages and twiddles than
+// src/cpufft.cpp. Elements of a transform are g_elementStride apart and transforms g_batchStride apart, so
+// rows and columns of 2d transforms are both batches. Every pass reads g_input and writes g_output.
+//  FFT_PASS_GROUPSHARED        the first stages, whose radices multiply to FFT_GROUPSHARED_SIZE, resident in
+//                              groupshared memory. Every group gathers the elements q + m * g_size / P of a
+//                              transform into a sub transform of P = FFT_GROUPSHARED_SIZE elements and writes
+//                              it from q * P. Transforms of up to FFT_MAX_GROUPSHARED_SIZE elements are done
+//                              by this pass alone.
+//  FFT_PASS_STAGE              one of the remaining stages of FFT_RADIX, a thread per butterfly
+//  FFT_PASS_REAL               combines the two halves of a real transform of 2 * g_size floats, transformed
+//                              as g_size complex elements. Forward after the transform of the rows, inverse
+//                              before it.
+// Permutations:
+//  FFT_PASS                    which of the passes above the shader runs
+//  FFT_INVERSE                 exp(2 pi i / N) twiddles instead of exp(-2 pi i / N) ones. Not scaled.
+//  FFT_GROUPSHARED_SIZE        P of FFT_PASS_GROUPSHARED
+//  FFT_GROUP_SIZE              threads of FFT_PASS_GROUPSHARED, FFT_GROUPSHARED_SIZE / 8 so every thread
+//                              keeps 8 elements in registers at every stage
+//  FFT_RADIX                   radix of FFT_PASS_STAGE
+#define FFT_MAX_GROUPSHARED_SIZE    4096
+#define FFT_MAX_RADIX               8
+#define FFT_STAGE_GROUP_SIZE        64
+#define FFT_REAL_GROUP_SIZE         256
+
+#define FFT_PASS_GROUPSHARED        0
+#define FFT_PASS_STAGE              1
+#define FFT_PASS_REAL               2
+
+#ifndef FFT_PASS
+#define FFT_PASS FFT_PASS_GROUPSHARED
+#endif
+
+#ifndef FFT_INVERSE
+#define FFT_INVERSE 0
+#endif
+
+#ifndef FFT_GROUPSHARED_SIZE
+#define FFT_GROUPSHARED_SIZE FFT_MAX_GROUPSHARED_SIZE
+#endif
+
+#ifndef FFT_GROUP_SIZE
+#define FFT_GROUP_SIZE (FFT_GROUPSHARED_SIZE / 8)
+#endif
+
+#ifndef FFT_RADIX
+#define FFT_RADIX FFT_MAX_RADIX
+#endif
+
+cbuffer FftConstants : register(b0)
+{
+    uint g_size;
+    // Product of the radices of the previous stages
+    uint g_stride;
+    uint g_twiddlesOffset;
+    uint g_elementStride;
+    uint g_batchStride;
+    // Rows of the real pass are g_batchStride apart in g_input and g_outputBatchStride apart in g_output
+    uint g_outputBatchStride;
+    // Threads per transform
+    uint g_itemsCount;
+    uint g_padding;
+}
+
+// Note all the twiddles of a plan, every pass starts at g_twiddlesOffset
+StructuredBuffer<float2>    g_twiddles  : register(t0);
+RWStructuredBuffer<float2>  g_input     : register(u0);
+RWStructuredBuffer<float2>  g_output    : register(u1);
+
+float2 ComplexMul(float2 a, float2 b)
+{
+    return float2(a.x * b.x - a.y * b.y, a.y * b.x + a.x * b.y);
+}
+
+float2 Conjugate(float2 a)
+{
+    return float2(a.x, -a.y);
+}
+
+// Note the twiddles are the forward ones, the inverse transform uses their conjugates
+float2 LoadTwiddle(uint index)
+{
+    const float2 twiddle = g_twiddles[g_twiddlesOffset + index];
+#if FFT_INVERSE
+    return Conjugate(twiddle);
+#else
+    return twiddle;
+#endif
+}
+
+// Multiplies by exp(-i pi / 2) forward and by exp(i pi / 2) inverse
+float2 RotateQuarter(float2 a)
+{
+#if FFT_INVERSE
+    return float2(-a.y, a.x);
+#else
+    return float2(a.y, -a.x);
+#endif
+}
+
+void Butterfly2(inout float2 v[FFT_MAX_RADIX], uint offset)
+{
+    const float2 v0 = v[offset];
+    v[offset] = v0 + v[offset + 1];
+    v[offset + 1] = v0 - v[offset + 1];
+}
+
+void Butterfly4(inout float2 v[FFT_MAX_RADIX], uint offset)
+{
+    const float2 t0 = v[offset] + v[offset + 2];
+    const float2 t1 = v[offset] - v[offset + 2];
+    const float2 t2 = v[offset + 1] + v[offset + 3];
+    const float2 t3 = RotateQuarter(v[offset + 1] - v[offset + 3]);
+    v[offset] = t0 + t2;
+    v[offset + 1] = t1 + t3;
+    v[offset + 2] = t0 - t2;
+    v[offset + 3] = t1 - t3;
+}
+
+// Note two radix 4 butterflies of the even and odd elements combined with the eighth roots of unity
+void Butterfly8(inout float2 v[FFT_MAX_RADIX])
+{
+    const float sqrtHalf = 0.70710678118654752f;
+#if FFT_INVERSE
+    const float sign = 1.0f;
+#else
+    const float sign = -1.0f;
+#endif
+
+    float2 halves[FFT_MAX_RADIX] = { v[0], v[2], v[4], v[6], v[1], v[3], v[5], v[7] };
+    Butterfly4(halves, 0);
+    Butterfly4(halves, 4);
+    halves[5] = ComplexMul(halves[5], float2(sqrtHalf, sign * sqrtHalf));
+    halves[6] = RotateQuarter(halves[6]);
+    halves[7] = ComplexMul(halves[7], float2(-sqrtHalf, sign * sqrtHalf));
+
+    [unroll]
+    for (uint k = 0; k < 4; ++k)
+    {
+        v[k] = halves[k] + halves[k + 4];
+        v[k + 4] = halves[k] - halves[k + 4];
+    }
+}
+
+// Butterflies of radix elements from offset. radix is a literal so the branches are resolved when compiling.
+void Butterfly(inout float2 v[FFT_MAX_RADIX], uint offset, uint radix)
+{
+    if (radix == 8)
+        Butterfly8(v);
+    else if (radix == 4)
+        Butterfly4(v, offset);
+    else
+        Butterfly2(v, offset);
+}
+
+uint ElementIndex(uint batch, uint element)
+{
+    return batch * g_batchStride + element * g_elementStride;
+}
+
+#if FFT_PASS == FFT_PASS_GROUPSHARED
+
+// Note separate real and imaginary parts, so FFT_MAX_GROUPSHARED_SIZE complex elements fill the 32KB
+groupshared float gs_re[FFT_GROUPSHARED_SIZE];
+groupshared float gs_im[FFT_GROUPSHARED_SIZE];
+
+// Same than the radix 8 stages after a first one of radix 2, 4 or 8, as CalculateFftRadices in src/cpufft.cpp
+uint StageRadix(uint stage)
+{
+    const uint firstStageBits = firstbithigh(FFT_GROUPSHARED_SIZE) % 3;
+    return stage > 0 || firstStageBits == 0 ? 8 : 1 << firstStageBits;
+}
+
+// Every thread loads 8 / radix butterflies, FFT_GROUP_SIZE apart, and writes them after a barrier so the
+// stage can be done in place
+void GroupSharedStage(uint radix, uint stride, uint twiddlesOffset, uint groupIndex)
+{
+    const uint butterfliesCount = FFT_GROUPSHARED_SIZE / radix;
+    const uint butterfliesPerThread = min(butterfliesCount / FFT_GROUP_SIZE, FFT_MAX_RADIX / radix);
+
+    float2 v[FFT_MAX_RADIX];
+    [unroll]
+    for (uint b = 0; b < butterfliesPerThread; ++b)
+    {
+        const uint j = groupIndex + b * FFT_GROUP_SIZE;
+        const uint k = j & (stride - 1);
+
+        [unroll]
+        for (uint r = 0; r < radix; ++r)
+        {
+            const uint index = j + r * butterfliesCount;
+            v[b * radix + r] = float2(gs_re[index], gs_im[index]);
+            if (r > 0)
+                v[b * radix + r] = ComplexMul(v[b * radix + r], LoadTwiddle(twiddlesOffset + (r - 1) * stride + k));
+        }
+        Butterfly(v, b * radix, radix);
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    [unroll]
+    for (uint c = 0; c < butterfliesPerThread; ++c)
+    {
+        const uint j = groupIndex + c * FFT_GROUP_SIZE;
+        const uint k = j & (stride - 1);
+
+        [unroll]
+        for (uint s = 0; s < radix; ++s)
+        {
+            const uint index = (j - k) * radix + k + s * stride;
+            gs_re[index] = v[c * radix + s].x;
+            gs_im[index] = v[c * radix + s].y;
+        }
+    }
+    GroupMemoryBarrierWithGroupSync();
+}
+
+// groupId.x is the sub transform and groupId.y the batch
+[numthreads( FFT_GROUP_SIZE, 1, 1 )]
+void main(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    const uint subTransformsCount = g_size / FFT_GROUPSHARED_SIZE;
+
+    for (uint i = groupIndex; i < FFT_GROUPSHARED_SIZE; i += FFT_GROUP_SIZE)
+    {
+        const float2 element = g_input[ElementIndex(groupId.y, groupId.x + i * subTransformsCount)];
+        gs_re[i] = element.x;
+        gs_im[i] = element.y;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    uint stride = 1;
+    uint twiddlesOffset = 0;
+    [unroll]
+    for (uint stage = 0; stride < FFT_GROUPSHARED_SIZE; ++stage)
+    {
+        const uint radix = StageRadix(stage);
+        GroupSharedStage(radix, stride, twiddlesOffset, groupIndex);
+        twiddlesOffset += (radix - 1) * stride;
+        stride *= radix;
+    }
+
+    for (uint o = groupIndex; o < FFT_GROUPSHARED_SIZE; o += FFT_GROUP_SIZE)
+    {
+        g_output[ElementIndex(groupId.y, groupId.x * FFT_GROUPSHARED_SIZE + o)] = float2(gs_re[o], gs_im[o]);
+    }
+}
+
+#elif FFT_PASS == FFT_PASS_STAGE
+
+// Same than Stage in src/cpufft.cpp. The butterfly j combines the elements j + r * g_size / FFT_RADIX of
+// FFT_RADIX transforms of g_stride elements into a transform of g_stride * FFT_RADIX elements.
+[numthreads( FFT_STAGE_GROUP_SIZE, 1, 1 )]
+void main(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+    const uint j = dispatchThreadId.x;
+    const uint batch = dispatchThreadId.y;
+    if (j >= g_itemsCount)
+        return;
+
+    const uint k = j & (g_stride - 1);
+
+    float2 v[FFT_MAX_RADIX];
+    [unroll]
+    for (uint r = 0; r < FFT_RADIX; ++r)
+    {
+        v[r] = g_input[ElementIndex(batch, j + r * g_itemsCount)];
+        if (r > 0)
+            v[r] = ComplexMul(v[r], LoadTwiddle((r - 1) * g_stride + k));
+    }
+    Butterfly(v, 0, FFT_RADIX);
+
+    [unroll]
+    for (uint s = 0; s < FFT_RADIX; ++s)
+    {
+        g_output[ElementIndex(batch, (j - k) * FFT_RADIX + k + s * g_stride)] = v[s];
+    }
+}
+
+#elif FFT_PASS == FFT_PASS_REAL
+
+// Same than PostprocessReal and PreprocessReal in src/cpufft.cpp. A thread per element k of a row, the
+// forward pass writes g_size + 1 elements and the inverse one g_size elements.
+[numthreads( FFT_REAL_GROUP_SIZE, 1, 1 )]
+void main(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+    const uint k = dispatchThreadId.x;
+    const uint row = dispatchThreadId.y;
+    if (k >= g_itemsCount)
+        return;
+
+    const uint inputStart = row * g_batchStride;
+    // Note the twiddles are loaded as forward ones, the inverse pass conjugates them itself
+    const float2 twiddle = g_twiddles[g_twiddlesOffset + k];
+#if FFT_INVERSE
+    const float2 x = g_input[inputStart + k];
+    const float2 xConjugate = Conjugate(g_input[inputStart + g_size - k]);
+    const float2 even = x + xConjugate;
+    const float2 odd = ComplexMul(x - xConjugate, Conjugate(twiddle));
+    // Note even + i * odd
+    g_output[row * g_outputBatchStride + k] = float2(even.x - odd.y, even.y + odd.x);
+#else
+    // Note the even and odd elements were transformed as the real and imaginary parts
+    const float2 z = g_input[inputStart + k % g_size];
+    const float2 zConjugate = Conjugate(g_input[inputStart + (g_size - k) % g_size]);
+    const float2 even = 0.5f * (z + zConjugate);
+    // Note (z - zConjugate) * -i / 2
+    const float2 difference = z - zConjugate;
+    const float2 odd = 0.5f * float2(difference.y, -difference.x);
+    g_output[row * g_outputBatchStride + k] = even + ComplexMul(odd, twiddle);
+#endif
+}
+
+#endif
@@ -0,0 +1,171 @@
+#define HistogramRootSig                                    \
+    "RootFlags( 0 ),"                                       \
+    "RootConstants( num32BitConstants = 16, b0 ),"          \
+    "DescriptorTable( SRV(t0), UAV(u0, numDescriptors = 2) )"
+
+// Luminance histogram of g_image with g_binsCount log2 scale bins between g_minLog2Luminance and
+// g_minLog2Luminance + g_log2LuminanceRange, and the luminance of up to 8 percentiles of it.
+// Luminances below the range, zero, negative or nan go to the first bin and the ones above the range
+// go to the last bin. Same mapping than CalculateHistogramBin in src/cpuhistogram.cpp.
+//  HISTOGRAM_PASS_CLEAR        zeroes g_bins
+//  HISTOGRAM_PASS_ACCUMULATE   every group builds the histogram of a tile in groupshared memory and
+//                              adds its non empty bins to g_bins with atomics
+//  HISTOGRAM_PASS_PERCENTILES  a single group scans g_bins and writes the percentiles to g_percentilesLuminance
+// Permutations:
+//  HISTOGRAM_PASS              which of the passes above the shader runs
+#define HISTOGRAM_GROUP_SIZE            16
+#define HISTOGRAM_THREADS_COUNT         (HISTOGRAM_GROUP_SIZE * HISTOGRAM_GROUP_SIZE)
+// Note every thread takes TEXELS_PER_THREAD x TEXELS_PER_THREAD texels, a group stride apart
+#define HISTOGRAM_TEXELS_PER_THREAD     4
+#define HISTOGRAM_TILE_SIZE             (HISTOGRAM_GROUP_SIZE * HISTOGRAM_TEXELS_PER_THREAD)
+#define HISTOGRAM_MAX_BINS_COUNT        1024
+#define HISTOGRAM_BINS_PER_THREAD       (HISTOGRAM_MAX_BINS_COUNT / HISTOGRAM_THREADS_COUNT)
+#define HISTOGRAM_MAX_PERCENTILES_COUNT 8
+
+#define HISTOGRAM_PASS_CLEAR            0
+#define HISTOGRAM_PASS_ACCUMULATE       1
+#define HISTOGRAM_PASS_PERCENTILES      2
+
+#ifndef HISTOGRAM_PASS
+#define HISTOGRAM_PASS HISTOGRAM_PASS_ACCUMULATE
+#endif
+
+cbuffer HistogramConstants : register(b0)
+{
+    uint2   g_imageSize;
+    uint    g_binsCount;
+    uint    g_percentilesCount;
+    float   g_minLuminance;
+    float   g_minLog2Luminance;
+    float   g_log2LuminanceRange;
+    uint    g_padding;
+    float4  g_percentiles[HISTOGRAM_MAX_PERCENTILES_COUNT / 4];
+}
+
+Texture2D<float4>           g_image             : register(t0);
+RWStructuredBuffer<uint>    g_bins              : register(u0);
+RWStructuredBuffer<float>   g_percentilesLuminance : register(u1);
+
+float GetPercentile(uint index)
+{
+    return g_percentiles[index / 4][index % 4];
+}
+
+uint CalculateBin(float3 rgb)
+{
+    const float luminance = dot(rgb, float3(0.2126f, 0.7152f, 0.0722f));
+
+    // Note written so nans go to the first bin
+    if (!(luminance > g_minLuminance))
+        return 0;
+
+    const float bin = (log2(luminance) - g_minLog2Luminance) / g_log2LuminanceRange * g_binsCount;
+    return min(uint(bin), g_binsCount - 1);
+}
+
+#if HISTOGRAM_PASS == HISTOGRAM_PASS_CLEAR
+
+[numthreads( HISTOGRAM_THREADS_COUNT, 1, 1 )]
+void main(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+    if (dispatchThreadId.x < g_binsCount)
+        g_bins[dispatchThreadId.x] = 0;
+}
+
+#elif HISTOGRAM_PASS == HISTOGRAM_PASS_ACCUMULATE
+
+// Note privatized bins so the global atomics are one per non empty bin and group instead of one per texel
+groupshared uint gs_bins[HISTOGRAM_MAX_BINS_COUNT];
+
+[numthreads( HISTOGRAM_GROUP_SIZE, HISTOGRAM_GROUP_SIZE, 1 )]
+void main(uint3 groupId : SV_GroupID, uint3 groupThreadId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+    [unroll]
+    for (uint i = 0; i < HISTOGRAM_BINS_PER_THREAD; ++i)
+    {
+        gs_bins[i * HISTOGRAM_THREADS_COUNT + groupIndex] = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint2 tileStart = groupId.xy * HISTOGRAM_TILE_SIZE + groupThreadId.xy;
+
+    [unroll]
+    for (uint y = 0; y < HISTOGRAM_TEXELS_PER_THREAD; ++y)
+    {
+        [unroll]
+        for (uint x = 0; x < HISTOGRAM_TEXELS_PER_THREAD; ++x)
+        {
+            const uint2 texel = tileStart + uint2(x, y) * HISTOGRAM_GROUP_SIZE;
+            if (all(texel < g_imageSize))
+                InterlockedAdd(gs_bins[CalculateBin(g_image.Load(int3(texel, 0)).rgb)], 1);
+        }
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    for (uint bin = groupIndex; bin < g_binsCount; bin += HISTOGRAM_THREADS_COUNT)
+    {
+        const uint count = gs_bins[bin];
+        if (count > 0)
+            InterlockedAdd(g_bins[bin], count);
+    }
+}
+
+#elif HISTOGRAM_PASS == HISTOGRAM_PASS_PERCENTILES
+
+groupshared uint gs_scan[HISTOGRAM_THREADS_COUNT];
+
+// Every thread takes HISTOGRAM_BINS_PER_THREAD consecutive bins. Same search than CalculatePercentiles in
+// src/cpuhistogram.cpp: the first bin whose cumulative count reaches the percentile, interpolated inside it.
+[numthreads( HISTOGRAM_THREADS_COUNT, 1, 1 )]
+void main(uint groupIndex : SV_GroupIndex)
+{
+    const uint begin = min(groupIndex * HISTOGRAM_BINS_PER_THREAD, g_binsCount);
+    const uint end = min(begin + HISTOGRAM_BINS_PER_THREAD, g_binsCount);
+
+    uint threadSum = 0;
+    for (uint i = begin; i < end; ++i)
+    {
+        threadSum += g_bins[i];
+    }
+
+    gs_scan[groupIndex] = threadSum;
+    GroupMemoryBarrierWithGroupSync();
+
+    [unroll]
+    for (uint offset = 1; offset < HISTOGRAM_THREADS_COUNT; offset <<= 1)
+    {
+        const uint previous = groupIndex >= offset ? gs_scan[groupIndex - offset] : 0;
+        GroupMemoryBarrierWithGroupSync();
+        gs_scan[groupIndex] += previous;
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    const uint total = gs_scan[HISTOGRAM_THREADS_COUNT - 1];
+    if (total == 0)
+    {
+        if (groupIndex < g_percentilesCount)
+            g_percentilesLuminance[groupIndex] = 0.0f;
+        return;
+    }
+
+    for (uint p = 0; p < g_percentilesCount; ++p)
+    {
+        // Note at least the first texel so empty leading bins are skipped
+        const float target = min(max(GetPercentile(p) * total, 1.0f), float(total));
+
+        uint cumulative = gs_scan[groupIndex] - threadSum;
+        for (uint j = begin; j < end; ++j)
+        {
+            const uint count = g_bins[j];
+            const float previous = float(cumulative);
+            cumulative += count;
+            if (previous < target && float(cumulative) >= target)
+            {
+                const float bin = j + (target - previous) / count;
+                g_percentilesLuminance[p] = exp2(g_minLog2Luminance + bin / g_binsCount * g_log2LuminanceRange);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,124 @@
+#define MipsGenRootSig                                      \
+    "RootFlags( 0 ),"                                       \
+    "RootConstants( num32BitConstants = 3, b0 ),"           \
+    "DescriptorTable( SRV(t0), UAV(u0, numDescriptors = 4) )"
+
+// Generates up to 4 mips from g_srcMip in a single dispatch. Every group computes a 8x8 tile of
+// the first mip and keeps it in groupshared memory to build the 4x4, 2x2 and 1x1 tiles of the
+// following mips.
+// Box filter: dst(x, y) = avg(src(2x, 2y), src(2x + 1, 2y), src(2x, 2y + 1), src(2x + 1, 2y + 1))
+// Note odd dimensions drop the last row/column as a plain 2x2 box filter would. When a dimension
+// is already 1 the texel is reused instead of reading past the edge.
+#define MIPSGEN_GROUP_SIZE 8
+
+cbuffer MipsGenConstants : register(b0)
+{
+    uint    g_mipsCount;
+    uint2   g_mip1Size;
+}
+
+Texture2D<float4>   g_srcMip    : register(t0);
+RWTexture2D<float4> g_dstMip1   : register(u0);
+RWTexture2D<float4> g_dstMip2   : register(u1);
+RWTexture2D<float4> g_dstMip3   : register(u2);
+RWTexture2D<float4> g_dstMip4   : register(u3);
+
+// Note one array per channel to avoid bank conflicts
+groupshared float gs_r[MIPSGEN_GROUP_SIZE * MIPSGEN_GROUP_SIZE];
+groupshared float gs_g[MIPSGEN_GROUP_SIZE * MIPSGEN_GROUP_SIZE];
+groupshared float gs_b[MIPSGEN_GROUP_SIZE * MIPSGEN_GROUP_SIZE];
+groupshared float gs_a[MIPSGEN_GROUP_SIZE * MIPSGEN_GROUP_SIZE];
+
+void StoreTexel(uint index, float4 texel)
+{
+    gs_r[index] = texel.r;
+    gs_g[index] = texel.g;
+    gs_b[index] = texel.b;
+    gs_a[index] = texel.a;
+}
+
+float4 LoadTexel(uint index)
+{
+    return float4(gs_r[index], gs_g[index], gs_b[index], gs_a[index]);
+}
+
+float4 Average(float4 a, float4 b, float4 c, float4 d)
+{
+    return (a + b + c + d) * 0.25f;
+}
+
+uint2 MipSize(uint mip)
+{
+    return max(g_mip1Size >> (mip - 1), 1);
+}
+
+// Averages the 2x2 quad at groupIndex from the previous mip stored in groupshared memory
+float4 ReduceQuad(uint groupIndex, float4 texel, uint2 step, uint2 prevMipSize)
+{
+    const uint2 offset = prevMipSize > 1 ? step : 0;
+    return Average(texel,
+                   LoadTexel(groupIndex + offset.x),
+                   LoadTexel(groupIndex + offset.y * MIPSGEN_GROUP_SIZE),
+                   LoadTexel(groupIndex + offset.x + offset.y * MIPSGEN_GROUP_SIZE));
+}
+
+[numthreads( MIPSGEN_GROUP_SIZE, MIPSGEN_GROUP_SIZE, 1 )]
+void main(uint groupIndex : SV_GroupIndex, uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+    uint2 srcSize;
+    g_srcMip.GetDimensions(srcSize.x, srcSize.y);
+
+    // Mip 1 straight from the source mip
+    const uint2 dst = dispatchThreadId.xy;
+    const uint2 src0 = dst * 2;
+    const uint2 src1 = src0 + (srcSize > 1 ? 1 : 0);
+    float4 texel = Average(g_srcMip.Load(int3(src0.x, src0.y, 0)), g_srcMip.Load(int3(src1.x, src0.y, 0)),
+                           g_srcMip.Load(int3(src0.x, src1.y, 0)), g_srcMip.Load(int3(src1.x, src1.y, 0)));
+    if (all(dst < g_mip1Size))
+        g_dstMip1[dst] = texel;
+
+    if (g_mipsCount == 1)
+        return;
+
+    StoreTexel(groupIndex, texel);
+    GroupMemoryBarrierWithGroupSync();
+
+    // Mip 2 by the threads with even x and y
+    if ((groupIndex & 0x9) == 0)
+    {
+        texel = ReduceQuad(groupIndex, texel, uint2(1, 1), MipSize(1));
+        const uint2 dst2 = dst >> 1;
+        if (all(dst2 < MipSize(2)))
+            g_dstMip2[dst2] = texel;
+        StoreTexel(groupIndex, texel);
+    }
+
+    if (g_mipsCount == 2)
+        return;
+
+    GroupMemoryBarrierWithGroupSync();
+
+    // Mip 3 by the threads with x and y multiple of 4
+    if ((groupIndex & 0x1B) == 0)
+    {
+        texel = ReduceQuad(groupIndex, texel, uint2(2, 2), MipSize(2));
+        const uint2 dst3 = dst >> 2;
+        if (all(dst3 < MipSize(3)))
+            g_dstMip3[dst3] = texel;
+        StoreTexel(groupIndex, texel);
+    }
+
+    if (g_mipsCount == 3)
+        return;
+
+    GroupMemoryBarrierWithGroupSync();
+
+    // Mip 4 by the first thread of the group
+    if (groupIndex == 0)
+    {
+        texel = ReduceQuad(groupIndex, texel, uint2(4, 4), MipSize(3));
+        const uint2 dst4 = dst >> 3;
+        if (all(dst4 < MipSize(4)))
+            g_dstMip4[dst4] = texel;
+    }
+}
@@ -0,0 +1,311 @@
+#define RadixSortRootSig                                    \
+    "RootFlags( 0 ),"                                       \
+    "RootConstants( num32BitConstants = 4, b0 ),"           \
+    "DescriptorTable( UAV(u0, numDescriptors = 5) )"
+
+// One 8 bits digit pass of a lsd radix sort of g_keysCount keys from g_keysIn to g_keysOut, moving the values
+// along with them. The c++ side runs the 3 passes below for every digit, ping-ponging between the keys buffer
+// and a temporary one.
+// Every group works on a contiguous block of g_blockSize keys, so the groups count stays bounded:
+//  RADIX_SORT_PASS_COUNT       histogram of the digits of the block of every group, stored digit major
+//                              in g_counts so the offsets of a digit are contiguous
+//  RADIX_SORT_PASS_SCAN        a group per digit scans the counts of that digit over the groups and stores
+//                              the digit total after the counts
+//  RADIX_SORT_PASS_SCATTER     every group scans the digits totals, then sorts its block tile by tile in
+//                              groupshared memory and writes every digit run to its offset
+// Permutations:
+//  RADIX_SORT_PASS             which of the passes above the shader runs
+//  RADIX_SORT_HAS_VALUES       1 moves a value with every key
+//  RADIX_SORT_USE_WAVE_INTRINSICS  scans with the wave intrinsics instead of a groupshared tree. Needs cs_6_0.
+#define RADIX_SORT_GROUP_SIZE       256
+#define RADIX_SORT_KEYS_PER_THREAD  4
+#define RADIX_SORT_TILE_SIZE        (RADIX_SORT_GROUP_SIZE * RADIX_SORT_KEYS_PER_THREAD)
+#define RADIX_SORT_DIGIT_BITS       8
+#define RADIX_SORT_DIGITS_COUNT     (1 << RADIX_SORT_DIGIT_BITS)
+// Note the scan pass covers up to RADIX_SORT_KEYS_PER_THREAD counts per thread
+#define RADIX_SORT_MAX_GROUPS_COUNT (RADIX_SORT_GROUP_SIZE * RADIX_SORT_KEYS_PER_THREAD)
+
+#define RADIX_SORT_PASS_COUNT       0
+#define RADIX_SORT_PASS_SCAN        1
+#define RADIX_SORT_PASS_SCATTER     2
+
+#ifndef RADIX_SORT_PASS
+#define RADIX_SORT_PASS RADIX_SORT_PASS_COUNT
+#endif
+
+#ifndef RADIX_SORT_HAS_VALUES
+#define RADIX_SORT_HAS_VALUES 0
+#endif
+
+#ifndef RADIX_SORT_USE_WAVE_INTRINSICS
+#define RADIX_SORT_USE_WAVE_INTRINSICS 0
+#endif
+
+cbuffer RadixSortConstants : register(b0)
+{
+    uint g_keysCount;
+    uint g_groupsCount;
+    uint g_blockSize;
+    uint g_shift;
+}
+
+// Note keys only sorts bind the keys again in the values slots
+RWStructuredBuffer<uint> g_keysIn       : register(u0);
+RWStructuredBuffer<uint> g_keysOut      : register(u1);
+RWStructuredBuffer<uint> g_valuesIn     : register(u2);
+RWStructuredBuffer<uint> g_valuesOut    : register(u3);
+// RADIX_SORT_DIGITS_COUNT * g_groupsCount counts followed by RADIX_SORT_DIGITS_COUNT digits totals
+RWStructuredBuffer<uint> g_counts       : register(u4);
+
+groupshared uint gs_scan[RADIX_SORT_GROUP_SIZE];
+
+uint GetDigit(uint key)
+{
+    return (key >> g_shift) & (RADIX_SORT_DIGITS_COUNT - 1);
+}
+
+// Exclusive scan of value across the group. The group total is returned in total.
+uint GroupExclusiveScan(uint value, uint groupIndex, out uint total)
+{
+#if RADIX_SORT_USE_WAVE_INTRINSICS
+    const uint lanesCount = WaveGetLaneCount();
+    const uint waveIndex = groupIndex / lanesCount;
+    const uint wavesCount = RADIX_SORT_GROUP_SIZE / lanesCount;
+
+    const uint exclusive = WavePrefixSum(value);
+    if (WaveGetLaneIndex() == lanesCount - 1)
+        gs_scan[waveIndex] = exclusive + value;
+    GroupMemoryBarrierWithGroupSync();
+
+    // Note small waves dont have a lane per wave sum
+    if (groupIndex == 0)
+    {
+        uint sum = 0;
+        for (uint i = 0; i < wavesCount; ++i)
+        {
+            const uint waveSum = gs_scan[i];
+            gs_scan[i] = sum;
+            sum += waveSum;
+        }
+        gs_scan[wavesCount] = sum;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint result = gs_scan[waveIndex] + exclusive;
+    total = gs_scan[wavesCount];
+#else
+    gs_scan[groupIndex] = value;
+    GroupMemoryBarrierWithGroupSync();
+
+    [unroll]
+    for (uint offset = 1; offset < RADIX_SORT_GROUP_SIZE; offset <<= 1)
+    {
+        const uint previous = groupIndex >= offset ? gs_scan[groupIndex - offset] : 0;
+        GroupMemoryBarrierWithGroupSync();
+        gs_scan[groupIndex] += previous;
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    const uint result = gs_scan[groupIndex] - value;
+    total = gs_scan[RADIX_SORT_GROUP_SIZE - 1];
+#endif
+    // Note gs_scan can be reused after this
+    GroupMemoryBarrierWithGroupSync();
+    return result;
+}
+
+#if RADIX_SORT_PASS == RADIX_SORT_PASS_COUNT
+
+groupshared uint gs_histogram[RADIX_SORT_DIGITS_COUNT];
+
+[numthreads( RADIX_SORT_GROUP_SIZE, 1, 1 )]
+void main(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    gs_histogram[groupIndex] = 0;
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint blockStart = groupId.x * g_blockSize;
+    const uint blockEnd = min(blockStart + g_blockSize, g_keysCount);
+    for (uint i = blockStart + groupIndex; i < blockEnd; i += RADIX_SORT_GROUP_SIZE)
+    {
+        InterlockedAdd(gs_histogram[GetDigit(g_keysIn[i])], 1);
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    g_counts[groupIndex * g_groupsCount + groupId.x] = gs_histogram[groupIndex];
+}
+
+#elif RADIX_SORT_PASS == RADIX_SORT_PASS_SCAN
+
+[numthreads( RADIX_SORT_GROUP_SIZE, 1, 1 )]
+void main(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    const uint digit = groupId.x;
+    const uint countsStart = digit * g_groupsCount;
+    const uint begin = min(groupIndex * RADIX_SORT_KEYS_PER_THREAD, g_groupsCount);
+    const uint end = min(begin + RADIX_SORT_KEYS_PER_THREAD, g_groupsCount);
+
+    uint threadSum = 0;
+    for (uint i = begin; i < end; ++i)
+    {
+        threadSum += g_counts[countsStart + i];
+    }
+
+    uint digitTotal;
+    uint prefix = GroupExclusiveScan(threadSum, groupIndex, digitTotal);
+    for (uint j = begin; j < end; ++j)
+    {
+        const uint count = g_counts[countsStart + j];
+        g_counts[countsStart + j] = prefix;
+        prefix += count;
+    }
+
+    if (groupIndex == 0)
+        g_counts[RADIX_SORT_DIGITS_COUNT * g_groupsCount + digit] = digitTotal;
+}
+
+#elif RADIX_SORT_PASS == RADIX_SORT_PASS_SCATTER
+
+groupshared uint gs_keys[RADIX_SORT_TILE_SIZE];
+#if RADIX_SORT_HAS_VALUES
+groupshared uint gs_values[RADIX_SORT_TILE_SIZE];
+#endif
+// Output offset of the next key of every digit
+groupshared uint gs_digitOffsets[RADIX_SORT_DIGITS_COUNT];
+// Range of every digit in the sorted tile
+groupshared uint gs_tileDigitStarts[RADIX_SORT_DIGITS_COUNT];
+groupshared uint gs_tileDigitEnds[RADIX_SORT_DIGITS_COUNT];
+
+// Stable sort of the tile by digit with a split per digit bit. Every thread keeps its consecutive keys in
+// registers and groupshared memory is only used to move them.
+void SortTile(uint groupIndex, inout uint keys[RADIX_SORT_KEYS_PER_THREAD],
+              inout uint values[RADIX_SORT_KEYS_PER_THREAD])
+{
+    [unroll]
+    for (uint bit = 0; bit < RADIX_SORT_DIGIT_BITS; ++bit)
+    {
+        uint ones[RADIX_SORT_KEYS_PER_THREAD];
+        uint threadOnes = 0;
+
+        [unroll]
+        for (uint i = 0; i < RADIX_SORT_KEYS_PER_THREAD; ++i)
+        {
+            ones[i] = threadOnes;
+            threadOnes += (GetDigit(keys[i]) >> bit) & 1;
+        }
+
+        uint totalOnes;
+        const uint onesBefore = GroupExclusiveScan(threadOnes, groupIndex, totalOnes);
+        const uint zerosCount = RADIX_SORT_TILE_SIZE - totalOnes;
+
+        [unroll]
+        for (uint j = 0; j < RADIX_SORT_KEYS_PER_THREAD; ++j)
+        {
+            const uint position = groupIndex * RADIX_SORT_KEYS_PER_THREAD + j;
+            const uint onesBeforeKey = onesBefore + ones[j];
+            const uint sortedPosition = ((GetDigit(keys[j]) >> bit) & 1) ? zerosCount + onesBeforeKey :
+                                                                           position - onesBeforeKey;
+            gs_keys[sortedPosition] = keys[j];
+#if RADIX_SORT_HAS_VALUES
+            gs_values[sortedPosition] = values[j];
+#endif
+        }
+        GroupMemoryBarrierWithGroupSync();
+
+        [unroll]
+        for (uint k = 0; k < RADIX_SORT_KEYS_PER_THREAD; ++k)
+        {
+            keys[k] = gs_keys[groupIndex * RADIX_SORT_KEYS_PER_THREAD + k];
+#if RADIX_SORT_HAS_VALUES
+            values[k] = gs_values[groupIndex * RADIX_SORT_KEYS_PER_THREAD + k];
+#endif
+        }
+    }
+}
+
+[numthreads( RADIX_SORT_GROUP_SIZE, 1, 1 )]
+void main(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    // Note a thread per digit
+    const uint digitTotal = g_counts[RADIX_SORT_DIGITS_COUNT * g_groupsCount + groupIndex];
+    uint keysCount;
+    const uint digitStart = GroupExclusiveScan(digitTotal, groupIndex, keysCount);
+    gs_digitOffsets[groupIndex] = digitStart + g_counts[groupIndex * g_groupsCount + groupId.x];
+
+    const uint blockStart = groupId.x * g_blockSize;
+    const uint blockEnd = min(blockStart + g_blockSize, g_keysCount);
+    for (uint tileStart = blockStart; tileStart < blockEnd; tileStart += RADIX_SORT_TILE_SIZE)
+    {
+        const uint tileKeysCount = min(blockEnd - tileStart, RADIX_SORT_TILE_SIZE);
+
+        // Note the loads are coalesced and the keys past the end get the last digit so they stay at the end
+        [unroll]
+        for (uint i = 0; i < RADIX_SORT_KEYS_PER_THREAD; ++i)
+        {
+            const uint tileIndex = i * RADIX_SORT_GROUP_SIZE + groupIndex;
+            const bool isValid = tileIndex < tileKeysCount;
+            gs_keys[tileIndex] = isValid ? g_keysIn[tileStart + tileIndex] : 0xFFFFFFFF;
+#if RADIX_SORT_HAS_VALUES
+            gs_values[tileIndex] = isValid ? g_valuesIn[tileStart + tileIndex] : 0;
+#endif
+        }
+        gs_tileDigitStarts[groupIndex] = 0;
+        gs_tileDigitEnds[groupIndex] = 0;
+        GroupMemoryBarrierWithGroupSync();
+
+        uint keys[RADIX_SORT_KEYS_PER_THREAD];
+        uint values[RADIX_SORT_KEYS_PER_THREAD];
+        [unroll]
+        for (uint j = 0; j < RADIX_SORT_KEYS_PER_THREAD; ++j)
+        {
+            keys[j] = gs_keys[groupIndex * RADIX_SORT_KEYS_PER_THREAD + j];
+#if RADIX_SORT_HAS_VALUES
+            values[j] = gs_values[groupIndex * RADIX_SORT_KEYS_PER_THREAD + j];
+#else
+            values[j] = 0;
+#endif
+        }
+        GroupMemoryBarrierWithGroupSync();
+
+        SortTile(groupIndex, keys, values);
+
+        // Digit runs limits. Note gs_keys holds the sorted tile after SortTile.
+        [unroll]
+        for (uint k = 0; k < RADIX_SORT_KEYS_PER_THREAD; ++k)
+        {
+            const uint position = groupIndex * RADIX_SORT_KEYS_PER_THREAD + k;
+            if (position < tileKeysCount)
+            {
+                const uint digit = GetDigit(keys[k]);
+                if (position == 0 || GetDigit(gs_keys[position - 1]) != digit)
+                    gs_tileDigitStarts[digit] = position;
+                if (position + 1 == tileKeysCount || GetDigit(gs_keys[position + 1]) != digit)
+                    gs_tileDigitEnds[digit] = position + 1;
+            }
+        }
+        GroupMemoryBarrierWithGroupSync();
+
+        // Note consecutive threads write consecutive keys of the same digit
+        [unroll]
+        for (uint l = 0; l < RADIX_SORT_KEYS_PER_THREAD; ++l)
+        {
+            const uint position = l * RADIX_SORT_GROUP_SIZE + groupIndex;
+            if (position < tileKeysCount)
+            {
+                const uint key = gs_keys[position];
+                const uint digit = GetDigit(key);
+                const uint dstIndex = gs_digitOffsets[digit] + position - gs_tileDigitStarts[digit];
+                g_keysOut[dstIndex] = key;
+#if RADIX_SORT_HAS_VALUES
+                g_valuesOut[dstIndex] = gs_values[position];
+#endif
+            }
+        }
+        GroupMemoryBarrierWithGroupSync();
+
+        gs_digitOffsets[groupIndex] += gs_tileDigitEnds[groupIndex] - gs_tileDigitStarts[groupIndex];
+        GroupMemoryBarrierWithGroupSync();
+    }
+}
+
+#endif
@@ -0,0 +1,148 @@
+#define ReductionRootSig                                    \
+    "RootFlags( 0 ),"                                       \
+    "RootConstants( num32BitConstants = 2, b0 ),"           \
+    "DescriptorTable( SRV(t0), UAV(u0) )"
+
+// Reduces the first g_elementsCount elements of g_input to one value per group, written to g_output[groupId].
+// The c++ side dispatches it twice: a pass over the input with a bounded amount of groups and a single
+// group pass over their partial results.
+// Permutations:
+//  REDUCTION_OP                    0 sum, 1 min, 2 max
+//  REDUCTION_DATA_TYPE             0 float, 1 uint, 2 int
+//  REDUCTION_USE_WAVE_INTRINSICS   reduces every wave with the wave intrinsics instead of a groupshared tree.
+//                                  Needs cs_6_0.
+#define REDUCTION_GROUP_SIZE 256
+
+#define REDUCTION_OP_SUM 0
+#define REDUCTION_OP_MIN 1
+#define REDUCTION_OP_MAX 2
+
+#ifndef REDUCTION_OP
+#define REDUCTION_OP REDUCTION_OP_SUM
+#endif
+
+#ifndef REDUCTION_DATA_TYPE
+#define REDUCTION_DATA_TYPE 0
+#endif
+
+#ifndef REDUCTION_USE_WAVE_INTRINSICS
+#define REDUCTION_USE_WAVE_INTRINSICS 0
+#endif
+
+#if REDUCTION_DATA_TYPE == 0
+#define DataType float
+#elif REDUCTION_DATA_TYPE == 1
+#define DataType uint
+#else
+#define DataType int
+#endif
+
+cbuffer ReductionConstants : register(b0)
+{
+    uint g_elementsCount;
+    uint g_groupsCount;
+}
+
+Buffer<DataType>    g_input     : register(t0);
+RWBuffer<DataType>  g_output    : register(u0);
+
+DataType Identity()
+{
+#if REDUCTION_OP == REDUCTION_OP_SUM
+    return 0;
+#elif REDUCTION_OP == REDUCTION_OP_MIN
+#if REDUCTION_DATA_TYPE == 0
+    return asfloat(0x7F800000); // +inf
+#elif REDUCTION_DATA_TYPE == 1
+    return 0xFFFFFFFF;
+#else
+    return 0x7FFFFFFF;
+#endif
+#else
+#if REDUCTION_DATA_TYPE == 0
+    return asfloat(0xFF800000); // -inf
+#elif REDUCTION_DATA_TYPE == 1
+    return 0;
+#else
+    return asint(0x80000000);
+#endif
+#endif
+}
+
+DataType Reduce(DataType a, DataType b)
+{
+#if REDUCTION_OP == REDUCTION_OP_SUM
+    return a + b;
+#elif REDUCTION_OP == REDUCTION_OP_MIN
+    return min(a, b);
+#else
+    return max(a, b);
+#endif
+}
+
+#if REDUCTION_USE_WAVE_INTRINSICS
+DataType WaveReduce(DataType value)
+{
+#if REDUCTION_OP == REDUCTION_OP_SUM
+    return WaveActiveSum(value);
+#elif REDUCTION_OP == REDUCTION_OP_MIN
+    return WaveActiveMin(value);
+#else
+    return WaveActiveMax(value);
+#endif
+}
+
+// One value per wave. Note waves have at least 4 lanes.
+groupshared DataType gs_partials[REDUCTION_GROUP_SIZE / 4];
+#else
+groupshared DataType gs_partials[REDUCTION_GROUP_SIZE];
+#endif
+
+[numthreads( REDUCTION_GROUP_SIZE, 1, 1 )]
+void main(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    // Note the groups stride over the whole input so a bounded amount of groups reduces any count
+    DataType value = Identity();
+    const uint stride = g_groupsCount * REDUCTION_GROUP_SIZE;
+    for (uint i = groupId.x * REDUCTION_GROUP_SIZE + groupIndex; i < g_elementsCount; i += stride)
+    {
+        value = Reduce(value, g_input[i]);
+    }
+
+#if REDUCTION_USE_WAVE_INTRINSICS
+    const uint lanesCount = WaveGetLaneCount();
+    const uint waveIndex = groupIndex / lanesCount;
+
+    value = WaveReduce(value);
+    if (WaveIsFirstLane())
+        gs_partials[waveIndex] = value;
+    GroupMemoryBarrierWithGroupSync();
+
+    if (waveIndex == 0)
+    {
+        const uint wavesCount = REDUCTION_GROUP_SIZE / lanesCount;
+        DataType groupValue = Identity();
+        for (uint i = WaveGetLaneIndex(); i < wavesCount; i += lanesCount)
+        {
+            groupValue = Reduce(groupValue, gs_partials[i]);
+        }
+        groupValue = WaveReduce(groupValue);
+        if (WaveIsFirstLane())
+            g_output[groupId.x] = groupValue;
+    }
+#else
+    gs_partials[groupIndex] = value;
+    GroupMemoryBarrierWithGroupSync();
+
+    [unroll]
+    for (uint activeThreads = REDUCTION_GROUP_SIZE / 2; activeThreads > 0; activeThreads >>= 1)
+    {
+        if (groupIndex < activeThreads)
+            gs_partials[groupIndex] = Reduce(gs_partials[groupIndex], gs_partials[groupIndex + activeThreads]);
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    if (groupIndex == 0)
+        g_output[groupId.x] = gs_partials[0];
+#endif
+}
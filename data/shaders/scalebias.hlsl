@@ -0,0 +1,31 @@
+#define ScaleBiasRootSig                                    \
+    "RootFlags( 0 ),"                                       \
+    "RootConstants( num32BitConstants = 4, b0 ),"           \
+    "SRV( t0 ),"                                            \
+    "UAV( u0 )"
+
+// Writes g_input * g_scale + g_bias to g_output, a thread per element. Small jobs of it are batched by
+// src/dispatchbatcher.h, every job with its own constants and buffers, all of them bound as root parameters
+// so jobs dont need descriptors.
+#define SCALE_BIAS_GROUP_SIZE   64
+
+cbuffer ScaleBiasConstants : register(b0)
+{
+    uint    g_elementsCount;
+    float   g_scale;
+    float   g_bias;
+    uint    g_padding;
+}
+
+StructuredBuffer<float>     g_input     : register(t0);
+RWStructuredBuffer<float>   g_output    : register(u0);
+
+[numthreads( SCALE_BIAS_GROUP_SIZE, 1, 1 )]
+void main(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+    const uint index = dispatchThreadId.x;
+    if (index >= g_elementsCount)
+        return;
+
+    g_output[index] = g_input[index] * g_scale + g_bias;
+}
\ No newline at end of file
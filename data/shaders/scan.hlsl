@@ -0,0 +1,350 @@
+#define ScanRootSig                                         \
+    "RootFlags( 0 ),"                                       \
+    "RootConstants( num32BitConstants = 2, b0 ),"           \
+    "DescriptorTable( SRV(t0), UAV(u0, numDescriptors = 2) )"
+
+// Prefix sum of the first g_elementsCount elements of g_input into g_output.
+// The input is split in partitions of SCAN_PARTITION_SIZE elements, one per group.
+// Permutations:
+//  SCAN_PASS                       which of the passes below the shader runs
+//  SCAN_INCLUSIVE                  0 exclusive scan, 1 inclusive scan
+//  SCAN_USE_WAVE_INTRINSICS        scans the waves with the wave intrinsics instead of a groupshared tree.
+//                                  Needs cs_6_0.
+//
+// Decoupled look-back: SCAN_PASS_CLEAR_STATE and then SCAN_PASS_LOOK_BACK. Groups take their partition from
+// an atomic counter, publish their aggregate and walk back the previous partitions states until one has its
+// inclusive prefix, so the input is read once.
+// Reduce then scan: SCAN_PASS_REDUCE, SCAN_PASS_SCAN_PARTITIONS and SCAN_PASS_DOWNSWEEP. It reads the input
+// twice but doesnt depend on groups of other partitions making progress.
+#define SCAN_GROUP_SIZE             256
+#define SCAN_ELEMENTS_PER_THREAD    8
+#define SCAN_PARTITION_SIZE         (SCAN_GROUP_SIZE * SCAN_ELEMENTS_PER_THREAD)
+
+#define SCAN_PASS_CLEAR_STATE       0
+#define SCAN_PASS_LOOK_BACK         1
+#define SCAN_PASS_REDUCE            2
+#define SCAN_PASS_SCAN_PARTITIONS   3
+#define SCAN_PASS_DOWNSWEEP         4
+
+#ifndef SCAN_PASS
+#define SCAN_PASS SCAN_PASS_LOOK_BACK
+#endif
+
+#ifndef SCAN_INCLUSIVE
+#define SCAN_INCLUSIVE 0
+#endif
+
+#ifndef SCAN_USE_WAVE_INTRINSICS
+#define SCAN_USE_WAVE_INTRINSICS 0
+#endif
+
+// g_state word 0 is the partitions counter.
+// Look-back states take SCAN_LOOK_BACK_STATE_WORDS words per partition from word 1: a flag, the aggregate and the
+// inclusive prefix. The sums are written before the flag telling they are there and read after it, with a device
+// memory barrier in between, so they use all the 32 bits and wrap as the cpu ones.
+// Reduce then scan states are the plain sums, a word per partition.
+#define SCAN_FLAG_NOT_READY         0
+#define SCAN_FLAG_AGGREGATE         1
+#define SCAN_FLAG_INCLUSIVE_PREFIX  2
+#define SCAN_LOOK_BACK_STATE_WORDS  3
+
+cbuffer ScanConstants : register(b0)
+{
+    uint g_elementsCount;
+    uint g_partitionsCount;
+}
+
+Buffer<uint>                            g_input     : register(t0);
+RWBuffer<uint>                          g_output    : register(u0);
+globallycoherent RWByteAddressBuffer    g_state     : register(u1);
+
+groupshared uint gs_elements[SCAN_PARTITION_SIZE];
+groupshared uint gs_scan[SCAN_GROUP_SIZE];
+groupshared uint gs_partitionIndex;
+groupshared uint gs_partitionPrefix;
+
+// Note reduce then scan states
+uint SumAddress(uint partitionIndex)
+{
+    return (1 + partitionIndex) * 4;
+}
+
+uint FlagAddress(uint partitionIndex)
+{
+    return (1 + partitionIndex * SCAN_LOOK_BACK_STATE_WORDS) * 4;
+}
+
+uint AggregateAddress(uint partitionIndex)
+{
+    return FlagAddress(partitionIndex) + 4;
+}
+
+uint InclusivePrefixAddress(uint partitionIndex)
+{
+    return FlagAddress(partitionIndex) + 8;
+}
+
+// Note the global memory is accessed by consecutive threads and every thread works on consecutive elements
+// in groupshared memory
+void LoadPartition(uint partitionIndex, uint groupIndex)
+{
+    const uint partitionStart = partitionIndex * SCAN_PARTITION_SIZE;
+
+    [unroll]
+    for (uint i = 0; i < SCAN_ELEMENTS_PER_THREAD; ++i)
+    {
+        const uint partitionOffset = i * SCAN_GROUP_SIZE + groupIndex;
+        const uint index = partitionStart + partitionOffset;
+        gs_elements[partitionOffset] = index < g_elementsCount ? g_input[index] : 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+}
+
+void StorePartition(uint partitionIndex, uint groupIndex)
+{
+    const uint partitionStart = partitionIndex * SCAN_PARTITION_SIZE;
+
+    [unroll]
+    for (uint i = 0; i < SCAN_ELEMENTS_PER_THREAD; ++i)
+    {
+        const uint partitionOffset = i * SCAN_GROUP_SIZE + groupIndex;
+        const uint index = partitionStart + partitionOffset;
+        if (index < g_elementsCount)
+            g_output[index] = gs_elements[partitionOffset];
+    }
+}
+
+// Scans the elements of the thread in registers. Returns their sum.
+uint ScanThreadElements(uint groupIndex, out uint scanned[SCAN_ELEMENTS_PER_THREAD])
+{
+    uint sum = 0;
+
+    [unroll]
+    for (uint i = 0; i < SCAN_ELEMENTS_PER_THREAD; ++i)
+    {
+        const uint element = gs_elements[groupIndex * SCAN_ELEMENTS_PER_THREAD + i];
+#if SCAN_INCLUSIVE
+        sum += element;
+        scanned[i] = sum;
+#else
+        scanned[i] = sum;
+        sum += element;
+#endif
+    }
+
+    return sum;
+}
+
+// Writes the scanned elements plus prefix back to groupshared memory to be stored by StorePartition
+void WriteThreadElements(uint groupIndex, uint scanned[SCAN_ELEMENTS_PER_THREAD], uint prefix)
+{
+    [unroll]
+    for (uint i = 0; i < SCAN_ELEMENTS_PER_THREAD; ++i)
+    {
+        gs_elements[groupIndex * SCAN_ELEMENTS_PER_THREAD + i] = prefix + scanned[i];
+    }
+    GroupMemoryBarrierWithGroupSync();
+}
+
+// Inclusive scan of value across the group
+uint GroupInclusiveScan(uint value, uint groupIndex)
+{
+#if SCAN_USE_WAVE_INTRINSICS
+    const uint lanesCount = WaveGetLaneCount();
+    const uint waveIndex = groupIndex / lanesCount;
+    const uint wavesCount = SCAN_GROUP_SIZE / lanesCount;
+
+    const uint inclusive = WavePrefixSum(value) + value;
+    if (WaveGetLaneIndex() == lanesCount - 1)
+        gs_scan[waveIndex] = inclusive;
+    GroupMemoryBarrierWithGroupSync();
+
+    // Exclusive scan of the wave sums. Note small waves dont have a lane per wave sum.
+    if (wavesCount <= lanesCount)
+    {
+        if (groupIndex < wavesCount)
+            gs_scan[groupIndex] = WavePrefixSum(gs_scan[groupIndex]);
+    }
+    else if (groupIndex == 0)
+    {
+        uint sum = 0;
+        for (uint i = 0; i < wavesCount; ++i)
+        {
+            const uint waveSum = gs_scan[i];
+            gs_scan[i] = sum;
+            sum += waveSum;
+        }
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint result = gs_scan[waveIndex] + inclusive;
+#else
+    gs_scan[groupIndex] = value;
+    GroupMemoryBarrierWithGroupSync();
+
+    [unroll]
+    for (uint offset = 1; offset < SCAN_GROUP_SIZE; offset <<= 1)
+    {
+        const uint previous = groupIndex >= offset ? gs_scan[groupIndex - offset] : 0;
+        GroupMemoryBarrierWithGroupSync();
+        gs_scan[groupIndex] += previous;
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    const uint result = gs_scan[groupIndex];
+#endif
+    // Note gs_scan can be reused after this
+    GroupMemoryBarrierWithGroupSync();
+    return result;
+}
+
+#if SCAN_PASS == SCAN_PASS_CLEAR_STATE
+
+// Note only the flags, the sums are written before them
+[numthreads( SCAN_GROUP_SIZE, 1, 1 )]
+void main(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+    if (dispatchThreadId.x == 0)
+        g_state.Store(0, 0);
+    else if (dispatchThreadId.x <= g_partitionsCount)
+        g_state.Store(FlagAddress(dispatchThreadId.x - 1), SCAN_FLAG_NOT_READY);
+}
+
+#elif SCAN_PASS == SCAN_PASS_LOOK_BACK
+
+// Writes a sum of the partition and then the flag telling it is there
+void PublishState(uint partitionIndex, uint sumAddress, uint sum, uint flag)
+{
+    g_state.Store(sumAddress, sum);
+    DeviceMemoryBarrier();
+    g_state.Store(FlagAddress(partitionIndex), flag);
+}
+
+// Walks back the states of the previous partitions adding their sums until one has its inclusive prefix
+uint LookBack(uint partitionIndex)
+{
+    uint prefix = 0;
+    int lookBackIndex = int(partitionIndex) - 1;
+
+    [allow_uav_condition]
+    while (lookBackIndex >= 0)
+    {
+        const uint flag = g_state.Load(FlagAddress(lookBackIndex));
+        if (flag == SCAN_FLAG_NOT_READY)
+            continue;
+
+        // Note the sum the flag tells about is read after it
+        DeviceMemoryBarrier();
+        if (flag == SCAN_FLAG_INCLUSIVE_PREFIX)
+        {
+            prefix += g_state.Load(InclusivePrefixAddress(lookBackIndex));
+            break;
+        }
+        prefix += g_state.Load(AggregateAddress(lookBackIndex));
+        --lookBackIndex;
+    }
+
+    return prefix;
+}
+
+[numthreads( SCAN_GROUP_SIZE, 1, 1 )]
+void main(uint groupIndex : SV_GroupIndex)
+{
+    // Note the partitions are taken in launch order so the ones looked back at have already started
+    if (groupIndex == 0)
+    {
+        uint partitionIndex;
+        g_state.InterlockedAdd(0, 1, partitionIndex);
+        gs_partitionIndex = partitionIndex;
+    }
+    GroupMemoryBarrierWithGroupSync();
+    const uint partitionIndex = gs_partitionIndex;
+
+    LoadPartition(partitionIndex, groupIndex);
+
+    uint scanned[SCAN_ELEMENTS_PER_THREAD];
+    const uint threadSum = ScanThreadElements(groupIndex, scanned);
+    const uint threadInclusive = GroupInclusiveScan(threadSum, groupIndex);
+
+    if (groupIndex == SCAN_GROUP_SIZE - 1)
+    {
+        const uint aggregate = threadInclusive;
+        uint prefix = 0;
+        if (partitionIndex == 0)
+        {
+            PublishState(partitionIndex, InclusivePrefixAddress(partitionIndex), aggregate, SCAN_FLAG_INCLUSIVE_PREFIX);
+        }
+        else
+        {
+            PublishState(partitionIndex, AggregateAddress(partitionIndex), aggregate, SCAN_FLAG_AGGREGATE);
+            prefix = LookBack(partitionIndex);
+            PublishState(partitionIndex, InclusivePrefixAddress(partitionIndex), prefix + aggregate,
+                         SCAN_FLAG_INCLUSIVE_PREFIX);
+        }
+        gs_partitionPrefix = prefix;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    WriteThreadElements(groupIndex, scanned, gs_partitionPrefix + threadInclusive - threadSum);
+    StorePartition(partitionIndex, groupIndex);
+}
+
+#elif SCAN_PASS == SCAN_PASS_REDUCE
+
+[numthreads( SCAN_GROUP_SIZE, 1, 1 )]
+void main(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    const uint partitionIndex = groupId.x;
+    LoadPartition(partitionIndex, groupIndex);
+
+    uint scanned[SCAN_ELEMENTS_PER_THREAD];
+    const uint threadSum = ScanThreadElements(groupIndex, scanned);
+    const uint threadInclusive = GroupInclusiveScan(threadSum, groupIndex);
+
+    if (groupIndex == SCAN_GROUP_SIZE - 1)
+        g_state.Store(SumAddress(partitionIndex), threadInclusive);
+}
+
+#elif SCAN_PASS == SCAN_PASS_SCAN_PARTITIONS
+
+// Single group exclusive scan of the partitions sums, in place. Every thread takes consecutive partitions.
+[numthreads( SCAN_GROUP_SIZE, 1, 1 )]
+void main(uint groupIndex : SV_GroupIndex)
+{
+    const uint partitionsPerThread = (g_partitionsCount + SCAN_GROUP_SIZE - 1) / SCAN_GROUP_SIZE;
+    const uint begin = min(groupIndex * partitionsPerThread, g_partitionsCount);
+    const uint end = min(begin + partitionsPerThread, g_partitionsCount);
+
+    uint threadSum = 0;
+    for (uint i = begin; i < end; ++i)
+    {
+        threadSum += g_state.Load(SumAddress(i));
+    }
+
+    uint prefix = GroupInclusiveScan(threadSum, groupIndex) - threadSum;
+    for (uint j = begin; j < end; ++j)
+    {
+        const uint partitionSum = g_state.Load(SumAddress(j));
+        g_state.Store(SumAddress(j), prefix);
+        prefix += partitionSum;
+    }
+}
+
+#elif SCAN_PASS == SCAN_PASS_DOWNSWEEP
+
+[numthreads( SCAN_GROUP_SIZE, 1, 1 )]
+void main(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    const uint partitionIndex = groupId.x;
+    LoadPartition(partitionIndex, groupIndex);
+
+    uint scanned[SCAN_ELEMENTS_PER_THREAD];
+    const uint threadSum = ScanThreadElements(groupIndex, scanned);
+    const uint threadInclusive = GroupInclusiveScan(threadSum, groupIndex);
+
+    const uint partitionPrefix = g_state.Load(SumAddress(partitionIndex));
+    WriteThreadElements(groupIndex, scanned, partitionPrefix + threadInclusive - threadSum);
+    StorePartition(partitionIndex, groupIndex);
+}
+
+#endif
@@ -0,0 +1,178 @@
+#define SgemmRootSig                                        \
+    "RootFlags( 0 ),"                                       \
+    "RootConstants( num32BitConstants = 5, b0 ),"           \
+    "DescriptorTable( SRV(t0, numDescriptors = 2), UAV(u0) )"
+
+// g_c = g_alpha * g_a * g_b + g_beta * g_c with row major matrices. g_a is g_m x g_k, g_b is g_k x g_n and
+// g_c is g_m x g_n.
+// Every group computes a SGEMM_TILE_M x SGEMM_TILE_N tile of g_c. The tiles of g_a and g_b are staged in
+// groupshared memory SGEMM_TILE_K columns/rows at a time and every thread accumulates a
+// SGEMM_THREAD_M x SGEMM_THREAD_N block in registers, so every groupshared read feeds several fmas.
+// Note the rows and columns of a thread are a group stride apart, so the threads of a wave read consecutive
+// groupshared addresses and write consecutive addresses of g_c.
+// Permutations:
+//  SGEMM_TILE_M, SGEMM_TILE_N, SGEMM_TILE_K    size of the tiles of g_c and of the steps along g_k
+//  SGEMM_THREAD_M, SGEMM_THREAD_N              size of the block of every thread
+//  SGEMM_VECTOR_LOADS                          loads g_a and g_b as float4. Needs g_k and g_n to be multiples
+//                                              of 4 and SGEMM_TILE_K and SGEMM_TILE_N too.
+#ifndef SGEMM_TILE_M
+#define SGEMM_TILE_M 64
+#endif
+
+#ifndef SGEMM_TILE_N
+#define SGEMM_TILE_N 64
+#endif
+
+#ifndef SGEMM_TILE_K
+#define SGEMM_TILE_K 16
+#endif
+
+#ifndef SGEMM_THREAD_M
+#define SGEMM_THREAD_M 4
+#endif
+
+#ifndef SGEMM_THREAD_N
+#define SGEMM_THREAD_N 4
+#endif
+
+#ifndef SGEMM_VECTOR_LOADS
+#define SGEMM_VECTOR_LOADS 0
+#endif
+
+#define SGEMM_GROUP_SIZE_X      (SGEMM_TILE_N / SGEMM_THREAD_N)
+#define SGEMM_GROUP_SIZE_Y      (SGEMM_TILE_M / SGEMM_THREAD_M)
+#define SGEMM_THREADS_COUNT     (SGEMM_GROUP_SIZE_X * SGEMM_GROUP_SIZE_Y)
+
+cbuffer SgemmConstants : register(b0)
+{
+    uint    g_m;
+    uint    g_n;
+    uint    g_k;
+    float   g_alpha;
+    float   g_beta;
+}
+
+#if SGEMM_VECTOR_LOADS
+Buffer<float4>  g_a : register(t0);
+Buffer<float4>  g_b : register(t1);
+#else
+Buffer<float>   g_a : register(t0);
+Buffer<float>   g_b : register(t1);
+#endif
+RWBuffer<float> g_c : register(u0);
+
+// Note g_a is stored transposed so the inner loop reads both tiles along their rows
+groupshared float gs_a[SGEMM_TILE_K][SGEMM_TILE_M];
+groupshared float gs_b[SGEMM_TILE_K][SGEMM_TILE_N];
+
+// Note out of bounds elements are loaded as 0 so they dont contribute to the sums
+void LoadTiles(uint2 tileStart, uint kStart, uint groupIndex)
+{
+#if SGEMM_VECTOR_LOADS
+    for (uint i = groupIndex; i < SGEMM_TILE_M * SGEMM_TILE_K / 4; i += SGEMM_THREADS_COUNT)
+    {
+        const uint tileRow = i / (SGEMM_TILE_K / 4);
+        const uint tileColumn = (i % (SGEMM_TILE_K / 4)) * 4;
+        const uint row = tileStart.y + tileRow;
+        const uint column = kStart + tileColumn;
+        const float4 a = row < g_m && column < g_k ? g_a[(row * g_k + column) / 4] : 0.0f;
+        gs_a[tileColumn][tileRow] = a.x;
+        gs_a[tileColumn + 1][tileRow] = a.y;
+        gs_a[tileColumn + 2][tileRow] = a.z;
+        gs_a[tileColumn + 3][tileRow] = a.w;
+    }
+
+    for (uint j = groupIndex; j < SGEMM_TILE_K * SGEMM_TILE_N / 4; j += SGEMM_THREADS_COUNT)
+    {
+        const uint tileRow = j / (SGEMM_TILE_N / 4);
+        const uint tileColumn = (j % (SGEMM_TILE_N / 4)) * 4;
+        const uint row = kStart + tileRow;
+        const uint column = tileStart.x + tileColumn;
+        const float4 b = row < g_k && column < g_n ? g_b[(row * g_n + column) / 4] : 0.0f;
+        gs_b[tileRow][tileColumn] = b.x;
+        gs_b[tileRow][tileColumn + 1] = b.y;
+        gs_b[tileRow][tileColumn + 2] = b.z;
+        gs_b[tileRow][tileColumn + 3] = b.w;
+    }
+#else
+    for (uint i = groupIndex; i < SGEMM_TILE_M * SGEMM_TILE_K; i += SGEMM_THREADS_COUNT)
+    {
+        const uint tileRow = i / SGEMM_TILE_K;
+        const uint tileColumn = i % SGEMM_TILE_K;
+        const uint row = tileStart.y + tileRow;
+        const uint column = kStart + tileColumn;
+        gs_a[tileColumn][tileRow] = row < g_m && column < g_k ? g_a[row * g_k + column] : 0.0f;
+    }
+
+    for (uint j = groupIndex; j < SGEMM_TILE_K * SGEMM_TILE_N; j += SGEMM_THREADS_COUNT)
+    {
+        const uint tileRow = j / SGEMM_TILE_N;
+        const uint tileColumn = j % SGEMM_TILE_N;
+        const uint row = kStart + tileRow;
+        const uint column = tileStart.x + tileColumn;
+        gs_b[tileRow][tileColumn] = row < g_k && column < g_n ? g_b[row * g_n + column] : 0.0f;
+    }
+#endif
+}
+
+[numthreads( SGEMM_GROUP_SIZE_X, SGEMM_GROUP_SIZE_Y, 1 )]
+void main(uint3 groupId : SV_GroupID, uint3 groupThreadId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+    const uint2 tileStart = groupId.xy * uint2(SGEMM_TILE_N, SGEMM_TILE_M);
+
+    float sums[SGEMM_THREAD_M][SGEMM_THREAD_N];
+    [unroll]
+    for (uint i = 0; i < SGEMM_THREAD_M; ++i)
+    {
+        [unroll]
+        for (uint j = 0; j < SGEMM_THREAD_N; ++j)
+            sums[i][j] = 0.0f;
+    }
+
+    for (uint kStart = 0; kStart < g_k; kStart += SGEMM_TILE_K)
+    {
+        LoadTiles(tileStart, kStart, groupIndex);
+        GroupMemoryBarrierWithGroupSync();
+
+        [unroll]
+        for (uint k = 0; k < SGEMM_TILE_K; ++k)
+        {
+            float a[SGEMM_THREAD_M];
+            float b[SGEMM_THREAD_N];
+            [unroll]
+            for (uint l = 0; l < SGEMM_THREAD_M; ++l)
+                a[l] = gs_a[k][l * SGEMM_GROUP_SIZE_Y + groupThreadId.y];
+            [unroll]
+            for (uint p = 0; p < SGEMM_THREAD_N; ++p)
+                b[p] = gs_b[k][p * SGEMM_GROUP_SIZE_X + groupThreadId.x];
+
+            [unroll]
+            for (uint q = 0; q < SGEMM_THREAD_M; ++q)
+            {
+                [unroll]
+                for (uint r = 0; r < SGEMM_THREAD_N; ++r)
+                    sums[q][r] = mad(a[q], b[r], sums[q][r]);
+            }
+        }
+        // Note the tiles are overwritten by the next step
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    [unroll]
+    for (uint s = 0; s < SGEMM_THREAD_M; ++s)
+    {
+        const uint row = tileStart.y + s * SGEMM_GROUP_SIZE_Y + groupThreadId.y;
+        [unroll]
+        for (uint t = 0; t < SGEMM_THREAD_N; ++t)
+        {
+            const uint column = tileStart.x + t * SGEMM_GROUP_SIZE_X + groupThreadId.x;
+            if (row < g_m && column < g_n)
+            {
+                const uint index = row * g_n + column;
+                // Note beta 0 doesnt read g_c, so it can hold nans
+                const float c = g_beta != 0.0f ? g_beta * g_c[index] : 0.0f;
+                g_c[index] = mad(g_alpha, sums[s][t], c);
+            }
+        }
+    }
+}
@@ -1,9 +1,10 @@
-#define SimpleRootSig                       \
-    "RootFlags( 0 ),"                       \
-    "DescriptorTable( SRV(t0), UAV(u0) ),"  \
-    "CBV(b0),"                              \
+#define SimpleRootSig                               \
+    "RootFlags( 0 ),"                               \
+    "DescriptorTable( SRV(t0), UAV(u0) ),"          \
+    "RootConstants( num32BitConstants = 1, b0 ),"   \
     "SRV(t1)"
 
+// Note set as root constants, so it needs no buffer nor upload
 cbuffer ConstantData : register(b0)
 {
     float g_float;
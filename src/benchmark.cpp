@@ -0,0 +1,31 @@
+#include "benchmark.h"
+
+#include <cassert>
+#include <iostream>
+#include <iomanip>
+
+namespace
+{
+const char* g_benchmarkTag = "[ComputeBasics][Benchmark]";
+}
+
+void ComputeBasics::ReportBenchmark(const std::string& name, const std::string& config, double seconds, double bytes)
+{
+    assert(seconds > 0.0);
+
+    std::cout << g_benchmarkTag << "[" << name << "] " << config << ": " 
+              << std::fixed << std::setprecision(3) << seconds * 1000.0 << "ms";
+    if (bytes > 0.0)
+        std::cout << " " << bytes / seconds / 1e9 << "GB/s";
+    std::cout << "\n";
+}
+
+void ComputeBasics::ReportBenchmark(const std::string& name, const std::string& config, double seconds,
+                                    double itemsPerSecond, const std::string& itemsUnit)
+{
+    assert(seconds > 0.0);
+
+    std::cout << g_benchmarkTag << "[" << name << "] " << config << ": " 
+              << std::fixed << std::setprecision(3) << seconds * 1000.0 << "ms " 
+              << itemsPerSecond << itemsUnit << "\n";
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Helpers shared by the cpu and gpu benchmarks. It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+class BenchmarkTimer
+{
+public:
+    BenchmarkTimer() : m_start(Clock::now()) {}
+
+    void Restart() { m_start = Clock::now(); }
+    double ElapsedSeconds() const { return std::chrono::duration<double>(Clock::now() - m_start).count(); }
+
+private:
+    using Clock = std::chrono::high_resolution_clock;
+
+    Clock::time_point m_start;
+};
+
+// Prints a line like [ComputeBasics][Benchmark][name] config: 1.234ms 12.345GB/s
+// bytes is the amount of memory read and written by the benchmarked work. 0 skips the bandwidth.
+void ReportBenchmark(const std::string& name, const std::string& config, double seconds, double bytes);
+
+// Same than ReportBenchmark but with a custom throughput unit (ie Mpixels/s or GFLOP/s)
+void ReportBenchmark(const std::string& name, const std::string& config, double seconds,
+                     double itemsPerSecond, const std::string& itemsUnit);
+
+}
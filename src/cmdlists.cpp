@@ -0,0 +1,313 @@
+#include "cmdlists.h"
+
+#include "utils.h"
+#include "cmdqueuesyncer.h"
+
+using namespace ComputeBasics;
+
+CommandQueue ComputeBasics::CreateCommandQueue(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type, 
+                                               bool disableTimeout, const std::wstring& name)
+{
+    assert(device);
+
+    D3D12_COMMAND_QUEUE_DESC queueDesc {};
+    queueDesc.Type = type;
+    if (disableTimeout)
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_DISABLE_GPU_TIMEOUT;
+
+    CommandQueue cmdQueue;
+    Utils::AssertIfFailed(device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&cmdQueue.m_cmdQueue)));
+    assert(cmdQueue.m_cmdQueue);
+
+    Utils::AssertIfFailed(cmdQueue.m_cmdQueue->GetTimestampFrequency(&cmdQueue.m_timestampFrequency));
+    cmdQueue.m_cmdQueue->SetName(name.c_str());
+
+    return cmdQueue;
+}
+
+CommandQueue ComputeBasics::CreateComputeCmdQueue(ID3D12Device* device)
+{
+    assert(device);
+    return CreateCommandQueue(device, D3D12_COMMAND_LIST_TYPE_COMPUTE, true, L"Compute Queue");
+}
+
+CommandQueue ComputeBasics::CreateCopyCmdQueue(ID3D12Device* device)
+{
+    assert(device);
+    return CreateCommandQueue(device, D3D12_COMMAND_LIST_TYPE_COPY, true, L"Copy Queue");
+}
+
+// Note sticking together the cmdlist and the allocator. Not the most efficient way of doing it
+// but good enough for now
+CommandList ComputeBasics::CreateCommandList(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type, const std::wstring& name)
+{
+    assert(device);
+
+    CommandList cmdList;
+
+    Utils::AssertIfFailed(device->CreateCommandAllocator(type, IID_PPV_ARGS(&cmdList.m_allocator)));
+    assert(cmdList.m_allocator);
+    cmdList.m_allocator->SetName((L"Command Allocator : CommandList " + name).c_str());
+
+    Utils::AssertIfFailed(device->CreateCommandList(0, type, cmdList.m_allocator.Get(), nullptr, 
+                                                    IID_PPV_ARGS(&cmdList.m_cmdList)));
+    assert(cmdList.m_cmdList);
+    cmdList.m_cmdList->SetName((L"Command List " + name).c_str());
+
+    return cmdList;
+}
+
+CommandList ComputeBasics::CreateCopyCommandList(ID3D12Device* device, const std::wstring& name)
+{
+    D3D12_COMMAND_LIST_TYPE type = D3D12_COMMAND_LIST_TYPE_COPY;
+    return CreateCommandList(device, type, name);
+}
+
+CommandList ComputeBasics::CreateComputeCommandList(ID3D12Device* device, const std::wstring& name)
+{
+    D3D12_COMMAND_LIST_TYPE type = D3D12_COMMAND_LIST_TYPE_COMPUTE;
+    return CreateCommandList(device, type, name);
+}
+
+D3D12_RESOURCE_BARRIER ComputeBasics::CreateTransition(ID3D12Resource* resource, 
+                                                       D3D12_RESOURCE_STATES before, 
+                                                       D3D12_RESOURCE_STATES after)
+{
+    return CreateTransition(resource, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, before, after);
+}
+
+D3D12_RESOURCE_BARRIER ComputeBasics::CreateTransition(ID3D12Resource* resource, uint32_t subresource,
+                                                       D3D12_RESOURCE_STATES before,
+                                                       D3D12_RESOURCE_STATES after)
+{
+    assert(resource);
+
+    D3D12_RESOURCE_BARRIER copyDestToReadDest;
+    copyDestToReadDest.Type                     = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    copyDestToReadDest.Flags                    = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+    copyDestToReadDest.Transition.pResource     = resource;
+    copyDestToReadDest.Transition.Subresource   = subresource;
+    copyDestToReadDest.Transition.StateBefore   = before;
+    copyDestToReadDest.Transition.StateAfter    = after;
+
+    return copyDestToReadDest;
+}
+
+D3D12_RESOURCE_BARRIER ComputeBasics::CreateUAVBarrier(ID3D12Resource* resource)
+{
+    assert(resource);
+
+    D3D12_RESOURCE_BARRIER uavBarrier;
+    uavBarrier.Type             = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    uavBarrier.Flags            = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+    uavBarrier.UAV.pResource    = resource;
+
+    return uavBarrier;
+}
+
+D3D12_RESOURCE_BARRIER ComputeBasics::CreateGlobalUAVBarrier()
+{
+    D3D12_RESOURCE_BARRIER uavBarrier;
+    uavBarrier.Type             = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    uavBarrier.Flags            = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+    uavBarrier.UAV.pResource    = nullptr;
+
+    return uavBarrier;
+}
+
+D3D12_RESOURCE_STATES ComputeBasics::ToD3D12State(ResourceState state)
+{
+    switch (state)
+    {
+    case ResourceState::Common:             return D3D12_RESOURCE_STATE_COMMON;
+    case ResourceState::CopySource:         return D3D12_RESOURCE_STATE_COPY_SOURCE;
+    case ResourceState::CopyDest:           return D3D12_RESOURCE_STATE_COPY_DEST;
+    case ResourceState::ShaderResource:     return D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+    case ResourceState::UnorderedAccess:    return D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    }
+    assert(false);
+    return D3D12_RESOURCE_STATE_COMMON;
+}
+
+D3D12_RESOURCE_BARRIER ComputeBasics::ToD3D12Barrier(const ResourceBarrier& barrier, ID3D12Resource* resource)
+{
+    if (barrier.m_type == ResourceBarrierType::UAV)
+        return barrier.m_resource == g_allResources ? CreateGlobalUAVBarrier() : CreateUAVBarrier(resource);
+
+    return CreateTransition(resource, barrier.m_subresource, ToD3D12State(barrier.m_before),
+                            ToD3D12State(barrier.m_after));
+}
+
+// TODO not quite happy with returning the temp here. Good enough for now.
+// Note returning the tmp so the object outlives the execution in the gpu
+GpuMemAllocation ComputeBasics::EnqueueUploadDataToBuffer(ID3D12Device* device,
+                                                          ID3D12GraphicsCommandList* copyCmdList,
+                                                          ID3D12Resource* dst, const void* data, uint64_t sizeBytes)
+{
+    assert(device);
+    assert(copyCmdList);
+    assert(dst);
+    assert(data && sizeBytes);
+
+    assert(copyCmdList->GetType() == D3D12_COMMAND_LIST_TYPE_COPY);
+
+    // Create temporal buffer in the upload heap
+    GpuMemAllocation src = AllocateUpload(device, sizeBytes, L"Upload temp buffer");
+    MemCpy(src, data, sizeBytes);
+
+    // Copy from upload heap to final buffer
+    copyCmdList->CopyResource(dst, src.m_resource.Get());
+
+    return src;
+}
+
+void ComputeBasics::EnqueueCopyBuffer(ID3D12Device* device,
+                                      ID3D12GraphicsCommandList* copyCmdList, 
+                                      ID3D12Resource* dst, ID3D12Resource* src)
+{
+    assert(device);
+    assert(copyCmdList);
+    assert(copyCmdList->GetType() == D3D12_COMMAND_LIST_TYPE_COPY);
+    assert(dst);
+    assert(src);
+
+    copyCmdList->CopyResource(dst, src);
+}
+
+void ComputeBasics::ExecuteCmdList(ID3D12Device* device, ID3D12CommandQueue* cmdQueue,
+                                   ID3D12GraphicsCommandList* cmdList)
+{
+    assert(device);
+    assert(cmdQueue);
+    assert(cmdList);
+ 
+    Utils::AssertIfFailed(cmdList->Close());
+    ID3D12CommandList* cmdLists[] = { cmdList };
+    cmdQueue->ExecuteCommandLists(1, cmdLists);
+
+    // Wait for the cmdlist to finish
+    CmdQueueSyncer cmdQueueSyncer(device, cmdQueue);
+    auto workId = cmdQueueSyncer.SignalWork();
+    cmdQueueSyncer.Wait(workId);
+}
+
+GpuMemAllocation ComputeBasics::EnqueueUploadDataToTexture(ID3D12Device* device,
+                                                           ID3D12GraphicsCommandList* copyCmdList,
+                                                           ID3D12Resource* dst, const SubresourceData* subresources,
+                                                           uint32_t firstSubresource, uint32_t subresourcesCount)
+{
+    assert(device);
+    assert(copyCmdList);
+    assert(dst);
+    assert(subresources && subresourcesCount);
+
+    assert(copyCmdList->GetType() == D3D12_COMMAND_LIST_TYPE_COPY);
+
+    // Let the runtime decide the placement of every subresource. It knows about the format
+    // and the alignment requirements of the device.
+    const D3D12_RESOURCE_DESC dstDesc = dst->GetDesc();
+    assert(dstDesc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER);
+
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(subresourcesCount);
+    std::vector<UINT> rowsCount(subresourcesCount);
+    std::vector<UINT64> rowSizesBytes(subresourcesCount);
+    UINT64 totalSizeBytes = 0;
+    device->GetCopyableFootprints(&dstDesc, firstSubresource, subresourcesCount, 0, &layouts[0], &rowsCount[0],
+                                  &rowSizesBytes[0], &totalSizeBytes);
+
+    std::vector<SubresourceFootprint> footprints(subresourcesCount);
+    for (uint32_t i = 0; i < subresourcesCount; ++i)
+    {
+        footprints[i] = ToSubresourceFootprint(layouts[i], rowsCount[i], rowSizesBytes[i]);
+    }
+
+    // Create temporal buffer in the upload heap and fill all the subresources with a single map
+    GpuMemAllocation src = AllocateUpload(device, totalSizeBytes, L"Upload temp texture");
+    {
+        ScopedMappedGpuMemAlloc scopedMappedAlloc(src);
+        PackSubresources(scopedMappedAlloc.GetBuffer(), &footprints[0], subresources, subresourcesCount);
+    }
+
+    // Copy from upload heap to the final texture. One copy per subresource.
+    for (uint32_t i = 0; i < subresourcesCount; ++i)
+    {
+        D3D12_TEXTURE_COPY_LOCATION dstLocation;
+        dstLocation.pResource           = dst;
+        dstLocation.Type                = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex    = firstSubresource + i;
+
+        D3D12_TEXTURE_COPY_LOCATION srcLocation;
+        srcLocation.pResource           = src.m_resource.Get();
+        srcLocation.Type                = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint     = layouts[i];
+
+        copyCmdList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+    }
+
+    return src;
+}
+
+SubresourceFootprint ComputeBasics::ToSubresourceFootprint(const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout,
+                                                           uint32_t rowsCount, uint64_t rowSizeBytes)
+{
+    SubresourceFootprint footprint;
+    footprint.m_offset          = layout.Offset;
+    footprint.m_width           = layout.Footprint.Width;
+    footprint.m_height          = layout.Footprint.Height;
+    footprint.m_depth           = layout.Footprint.Depth;
+    footprint.m_rowPitch        = layout.Footprint.RowPitch;
+    footprint.m_rowsCount       = rowsCount;
+    footprint.m_rowSizeBytes    = rowSizeBytes;
+
+    return footprint;
+}
+
+ID3D12QueryHeapComPtr ComputeBasics::CreateTimestampQueryHeap(ID3D12Device* device, uint32_t timeStampsCount)
+{
+    assert(device);
+
+    D3D12_QUERY_HEAP_DESC queryHeapDesc;
+    queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    queryHeapDesc.Count = timeStampsCount;
+    queryHeapDesc.NodeMask = 0;
+
+    ID3D12QueryHeapComPtr queryHeap;
+    Utils::AssertIfFailed(device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&queryHeap)));
+    return queryHeap;
+}
+
+void ComputeBasics::EnqueueTimestampQuery(ID3D12GraphicsCommandList* cmdList, ID3D12QueryHeap* queryHeap,  uint32_t queryIndex)
+{
+    assert(cmdList);
+    assert(queryHeap);
+    cmdList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, queryIndex);
+}
+
+void ComputeBasics::EnqueueResolveTimestampQueries(ID3D12GraphicsCommandList* cmdList, ID3D12QueryHeap* queryHeap,
+                                                   uint32_t timeStampsCount, ID3D12Resource* readbackBuffer)
+{
+    assert(cmdList);
+    assert(queryHeap);
+    assert(timeStampsCount > 0);
+    assert(readbackBuffer);
+
+    cmdList->ResolveQueryData(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0, timeStampsCount, readbackBuffer, 0);
+}
+
+std::vector<double> ComputeBasics::ReadbackTimestamps(const GpuMemAllocation& allocation, uint32_t timestampsCount, 
+                                                      uint64_t cmdQueueTimestampFrequency)
+{
+    assert(timestampsCount > 0);
+
+    ScopedMappedGpuMemAlloc memMap(allocation);
+
+    std::vector<double> timestamps(timestampsCount);
+    // Note timestamps data are ticks and cmd queue timestamp frequency is ticks/sec
+    const uint64_t* timestampsTicks = reinterpret_cast<uint64_t*>(static_cast<uint8_t*>(memMap.GetBuffer()));
+    for (uint32_t i = 0; i < timestampsCount; ++i)
+    {
+        timestamps[i] = timestampsTicks[i] / static_cast<double>(cmdQueueTimestampFrequency);
+    }
+
+    return timestamps;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "common.h"
+
+#include <vector>
+
+#include "gpumemory.h"
+#include "texturelayout.h"
+#include "resourcestatetracker.h"
+
+namespace ComputeBasics
+{
+
+struct CommandQueue
+{
+    ID3D12CommandQueueComPtr    m_cmdQueue;
+    uint64_t                    m_timestampFrequency;
+};
+
+struct CommandList
+{
+    ID3D12CommandAllocatorComPtr    m_allocator;
+    ID3D12GraphicsCommandListComPtr m_cmdList;
+};
+
+CommandQueue CreateCommandQueue(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type,
+                                bool disableTimeout, const std::wstring& name);
+CommandQueue CreateComputeCmdQueue(ID3D12Device* device);
+CommandQueue CreateCopyCmdQueue(ID3D12Device* device);
+
+// Note sticking together the cmdlist and the allocator. Not the most efficient way of doing it
+// but good enough for now
+CommandList CreateCommandList(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type, const std::wstring& name);
+CommandList CreateCopyCommandList(ID3D12Device* device, const std::wstring& name);
+CommandList CreateComputeCommandList(ID3D12Device* device, const std::wstring& name);
+
+D3D12_RESOURCE_BARRIER CreateTransition(ID3D12Resource* resource,
+                                        D3D12_RESOURCE_STATES before,
+                                        D3D12_RESOURCE_STATES after);
+
+D3D12_RESOURCE_BARRIER CreateTransition(ID3D12Resource* resource, uint32_t subresource,
+                                        D3D12_RESOURCE_STATES before,
+                                        D3D12_RESOURCE_STATES after);
+
+D3D12_RESOURCE_BARRIER CreateUAVBarrier(ID3D12Resource* resource);
+
+// Note orders the accesses to all the uavs, for work whose resources are not known
+D3D12_RESOURCE_BARRIER CreateGlobalUAVBarrier();
+
+D3D12_RESOURCE_STATES ToD3D12State(ResourceState state);
+
+// Translates a barrier of src/resourcestatetracker.h. resource is the d3d12 resource of its id, null for
+// g_allResources.
+D3D12_RESOURCE_BARRIER ToD3D12Barrier(const ResourceBarrier& barrier, ID3D12Resource* resource);
+
+// TODO not quite happy with returning the temp here. Good enough for now.
+// Note returning the tmp so the object outlives the execution in the gpu
+GpuMemAllocation EnqueueUploadDataToBuffer(ID3D12Device* device,
+                                           ID3D12GraphicsCommandList* copyCmdList,
+                                           ID3D12Resource* dst, const void* data, uint64_t sizeBytes);
+
+// Uploads subresourcesCount subresources starting at firstSubresource. subresources holds one entry
+// per subresource in d3d12 subresource order (mip + arraySlice * mipsCount).
+// Note returning the tmp so the object outlives the execution in the gpu
+GpuMemAllocation EnqueueUploadDataToTexture(ID3D12Device* device,
+                                            ID3D12GraphicsCommandList* copyCmdList,
+                                            ID3D12Resource* dst, const SubresourceData* subresources,
+                                            uint32_t firstSubresource, uint32_t subresourcesCount);
+
+void EnqueueCopyBuffer(ID3D12Device* device,
+                       ID3D12GraphicsCommandList* copyCmdList,
+                       ID3D12Resource* dst, ID3D12Resource* src);
+
+void ExecuteCmdList(ID3D12Device* device, ID3D12CommandQueue* cmdQueue,
+                    ID3D12GraphicsCommandList* cmdList);
+
+ID3D12QueryHeapComPtr CreateTimestampQueryHeap(ID3D12Device* device, uint32_t timeStampsCount);
+
+void EnqueueTimestampQuery(ID3D12GraphicsCommandList* cmdList, ID3D12QueryHeap* queryHeap, uint32_t queryIndex);
+
+void EnqueueResolveTimestampQueries(ID3D12GraphicsCommandList* cmdList, ID3D12QueryHeap* queryHeap,
+                                    uint32_t timeStampsCount, ID3D12Resource* readbackBuffer);
+
+// Returns the timestamps in seconds
+std::vector<double> ReadbackTimestamps(const GpuMemAllocation& allocation, uint32_t timestampsCount,
+                                       uint64_t cmdQueueTimestampFrequency);
+
+SubresourceFootprint ToSubresourceFootprint(const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout,
+                                            uint32_t rowsCount, uint64_t rowSizeBytes);
+
+}
@@ -0,0 +1,206 @@
+#include "colorpipeline.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "cmdlists.h"
+
+namespace
+{
+const wchar_t* g_colorPipelineShaderFileName        = L"./data/shaders/colorpipeline.hlsl";
+const char* g_colorPipelineRootSignatureName        = "ColorPipelineRootSig";
+const uint32_t g_colorPipelineGroupSize             = 8;
+const uint32_t g_colorPipelineDescriptorsPerPass    = 2;
+const D3D12_RESOURCE_STATES g_srcState              = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+
+// Root parameters as laid out in ColorPipelineRootSig
+enum ColorPipelineRootParameters
+{
+    ColorPipelineRootParameters_Constants = 0,
+    ColorPipelineRootParameters_Table
+};
+
+struct ColorPipelineConstants
+{
+    uint32_t    m_width;
+    uint32_t    m_height;
+    float       m_exposureScale;
+    uint32_t    m_padding;
+    // Rows of the 3x3 matrix padded to float4
+    float       m_colorMatrix[12];
+};
+}
+
+using namespace ComputeBasics;
+
+ColorPipeline::ColorPipeline(ID3D12Device* device, const ColorPipelineDesc& desc) : m_device(device), m_desc(desc)
+{
+    assert(m_device);
+
+    m_fusedPipelineState = CreatePermutation(m_desc.m_useExposure, m_desc.m_useColorMatrix, m_desc.m_toneCurve,
+                                             L"Color Pipeline Fused");
+    if (m_desc.m_useExposure)
+        m_stepPipelineStates[ColorPipelineStep_Exposure] = CreatePermutation(true, false, ToneCurve::None,
+                                                                             L"Color Pipeline Exposure");
+    if (m_desc.m_useColorMatrix)
+        m_stepPipelineStates[ColorPipelineStep_ColorMatrix] = CreatePermutation(false, true, ToneCurve::None,
+                                                                                L"Color Pipeline Color Matrix");
+    if (m_desc.m_toneCurve != ToneCurve::None)
+        m_stepPipelineStates[ColorPipelineStep_ToneCurve] = CreatePermutation(false, false, m_desc.m_toneCurve,
+                                                                              L"Color Pipeline Tone Curve");
+}
+
+PipelineState ColorPipeline::CreatePermutation(bool useExposure, bool useColorMatrix, ToneCurve toneCurve,
+                                               const std::wstring& name) const
+{
+    const ShaderDefines defines
+    {
+        { "COLOR_PIPELINE_EXPOSURE", useExposure ? "1" : "0" },
+        { "COLOR_PIPELINE_COLOR_MATRIX", useColorMatrix ? "1" : "0" },
+        { "COLOR_PIPELINE_TONE_CURVE", std::to_string(static_cast<uint32_t>(toneCurve)) }
+    };
+    return CreatePipelineState(m_device, g_colorPipelineShaderFileName, g_colorPipelineRootSignatureName, defines, name);
+}
+
+bool ColorPipeline::IsValid() const
+{
+    if (!m_fusedPipelineState.m_pso)
+        return false;
+
+    const bool isStepEnabled[ColorPipelineStep_Count] =
+    {
+        m_desc.m_useExposure, m_desc.m_useColorMatrix, m_desc.m_toneCurve != ToneCurve::None
+    };
+    for (uint32_t step = 0; step < ColorPipelineStep_Count; ++step)
+    {
+        if (isStepEnabled[step] && !m_stepPipelineStates[step].m_pso)
+            return false;
+    }
+
+    return true;
+}
+
+void ColorPipeline::SetConstantsAndDispatch(ID3D12GraphicsCommandList* computeCmdList,
+                                            const PipelineState& pipelineState, D3D12_GPU_DESCRIPTOR_HANDLE table,
+                                            const TextureDesc& desc) const
+{
+    const uint32_t width = static_cast<uint32_t>(desc.m_width);
+    const uint32_t height = desc.m_height;
+
+    ColorPipelineConstants constants = {};
+    constants.m_width = width;
+    constants.m_height = height;
+    constants.m_exposureScale = std::exp2(m_desc.m_exposure);
+    for (uint32_t row = 0; row < 3; ++row)
+    {
+        for (uint32_t column = 0; column < 3; ++column)
+            constants.m_colorMatrix[row * 4 + column] = m_desc.m_colorMatrix[row * 3 + column];
+    }
+
+    computeCmdList->SetComputeRootSignature(pipelineState.m_rootSignature.Get());
+    computeCmdList->SetPipelineState(pipelineState.m_pso.Get());
+    computeCmdList->SetComputeRoot32BitConstants(ColorPipelineRootParameters_Constants,
+                                                 sizeof(constants) / sizeof(uint32_t), &constants, 0);
+    computeCmdList->SetComputeRootDescriptorTable(ColorPipelineRootParameters_Table, table);
+    computeCmdList->Dispatch((width + g_colorPipelineGroupSize - 1) / g_colorPipelineGroupSize,
+                             (height + g_colorPipelineGroupSize - 1) / g_colorPipelineGroupSize, 1);
+}
+
+DescriptorHeapPtr ColorPipeline::EnqueueColorPipeline(ID3D12GraphicsCommandList* computeCmdList,
+                                                      const GpuMemAllocation& src, const GpuMemAllocation& dst,
+                                                      const TextureDesc& desc)
+{
+    assert(IsValid());
+    assert(computeCmdList);
+    assert(src.m_resource);
+    assert(dst.m_resource);
+    assert(desc.m_type == TextureType::Texture2D && desc.m_arraySize == 1);
+
+    auto descriptorHeap = std::make_unique<DescriptorHeap>(m_device, g_colorPipelineDescriptorsPerPass);
+    auto table = descriptorHeap->CreateTexture2DDescriptor(src, desc.m_format, 0, false);
+    descriptorHeap->CreateTexture2DDescriptor(dst, desc.m_format, 0, true);
+
+    ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { descriptorHeap->GetD3D12DescriptorHeap() };
+    computeCmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+
+    SetConstantsAndDispatch(computeCmdList, m_fusedPipelineState, table.m_gpuHandle, desc);
+
+    return descriptorHeap;
+}
+
+DescriptorHeapPtr ColorPipeline::EnqueueColorPipelineUnfused(ID3D12GraphicsCommandList* computeCmdList,
+                                                             const GpuMemAllocation& src,
+                                                             const GpuMemAllocation& intermediate,
+                                                             const GpuMemAllocation& dst, const TextureDesc& desc)
+{
+    assert(IsValid());
+    assert(computeCmdList);
+    assert(src.m_resource);
+    assert(intermediate.m_resource);
+    assert(dst.m_resource);
+    assert(desc.m_type == TextureType::Texture2D && desc.m_arraySize == 1);
+
+    std::vector<const PipelineState*> passes;
+    for (const auto& pipelineState : m_stepPipelineStates)
+    {
+        if (pipelineState.m_pso)
+            passes.push_back(&pipelineState);
+    }
+    // Note without steps the fused permutation copies src
+    if (passes.empty())
+        passes.push_back(&m_fusedPipelineState);
+
+    const uint32_t passesCount = static_cast<uint32_t>(passes.size());
+    auto descriptorHeap = std::make_unique<DescriptorHeap>(m_device, passesCount * g_colorPipelineDescriptorsPerPass);
+    ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { descriptorHeap->GetD3D12DescriptorHeap() };
+    computeCmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+
+    // Note the last pass writes dst and the ones before alternate with intermediate. Every texture is read as srv
+    // after being written, and goes back to uav to be written again.
+    const GpuMemAllocation* textures[] = { &intermediate, &dst };
+    D3D12_RESOURCE_STATES states[] = { D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_UNORDERED_ACCESS };
+    const GpuMemAllocation* input = &src;
+    int32_t inputIndex = -1;
+    for (uint32_t pass = 0; pass < passesCount; ++pass)
+    {
+        const uint32_t outputIndex = (passesCount - 1 - pass) % 2 == 0 ? 1 : 0;
+
+        D3D12_RESOURCE_BARRIER barriers[2];
+        uint32_t barriersCount = 0;
+        if (inputIndex >= 0 && states[inputIndex] != g_srcState)
+        {
+            barriers[barriersCount++] = CreateTransition(textures[inputIndex]->m_resource.Get(), states[inputIndex],
+                                                         g_srcState);
+            states[inputIndex] = g_srcState;
+        }
+        if (states[outputIndex] != D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+        {
+            barriers[barriersCount++] = CreateTransition(textures[outputIndex]->m_resource.Get(), states[outputIndex],
+                                                         D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+            states[outputIndex] = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        }
+        if (barriersCount > 0)
+            computeCmdList->ResourceBarrier(barriersCount, barriers);
+
+        auto table = descriptorHeap->CreateTexture2DDescriptor(*input, desc.m_format, 0, false);
+        descriptorHeap->CreateTexture2DDescriptor(*textures[outputIndex], desc.m_format, 0, true);
+        SetConstantsAndDispatch(computeCmdList, *passes[pass], table.m_gpuHandle, desc);
+
+        input = textures[outputIndex];
+        inputIndex = outputIndex;
+    }
+
+    D3D12_RESOURCE_BARRIER barriers[2];
+    uint32_t barriersCount = 0;
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        if (states[i] != D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+            barriers[barriersCount++] = CreateTransition(textures[i]->m_resource.Get(), states[i],
+                                                         D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    }
+    if (barriersCount > 0)
+        computeCmdList->ResourceBarrier(barriersCount, barriers);
+
+    return descriptorHeap;
+}
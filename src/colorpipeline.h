@@ -0,0 +1,64 @@
+#pragma once
+
+#include "common.h"
+
+#include "gpumemory.h"
+#include "descriptors.h"
+#include "pipelinestate.h"
+#include "cpucolorpipeline.h"
+
+namespace ComputeBasics
+{
+
+// Color pipeline of 2d textures on the gpu using data/shaders/colorpipeline.hlsl. The steps enabled in the desc
+// are fused in a single shader permutation, so every texel is read and written once.
+// Note dst textures have to be allocated as RW and their format has to support typed uav stores.
+class ColorPipeline
+{
+public:
+    ColorPipeline(ID3D12Device* device, const ColorPipelineDesc& desc);
+
+    bool IsValid() const;
+    const ColorPipelineDesc& GetDesc() const { return m_desc; }
+
+    // Applies the steps to mip 0 of src and writes the result to mip 0 of dst. Both textures have the size of desc.
+    // Same result than Cpu::ApplyColorPipeline.
+    // src has to be in NON_PIXEL_SHADER_RESOURCE state and dst in UNORDERED_ACCESS state.
+    // They are left as they are.
+    // Note the descriptor heaps of the cmd list are replaced.
+    // Note returning the descriptor heap so it outlives the execution in the gpu
+    DescriptorHeapPtr EnqueueColorPipeline(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& src,
+                                           const GpuMemAllocation& dst, const TextureDesc& desc);
+
+    // Same result with a pass per enabled step, as running the steps one after the other. The passes ping pong
+    // between intermediate and dst. Meant to measure what fusing them saves.
+    // src has to be in NON_PIXEL_SHADER_RESOURCE state and intermediate and dst in UNORDERED_ACCESS state.
+    // They are left as they are.
+    // Note the descriptor heaps of the cmd list are replaced.
+    // Note returning the descriptor heap so it outlives the execution in the gpu
+    DescriptorHeapPtr EnqueueColorPipelineUnfused(ID3D12GraphicsCommandList* computeCmdList,
+                                                  const GpuMemAllocation& src, const GpuMemAllocation& intermediate,
+                                                  const GpuMemAllocation& dst, const TextureDesc& desc);
+
+private:
+    enum ColorPipelineStep
+    {
+        ColorPipelineStep_Exposure = 0,
+        ColorPipelineStep_ColorMatrix,
+        ColorPipelineStep_ToneCurve,
+        ColorPipelineStep_Count
+    };
+
+    ID3D12Device*       m_device;
+    ColorPipelineDesc   m_desc;
+    PipelineState       m_fusedPipelineState;
+    // Note only the enabled steps have one
+    PipelineState       m_stepPipelineStates[ColorPipelineStep_Count];
+
+    PipelineState CreatePermutation(bool useExposure, bool useColorMatrix, ToneCurve toneCurve,
+                                    const std::wstring& name) const;
+    void SetConstantsAndDispatch(ID3D12GraphicsCommandList* computeCmdList, const PipelineState& pipelineState,
+                                 D3D12_GPU_DESCRIPTOR_HANDLE table, const TextureDesc& desc) const;
+};
+
+}
@@ -0,0 +1,82 @@
+#include "commandlistpool.h"
+
+#include "utils.h"
+#include "cmdqueuesyncer.h"
+
+using namespace ComputeBasics;
+
+CommandListPool::CommandListPool(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type, const std::wstring& name) :
+    m_device(device), m_type(type), m_name(name), m_cmdListsCount(0)
+{
+    assert(device);
+}
+
+CommandList CommandListPool::Acquire()
+{
+    CommandList cmdList;
+    uint32_t cmdListIndex = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_freeCmdLists.empty())
+        {
+            cmdListIndex = m_cmdListsCount++;
+        }
+        else
+        {
+            cmdList = m_freeCmdLists.back();
+            m_freeCmdLists.pop_back();
+        }
+    }
+
+    // Note out of the lock, creating and resetting only touch the cmd list and its allocator
+    if (!cmdList.m_cmdList)
+        return CreateCommandList(m_device, m_type, m_name + L" " + std::to_wstring(cmdListIndex));
+
+    Utils::AssertIfFailed(cmdList.m_allocator->Reset());
+    Utils::AssertIfFailed(cmdList.m_cmdList->Reset(cmdList.m_allocator.Get(), nullptr));
+    return cmdList;
+}
+
+void CommandListPool::Release(const CommandList& cmdList)
+{
+    assert(cmdList.m_allocator && cmdList.m_cmdList);
+    assert(cmdList.m_cmdList->GetType() == m_type);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_freeCmdLists.push_back(cmdList);
+}
+
+void ComputeBasics::RecordAndExecuteInParallel(ID3D12Device* device, ID3D12CommandQueue* cmdQueue,
+                                               CommandListPool& cmdListPool, const std::vector<WorkSlice>& slices,
+                                               const RecordCmdListSlice& recordSlice)
+{
+    assert(device);
+    assert(cmdQueue);
+    assert(cmdQueue->GetDesc().Type == cmdListPool.GetType());
+    assert(recordSlice);
+
+    if (slices.empty())
+        return;
+
+    std::vector<CommandList> cmdLists(slices.size());
+    RecordInParallel(slices, [&](uint32_t slice, const WorkSlice& workSlice)
+    {
+        cmdLists[slice] = cmdListPool.Acquire();
+        ID3D12GraphicsCommandList* cmdList = cmdLists[slice].m_cmdList.Get();
+        recordSlice(cmdList, workSlice);
+        Utils::AssertIfFailed(cmdList->Close());
+    });
+
+    std::vector<ID3D12CommandList*> executedCmdLists(cmdLists.size());
+    for (size_t i = 0; i < cmdLists.size(); ++i)
+        executedCmdLists[i] = cmdLists[i].m_cmdList.Get();
+    cmdQueue->ExecuteCommandLists(static_cast<UINT>(executedCmdLists.size()), &executedCmdLists[0]);
+
+    // Wait for the cmd lists to finish
+    CmdQueueSyncer cmdQueueSyncer(device, cmdQueue);
+    auto workId = cmdQueueSyncer.SignalWork();
+    cmdQueueSyncer.Wait(workId);
+
+    for (const auto& cmdList : cmdLists)
+        cmdListPool.Release(cmdList);
+}
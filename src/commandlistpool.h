@@ -0,0 +1,49 @@
+#pragma once
+
+#include "common.h"
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "cmdlists.h"
+#include "parallelrecording.h"
+
+namespace ComputeBasics
+{
+
+// Pool of cmd lists of a single type, each with an allocator of its own so threads can record at the same time.
+// Cmd lists are created on demand and given back to the pool once the gpu is done with them.
+// Note Acquire and Release are thread safe
+class CommandListPool
+{
+public:
+    CommandListPool(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type, const std::wstring& name);
+
+    D3D12_COMMAND_LIST_TYPE GetType() const { return m_type; }
+
+    // Returns a cmd list ready to record
+    CommandList Acquire();
+    // Note the gpu has to be done with cmdList. Its allocator is reset the next time the cmd list is acquired.
+    void Release(const CommandList& cmdList);
+
+private:
+    ID3D12Device*               m_device;
+    D3D12_COMMAND_LIST_TYPE     m_type;
+    std::wstring                m_name;
+
+    std::mutex                  m_mutex;
+    std::vector<CommandList>    m_freeCmdLists;
+    uint32_t                    m_cmdListsCount;
+};
+
+// Records the items of a slice in cmdList
+using RecordCmdListSlice = std::function<void(ID3D12GraphicsCommandList* cmdList, const WorkSlice& workSlice)>;
+
+// Records every slice in a thread of its own, into a cmd list of the pool, and executes them in slice order with
+// a single ExecuteCommandLists. Waits for them to finish and gives the cmd lists back to the pool.
+// Note the cmd lists dont inherit any state, every slice has to set its root signature, pso and descriptor heaps
+void RecordAndExecuteInParallel(ID3D12Device* device, ID3D12CommandQueue* cmdQueue, CommandListPool& cmdListPool,
+                                const std::vector<WorkSlice>& slices, const RecordCmdListSlice& recordSlice);
+
+}
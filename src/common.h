@@ -10,15 +10,20 @@
 #define ENABLE_D3D12_DEBUG_LAYER            ( 1 )
 #define ENABLE_D3D12_DEBUG_GPU_VALIDATION   ( 1 )
 #define ENABLE_PIX_CAPTURE                  ( 1 )
+// Note 1 compiles cs_5_1 with fxc, 0 compiles cs_6_0 with dxc, which enables the wave intrinsics permutations
 #define ENABLE_RGA_COMPATIBILITY            ( 1 )
+#define ENABLE_BENCHMARKS                   ( 0 )
 
 #if ENABLE_PIX_CAPTURE
 #include <DXProgrammableCapture.h>
 #endif
 
+const char* const g_outputTag = "[ComputeBasics]";
+
 // Note actually comptr is not a smart tr but a raii class using
 // IUnknown AddRef and Release functions
 using IDXGIAdapter1ComPtr = Microsoft::WRL::ComPtr<IDXGIAdapter1>;
+using IDXGIAdapter3ComPtr = Microsoft::WRL::ComPtr<IDXGIAdapter3>;
 using IDXGIFactory6ComPtr = Microsoft::WRL::ComPtr<IDXGIFactory6>;
 using ID3D12DeviceComPtr = Microsoft::WRL::ComPtr<ID3D12Device>;
 using ID3D12CommandQueueComPtr = Microsoft::WRL::ComPtr<ID3D12CommandQueue>;
@@ -32,4 +37,7 @@ using ID3D12RootSignatureComPtr = Microsoft::WRL::ComPtr<ID3D12RootSignature>;
 #if ENABLE_PIX_CAPTURE
 using IDXGraphicsAnalysisComPtr = Microsoft::WRL::ComPtr<IDXGraphicsAnalysis>;
 #endif
-using ID3D12QueryHeapComPtr = Microsoft::WRL::ComPtr<ID3D12QueryHeap>;
\ No newline at end of file
+using ID3D12QueryHeapComPtr = Microsoft::WRL::ComPtr<ID3D12QueryHeap>;
+using ID3D12CommandSignatureComPtr = Microsoft::WRL::ComPtr<ID3D12CommandSignature>;
+using ID3D12FenceComPtr = Microsoft::WRL::ComPtr<ID3D12Fence>;
+using ID3D12HeapComPtr = Microsoft::WRL::ComPtr<ID3D12Heap>;
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "compaction.h"
+
+#include <cstring>
+#include <string>
+
+#include "utils.h"
+#include "cmdlists.h"
+
+namespace
+{
+const wchar_t* g_compactionShaderFileName   = L"./data/shaders/compaction.hlsl";
+const char* g_compactionRootSignatureName   = "CompactionRootSig";
+const uint32_t g_compactionDescriptorsCount = 4;
+
+// Root parameters as laid out in CompactionRootSig
+enum CompactionRootParameters
+{
+    CompactionRootParameters_Constants = 0,
+    CompactionRootParameters_Table
+};
+
+struct CompactionConstants
+{
+    uint32_t m_elementsCount;
+    uint32_t m_partitionsCount;
+    uint32_t m_value;
+    uint32_t m_dispatchGroupSize;
+};
+
+DXGI_FORMAT GetCompactionFormat(ComputeBasics::CompactionDataType dataType)
+{
+    switch (dataType)
+    {
+    case ComputeBasics::CompactionDataType::UInt:
+        return DXGI_FORMAT_R32_UINT;
+    case ComputeBasics::CompactionDataType::Int:
+        return DXGI_FORMAT_R32_SINT;
+    default:
+        return DXGI_FORMAT_R32_FLOAT;
+    }
+}
+
+template<typename T>
+uint32_t ToBits(T value)
+{
+    static_assert(sizeof(T) == sizeof(uint32_t), "Compaction values are 32 bits");
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+uint32_t CalculatePartitionsCount(uint32_t elementsCount)
+{
+    return (elementsCount + ComputeBasics::Compaction::g_partitionSize - 1) / ComputeBasics::Compaction::g_partitionSize;
+}
+}
+
+using namespace ComputeBasics;
+
+const uint32_t Compaction::g_partitionSize;
+
+Compaction::Compaction(ID3D12Device* device, CompactionDataType dataType, CompactionPredicate predicate,
+                       uint32_t maxElementsCount) :
+    m_device(device), m_dataType(dataType), m_format(GetCompactionFormat(dataType)), m_maxElementsCount(maxElementsCount)
+{
+    assert(m_device);
+    assert(m_maxElementsCount > 0);
+
+#if ENABLE_RGA_COMPATIBILITY
+    m_useWaveIntrinsics = false;
+#else
+    m_useWaveIntrinsics = Utils::CheckWaveIntrinsicsSupport(m_device);
+#endif
+
+    for (uint32_t pass = 0; pass < CompactionPass_PassesCount; ++pass)
+    {
+        const ShaderDefines defines
+        {
+            { "COMPACTION_PASS", std::to_string(pass) },
+            { "COMPACTION_PREDICATE", std::to_string(static_cast<int>(predicate)) },
+            { "COMPACTION_DATA_TYPE", std::to_string(static_cast<int>(dataType)) },
+            { "COMPACTION_USE_WAVE_INTRINSICS", m_useWaveIntrinsics ? "1" : "0" }
+        };
+        m_pipelineStates[pass] = CreatePipelineState(m_device, g_compactionShaderFileName, g_compactionRootSignatureName,
+                                                     defines, L"Compaction Pass " + std::to_wstring(pass));
+    }
+
+    m_partitionsCounts = Allocate(m_device, CalculatePartitionsCount(m_maxElementsCount) * sizeof(uint32_t), true,
+                                  L"Compaction Partitions Counts");
+}
+
+bool Compaction::IsValid() const
+{
+    return m_pipelineStates[CompactionPass_Count].m_pso && m_pipelineStates[CompactionPass_ScanPartitions].m_pso &&
+           m_pipelineStates[CompactionPass_Scatter].m_pso;
+}
+
+DescriptorHeapPtr Compaction::EnqueueCompact(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& input,
+                                             uint32_t elementsCount, float value, const GpuMemAllocation& output,
+                                             const GpuMemAllocation& arguments, uint32_t dispatchGroupSize)
+{
+    assert(m_dataType == CompactionDataType::Float);
+    return EnqueueCompactPasses(computeCmdList, input, elementsCount, ToBits(value), output, arguments,
+                                dispatchGroupSize);
+}
+
+DescriptorHeapPtr Compaction::EnqueueCompact(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& input,
+                                             uint32_t elementsCount, uint32_t value, const GpuMemAllocation& output,
+                                             const GpuMemAllocation& arguments, uint32_t dispatchGroupSize)
+{
+    assert(m_dataType == CompactionDataType::UInt);
+    return EnqueueCompactPasses(computeCmdList, input, elementsCount, value, output, arguments, dispatchGroupSize);
+}
+
+DescriptorHeapPtr Compaction::EnqueueCompact(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& input,
+                                             uint32_t elementsCount, int32_t value, const GpuMemAllocation& output,
+                                             const GpuMemAllocation& arguments, uint32_t dispatchGroupSize)
+{
+    assert(m_dataType == CompactionDataType::Int);
+    return EnqueueCompactPasses(computeCmdList, input, elementsCount, ToBits(value), output, arguments,
+                                dispatchGroupSize);
+}
+
+DescriptorHeapPtr Compaction::EnqueueCompactPasses(ID3D12GraphicsCommandList* computeCmdList,
+                                                   const GpuMemAllocation& input, uint32_t elementsCount,
+                                                   uint32_t valueBits, const GpuMemAllocation& output,
+                                                   const GpuMemAllocation& arguments, uint32_t dispatchGroupSize)
+{
+    assert(IsValid());
+    assert(computeCmdList);
+    assert(input.m_resource);
+    assert(output.m_resource);
+    assert(arguments.m_resource);
+    assert(elementsCount > 0 && elementsCount <= m_maxElementsCount);
+    assert(dispatchGroupSize > 0);
+
+    const uint32_t partitionsCount = CalculatePartitionsCount(elementsCount);
+
+    auto descriptorHeap = std::make_unique<DescriptorHeap>(m_device, g_compactionDescriptorsCount);
+    auto table = descriptorHeap->CreateBufferDescriptor(input, m_format, elementsCount, false);
+    descriptorHeap->CreateBufferDescriptor(output, m_format, elementsCount, true);
+    descriptorHeap->CreateStructuredBufferDescriptor(m_partitionsCounts, partitionsCount, sizeof(uint32_t), true);
+    descriptorHeap->CreateByteBufferDescriptor(arguments, sizeof(CompactionArguments) / sizeof(uint32_t), true);
+
+    ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { descriptorHeap->GetD3D12DescriptorHeap() };
+    computeCmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+
+    const CompactionConstants constants = { elementsCount, partitionsCount, valueBits, dispatchGroupSize };
+    const uint32_t groupsCounts[CompactionPass_PassesCount] = { partitionsCount, 1, partitionsCount };
+    const auto countsBarrier = CreateUAVBarrier(m_partitionsCounts.m_resource.Get());
+    for (uint32_t pass = 0; pass < CompactionPass_PassesCount; ++pass)
+    {
+        // Note every pass depends on the counts written by the previous one
+        if (pass > 0)
+            computeCmdList->ResourceBarrier(1, &countsBarrier);
+
+        const auto& pipelineState = m_pipelineStates[pass];
+        computeCmdList->SetComputeRootSignature(pipelineState.m_rootSignature.Get());
+        computeCmdList->SetPipelineState(pipelineState.m_pso.Get());
+        computeCmdList->SetComputeRoot32BitConstants(CompactionRootParameters_Constants,
+                                                     sizeof(constants) / sizeof(uint32_t), &constants, 0);
+        computeCmdList->SetComputeRootDescriptorTable(CompactionRootParameters_Table, table.m_gpuHandle);
+        computeCmdList->Dispatch(groupsCounts[pass], 1, 1);
+    }
+    computeCmdList->ResourceBarrier(1, &countsBarrier);
+
+    return descriptorHeap;
+}
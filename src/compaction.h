@@ -0,0 +1,85 @@
+#pragma once
+
+#include "common.h"
+
+#include "gpumemory.h"
+#include "descriptors.h"
+#include "pipelinestate.h"
+#include "cpucompaction.h"
+
+namespace ComputeBasics
+{
+
+enum class CompactionDataType
+{
+    Float,
+    UInt,
+    Int
+};
+
+// Layout of the arguments buffer written by Compaction. m_dispatchArguments launches a thread per survivor
+// with a DispatchCommandSignature of sizeof(CompactionArguments) stride and m_survivorsCount lets those threads
+// know how many there are.
+struct CompactionArguments
+{
+    D3D12_DISPATCH_ARGUMENTS    m_dispatchArguments;
+    uint32_t                    m_survivorsCount;
+};
+
+// Stream compaction of typed buffers on the gpu using data/shaders/compaction.hlsl.
+// A count pass, a single group scan of the partitions counts and a scatter pass. The survivors count only
+// lives in the gpu, in the arguments buffer.
+class Compaction
+{
+public:
+    static const uint32_t g_partitionSize = 2048;
+
+    // maxElementsCount sizes the partitions counts buffer
+    Compaction(ID3D12Device* device, CompactionDataType dataType, CompactionPredicate predicate,
+               uint32_t maxElementsCount);
+
+    bool IsValid() const;
+    bool UsesWaveIntrinsics() const { return m_useWaveIntrinsics; }
+    DXGI_FORMAT GetFormat() const { return m_format; }
+
+    // Writes the first elementsCount elements of input that survive the predicate against value to output,
+    // in the same order. output has to hold elementsCount elements. arguments gets CompactionArguments with
+    // groups of dispatchGroupSize threads.
+    // input has to be in NON_PIXEL_SHADER_RESOURCE state, output and arguments in UNORDERED_ACCESS state.
+    // They are left as they are, arguments has to be transitioned to INDIRECT_ARGUMENT to be used.
+    // Note the descriptor heaps of the cmd list are replaced.
+    // Note calls share the partitions counts buffer, so they have to execute in the order they were enqueued.
+    // Note returning the descriptor heap so it outlives the execution in the gpu
+    DescriptorHeapPtr EnqueueCompact(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& input,
+                                     uint32_t elementsCount, float value, const GpuMemAllocation& output,
+                                     const GpuMemAllocation& arguments, uint32_t dispatchGroupSize);
+    DescriptorHeapPtr EnqueueCompact(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& input,
+                                     uint32_t elementsCount, uint32_t value, const GpuMemAllocation& output,
+                                     const GpuMemAllocation& arguments, uint32_t dispatchGroupSize);
+    DescriptorHeapPtr EnqueueCompact(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& input,
+                                     uint32_t elementsCount, int32_t value, const GpuMemAllocation& output,
+                                     const GpuMemAllocation& arguments, uint32_t dispatchGroupSize);
+
+private:
+    enum CompactionPass
+    {
+        CompactionPass_Count = 0,
+        CompactionPass_ScanPartitions,
+        CompactionPass_Scatter,
+        CompactionPass_PassesCount
+    };
+
+    ID3D12Device*       m_device;
+    CompactionDataType  m_dataType;
+    DXGI_FORMAT         m_format;
+    bool                m_useWaveIntrinsics;
+    uint32_t            m_maxElementsCount;
+    PipelineState       m_pipelineStates[CompactionPass_PassesCount];
+    GpuMemAllocation    m_partitionsCounts;
+
+    DescriptorHeapPtr EnqueueCompactPasses(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& input,
+                                           uint32_t elementsCount, uint32_t valueBits, const GpuMemAllocation& output,
+                                           const GpuMemAllocation& arguments, uint32_t dispatchGroupSize);
+};
+
+}
@@ -0,0 +1,515 @@
+#include "computegraph.h"
+
+#include <cassert>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <sstream>
+
+#include "transientmemory.h"
+
+using namespace ComputeBasics;
+
+namespace
+{
+const size_t g_queuesCount = 2;
+const uint32_t g_noSegment = ~0u;
+const uint32_t g_noPass = ~0u;
+
+size_t ToIndex(ComputeGraphQueue queue)
+{
+    return static_cast<size_t>(queue);
+}
+
+const char* ToString(ComputeGraphQueue queue)
+{
+    return queue == ComputeGraphQueue::Compute ? "Compute" : "Copy";
+}
+
+const char* ToString(ComputeGraphBufferState state)
+{
+    switch (state)
+    {
+    case ComputeGraphBufferState::Common:           return "Common";
+    case ComputeGraphBufferState::CopySource:       return "CopySource";
+    case ComputeGraphBufferState::CopyDest:         return "CopyDest";
+    case ComputeGraphBufferState::ShaderResource:   return "ShaderResource";
+    case ComputeGraphBufferState::UnorderedAccess:  return "UnorderedAccess";
+    }
+    assert(false);
+    return "";
+}
+
+// Splits the alive passes in segments. A pass joins the open segment of its queue unless it depends on a pass
+// of the other queue not waited for yet. Then the segment of that pass is closed, so its fence value is final,
+// and the pass starts a new segment waiting for it.
+std::vector<ComputeGraphSegment> BuildSegments(const std::vector<bool>& isAlive,
+                                               const std::vector<ComputeGraphQueue>& queues,
+                                               const std::vector<std::vector<uint32_t>>& dependencies)
+{
+    std::vector<ComputeGraphSegment> segments;
+    std::vector<uint32_t> passSegments(isAlive.size(), g_noSegment);
+    uint32_t openSegments[g_queuesCount] = { g_noSegment, g_noSegment };
+    uint64_t signaledFenceValues[g_queuesCount] = {};
+    // Note fence values of the other queue already waited for by each queue
+    uint64_t waitedFenceValues[g_queuesCount] = {};
+
+    for (uint32_t pass = 0; pass < isAlive.size(); ++pass)
+    {
+        if (!isAlive[pass])
+            continue;
+
+        const size_t queue = ToIndex(queues[pass]);
+        uint64_t waitFenceValue = 0;
+        for (uint32_t dependency : dependencies[pass])
+        {
+            const ComputeGraphSegment& segment = segments[passSegments[dependency]];
+            if (ToIndex(segment.m_queue) == queue)
+                continue;
+
+            waitFenceValue = std::max(waitFenceValue, segment.m_signalFenceValue);
+            if (openSegments[ToIndex(segment.m_queue)] == passSegments[dependency])
+                openSegments[ToIndex(segment.m_queue)] = g_noSegment;
+        }
+
+        const bool needsWait = waitFenceValue > waitedFenceValues[queue];
+        if (openSegments[queue] == g_noSegment || needsWait)
+        {
+            ComputeGraphSegment segment;
+            segment.m_queue = queues[pass];
+            segment.m_waitFenceValue = needsWait ? waitFenceValue : 0;
+            segment.m_signalFenceValue = ++signaledFenceValues[queue];
+            segments.push_back(segment);
+            openSegments[queue] = static_cast<uint32_t>(segments.size() - 1);
+            if (needsWait)
+                waitedFenceValues[queue] = waitFenceValue;
+        }
+
+        passSegments[pass] = openSegments[queue];
+        segments[openSegments[queue]].m_passes.push_back(ComputeGraphScheduledPass{ pass, {} });
+    }
+
+    return segments;
+}
+
+// Tells whether a pass finishes before another one starts, either by being before it in the same queue or
+// through the fences of the segments
+class PassesOrder
+{
+public:
+    PassesOrder(const std::vector<ComputeGraphSegment>& segments, uint32_t passesCount) :
+        m_segments(segments), m_passSegments(passesCount, g_noSegment), m_passPositions(passesCount, 0)
+    {
+        uint64_t completedFenceValues[g_queuesCount][g_queuesCount] = {};
+        for (uint32_t s = 0; s < segments.size(); ++s)
+        {
+            const ComputeGraphSegment& segment = segments[s];
+            const size_t queue = ToIndex(segment.m_queue);
+            const size_t otherQueue = 1 - queue;
+            completedFenceValues[queue][otherQueue] = std::max(completedFenceValues[queue][otherQueue],
+                                                               segment.m_waitFenceValue);
+            completedFenceValues[queue][queue] = segment.m_signalFenceValue - 1;
+            m_completedFenceValues.push_back({ completedFenceValues[queue][0], completedFenceValues[queue][1] });
+
+            for (uint32_t i = 0; i < segment.m_passes.size(); ++i)
+            {
+                m_passSegments[segment.m_passes[i].m_pass] = s;
+                m_passPositions[segment.m_passes[i].m_pass] = i;
+            }
+        }
+    }
+
+    bool HappensBefore(uint32_t first, uint32_t second) const
+    {
+        const uint32_t firstSegment = m_passSegments[first];
+        const uint32_t secondSegment = m_passSegments[second];
+        assert(firstSegment != g_noSegment && secondSegment != g_noSegment);
+
+        if (firstSegment == secondSegment)
+            return m_passPositions[first] < m_passPositions[second];
+
+        const size_t firstQueue = ToIndex(m_segments[firstSegment].m_queue);
+        return m_completedFenceValues[secondSegment][firstQueue] >= m_segments[firstSegment].m_signalFenceValue;
+    }
+
+    uint32_t GetSegment(uint32_t pass) const { return m_passSegments[pass]; }
+    uint32_t GetPosition(uint32_t pass) const { return m_passPositions[pass]; }
+
+private:
+    const std::vector<ComputeGraphSegment>&             m_segments;
+    std::vector<uint32_t>                               m_passSegments;
+    std::vector<uint32_t>                               m_passPositions;
+    // Note fence values of every queue known to be completed when each segment starts
+    std::vector<std::array<uint64_t, g_queuesCount>>    m_completedFenceValues;
+};
+
+// Note the states a copy cmd list can transition in between
+bool IsCopyQueueState(ComputeGraphBufferState state)
+{
+    return state == ComputeGraphBufferState::Common || state == ComputeGraphBufferState::CopySource ||
+           state == ComputeGraphBufferState::CopyDest;
+}
+
+void AppendBarriers(const std::vector<ResourceBarrier>& barriers, bool isCopySegment,
+                    std::vector<ComputeGraphBarrier>& graphBarriers)
+{
+    for (const auto& barrier : barriers)
+    {
+        assert(!isCopySegment || (IsCopyQueueState(barrier.m_before) && IsCopyQueueState(barrier.m_after)));
+        (void)isCopySegment;
+
+        const ComputeGraphBarrierType type = barrier.m_type == ResourceBarrierType::Transition ?
+                                             ComputeGraphBarrierType::Transition : ComputeGraphBarrierType::UAV;
+        graphBarriers.push_back(ComputeGraphBarrier{ type, barrier.m_resource, barrier.m_before, barrier.m_after });
+    }
+}
+
+ComputeGraphBufferState CalculateRequiredState(ComputeGraphPassType type, bool isWrite)
+{
+    if (type == ComputeGraphPassType::Copy)
+        return isWrite ? ComputeGraphBufferState::CopyDest : ComputeGraphBufferState::CopySource;
+    return isWrite ? ComputeGraphBufferState::UnorderedAccess : ComputeGraphBufferState::ShaderResource;
+}
+}
+
+uint32_t ComputeGraph::CreateTransientBuffer(const std::string& name, uint64_t sizeBytes)
+{
+    assert(sizeBytes > 0);
+
+    m_buffers.push_back(Buffer{ name, sizeBytes, true, ComputeGraphBufferState::Common });
+    return static_cast<uint32_t>(m_buffers.size() - 1);
+}
+
+uint32_t ComputeGraph::ImportBuffer(const std::string& name, uint64_t sizeBytes, ComputeGraphBufferState initialState)
+{
+    m_buffers.push_back(Buffer{ name, sizeBytes, false, initialState });
+    return static_cast<uint32_t>(m_buffers.size() - 1);
+}
+
+uint32_t ComputeGraph::AddPass(const std::string& name, ComputeGraphPassType type)
+{
+    m_passes.push_back(Pass{ name, type, {} });
+    return static_cast<uint32_t>(m_passes.size() - 1);
+}
+
+void ComputeGraph::ReadBuffer(uint32_t pass, uint32_t buffer)
+{
+    AddAccess(pass, buffer, true, false);
+}
+
+void ComputeGraph::WriteBuffer(uint32_t pass, uint32_t buffer)
+{
+    AddAccess(pass, buffer, false, true);
+}
+
+ComputeGraphSchedule ComputeGraph::Compile() const
+{
+    const std::vector<bool> isAlive = FindAlivePasses();
+    const std::vector<std::vector<uint32_t>> dependencies = FindDependencies(isAlive);
+    const std::vector<ComputeGraphQueue> queues = AssignQueues(isAlive, dependencies);
+
+    ComputeGraphSchedule schedule;
+    schedule.m_segments = BuildSegments(isAlive, queues, dependencies);
+    for (uint32_t pass = 0; pass < m_passes.size(); ++pass)
+    {
+        if (!isAlive[pass])
+            schedule.m_culledPasses.push_back(pass);
+    }
+
+    // Note the aliasing barriers go first, the buffer has to own the memory before transitioning
+    PlaceTransientBuffers(schedule);
+    DeriveBarriers(schedule);
+
+    return schedule;
+}
+
+std::string ComputeGraph::ToString(const ComputeGraphSchedule& schedule) const
+{
+    std::ostringstream stream;
+    for (uint32_t s = 0; s < schedule.m_segments.size(); ++s)
+    {
+        const ComputeGraphSegment& segment = schedule.m_segments[s];
+        stream << "Segment " << s << " " << ::ToString(segment.m_queue) << " queue";
+        if (segment.m_waitFenceValue > 0)
+            stream << ", waits " << segment.m_waitFenceValue;
+        stream << ", signals " << segment.m_signalFenceValue << "\n";
+
+        for (const auto& scheduledPass : segment.m_passes)
+        {
+            for (const auto& barrier : scheduledPass.m_barriers)
+            {
+                const std::string& bufferName = m_buffers[barrier.m_buffer].m_name;
+                if (barrier.m_type == ComputeGraphBarrierType::Transition)
+                {
+                    stream << "  Transition " << bufferName << " " << ::ToString(barrier.m_before) << " -> "
+                           << ::ToString(barrier.m_after) << "\n";
+                }
+                else if (barrier.m_type == ComputeGraphBarrierType::UAV)
+                {
+                    stream << "  UAV barrier " << bufferName << "\n";
+                }
+                else
+                {
+                    stream << "  Aliasing barrier " << bufferName << "\n";
+                }
+            }
+            stream << "  Pass " << m_passes[scheduledPass.m_pass].m_name << "\n";
+        }
+    }
+
+    for (uint32_t pass : schedule.m_culledPasses)
+        stream << "Culled pass " << m_passes[pass].m_name << "\n";
+
+    for (uint32_t buffer = 0; buffer < m_buffers.size(); ++buffer)
+    {
+        if (schedule.m_transientOffsets[buffer] != g_computeGraphNoOffset)
+        {
+            stream << "Transient buffer " << m_buffers[buffer].m_name << " at " << schedule.m_transientOffsets[buffer]
+                   << ", " << m_buffers[buffer].m_sizeBytes << " bytes\n";
+        }
+    }
+    // Note the peak memory saved by aliasing
+    stream << "Transient memory " << schedule.m_transientMemorySize << " bytes, "
+           << schedule.m_transientUnaliasedMemorySize << " bytes without aliasing, "
+           << schedule.m_transientUnaliasedMemorySize - schedule.m_transientMemorySize << " bytes saved\n";
+
+    return stream.str();
+}
+
+void ComputeGraph::AddAccess(uint32_t pass, uint32_t buffer, bool isRead, bool isWrite)
+{
+    assert(pass < m_passes.size());
+    assert(buffer < m_buffers.size());
+
+    // Note a buffer read and written by the same pass is a single access
+    for (auto& access : m_passes[pass].m_accesses)
+    {
+        if (access.m_buffer == buffer)
+        {
+            access.m_isRead |= isRead;
+            access.m_isWrite |= isWrite;
+            assert(m_passes[pass].m_type != ComputeGraphPassType::Copy || !(access.m_isRead && access.m_isWrite));
+            return;
+        }
+    }
+    m_passes[pass].m_accesses.push_back(Access{ buffer, isRead, isWrite });
+}
+
+// From the last pass to the first one, a pass is alive when it writes an imported buffer or a transient buffer
+// read by an alive pass after it
+std::vector<bool> ComputeGraph::FindAlivePasses() const
+{
+    std::vector<bool> isAlive(m_passes.size(), false);
+    std::vector<bool> isBufferNeeded(m_buffers.size(), false);
+
+    for (size_t pass = m_passes.size(); pass-- > 0;)
+    {
+        for (const auto& access : m_passes[pass].m_accesses)
+        {
+            if (access.m_isWrite && (!m_buffers[access.m_buffer].m_isTransient || isBufferNeeded[access.m_buffer]))
+                isAlive[pass] = true;
+        }
+
+        if (!isAlive[pass])
+            continue;
+
+        for (const auto& access : m_passes[pass].m_accesses)
+        {
+            if (access.m_isRead)
+                isBufferNeeded[access.m_buffer] = true;
+        }
+    }
+
+    return isAlive;
+}
+
+// Passes every alive pass has to wait for: the last writer of every buffer it accesses, and the readers since then
+// of the buffers it writes
+std::vector<std::vector<uint32_t>> ComputeGraph::FindDependencies(const std::vector<bool>& isAlive) const
+{
+    std::vector<std::vector<uint32_t>> dependencies(m_passes.size());
+    std::vector<uint32_t> lastWriters(m_buffers.size(), g_noPass);
+    std::vector<std::vector<uint32_t>> readersSinceWrite(m_buffers.size());
+
+    for (uint32_t pass = 0; pass < m_passes.size(); ++pass)
+    {
+        if (!isAlive[pass])
+            continue;
+
+        for (const auto& access : m_passes[pass].m_accesses)
+        {
+            if (lastWriters[access.m_buffer] != g_noPass)
+                dependencies[pass].push_back(lastWriters[access.m_buffer]);
+            if (access.m_isWrite)
+            {
+                const auto& readers = readersSinceWrite[access.m_buffer];
+                std::copy_if(readers.begin(), readers.end(), std::back_inserter(dependencies[pass]),
+                             [pass](uint32_t reader) { return reader != pass; });
+            }
+        }
+
+        for (const auto& access : m_passes[pass].m_accesses)
+        {
+            if (access.m_isWrite)
+            {
+                lastWriters[access.m_buffer] = pass;
+                readersSinceWrite[access.m_buffer].clear();
+            }
+            else
+            {
+                readersSinceWrite[access.m_buffer].push_back(pass);
+            }
+        }
+    }
+
+    return dependencies;
+}
+
+// Note a copy in between dispatches stays in the compute queue, the two fences would cost more than the copy itself.
+// A copy of an imported buffer starting in a state the copy queue doesnt take stays there too.
+std::vector<ComputeGraphQueue> ComputeGraph::AssignQueues(const std::vector<bool>& isAlive,
+                                                          const std::vector<std::vector<uint32_t>>& dependencies) const
+{
+    std::vector<bool> hasDispatchProducer(m_passes.size(), false);
+    std::vector<bool> hasDispatchConsumer(m_passes.size(), false);
+    for (uint32_t pass = 0; pass < m_passes.size(); ++pass)
+    {
+        if (!isAlive[pass])
+            continue;
+
+        for (uint32_t dependency : dependencies[pass])
+        {
+            if (m_passes[dependency].m_type == ComputeGraphPassType::Dispatch)
+                hasDispatchProducer[pass] = true;
+            if (m_passes[pass].m_type == ComputeGraphPassType::Dispatch)
+                hasDispatchConsumer[dependency] = true;
+        }
+    }
+
+    std::vector<ComputeGraphQueue> queues(m_passes.size(), ComputeGraphQueue::Compute);
+    for (uint32_t pass = 0; pass < m_passes.size(); ++pass)
+    {
+        const auto& accesses = m_passes[pass].m_accesses;
+        const bool needsComputeTransition = std::any_of(accesses.begin(), accesses.end(), [this](const Access& access)
+        {
+            return !IsCopyQueueState(m_buffers[access.m_buffer].m_initialState);
+        });
+        if (m_passes[pass].m_type == ComputeGraphPassType::Copy &&
+            !(hasDispatchProducer[pass] && hasDispatchConsumer[pass]) && !needsComputeTransition)
+            queues[pass] = ComputeGraphQueue::Copy;
+    }
+
+    return queues;
+}
+
+// Every segment is a cmd list of its own, tracked by a ResourceStateTracker. Buffers decay to common after every
+// segment, so their first use in a segment is an implicit promotion, but for imported buffers still in their initial
+// state. Later uses need a transition when the state changes, or a uav barrier in between passes accessing them as uav.
+void ComputeGraph::DeriveBarriers(ComputeGraphSchedule& schedule) const
+{
+    ResourceStates resourceStates;
+    for (uint32_t buffer = 0; buffer < m_buffers.size(); ++buffer)
+        resourceStates.Register(buffer, m_buffers[buffer].m_initialState, 1, true);
+
+    ResourceStateTracker tracker(resourceStates);
+    std::vector<ResourceBarrier> barriers;
+    for (auto& segment : schedule.m_segments)
+    {
+        const bool isCopySegment = segment.m_queue == ComputeGraphQueue::Copy;
+        for (auto& scheduledPass : segment.m_passes)
+        {
+            const Pass& pass = m_passes[scheduledPass.m_pass];
+            for (const auto& access : pass.m_accesses)
+            {
+                const ComputeGraphBufferState state = CalculateRequiredState(pass.m_type, access.m_isWrite);
+                ComputeGraphBufferState currentState;
+                if (state == ComputeGraphBufferState::UnorderedAccess &&
+                    tracker.FindState(access.m_buffer, g_allSubresources, currentState) && currentState == state)
+                    tracker.UAVBarrier(access.m_buffer);
+                tracker.Transition(access.m_buffer, state);
+            }
+
+            barriers.clear();
+            tracker.FlushBarriers(barriers);
+            AppendBarriers(barriers, isCopySegment, scheduledPass.m_barriers);
+        }
+
+        // Note the transitions out of the initial states go before the first pass of the segment, the buffers
+        // are not used before in it
+        barriers.clear();
+        tracker.ResolvePendingBarriers(isCopySegment, barriers);
+        tracker.Reset();
+
+        std::vector<ComputeGraphBarrier> pendingBarriers;
+        AppendBarriers(barriers, isCopySegment, pendingBarriers);
+        std::vector<ComputeGraphBarrier>& firstBarriers = segment.m_passes.front().m_barriers;
+        firstBarriers.insert(firstBarriers.begin(), pendingBarriers.begin(), pendingBarriers.end());
+    }
+}
+
+// Two transient buffers can share memory when all the passes using one of them happen before the first use of the
+// other one. The buffer used later gets an aliasing barrier when it overlaps the memory of a buffer used before.
+void ComputeGraph::PlaceTransientBuffers(ComputeGraphSchedule& schedule) const
+{
+    const PassesOrder order(schedule.m_segments, static_cast<uint32_t>(m_passes.size()));
+
+    std::vector<std::vector<uint32_t>> bufferPasses(m_buffers.size());
+    for (uint32_t pass = 0; pass < m_passes.size(); ++pass)
+    {
+        if (order.GetSegment(pass) == g_noSegment)
+            continue;
+        for (const auto& access : m_passes[pass].m_accesses)
+            bufferPasses[access.m_buffer].push_back(pass);
+    }
+
+    // Note only the transient buffers used by the alive passes take memory
+    std::vector<uint32_t> placedBuffers;
+    std::vector<uint64_t> sizesBytes;
+    for (uint32_t buffer = 0; buffer < m_buffers.size(); ++buffer)
+    {
+        if (m_buffers[buffer].m_isTransient && !bufferPasses[buffer].empty())
+        {
+            placedBuffers.push_back(buffer);
+            sizesBytes.push_back(m_buffers[buffer].m_sizeBytes);
+        }
+    }
+
+    const auto isDeadBefore = [&](uint32_t buffer, uint32_t otherBuffer)
+    {
+        const uint32_t firstPass = bufferPasses[otherBuffer].front();
+        const auto& passes = bufferPasses[buffer];
+        return std::all_of(passes.begin(), passes.end(), [&](uint32_t pass)
+        {
+            return order.HappensBefore(pass, firstPass);
+        });
+    };
+    const TransientMemoryLayout layout = PackTransientBuffers(sizesBytes, [&](uint32_t a, uint32_t b)
+    {
+        return !isDeadBefore(placedBuffers[a], placedBuffers[b]) && !isDeadBefore(placedBuffers[b], placedBuffers[a]);
+    }, g_computeGraphTransientAlignment);
+
+    schedule.m_transientOffsets.assign(m_buffers.size(), g_computeGraphNoOffset);
+    schedule.m_transientMemorySize = layout.m_sizeBytes;
+    schedule.m_transientUnaliasedMemorySize = layout.m_unaliasedSizeBytes;
+    for (uint32_t i = 0; i < placedBuffers.size(); ++i)
+    {
+        const uint32_t buffer = placedBuffers[i];
+        schedule.m_transientOffsets[buffer] = layout.m_offsets[i];
+
+        bool isAliased = false;
+        for (uint32_t j = 0; j < placedBuffers.size() && !isAliased; ++j)
+        {
+            isAliased = j != i && isDeadBefore(placedBuffers[j], buffer) &&
+                        AreTransientBuffersOverlapping(layout, sizesBytes, i, j, g_computeGraphTransientAlignment);
+        }
+        if (isAliased)
+        {
+            const uint32_t firstPass = bufferPasses[buffer].front();
+            ComputeGraphScheduledPass& scheduledPass =
+                schedule.m_segments[order.GetSegment(firstPass)].m_passes[order.GetPosition(firstPass)];
+            scheduledPass.m_barriers.push_back(ComputeGraphBarrier{
+                ComputeGraphBarrierType::Aliasing, buffer, ComputeGraphBufferState::Common,
+                ComputeGraphBufferState::Common });
+        }
+    }
+}
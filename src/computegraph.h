@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "resourcestatetracker.h"
+
+// Declarative graph of copies and dispatches. Passes declare the buffers they read and write, and compiling
+// the graph derives a schedule: the passes not contributing to any imported buffer are culled, copies go to the
+// copy queue unless they sit in between dispatches, the passes are split in segments per queue synchronized with
+// fences, the barriers in between passes are derived and the transient buffers not alive at the same time share
+// memory. It doesnt depend on d3d12 so it can be compiled and inspected on any platform.
+// Note every segment is executed on its own, so buffers decay to common in between segments and are implicitly
+// promoted on their first use in a segment.
+namespace ComputeBasics
+{
+
+enum class ComputeGraphPassType
+{
+    Copy,
+    Dispatch
+};
+
+enum class ComputeGraphQueue
+{
+    Compute,
+    Copy
+};
+
+// Note the barriers in between passes are derived by the trackers of src/resourcestatetracker.h, a segment per cmd
+// list, so the states are the ones of the trackers
+using ComputeGraphBufferState = ResourceState;
+
+enum class ComputeGraphBarrierType
+{
+    Transition,
+    UAV,
+    // Note the buffer starts using memory used by other transient buffers before
+    Aliasing
+};
+
+struct ComputeGraphBarrier
+{
+    ComputeGraphBarrierType m_type;
+    uint32_t                m_buffer;
+    ComputeGraphBufferState m_before;
+    ComputeGraphBufferState m_after;
+};
+
+struct ComputeGraphScheduledPass
+{
+    uint32_t                            m_pass;
+    // Note issued right before the pass
+    std::vector<ComputeGraphBarrier>    m_barriers;
+};
+
+// Passes executed one after the other in a queue. The segment waits for m_waitFenceValue in the fence of the other
+// queue before starting, 0 meaning no wait, and signals m_signalFenceValue in the fence of its queue once done.
+struct ComputeGraphSegment
+{
+    ComputeGraphQueue                       m_queue;
+    uint64_t                                m_waitFenceValue;
+    uint64_t                                m_signalFenceValue;
+    std::vector<ComputeGraphScheduledPass>  m_passes;
+};
+
+// Note placed resources of buffers have to be aligned to 64KB in d3d12
+const uint64_t g_computeGraphTransientAlignment = 64 * 1024;
+const uint64_t g_computeGraphNoOffset = ~0ull;
+
+struct ComputeGraphSchedule
+{
+    // In submission order
+    std::vector<ComputeGraphSegment>    m_segments;
+    std::vector<uint32_t>               m_culledPasses;
+    // Offsets of the transient buffers in the transient memory, indexed by buffer. g_computeGraphNoOffset for imported
+    // buffers and unused transient ones.
+    std::vector<uint64_t>               m_transientOffsets;
+    uint64_t                            m_transientMemorySize;
+    // Note the memory the transient buffers would need without aliasing
+    uint64_t                            m_transientUnaliasedMemorySize;
+};
+
+class ComputeGraph
+{
+public:
+    // Note transient buffers only live inside the graph. Imported buffers live outside, so the passes writing them are
+    // never culled. initialState is the state of the imported buffer when the graph starts.
+    // Note the copy queue only takes common and the copy states, so copies of imported buffers starting in other
+    // states stay in the compute queue, which can transition them out of it
+    uint32_t CreateTransientBuffer(const std::string& name, uint64_t sizeBytes);
+    uint32_t ImportBuffer(const std::string& name, uint64_t sizeBytes,
+                          ComputeGraphBufferState initialState = ComputeGraphBufferState::Common);
+
+    // Note passes have to be added in execution order, reading buffers written by previous passes
+    uint32_t AddPass(const std::string& name, ComputeGraphPassType type);
+    void ReadBuffer(uint32_t pass, uint32_t buffer);
+    void WriteBuffer(uint32_t pass, uint32_t buffer);
+
+    ComputeGraphSchedule Compile() const;
+
+    std::string ToString(const ComputeGraphSchedule& schedule) const;
+
+    uint32_t GetPassesCount() const { return static_cast<uint32_t>(m_passes.size()); }
+    uint32_t GetBuffersCount() const { return static_cast<uint32_t>(m_buffers.size()); }
+    const std::string& GetPassName(uint32_t pass) const { return m_passes[pass].m_name; }
+    const std::string& GetBufferName(uint32_t buffer) const { return m_buffers[buffer].m_name; }
+    uint64_t GetBufferSize(uint32_t buffer) const { return m_buffers[buffer].m_sizeBytes; }
+    bool IsTransientBuffer(uint32_t buffer) const { return m_buffers[buffer].m_isTransient; }
+
+private:
+    struct Buffer
+    {
+        std::string             m_name;
+        uint64_t                m_sizeBytes;
+        bool                    m_isTransient;
+        ComputeGraphBufferState m_initialState;
+    };
+
+    struct Access
+    {
+        uint32_t    m_buffer;
+        bool        m_isRead;
+        bool        m_isWrite;
+    };
+
+    struct Pass
+    {
+        std::string             m_name;
+        ComputeGraphPassType    m_type;
+        std::vector<Access>     m_accesses;
+    };
+
+    std::vector<Buffer> m_buffers;
+    std::vector<Pass>   m_passes;
+
+    void AddAccess(uint32_t pass, uint32_t buffer, bool isRead, bool isWrite);
+
+    // Compile stages
+    std::vector<bool> FindAlivePasses() const;
+    std::vector<std::vector<uint32_t>> FindDependencies(const std::vector<bool>& isAlive) const;
+    std::vector<ComputeGraphQueue> AssignQueues(const std::vector<bool>& isAlive,
+                                                const std::vector<std::vector<uint32_t>>& dependencies) const;
+    void DeriveBarriers(ComputeGraphSchedule& schedule) const;
+    void PlaceTransientBuffers(ComputeGraphSchedule& schedule) const;
+};
+
+}
@@ -0,0 +1,156 @@
+#include "computegraphexecutor.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "utils.h"
+#include "cmdlists.h"
+
+using namespace ComputeBasics;
+
+namespace
+{
+D3D12_RESOURCE_BARRIER ToD3D12GraphBarrier(const ComputeGraphBarrier& barrier, ID3D12Resource* resource)
+{
+    if (barrier.m_type == ComputeGraphBarrierType::Transition)
+        return CreateTransition(resource, ToD3D12State(barrier.m_before), ToD3D12State(barrier.m_after));
+    if (barrier.m_type == ComputeGraphBarrierType::UAV)
+        return CreateUAVBarrier(resource);
+
+    D3D12_RESOURCE_BARRIER aliasing = {};
+    aliasing.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+    aliasing.Aliasing.pResourceBefore = nullptr;
+    aliasing.Aliasing.pResourceAfter = resource;
+    return aliasing;
+}
+
+D3D12_COMMAND_LIST_TYPE ToCmdListType(ComputeGraphQueue queue)
+{
+    return queue == ComputeGraphQueue::Compute ? D3D12_COMMAND_LIST_TYPE_COMPUTE : D3D12_COMMAND_LIST_TYPE_COPY;
+}
+}
+
+ComputeGraphExecutor::ComputeGraphExecutor(ID3D12Device* device, ID3D12CommandQueue* computeCmdQueue,
+                                           ID3D12CommandQueue* copyCmdQueue) :
+    m_device(device), m_cmdQueues{ computeCmdQueue, copyCmdQueue }, m_fenceValues{}, m_transientHeapSize(0)
+{
+    assert(device);
+    assert(computeCmdQueue && copyCmdQueue);
+
+    for (auto& fence : m_fences)
+    {
+        Utils::AssertIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence)));
+        assert(fence);
+    }
+}
+
+void ComputeGraphExecutor::Execute(const ComputeGraph& graph, const ComputeGraphSchedule& schedule,
+                                   const std::vector<ID3D12Resource*>& importedBuffers,
+                                   const std::vector<RecordComputeGraphPass>& recordPasses)
+{
+    assert(importedBuffers.size() == graph.GetBuffersCount());
+    assert(recordPasses.size() == graph.GetPassesCount());
+
+    // Note the placed resources have to outlive the execution in the gpu
+    const std::vector<ID3D12ResourceComPtr> transientBuffers = CreateTransientBuffers(graph, schedule);
+    std::vector<ID3D12Resource*> buffers(graph.GetBuffersCount());
+    for (uint32_t buffer = 0; buffer < buffers.size(); ++buffer)
+    {
+        buffers[buffer] = graph.IsTransientBuffer(buffer) ? transientBuffers[buffer].Get() : importedBuffers[buffer];
+        assert(buffers[buffer] || (graph.IsTransientBuffer(buffer) &&
+                                   schedule.m_transientOffsets[buffer] == g_computeGraphNoOffset));
+    }
+
+    uint64_t baseFenceValues[g_queuesCount];
+    std::copy(std::begin(m_fenceValues), std::end(m_fenceValues), baseFenceValues);
+
+    std::vector<CommandList> cmdLists;
+    cmdLists.reserve(schedule.m_segments.size());
+    for (uint32_t s = 0; s < schedule.m_segments.size(); ++s)
+    {
+        const ComputeGraphSegment& segment = schedule.m_segments[s];
+        const size_t queue = static_cast<size_t>(segment.m_queue);
+        const size_t otherQueue = 1 - queue;
+
+        cmdLists.push_back(CreateCommandList(m_device, ToCmdListType(segment.m_queue),
+                                             L"Compute Graph Segment " + std::to_wstring(s)));
+        ID3D12GraphicsCommandList* cmdList = cmdLists.back().m_cmdList.Get();
+
+        for (const auto& scheduledPass : segment.m_passes)
+        {
+            // Note batching up the barriers of the pass in a single call
+            if (!scheduledPass.m_barriers.empty())
+            {
+                std::vector<D3D12_RESOURCE_BARRIER> barriers;
+                barriers.reserve(scheduledPass.m_barriers.size());
+                for (const auto& barrier : scheduledPass.m_barriers)
+                    barriers.push_back(ToD3D12GraphBarrier(barrier, buffers[barrier.m_buffer]));
+                cmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), &barriers[0]);
+            }
+
+            assert(recordPasses[scheduledPass.m_pass]);
+            recordPasses[scheduledPass.m_pass](cmdList, buffers);
+        }
+        Utils::AssertIfFailed(cmdList->Close());
+
+        if (segment.m_waitFenceValue > 0)
+        {
+            Utils::AssertIfFailed(m_cmdQueues[queue]->Wait(m_fences[otherQueue].Get(),
+                                                           baseFenceValues[otherQueue] + segment.m_waitFenceValue));
+        }
+        ID3D12CommandList* executedCmdLists[] = { cmdList };
+        m_cmdQueues[queue]->ExecuteCommandLists(1, executedCmdLists);
+        m_fenceValues[queue] = baseFenceValues[queue] + segment.m_signalFenceValue;
+        Utils::AssertIfFailed(m_cmdQueues[queue]->Signal(m_fences[queue].Get(), m_fenceValues[queue]));
+    }
+
+    // Wait for both queues to finish. Note a null event blocks until the fence reaches the value.
+    for (size_t queue = 0; queue < g_queuesCount; ++queue)
+        Utils::AssertIfFailed(m_fences[queue]->SetEventOnCompletion(m_fenceValues[queue], nullptr));
+}
+
+std::vector<ID3D12ResourceComPtr> ComputeGraphExecutor::CreateTransientBuffers(const ComputeGraph& graph,
+                                                                               const ComputeGraphSchedule& schedule)
+{
+    if (schedule.m_transientMemorySize > m_transientHeapSize)
+    {
+        D3D12_HEAP_DESC heapDesc = {};
+        heapDesc.SizeInBytes = schedule.m_transientMemorySize;
+        heapDesc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+        heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+
+        m_transientHeap.Reset();
+        Utils::AssertIfFailed(m_device->CreateHeap(&heapDesc, IID_PPV_ARGS(&m_transientHeap)));
+        assert(m_transientHeap);
+        m_transientHeap->SetName(L"Compute Graph Transient Heap");
+        m_transientHeapSize = schedule.m_transientMemorySize;
+    }
+
+    std::vector<ID3D12ResourceComPtr> transientBuffers(graph.GetBuffersCount());
+    for (uint32_t buffer = 0; buffer < graph.GetBuffersCount(); ++buffer)
+    {
+        if (schedule.m_transientOffsets[buffer] == g_computeGraphNoOffset)
+            continue;
+
+        D3D12_RESOURCE_DESC resourceDesc = {};
+        resourceDesc.Dimension          = D3D12_RESOURCE_DIMENSION_BUFFER;
+        resourceDesc.Width              = Utils::AlignToPowerof2(graph.GetBufferSize(buffer),
+                                                                 D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+        resourceDesc.Height             = 1;
+        resourceDesc.DepthOrArraySize   = 1;
+        resourceDesc.MipLevels          = 1;
+        resourceDesc.Format             = DXGI_FORMAT_UNKNOWN;
+        resourceDesc.SampleDesc.Count   = 1;
+        resourceDesc.Layout             = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        resourceDesc.Flags              = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+        Utils::AssertIfFailed(m_device->CreatePlacedResource(m_transientHeap.Get(), schedule.m_transientOffsets[buffer],
+                                                             &resourceDesc, D3D12_RESOURCE_STATE_COMMON, nullptr,
+                                                             IID_PPV_ARGS(&transientBuffers[buffer])));
+        assert(transientBuffers[buffer]);
+        transientBuffers[buffer]->SetName(Utils::ConvertFromUTF8ToUTF16(graph.GetBufferName(buffer)).c_str());
+    }
+
+    return transientBuffers;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "common.h"
+
+#include <functional>
+#include <vector>
+
+#include "computegraph.h"
+
+namespace ComputeBasics
+{
+
+// Records the commands of a pass. buffers holds the resources of the graph indexed by buffer.
+// Note the barriers of the schedule are already recorded, the pass only records its own copies or dispatches
+using RecordComputeGraphPass = std::function<void(ID3D12GraphicsCommandList* cmdList,
+                                                  const std::vector<ID3D12Resource*>& buffers)>;
+
+// Executes compiled compute graphs in a compute and a copy queue. Every segment is a cmd list of its own, submitted
+// in order, and the queues wait on each other through a fence per queue.
+// Transient buffers are placed resources in a heap owned by the executor, grown when a graph needs more memory.
+class ComputeGraphExecutor
+{
+public:
+    ComputeGraphExecutor(ID3D12Device* device, ID3D12CommandQueue* computeCmdQueue, ID3D12CommandQueue* copyCmdQueue);
+
+    // importedBuffers holds the resources of the imported buffers indexed by buffer, null for the transient ones.
+    // recordPasses holds a function per pass of the graph, the culled ones are not called.
+    // Note it waits for the graph to finish in the gpu
+    void Execute(const ComputeGraph& graph, const ComputeGraphSchedule& schedule,
+                 const std::vector<ID3D12Resource*>& importedBuffers,
+                 const std::vector<RecordComputeGraphPass>& recordPasses);
+
+private:
+    static const size_t g_queuesCount = 2;
+
+    ID3D12Device*       m_device;
+    ID3D12CommandQueue* m_cmdQueues[g_queuesCount];
+    ID3D12FenceComPtr   m_fences[g_queuesCount];
+    // Note the fence values of a schedule start at 1, they are offset by the last value signaled in every fence
+    uint64_t            m_fenceValues[g_queuesCount];
+
+    ID3D12HeapComPtr    m_transientHeap;
+    uint64_t            m_transientHeapSize;
+
+    std::vector<ID3D12ResourceComPtr> CreateTransientBuffers(const ComputeGraph& graph,
+                                                             const ComputeGraphSchedule& schedule);
+};
+
+}
@@ -0,0 +1,68 @@
+#include "constantring.h"
+
+#include <cstring>
+
+#include "utils.h"
+
+using namespace ComputeBasics;
+
+ConstantRing::ConstantRing(ID3D12Device* device, uint64_t frameSizeBytes, uint32_t framesCount,
+                           const std::wstring& name) :
+    m_frameSizeBytes(Utils::AlignToPowerof2(frameSizeBytes, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT)),
+    m_fenceValue(0), m_frameFenceValues(framesCount, 0), m_frame(0), m_frameOffset(0)
+{
+    assert(device);
+    assert(frameSizeBytes > 0);
+    assert(framesCount > 0);
+
+    m_buffer = AllocateUpload(device, m_frameSizeBytes * framesCount, name);
+    // Note upload memory can stay mapped while the gpu reads it
+    m_cpuAddress = static_cast<uint8_t*>(MemMap(m_buffer));
+    m_gpuAddress = m_buffer.m_resource->GetGPUVirtualAddress();
+
+    Utils::AssertIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+    assert(m_fence);
+}
+
+ConstantRing::~ConstantRing()
+{
+    MemUnmap(m_buffer);
+}
+
+ConstantAllocation ConstantRing::Allocate(uint64_t sizeBytes)
+{
+    assert(sizeBytes > 0);
+
+    const uint64_t blockSizeBytes = Utils::AlignToPowerof2(sizeBytes, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+    if (m_frameOffset + blockSizeBytes > m_frameSizeBytes)
+        return { nullptr, 0 };
+
+    const uint64_t offset = m_frame * m_frameSizeBytes + m_frameOffset;
+    m_frameOffset += blockSizeBytes;
+    return { m_cpuAddress + offset, m_gpuAddress + offset };
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS ConstantRing::Push(const void* data, uint64_t sizeBytes)
+{
+    assert(data);
+
+    const ConstantAllocation allocation = Allocate(sizeBytes);
+    if (allocation.m_cpuAddress)
+        memcpy(allocation.m_cpuAddress, data, static_cast<size_t>(sizeBytes));
+    return allocation.m_gpuAddress;
+}
+
+void ConstantRing::EndFrame(ID3D12CommandQueue* cmdQueue)
+{
+    assert(cmdQueue);
+
+    Utils::AssertIfFailed(cmdQueue->Signal(m_fence.Get(), ++m_fenceValue));
+    m_frameFenceValues[m_frame] = m_fenceValue;
+
+    m_frame = (m_frame + 1) % static_cast<uint32_t>(m_frameFenceValues.size());
+    m_frameOffset = 0;
+
+    // Note a null event blocks until the fence reaches the value
+    if (m_fence->GetCompletedValue() < m_frameFenceValues[m_frame])
+        Utils::AssertIfFailed(m_fence->SetEventOnCompletion(m_frameFenceValues[m_frame], nullptr));
+}
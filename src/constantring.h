@@ -0,0 +1,58 @@
+#pragma once
+
+#include "common.h"
+
+#include <vector>
+
+#include "gpumemory.h"
+
+namespace ComputeBasics
+{
+
+struct ConstantAllocation
+{
+    void*                       m_cpuAddress;
+    // For SetComputeRootConstantBufferView
+    D3D12_GPU_VIRTUAL_ADDRESS   m_gpuAddress;
+};
+
+// Ring of constant blocks in an upload buffer, mapped once for its whole life. It is split in frames, every frame
+// a linear allocator of 256 bytes aligned blocks, so constants are written by the cpu and read by the gpu
+// right from upload memory, without copies nor copy queue.
+// Constants too small to be worth a block should go in root constants instead.
+// Note a frame is reused once the gpu is done with it, EndFrame signals the queue using it and starting a frame
+// waits for the gpu to finish with it if it has to.
+class ConstantRing
+{
+public:
+    ConstantRing(ID3D12Device* device, uint64_t frameSizeBytes, uint32_t framesCount, const std::wstring& name);
+    ~ConstantRing();
+    ConstantRing(const ConstantRing&) = delete;
+    ConstantRing& operator=(const ConstantRing&) = delete;
+
+    // Returns a block of at least sizeBytes in the current frame, with null addresses if the frame is full
+    ConstantAllocation Allocate(uint64_t sizeBytes);
+    // Same than Allocate, copying data to the block. Returns 0 if the frame is full.
+    D3D12_GPU_VIRTUAL_ADDRESS Push(const void* data, uint64_t sizeBytes);
+
+    template<typename T>
+    D3D12_GPU_VIRTUAL_ADDRESS Push(const T& constants) { return Push(&constants, sizeof(T)); }
+
+    // Ends the frame once its cmd lists are executed in cmdQueue and starts the next one
+    void EndFrame(ID3D12CommandQueue* cmdQueue);
+
+private:
+    GpuMemAllocation            m_buffer;
+    uint8_t*                    m_cpuAddress;
+    D3D12_GPU_VIRTUAL_ADDRESS   m_gpuAddress;
+    uint64_t                    m_frameSizeBytes;
+
+    ID3D12FenceComPtr           m_fence;
+    uint64_t                    m_fenceValue;
+    // Indexed by frame, the value signaled when the frame ended
+    std::vector<uint64_t>       m_frameFenceValues;
+    uint32_t                    m_frame;
+    uint64_t                    m_frameOffset;
+};
+
+}
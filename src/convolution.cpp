@@ -0,0 +1,117 @@
+#include "convolution.h"
+
+#include <cstring>
+#include <string>
+
+#include "cmdlists.h"
+
+namespace
+{
+const wchar_t* g_convolutionShaderFileName      = L"./data/shaders/convolution.hlsl";
+const char* g_convolutionRootSignatureName      = "ConvolutionRootSig";
+const uint32_t g_convolutionTileSize            = 256;
+const uint32_t g_convolutionDescriptorsPerPass  = 3;
+const D3D12_RESOURCE_STATES g_srcState          = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+
+// Root parameters as laid out in ConvolutionRootSig
+enum ConvolutionRootParameters
+{
+    ConvolutionRootParameters_Constants = 0,
+    ConvolutionRootParameters_Table
+};
+
+struct ConvolutionConstants
+{
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_radius;
+};
+}
+
+using namespace ComputeBasics;
+
+SeparableConvolution::SeparableConvolution(ID3D12Device* device, const std::vector<float>& weights) :
+    m_device(device), m_radius(static_cast<uint32_t>(weights.size() / 2))
+{
+    assert(m_device);
+    assert(weights.size() % 2 == 1 && m_radius <= g_maxConvolutionRadius);
+
+    for (uint32_t pass = 0; pass < ConvolutionPass_Count; ++pass)
+    {
+        const ShaderDefines defines{ { "CONVOLUTION_DIRECTION", std::to_string(pass) } };
+        m_pipelineStates[pass] = CreatePipelineState(m_device, g_convolutionShaderFileName, g_convolutionRootSignatureName,
+                                                     defines, L"Convolution Pass " + std::to_wstring(pass));
+    }
+
+    // Note the weights are small and read once per group, so they stay in the upload heap
+    const uint64_t weightsSizeBytes = weights.size() * sizeof(float);
+    m_weights = AllocateUpload(m_device, weightsSizeBytes, L"Convolution Weights");
+    ScopedMappedGpuMemAlloc mapped(m_weights);
+    memcpy(mapped.GetBuffer(), &weights[0], weightsSizeBytes);
+}
+
+bool SeparableConvolution::IsValid() const
+{
+    return m_pipelineStates[ConvolutionPass_Rows].m_pso && m_pipelineStates[ConvolutionPass_Columns].m_pso;
+}
+
+DescriptorHeapPtr SeparableConvolution::EnqueueConvolution(ID3D12GraphicsCommandList* computeCmdList,
+                                                           const GpuMemAllocation& src,
+                                                           const GpuMemAllocation& intermediate,
+                                                           const GpuMemAllocation& dst, const TextureDesc& desc)
+{
+    assert(IsValid());
+    assert(computeCmdList);
+    assert(src.m_resource);
+    assert(intermediate.m_resource);
+    assert(dst.m_resource);
+    assert(desc.m_type == TextureType::Texture2D && desc.m_arraySize == 1);
+
+    const uint32_t width = static_cast<uint32_t>(desc.m_width);
+    const uint32_t height = desc.m_height;
+
+    auto descriptorHeap = std::make_unique<DescriptorHeap>(m_device, ConvolutionPass_Count * g_convolutionDescriptorsPerPass);
+    const uint32_t weightsCount = 2 * m_radius + 1;
+    auto rowsTable = descriptorHeap->CreateTexture2DDescriptor(src, desc.m_format, 0, false);
+    descriptorHeap->CreateBufferDescriptor(m_weights, DXGI_FORMAT_R32_FLOAT, weightsCount, false);
+    descriptorHeap->CreateTexture2DDescriptor(intermediate, desc.m_format, 0, true);
+    auto columnsTable = descriptorHeap->CreateTexture2DDescriptor(intermediate, desc.m_format, 0, false);
+    descriptorHeap->CreateBufferDescriptor(m_weights, DXGI_FORMAT_R32_FLOAT, weightsCount, false);
+    descriptorHeap->CreateTexture2DDescriptor(dst, desc.m_format, 0, true);
+
+    ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { descriptorHeap->GetD3D12DescriptorHeap() };
+    computeCmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+
+    const ConvolutionConstants constants = { width, height, m_radius };
+    const D3D12_GPU_DESCRIPTOR_HANDLE tables[ConvolutionPass_Count] = { rowsTable.m_gpuHandle, columnsTable.m_gpuHandle };
+    // Note a group per tile of a row or a column
+    const uint32_t dispatchSizes[ConvolutionPass_Count][2] =
+    {
+        { (width + g_convolutionTileSize - 1) / g_convolutionTileSize, height },
+        { (height + g_convolutionTileSize - 1) / g_convolutionTileSize, width }
+    };
+
+    ID3D12Resource* intermediateResource = intermediate.m_resource.Get();
+    for (uint32_t pass = 0; pass < ConvolutionPass_Count; ++pass)
+    {
+        // The columns pass reads what the rows pass wrote as uav
+        if (pass == ConvolutionPass_Columns)
+        {
+            const auto barrier = CreateTransition(intermediateResource, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, g_srcState);
+            computeCmdList->ResourceBarrier(1, &barrier);
+        }
+
+        const auto& pipelineState = m_pipelineStates[pass];
+        computeCmdList->SetComputeRootSignature(pipelineState.m_rootSignature.Get());
+        computeCmdList->SetPipelineState(pipelineState.m_pso.Get());
+        computeCmdList->SetComputeRoot32BitConstants(ConvolutionRootParameters_Constants,
+                                                     sizeof(constants) / sizeof(uint32_t), &constants, 0);
+        computeCmdList->SetComputeRootDescriptorTable(ConvolutionRootParameters_Table, tables[pass]);
+        computeCmdList->Dispatch(dispatchSizes[pass][0], dispatchSizes[pass][1], 1);
+    }
+
+    const auto barrier = CreateTransition(intermediateResource, g_srcState, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    computeCmdList->ResourceBarrier(1, &barrier);
+
+    return descriptorHeap;
+}
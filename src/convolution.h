@@ -0,0 +1,53 @@
+#pragma once
+
+#include "common.h"
+
+#include <vector>
+
+#include "gpumemory.h"
+#include "descriptors.h"
+#include "pipelinestate.h"
+#include "cpuconvolution.h"
+
+namespace ComputeBasics
+{
+
+// Separable convolution of 2d textures on the gpu using data/shaders/convolution.hlsl, such as a gaussian blur
+// with the weights of CreateGaussianWeights. A pass along the rows writes an intermediate texture and a pass
+// along the columns writes the result.
+// Note the intermediate and dst textures have to be allocated as RW and their format has to support typed uav
+// stores.
+class SeparableConvolution
+{
+public:
+    // weights has 2 * radius + 1 elements, radius up to g_maxConvolutionRadius. The same weights are used in
+    // both directions.
+    SeparableConvolution(ID3D12Device* device, const std::vector<float>& weights);
+
+    bool IsValid() const;
+    uint32_t GetRadius() const { return m_radius; }
+
+    // Convolves mip 0 of src into mip 0 of dst. The three textures have the size of desc.
+    // src has to be in NON_PIXEL_SHADER_RESOURCE state and intermediate and dst in UNORDERED_ACCESS state.
+    // They are left as they are.
+    // Note the descriptor heaps of the cmd list are replaced.
+    // Note returning the descriptor heap so it outlives the execution in the gpu
+    DescriptorHeapPtr EnqueueConvolution(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& src,
+                                         const GpuMemAllocation& intermediate, const GpuMemAllocation& dst,
+                                         const TextureDesc& desc);
+
+private:
+    enum ConvolutionPass
+    {
+        ConvolutionPass_Rows = 0,
+        ConvolutionPass_Columns,
+        ConvolutionPass_Count
+    };
+
+    ID3D12Device*       m_device;
+    uint32_t            m_radius;
+    PipelineState       m_pipelineStates[ConvolutionPass_Count];
+    GpuMemAllocation    m_weights;
+};
+
+}
@@ -0,0 +1,755 @@
+#include "cpubenchmarks.h"
+
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <string>
+
+#include "benchmark.h"
+#include "cpumipsgenerator.h"
+#include "cpureduction.h"
+#include "cpuprefixscan.h"
+#include "cpuradixsort.h"
+#include "cpuhistogram.h"
+#include "cpucompaction.h"
+#include "cpusgemm.h"
+#include "cpuconvolution.h"
+#include "cpufft.h"
+#include "cpucolorpipeline.h"
+#include "computegraph.h"
+#include "parallelrecording.h"
+#include "cpucommandlist.h"
+#include "cpudispatchbatcher.h"
+#include "cpubindless.h"
+#include "residencypolicy.h"
+#include "cpuoutofcore.h"
+
+namespace
+{
+// Note 16K rgba float textures need 4GB for the mip 0 alone
+const uint32_t g_mipsBenchmarkSizes[] = { 1024, 2048, 4096, 8192, 16384 };
+const uint32_t g_reductionBenchmarkSizes[] = { 1 << 20, 1 << 24, 1 << 26, 1 << 28 };
+const uint32_t g_scanBenchmarkSizes[] = { 1 << 20, 1 << 24, 1 << 26 };
+const uint32_t g_radixSortBenchmarkSizes[] = { 1 << 10, 1 << 14, 1 << 18, 1 << 22, 1 << 26, 1 << 28 };
+// 4K and 8K uhd
+const uint32_t g_histogramBenchmarkSizes[][2] = { { 3840, 2160 }, { 7680, 4320 } };
+const uint32_t g_histogramBenchmarkBinsCounts[] = { 256, 1024 };
+const uint32_t g_compactionBenchmarkSizes[] = { 1 << 20, 1 << 24, 1 << 26 };
+// Note thresholds for Greater on uniform random keys, so about 5% and 50% of them survive
+const struct
+{
+    uint32_t    m_threshold;
+    const char* m_name;
+} g_compactionBenchmarkSelectivities[] = { { 0xF3333333, " 5%" }, { 0x80000000, " 50%" } };
+// m x n x k, square and skinny ones
+const uint32_t g_sgemmBenchmarkShapes[][3] =
+{
+    { 512, 512, 512 }, { 1024, 1024, 1024 }, { 2048, 2048, 2048 },
+    { 4096, 64, 4096 }, { 64, 4096, 4096 }, { 4096, 4096, 64 }
+};
+// 4K and 8K uhd
+const uint32_t g_convolutionBenchmarkSizes[][2] = { { 3840, 2160 }, { 7680, 4320 } };
+const uint32_t g_convolutionBenchmarkRadii[] = { 1, 4, 16, 64 };
+// 1d sizes and 2d square ones
+const uint32_t g_fftBenchmarkSizes[] = { 1 << 10, 1 << 14, 1 << 18, 1 << 22, 1 << 24 };
+const uint32_t g_fft2DBenchmarkSizes[] = { 1024, 4096, 8192 };
+// 4K and 8K uhd
+const uint32_t g_colorPipelineBenchmarkSizes[][2] = { { 3840, 2160 }, { 7680, 4320 } };
+const uint32_t g_computeGraphBenchmarkPassesCounts[] = { 64, 256, 1024, 4096 };
+// Note small dispatches, as in the batches where recording costs as much as the work
+const uint32_t g_parallelRecordingBenchmarkDispatchesCounts[] = { 1024, 16384, 65536 };
+const uint32_t g_parallelRecordingBenchmarkGroupsPerDispatch = 4;
+const uint32_t g_parallelRecordingBenchmarkThreadsPerGroup = 64;
+const uint32_t g_parallelRecordingBenchmarkMinDispatchesPerThread = 64;
+const uint32_t g_dispatchBatchingBenchmarkJobsCount = 16384;
+const uint32_t g_dispatchBatchingBenchmarkBatchSizes[] = { 1, 8, 64, 512, 4096 };
+const uint32_t g_dispatchBatchingBenchmarkElementsPerJob = 256;
+const uint32_t g_dispatchBatchingBenchmarkGroupSize = 64;
+// Note simulated allocations, 64GB of them in all against budgets of a part of them or all of them
+const uint32_t g_residencyBenchmarkAllocationsCount = 1024;
+const uint64_t g_residencyBenchmarkAllocationSizeBytes = 64ull << 20;
+const uint64_t g_residencyBenchmarkBudgetsBytes[] = { 8ull << 30, 16ull << 30, 32ull << 30, 64ull << 30 };
+const uint32_t g_residencyBenchmarkJobsCount = 65536;
+// Note half of them from a small set used by most of the jobs, the rest from all the allocations
+const uint32_t g_residencyBenchmarkAllocationsPerJob = 8;
+const uint32_t g_residencyBenchmarkHotAllocationsCount = 64;
+// Note 64MB of floats through a 8MB budget. The simulated bandwidth is below the one of memcpy, so the transfers
+// mostly wait and leave the cpu to the dispatches, as dma transfers would.
+const uint64_t g_outOfCoreBenchmarkElementsCount = 1 << 24;
+const uint64_t g_outOfCoreBenchmarkBudgetBytes = 8 << 20;
+const uint32_t g_outOfCoreBenchmarkBuffersCounts[] = { 1, 2, 3 };
+const double g_outOfCoreBenchmarkBytesPerSecond = 2e9;
+
+std::string SizeToString(uint32_t width, uint32_t height)
+{
+    return std::to_string(width) + "x" + std::to_string(height);
+}
+
+// Note the customary 5 N log2 N flops of a complex transform, half of them for a real one
+double CalculateFftFlops(const ComputeBasics::FftDesc& desc)
+{
+    const double size = static_cast<double>(desc.m_width) * desc.m_height;
+    const double flops = 5.0 * size * std::log2(size);
+    return desc.m_type == ComputeBasics::FftType::RealToComplex ? 0.5 * flops : flops;
+}
+
+// Note all the steps, as a batch job taking a linear rec 709 exr to a tone mapped rec 2020 one
+ComputeBasics::ColorPipelineDesc CreateColorPipelineBenchmarkDesc()
+{
+    ComputeBasics::ColorPipelineDesc desc = {};
+    desc.m_useExposure = true;
+    desc.m_exposure = 1.0f;
+    desc.m_useColorMatrix = true;
+    std::copy(std::begin(ComputeBasics::g_rec709ToRec2020Matrix), std::end(ComputeBasics::g_rec709ToRec2020Matrix),
+              desc.m_colorMatrix);
+    desc.m_toneCurve = ComputeBasics::ToneCurve::AcesFilmic;
+    return desc;
+}
+
+// Note a chain of passes reading the outputs of the previous pass and of the fourth previous one, as a long multi
+// stage job. One in four passes is a copy and one in eight only feeds a transient buffer nobody reads, so it is culled.
+ComputeBasics::ComputeGraph CreateComputeGraphBenchmarkGraph(uint32_t passesCount)
+{
+    using namespace ComputeBasics;
+
+    ComputeGraph graph;
+    const uint32_t input = graph.ImportBuffer("Input", 1 << 20);
+    const uint32_t output = graph.ImportBuffer("Output", 1 << 20);
+    std::vector<uint32_t> outputs;
+    for (uint32_t i = 0; i < passesCount; ++i)
+    {
+        const bool isCopy = i % 4 == 3;
+        const uint32_t pass = graph.AddPass("Pass " + std::to_string(i),
+                                            isCopy ? ComputeGraphPassType::Copy : ComputeGraphPassType::Dispatch);
+        if (i % 8 == 5)
+        {
+            graph.ReadBuffer(pass, outputs.empty() ? input : outputs.back());
+            graph.WriteBuffer(pass, graph.CreateTransientBuffer("Unused " + std::to_string(i), 1 << 16));
+            continue;
+        }
+
+        graph.ReadBuffer(pass, outputs.empty() ? input : outputs.back());
+        if (!isCopy && outputs.size() >= 4)
+            graph.ReadBuffer(pass, outputs[outputs.size() - 4]);
+        const uint32_t buffer = i + 1 == passesCount ? output :
+                                graph.CreateTransientBuffer("Buffer " + std::to_string(i), (1 << 16) << (i % 5));
+        graph.WriteBuffer(pass, buffer);
+        outputs.push_back(buffer);
+    }
+    return graph;
+}
+
+// Records a dispatch per item of the slice, each one running the kernel of data/shaders/simple.hlsl over its own
+// range of the buffers
+void RecordParallelRecordingBenchmarkSlice(ComputeBasics::Cpu::CommandList& cmdList,
+                                           const ComputeBasics::WorkSlice& workSlice,
+                                           const float* input, const float* inputPerGroup, float* output)
+{
+    const uint32_t elementsPerDispatch = g_parallelRecordingBenchmarkGroupsPerDispatch *
+                                         g_parallelRecordingBenchmarkThreadsPerGroup;
+    for (uint32_t item = workSlice.m_firstItem; item < workSlice.m_firstItem + workSlice.m_itemsCount; ++item)
+    {
+        const size_t offset = static_cast<size_t>(item) * elementsPerDispatch;
+        const float constant = -1.0f;
+        cmdList.Dispatch({ g_parallelRecordingBenchmarkGroupsPerDispatch, 1, 1 },
+                         [=](uint32_t groupX, uint32_t, uint32_t)
+        {
+            const size_t begin = offset + groupX * g_parallelRecordingBenchmarkThreadsPerGroup;
+            const float groupValue = inputPerGroup[item * g_parallelRecordingBenchmarkGroupsPerDispatch + groupX];
+            for (size_t i = begin; i < begin + g_parallelRecordingBenchmarkThreadsPerGroup; ++i)
+                output[i] = input[i] * constant * groupValue;
+        });
+    }
+}
+
+// Note xorshift, deterministic and fast enough to fill big inputs
+void FillRandom(std::vector<uint32_t>& data)
+{
+    uint32_t state = 0x9E3779B9;
+    for (auto& value : data)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        value = state;
+    }
+}
+}
+
+void ComputeBasics::Cpu::RunBenchmarks()
+{
+    BenchmarkMipsGeneration();
+    BenchmarkReduction();
+    BenchmarkPrefixScan();
+    BenchmarkRadixSort();
+    BenchmarkHistogram();
+    BenchmarkCompaction();
+    BenchmarkSgemm();
+    BenchmarkConvolution();
+    BenchmarkFft();
+    BenchmarkColorPipeline();
+    BenchmarkComputeGraph();
+    BenchmarkParallelRecording();
+    BenchmarkDispatchBatching();
+    BenchmarkBindless();
+    BenchmarkResidency();
+    BenchmarkOutOfCore();
+}
+
+void ComputeBasics::Cpu::BenchmarkMipsGeneration()
+{
+    for (uint32_t size : g_mipsBenchmarkSizes)
+    {
+        std::vector<float> mip0(static_cast<size_t>(size) * size * 4);
+        for (size_t i = 0; i < mip0.size(); ++i)
+            mip0[i] = static_cast<float>(i & 0xFFFF);
+
+        BenchmarkTimer timer;
+        auto mips = GenerateMips(&mip0[0], size, size, 0);
+        const double seconds = timer.ElapsedSeconds();
+
+        // Every mip is read once and written once
+        double bytes = static_cast<double>(mip0.size() * sizeof(float));
+        for (auto& mip : mips)
+            bytes += 2.0 * mip.m_texels.size() * sizeof(float);
+
+        ReportBenchmark("Cpu Mips Generation", SizeToString(size, size), seconds, bytes);
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkReduction()
+{
+    const uint32_t threadsCounts[] = { 1, 0 };
+
+    for (uint32_t count : g_reductionBenchmarkSizes)
+    {
+        std::vector<float> data(count);
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<float>(i & 0xFF);
+
+        for (uint32_t threadsCount : threadsCounts)
+        {
+            const std::string config = std::to_string(count) + (threadsCount == 1 ? " 1 thread" : " all threads");
+
+            BenchmarkTimer timer;
+            volatile float result = Reduce(&data[0], data.size(), ReductionOp::Sum, threadsCount);
+            const double seconds = timer.ElapsedSeconds();
+            (void)result;
+
+            ReportBenchmark("Cpu Reduction Sum", config, seconds, static_cast<double>(count) * sizeof(float));
+        }
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkPrefixScan()
+{
+    const uint32_t threadsCounts[] = { 1, 0 };
+
+    for (uint32_t count : g_scanBenchmarkSizes)
+    {
+        std::vector<uint32_t> src(count);
+        std::vector<uint32_t> dst(count);
+        for (size_t i = 0; i < src.size(); ++i)
+            src[i] = static_cast<uint32_t>(i & 0xFF);
+
+        for (uint32_t threadsCount : threadsCounts)
+        {
+            const std::string config = std::to_string(count) + (threadsCount == 1 ? " 1 thread" : " all threads");
+
+            BenchmarkTimer timer;
+            Scan(&src[0], &dst[0], src.size(), ScanType::Exclusive, threadsCount);
+            const double seconds = timer.ElapsedSeconds();
+
+            // Every element is read once and written once
+            ReportBenchmark("Cpu Prefix Scan", config, seconds, 2.0 * count * sizeof(uint32_t));
+        }
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkRadixSort()
+{
+    const uint32_t threadsCounts[] = { 1, 0 };
+
+    for (uint32_t count : g_radixSortBenchmarkSizes)
+    {
+        std::vector<uint32_t> keys(count);
+        std::vector<uint32_t> values(count);
+
+        for (uint32_t threadsCount : threadsCounts)
+        {
+            const std::string threadsConfig = threadsCount == 1 ? " 1 thread" : " all threads";
+
+            // Note the sorts are in place so the keys are filled again before every run
+            FillRandom(keys);
+            BenchmarkTimer keysTimer;
+            RadixSort(&keys[0], keys.size(), threadsCount);
+            const double keysSeconds = keysTimer.ElapsedSeconds();
+            ReportBenchmark("Cpu Radix Sort Keys", std::to_string(count) + threadsConfig, keysSeconds,
+                            count / keysSeconds / 1e6, "Mkeys/s");
+
+            FillRandom(keys);
+            BenchmarkTimer keysValuesTimer;
+            RadixSort(&keys[0], &values[0], keys.size(), threadsCount);
+            const double keysValuesSeconds = keysValuesTimer.ElapsedSeconds();
+            ReportBenchmark("Cpu Radix Sort Keys Values", std::to_string(count) + threadsConfig, keysValuesSeconds,
+                            count / keysValuesSeconds / 1e6, "Mkeys/s");
+        }
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkHistogram()
+{
+    const uint32_t threadsCounts[] = { 1, 0 };
+    const std::vector<float> percentiles = { 0.01f, 0.5f, 0.99f };
+
+    for (auto& size : g_histogramBenchmarkSizes)
+    {
+        // Note hdr values spread over the luminance range
+        std::vector<uint32_t> random(static_cast<size_t>(size[0]) * size[1] * 4);
+        FillRandom(random);
+        std::vector<float> texels(random.size());
+        for (size_t i = 0; i < texels.size(); ++i)
+            texels[i] = std::exp2(static_cast<float>(random[i] >> 8) / (1 << 24) * 32.0f - 16.0f);
+
+        for (uint32_t binsCount : g_histogramBenchmarkBinsCounts)
+        {
+            const HistogramDesc desc = { binsCount, 1.0f / 65536.0f, 65536.0f };
+            for (uint32_t threadsCount : threadsCounts)
+            {
+                const std::string config = SizeToString(size[0], size[1]) + " " + std::to_string(binsCount) + " bins" +
+                                           (threadsCount == 1 ? " 1 thread" : " all threads");
+
+                BenchmarkTimer timer;
+                auto bins = CalculateLuminanceHistogram(&texels[0], size[0], size[1], desc, threadsCount);
+                volatile float median = CalculatePercentiles(bins, desc, percentiles)[1];
+                const double seconds = timer.ElapsedSeconds();
+                (void)median;
+
+                ReportBenchmark("Cpu Luminance Histogram", config, seconds,
+                                static_cast<double>(texels.size()) * sizeof(float));
+            }
+        }
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkCompaction()
+{
+    const uint32_t threadsCounts[] = { 1, 0 };
+
+    for (uint32_t count : g_compactionBenchmarkSizes)
+    {
+        std::vector<uint32_t> src(count);
+        std::vector<uint32_t> dst(count);
+        FillRandom(src);
+
+        for (auto& selectivity : g_compactionBenchmarkSelectivities)
+        {
+            for (uint32_t threadsCount : threadsCounts)
+            {
+                const std::string config = std::to_string(count) + selectivity.m_name +
+                                           (threadsCount == 1 ? " 1 thread" : " all threads");
+
+                BenchmarkTimer timer;
+                const size_t survivorsCount = Compact(&src[0], src.size(), CompactionPredicate::Greater,
+                                                      selectivity.m_threshold, &dst[0], threadsCount);
+                const double seconds = timer.ElapsedSeconds();
+
+                // Every element is read once and the survivors are written once
+                ReportBenchmark("Cpu Compaction", config, seconds,
+                                static_cast<double>(count + survivorsCount) * sizeof(uint32_t));
+            }
+        }
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkSgemm()
+{
+    const uint32_t threadsCounts[] = { 1, 0 };
+
+    for (auto& shape : g_sgemmBenchmarkShapes)
+    {
+        const uint32_t m = shape[0];
+        const uint32_t n = shape[1];
+        const uint32_t k = shape[2];
+
+        // Note values in [-1, 1) so the sums stay small
+        std::vector<uint32_t> random(static_cast<size_t>(m) * k + static_cast<size_t>(k) * n);
+        FillRandom(random);
+        std::vector<float> values(random.size());
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = static_cast<float>(random[i] >> 8) / (1 << 23) - 1.0f;
+        std::vector<float> c(static_cast<size_t>(m) * n);
+
+        for (uint32_t threadsCount : threadsCounts)
+        {
+            const std::string config = std::to_string(m) + "x" + std::to_string(n) + "x" + std::to_string(k) +
+                                       (threadsCount == 1 ? " 1 thread" : " all threads");
+
+            BenchmarkTimer timer;
+            Sgemm(m, n, k, 1.0f, &values[0], &values[static_cast<size_t>(m) * k], 0.0f, &c[0], threadsCount);
+            const double seconds = timer.ElapsedSeconds();
+
+            // Note a multiply add per m, n and k
+            ReportBenchmark("Cpu Sgemm", config, seconds, 2.0 * m * n * k / seconds / 1e9, "GFLOP/s");
+        }
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkConvolution()
+{
+    const uint32_t threadsCounts[] = { 1, 0 };
+
+    for (auto& size : g_convolutionBenchmarkSizes)
+    {
+        std::vector<uint32_t> random(static_cast<size_t>(size[0]) * size[1] * 4);
+        FillRandom(random);
+        std::vector<float> src(random.size());
+        for (size_t i = 0; i < src.size(); ++i)
+            src[i] = static_cast<float>(random[i] >> 8) / (1 << 24);
+        std::vector<float> dst(src.size());
+
+        for (uint32_t radius : g_convolutionBenchmarkRadii)
+        {
+            const std::vector<float> weights = CreateGaussianWeights(radius);
+            for (uint32_t threadsCount : threadsCounts)
+            {
+                const std::string config = SizeToString(size[0], size[1]) + " radius " + std::to_string(radius) +
+                                           (threadsCount == 1 ? " 1 thread" : " all threads");
+
+                BenchmarkTimer timer;
+                ConvolveSeparable(&src[0], size[0], size[1], weights, &dst[0], threadsCount);
+                const double seconds = timer.ElapsedSeconds();
+
+                ReportBenchmark("Cpu Separable Convolution", config, seconds,
+                                static_cast<double>(size[0]) * size[1] / seconds / 1e6, "Mpixels/s");
+            }
+        }
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkFft()
+{
+    const uint32_t threadsCounts[] = { 1, 0 };
+
+    std::vector<FftDesc> descs;
+    for (FftType type : { FftType::ComplexToComplex, FftType::RealToComplex })
+    {
+        for (uint32_t size : g_fftBenchmarkSizes)
+            descs.push_back({ type, size, 1 });
+        for (uint32_t size : g_fft2DBenchmarkSizes)
+            descs.push_back({ type, size, size });
+    }
+
+    for (const FftDesc& desc : descs)
+    {
+        const bool isReal = desc.m_type == FftType::RealToComplex;
+        const size_t elementsCount = static_cast<size_t>(desc.m_width) * desc.m_height;
+
+        // Note values in [-1, 1), complex ones take two floats
+        std::vector<uint32_t> random(isReal ? elementsCount : 2 * elementsCount);
+        FillRandom(random);
+        std::vector<float> src(random.size());
+        for (size_t i = 0; i < src.size(); ++i)
+            src[i] = static_cast<float>(random[i] >> 8) / (1 << 23) - 1.0f;
+        std::vector<Complex> dst(static_cast<size_t>(CalculateFftComplexWidth(desc)) * desc.m_height);
+
+        const FftPlan plan(desc);
+        for (uint32_t threadsCount : threadsCounts)
+        {
+            const std::string config = (desc.m_height == 1 ? std::to_string(desc.m_width) :
+                                        SizeToString(desc.m_width, desc.m_height)) +
+                                       (isReal ? " real" : " complex") +
+                                       (threadsCount == 1 ? " 1 thread" : " all threads");
+
+            BenchmarkTimer timer;
+            plan.Execute(&src[0], &dst[0], FftDirection::Forward, threadsCount);
+            const double seconds = timer.ElapsedSeconds();
+
+            ReportBenchmark("Cpu Fft", config, seconds, CalculateFftFlops(desc) / seconds / 1e9, "GFLOP/s");
+        }
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkColorPipeline()
+{
+    const uint32_t threadsCounts[] = { 1, 0 };
+    const ColorPipelineDesc desc = CreateColorPipelineBenchmarkDesc();
+
+    for (auto& size : g_colorPipelineBenchmarkSizes)
+    {
+        // Note hdr values, some of them negative as out of gamut ones
+        std::vector<uint32_t> random(static_cast<size_t>(size[0]) * size[1] * 4);
+        FillRandom(random);
+        std::vector<float> src(random.size());
+        for (size_t i = 0; i < src.size(); ++i)
+            src[i] = static_cast<float>(random[i] >> 8) / (1 << 20) - 1.0f;
+        std::vector<float> dst(src.size());
+        const size_t texelsCount = static_cast<size_t>(size[0]) * size[1];
+
+        for (uint32_t isFused = 0; isFused < 2; ++isFused)
+        {
+            for (uint32_t threadsCount : threadsCounts)
+            {
+                const std::string config = SizeToString(size[0], size[1]) + (isFused ? " fused" : " unfused") +
+                                           (threadsCount == 1 ? " 1 thread" : " all threads");
+
+                BenchmarkTimer timer;
+                if (isFused)
+                    ApplyColorPipeline(&src[0], texelsCount, desc, &dst[0], threadsCount);
+                else
+                    ApplyColorPipelineUnfused(&src[0], texelsCount, desc, &dst[0], threadsCount);
+                const double seconds = timer.ElapsedSeconds();
+
+                ReportBenchmark("Cpu Color Pipeline", config, seconds, texelsCount / seconds / 1e6, "Mpixels/s");
+            }
+        }
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkComputeGraph()
+{
+    for (uint32_t passesCount : g_computeGraphBenchmarkPassesCounts)
+    {
+        const ComputeGraph graph = CreateComputeGraphBenchmarkGraph(passesCount);
+
+        BenchmarkTimer timer;
+        const ComputeGraphSchedule schedule = graph.Compile();
+        const double seconds = timer.ElapsedSeconds();
+
+        const std::string config = std::to_string(passesCount) + " passes, " +
+                                   std::to_string(schedule.m_segments.size()) + " segments, transient memory " +
+                                   std::to_string(schedule.m_transientMemorySize >> 20) + "MB aliased " +
+                                   std::to_string(schedule.m_transientUnaliasedMemorySize >> 20) + "MB not";
+        ReportBenchmark("Cpu Compute Graph Compile", config, seconds, passesCount / seconds / 1e3, "Kpasses/s");
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkParallelRecording()
+{
+    // Note more than the usual 1 thread and all threads, to see how recording scales
+    const uint32_t threadsCounts[] = { 1, 2, 4, 0 };
+    const uint32_t elementsPerDispatch = g_parallelRecordingBenchmarkGroupsPerDispatch *
+                                         g_parallelRecordingBenchmarkThreadsPerGroup;
+
+    for (uint32_t dispatchesCount : g_parallelRecordingBenchmarkDispatchesCounts)
+    {
+        const size_t elementsCount = static_cast<size_t>(dispatchesCount) * elementsPerDispatch;
+        const std::vector<float> input(elementsCount, 1.0f);
+        const std::vector<float> inputPerGroup(static_cast<size_t>(dispatchesCount) *
+                                               g_parallelRecordingBenchmarkGroupsPerDispatch, 2.0f);
+        std::vector<float> output(elementsCount);
+
+        for (uint32_t threadsCount : threadsCounts)
+        {
+            const std::vector<WorkSlice> slices = SplitWork(dispatchesCount, threadsCount,
+                                                            g_parallelRecordingBenchmarkMinDispatchesPerThread);
+            const std::string config = std::to_string(dispatchesCount) + " dispatches " +
+                                       (threadsCount == 0 ? "all" : std::to_string(threadsCount)) +
+                                       (threadsCount == 1 ? " thread" : " threads");
+
+            std::vector<CommandList> cmdLists(slices.size());
+            BenchmarkTimer timer;
+            RecordInParallel(slices, [&](uint32_t slice, const WorkSlice& workSlice)
+            {
+                RecordParallelRecordingBenchmarkSlice(cmdLists[slice], workSlice, &input[0], &inputPerGroup[0],
+                                                      &output[0]);
+            });
+            const double recordSeconds = timer.ElapsedSeconds();
+            ExecuteCommandLists(cmdLists, threadsCount);
+            const double seconds = timer.ElapsedSeconds();
+
+            ReportBenchmark("Cpu Parallel Recording", config, recordSeconds, dispatchesCount / recordSeconds / 1e3,
+                            "Kdispatches/s");
+            ReportBenchmark("Cpu Parallel Recording Execute", config, seconds, dispatchesCount / seconds / 1e3,
+                            "Kdispatches/s");
+        }
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkDispatchBatching()
+{
+    const uint32_t threadsCounts[] = { 1, 0 };
+    const size_t elementsCount = static_cast<size_t>(g_dispatchBatchingBenchmarkJobsCount) *
+                                 g_dispatchBatchingBenchmarkElementsPerJob;
+    const std::vector<float> input(elementsCount, 1.0f);
+    std::vector<float> output(elementsCount);
+
+    for (uint32_t batchSize : g_dispatchBatchingBenchmarkBatchSizes)
+    {
+        for (uint32_t threadsCount : threadsCounts)
+        {
+            // Note a latency long enough for the size to flush all the batches but the last one
+            const DispatchBatchLimits limits = { batchSize, 1.0 };
+
+            BenchmarkTimer timer;
+            DispatchBatchStats stats;
+            {
+                DispatchBatcher batcher(limits, threadsCount);
+                for (uint32_t job = 0; job < g_dispatchBatchingBenchmarkJobsCount; ++job)
+                {
+                    // Same than data/shaders/scalebias.hlsl, every job with its own constants and range of the buffers
+                    const float* jobInput = &input[static_cast<size_t>(job) * g_dispatchBatchingBenchmarkElementsPerJob];
+                    float* jobOutput = &output[static_cast<size_t>(job) * g_dispatchBatchingBenchmarkElementsPerJob];
+                    const float scale = static_cast<float>(job);
+                    const float bias = 1.0f;
+                    batcher.Add(CalculateDispatchArguments(g_dispatchBatchingBenchmarkElementsPerJob,
+                                                           g_dispatchBatchingBenchmarkGroupSize),
+                                [=](uint32_t groupX, uint32_t, uint32_t)
+                    {
+                        const uint32_t begin = groupX * g_dispatchBatchingBenchmarkGroupSize;
+                        const uint32_t end = std::min(begin + g_dispatchBatchingBenchmarkGroupSize,
+                                                      g_dispatchBatchingBenchmarkElementsPerJob);
+                        for (uint32_t i = begin; i < end; ++i)
+                            jobOutput[i] = jobInput[i] * scale + bias;
+                    });
+                }
+                batcher.Flush();
+                stats = batcher.GetStats();
+            }
+            const double seconds = timer.ElapsedSeconds();
+
+            const std::string config = "batch " + std::to_string(batchSize) + ", " +
+                                       std::to_string(stats.m_batchesCount) + " batches" +
+                                       (threadsCount == 1 ? " 1 thread" : " all threads");
+            ReportBenchmark("Cpu Dispatch Batching", config, seconds,
+                            g_dispatchBatchingBenchmarkJobsCount / seconds / 1e3, "Kjobs/s");
+        }
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkBindless()
+{
+    const uint32_t threadsCounts[] = { 1, 0 };
+    const size_t elementsCount = static_cast<size_t>(g_dispatchBatchingBenchmarkJobsCount) *
+                                 g_dispatchBatchingBenchmarkElementsPerJob;
+    const std::vector<float> input(elementsCount, 1.0f);
+    std::vector<float> output(elementsCount);
+
+    // Note every job has its own input and output in the table, as they would be distinct resources
+    const uint64_t jobSizeBytes = g_dispatchBatchingBenchmarkElementsPerJob * sizeof(float);
+    ResourceTable resourceTable(2 * g_dispatchBatchingBenchmarkJobsCount);
+    std::vector<uint32_t> inputIndices(g_dispatchBatchingBenchmarkJobsCount);
+    std::vector<uint32_t> outputIndices(g_dispatchBatchingBenchmarkJobsCount);
+    for (uint32_t job = 0; job < g_dispatchBatchingBenchmarkJobsCount; ++job)
+    {
+        const size_t firstElement = static_cast<size_t>(job) * g_dispatchBatchingBenchmarkElementsPerJob;
+        inputIndices[job] = resourceTable.AddBuffer(&input[firstElement], jobSizeBytes);
+        outputIndices[job] = resourceTable.AddRWBuffer(&output[firstElement], jobSizeBytes);
+    }
+
+    for (uint32_t threadsCount : threadsCounts)
+    {
+        BenchmarkTimer timer;
+        CommandList cmdList;
+        for (uint32_t job = 0; job < g_dispatchBatchingBenchmarkJobsCount; ++job)
+        {
+            // Same than data/shaders/bindless.hlsl, the kernel only gets the indices of its buffers
+            const uint32_t inputIndex = inputIndices[job];
+            const uint32_t outputIndex = outputIndices[job];
+            const float scale = static_cast<float>(job);
+            const float bias = 1.0f;
+            cmdList.Dispatch(CalculateDispatchArguments(g_dispatchBatchingBenchmarkElementsPerJob,
+                                                        g_dispatchBatchingBenchmarkGroupSize),
+                             [&resourceTable, inputIndex, outputIndex, scale, bias](uint32_t groupX, uint32_t, uint32_t)
+            {
+                const float* jobInput = resourceTable.GetBuffer<float>(inputIndex);
+                float* jobOutput = resourceTable.GetRWBuffer<float>(outputIndex);
+                const uint32_t elementsCount = static_cast<uint32_t>(resourceTable.GetElementsCount<float>(inputIndex));
+                const uint32_t begin = groupX * g_dispatchBatchingBenchmarkGroupSize;
+                const uint32_t end = std::min(begin + g_dispatchBatchingBenchmarkGroupSize, elementsCount);
+                for (uint32_t i = begin; i < end; ++i)
+                    jobOutput[i] = jobInput[i] * scale + bias;
+            });
+        }
+        ExecuteCommandList(cmdList, threadsCount);
+        const double seconds = timer.ElapsedSeconds();
+
+        const std::string config = std::to_string(g_dispatchBatchingBenchmarkJobsCount) + " jobs" +
+                                   (threadsCount == 1 ? " 1 thread" : " all threads");
+        ReportBenchmark("Cpu Bindless Dispatches", config, seconds,
+                        g_dispatchBatchingBenchmarkJobsCount / seconds / 1e3, "Kjobs/s");
+    }
+}
+
+
+void ComputeBasics::Cpu::BenchmarkResidency()
+{
+    std::vector<uint32_t> random(static_cast<size_t>(g_residencyBenchmarkJobsCount) *
+                                 g_residencyBenchmarkAllocationsPerJob);
+    FillRandom(random);
+    for (size_t i = 0; i < random.size(); ++i)
+        random[i] %= i % 2 == 0 ? g_residencyBenchmarkHotAllocationsCount : g_residencyBenchmarkAllocationsCount;
+
+    for (uint64_t budgetBytes : g_residencyBenchmarkBudgetsBytes)
+    {
+        ResidencyPolicy policy;
+        std::vector<uint32_t> allocations(g_residencyBenchmarkAllocationsCount);
+        for (uint32_t& allocation : allocations)
+            allocation = policy.Track(g_residencyBenchmarkAllocationSizeBytes, ResidencyHeapType::Default);
+
+        BenchmarkTimer timer;
+        ResidencyPlan plan;
+        for (uint32_t job = 0; job < g_residencyBenchmarkJobsCount; ++job)
+        {
+            for (uint32_t i = 0; i < g_residencyBenchmarkAllocationsPerJob; ++i)
+                policy.Use(allocations[random[static_cast<size_t>(job) * g_residencyBenchmarkAllocationsPerJob + i]]);
+            policy.PlanJob(budgetBytes, plan);
+        }
+        const double seconds = timer.ElapsedSeconds();
+
+        const ResidencyCounters& counters = policy.GetCounters();
+        const std::string config = "budget " + std::to_string(budgetBytes >> 30) + "GB, " +
+                                   std::to_string(counters.m_evictionsCount) + " evictions " +
+                                   std::to_string(counters.m_madeResidentBytes >> 30) + "GB made resident";
+        ReportBenchmark("Cpu Residency Policy", config, seconds, g_residencyBenchmarkJobsCount / seconds / 1e3,
+                        "Kjobs/s");
+    }
+}
+
+void ComputeBasics::Cpu::BenchmarkOutOfCore()
+{
+    std::vector<float> input(g_outOfCoreBenchmarkElementsCount, 1.0f);
+    std::vector<float> output(g_outOfCoreBenchmarkElementsCount);
+    const OutOfCoreRates simulatedRates = { g_outOfCoreBenchmarkBytesPerSecond, g_outOfCoreBenchmarkBytesPerSecond,
+                                            0.0 };
+
+    for (OutOfCoreKernelType kernelType : { OutOfCoreKernelType::Elementwise, OutOfCoreKernelType::Reduction })
+    {
+        const bool isElementwise = kernelType == OutOfCoreKernelType::Elementwise;
+        for (uint32_t buffersCount : g_outOfCoreBenchmarkBuffersCounts)
+        {
+            const OutOfCoreDesc desc = { kernelType, g_outOfCoreBenchmarkElementsCount, sizeof(float), sizeof(float),
+                                         64, buffersCount, g_outOfCoreBenchmarkBudgetBytes };
+            OutOfCoreExecutor executor(desc, simulatedRates);
+
+            // Same than data/shaders/scalebias.hlsl and data/shaders/reduction.hlsl, in a single thread as the
+            // dispatches of the gpu run one after the other
+            BenchmarkTimer timer;
+            executor.Execute(&input[0], &output[0], [isElementwise](const void* chunkInput, void* chunkOutput,
+                                                                    uint32_t elementsCount, const OutOfCoreStep&)
+            {
+                const float* elements = static_cast<const float*>(chunkInput);
+                float* results = static_cast<float*>(chunkOutput);
+                if (isElementwise)
+                {
+                    for (uint32_t i = 0; i < elementsCount; ++i)
+                        results[i] = elements[i] * 2.0f + 1.0f;
+                }
+                else
+                    results[0] = Reduce(elements, elementsCount, ReductionOp::Sum, 1);
+            });
+            const double seconds = timer.ElapsedSeconds();
+
+            const OutOfCoreTimeline& timeline = executor.GetTimeline();
+            const std::string config = std::to_string(buffersCount) + " buffers, " +
+                                       std::to_string(executor.GetSchedule().m_chunksCount) + " chunks, copy " +
+                                       std::to_string(static_cast<uint32_t>(timeline.m_copySeconds * 1e3)) +
+                                       "ms dispatch " +
+                                       std::to_string(static_cast<uint32_t>(timeline.m_computeSeconds * 1e3)) + "ms";
+            ReportBenchmark(isElementwise ? "Cpu Out Of Core Scale Bias" : "Cpu Out Of Core Reduction", config,
+                            seconds, static_cast<double>(g_outOfCoreBenchmarkElementsCount) * sizeof(float) *
+                                     (isElementwise ? 2 : 1));
+        }
+    }
+}
\ No newline at end of file
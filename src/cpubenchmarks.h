@@ -0,0 +1,44 @@
+#pragma once
+
+// Benchmarks of the cpu implementations. It doesnt depend on d3d12 so it can run on any platform.
+namespace ComputeBasics
+{
+namespace Cpu
+{
+
+void RunBenchmarks();
+
+void BenchmarkMipsGeneration();
+
+void BenchmarkReduction();
+
+void BenchmarkPrefixScan();
+
+void BenchmarkRadixSort();
+
+void BenchmarkHistogram();
+
+void BenchmarkCompaction();
+
+void BenchmarkSgemm();
+
+void BenchmarkConvolution();
+
+void BenchmarkFft();
+
+void BenchmarkColorPipeline();
+
+void BenchmarkComputeGraph();
+
+void BenchmarkParallelRecording();
+
+void BenchmarkDispatchBatching();
+
+void BenchmarkBindless();
+
+void BenchmarkResidency();
+
+void BenchmarkOutOfCore();
+
+}
+}
@@ -0,0 +1,115 @@
+#include "cpubindless.h"
+
+#include <algorithm>
+
+using namespace ComputeBasics;
+
+BindlessIndexAllocator::BindlessIndexAllocator(uint32_t capacity) : m_capacity(capacity), m_allocatedCount(0)
+{
+    assert(capacity > 0 && capacity != g_invalidBindlessIndex);
+
+    m_freeRanges.push_back({ 0, capacity });
+}
+
+uint32_t BindlessIndexAllocator::Allocate(uint32_t count)
+{
+    assert(count > 0);
+
+    const auto range = std::find_if(m_freeRanges.begin(), m_freeRanges.end(), [count](const Range& freeRange)
+    {
+        return freeRange.m_count >= count;
+    });
+    if (range == m_freeRanges.end())
+        return g_invalidBindlessIndex;
+
+    const uint32_t first = range->m_first;
+    range->m_first += count;
+    range->m_count -= count;
+    if (range->m_count == 0)
+        m_freeRanges.erase(range);
+
+    m_allocatedCount += count;
+    return first;
+}
+
+void BindlessIndexAllocator::Free(uint32_t first, uint32_t count)
+{
+    assert(count > 0);
+    assert(first + count <= m_capacity);
+    assert(count <= m_allocatedCount);
+
+    // Note the first free range after the freed one, the one before it is the previous one
+    const auto next = std::lower_bound(m_freeRanges.begin(), m_freeRanges.end(), first,
+                                       [](const Range& freeRange, uint32_t index)
+    {
+        return freeRange.m_first < index;
+    });
+    assert(next == m_freeRanges.end() || first + count <= next->m_first);
+    assert(next == m_freeRanges.begin() || (next - 1)->m_first + (next - 1)->m_count <= first);
+
+    m_allocatedCount -= count;
+
+    const bool mergesPrevious = next != m_freeRanges.begin() && (next - 1)->m_first + (next - 1)->m_count == first;
+    const bool mergesNext = next != m_freeRanges.end() && first + count == next->m_first;
+    if (mergesPrevious && mergesNext)
+    {
+        (next - 1)->m_count += count + next->m_count;
+        m_freeRanges.erase(next);
+    }
+    else if (mergesPrevious)
+        (next - 1)->m_count += count;
+    else if (mergesNext)
+    {
+        next->m_first = first;
+        next->m_count += count;
+    }
+    else
+        m_freeRanges.insert(next, { first, count });
+}
+
+Cpu::ResourceTable::ResourceTable(uint32_t capacity) : m_allocator(capacity), m_resources(capacity)
+{
+}
+
+uint32_t Cpu::ResourceTable::AddBuffer(const void* data, uint64_t sizeBytes)
+{
+    // Note read only entries keep the pointer as non const too, the getters dont let kernels write them
+    return Add({ BindlessResourceType::Buffer, const_cast<void*>(data), false, sizeBytes, 0, 0, 0 });
+}
+
+uint32_t Cpu::ResourceTable::AddRWBuffer(void* data, uint64_t sizeBytes)
+{
+    return Add({ BindlessResourceType::Buffer, data, true, sizeBytes, 0, 0, 0 });
+}
+
+uint32_t Cpu::ResourceTable::AddTexture2D(const void* data, uint32_t width, uint32_t height, uint32_t rowPitch)
+{
+    return Add({ BindlessResourceType::Texture2D, const_cast<void*>(data), false,
+                 static_cast<uint64_t>(height) * rowPitch, width, height, rowPitch });
+}
+
+uint32_t Cpu::ResourceTable::AddRWTexture2D(void* data, uint32_t width, uint32_t height, uint32_t rowPitch)
+{
+    return Add({ BindlessResourceType::Texture2D, data, true, static_cast<uint64_t>(height) * rowPitch,
+                 width, height, rowPitch });
+}
+
+void Cpu::ResourceTable::Remove(uint32_t index)
+{
+    assert(index < m_resources.size());
+    assert(m_resources[index].m_data);
+
+    m_resources[index].m_data = nullptr;
+    m_allocator.Free(index);
+}
+
+uint32_t Cpu::ResourceTable::Add(const BindlessResource& resource)
+{
+    assert(resource.m_data);
+    assert(resource.m_sizeBytes > 0);
+
+    const uint32_t index = m_allocator.Allocate();
+    if (index != g_invalidBindlessIndex)
+        m_resources[index] = resource;
+    return index;
+}
\ No newline at end of file
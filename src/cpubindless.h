@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Bindless resources: every buffer and texture gets a persistent index in one large table and kernels find them by
+// the indices passed in their constants, instead of having them bound per dispatch. In the gpu the table is a
+// shader visible descriptor heap, BindlessDescriptorHeap in src/descriptors.h, read by data/shaders/bindless.hlsl.
+// In the cpu it is a ResourceTable, so kernels written against indices run without a gpu too.
+// It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+const uint32_t g_invalidBindlessIndex = UINT32_MAX;
+
+// Persistent allocator of ranges of consecutive indices of a table. First fit over the free ranges sorted by index,
+// and the freed ranges are merged with their free neighbours, so resources created and destroyed all along dont
+// fragment the table.
+class BindlessIndexAllocator
+{
+public:
+    explicit BindlessIndexAllocator(uint32_t capacity);
+
+    // Returns the first of count consecutive indices, g_invalidBindlessIndex if no free range is big enough
+    uint32_t Allocate(uint32_t count = 1);
+    // Note the range has to be allocated, as a whole or as a part of an allocation
+    void Free(uint32_t first, uint32_t count = 1);
+
+    uint32_t GetCapacity() const { return m_capacity; }
+    uint32_t GetAllocatedCount() const { return m_allocatedCount; }
+    size_t GetFreeRangesCount() const { return m_freeRanges.size(); }
+
+private:
+    struct Range
+    {
+        uint32_t m_first;
+        uint32_t m_count;
+    };
+
+    std::vector<Range>  m_freeRanges;
+    uint32_t            m_capacity;
+    uint32_t            m_allocatedCount;
+};
+
+namespace Cpu
+{
+
+enum class BindlessResourceType
+{
+    Buffer,
+    Texture2D
+};
+
+struct BindlessResource
+{
+    BindlessResourceType    m_type;
+    // Note null for the free entries
+    void*                   m_data;
+    bool                    m_isRW;
+    uint64_t                m_sizeBytes;
+    // Only for textures
+    uint32_t                m_width;
+    uint32_t                m_height;
+    uint32_t                m_rowPitch;
+};
+
+// Cpu version of BindlessDescriptorHeap. The entries point to memory the table doesnt own, it has to outlive them.
+// Buffers are raw, as the ByteAddressBuffer arrays of data/shaders/bindless.hlsl, and kernels read them as the
+// type they want.
+// Note kernels can read the table from many threads at once, adding and removing entries has to be done between
+// dispatches
+class ResourceTable
+{
+public:
+    explicit ResourceTable(uint32_t capacity);
+
+    // Return g_invalidBindlessIndex if the table is full
+    uint32_t AddBuffer(const void* data, uint64_t sizeBytes);
+    uint32_t AddRWBuffer(void* data, uint64_t sizeBytes);
+    uint32_t AddTexture2D(const void* data, uint32_t width, uint32_t height, uint32_t rowPitch);
+    uint32_t AddRWTexture2D(void* data, uint32_t width, uint32_t height, uint32_t rowPitch);
+    // Note the index can be returned by the next Add
+    void Remove(uint32_t index);
+
+    uint32_t GetAllocatedCount() const { return m_allocator.GetAllocatedCount(); }
+    const BindlessResource& Get(uint32_t index) const
+    {
+        assert(index < m_resources.size());
+        assert(m_resources[index].m_data);
+        return m_resources[index];
+    }
+
+    template<typename T>
+    const T* GetBuffer(uint32_t index) const
+    {
+        assert(Get(index).m_type == BindlessResourceType::Buffer);
+        return static_cast<const T*>(Get(index).m_data);
+    }
+
+    template<typename T>
+    T* GetRWBuffer(uint32_t index) const
+    {
+        assert(Get(index).m_type == BindlessResourceType::Buffer);
+        assert(Get(index).m_isRW);
+        return static_cast<T*>(Get(index).m_data);
+    }
+
+    template<typename T>
+    uint64_t GetElementsCount(uint32_t index) const { return Get(index).m_sizeBytes / sizeof(T); }
+
+    template<typename T>
+    const T* GetTexture2DRow(uint32_t index, uint32_t y) const
+    {
+        const BindlessResource& texture = Get(index);
+        assert(texture.m_type == BindlessResourceType::Texture2D);
+        assert(y < texture.m_height);
+        return reinterpret_cast<const T*>(static_cast<const uint8_t*>(texture.m_data) +
+                                          static_cast<uint64_t>(y) * texture.m_rowPitch);
+    }
+
+    template<typename T>
+    T* GetRWTexture2DRow(uint32_t index, uint32_t y) const
+    {
+        assert(Get(index).m_isRW);
+        return const_cast<T*>(GetTexture2DRow<T>(index, y));
+    }
+
+private:
+    BindlessIndexAllocator          m_allocator;
+    std::vector<BindlessResource>   m_resources;
+
+    uint32_t Add(const BindlessResource& resource);
+};
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,373 @@
+#include "cpucolorpipeline.h"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX512F__)
+#define CPUCOLORPIPELINE_AVX512 ( 1 )
+#define CPUCOLORPIPELINE_AVX ( 0 )
+#define CPUCOLORPIPELINE_SSE ( 0 )
+#include <immintrin.h>
+#elif defined(__AVX__)
+#define CPUCOLORPIPELINE_AVX512 ( 0 )
+#define CPUCOLORPIPELINE_AVX ( 1 )
+#define CPUCOLORPIPELINE_SSE ( 0 )
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__)
+#define CPUCOLORPIPELINE_AVX512 ( 0 )
+#define CPUCOLORPIPELINE_AVX ( 0 )
+#define CPUCOLORPIPELINE_SSE ( 1 )
+#include <emmintrin.h>
+#else
+#define CPUCOLORPIPELINE_AVX512 ( 0 )
+#define CPUCOLORPIPELINE_AVX ( 0 )
+#define CPUCOLORPIPELINE_SSE ( 0 )
+#endif
+
+namespace
+{
+using ComputeBasics::ColorPipelineDesc;
+
+const size_t g_channelsCount = 4;
+// Note below this amount of texels the cost of launching a thread is higher than the work itself
+const size_t g_minTexelsPerThread = 64 * 1024;
+// Note bands of whole cache lines so threads dont share them
+const size_t g_texelsPerCacheLine = 4;
+
+// Single texel traits, used for the texels that dont fill a vector
+struct ScalarTexels
+{
+    struct Type
+    {
+        float m_channels[g_channelsCount];
+    };
+    static const size_t texelsCount = 1;
+
+    static Type Set(float r, float g, float b, float a) { return { { r, g, b, a } }; }
+    static Type Load(const float* src) { return { { src[0], src[1], src[2], src[3] } }; }
+    static void Store(float* dst, Type v) { std::copy(v.m_channels, v.m_channels + g_channelsCount, dst); }
+    template<int Channel>
+    static Type Broadcast(Type v) { return Set(v.m_channels[Channel], v.m_channels[Channel], v.m_channels[Channel],
+                                               v.m_channels[Channel]); }
+    // rgb of a and alpha of b
+    static Type SelectRgb(Type a, Type b) { return Set(a.m_channels[0], a.m_channels[1], a.m_channels[2], b.m_channels[3]); }
+
+    template<typename Op>
+    static Type Apply(Type a, Type b, Op op)
+    {
+        Type result;
+        for (size_t i = 0; i < g_channelsCount; ++i)
+            result.m_channels[i] = op(a.m_channels[i], b.m_channels[i]);
+        return result;
+    }
+    static Type Add(Type a, Type b) { return Apply(a, b, [](float x, float y) { return x + y; }); }
+    static Type Mul(Type a, Type b) { return Apply(a, b, [](float x, float y) { return x * y; }); }
+    static Type Div(Type a, Type b) { return Apply(a, b, [](float x, float y) { return x / y; }); }
+    // Note written so nans become y, as maxps and minps do
+    static Type Max(Type a, Type b) { return Apply(a, b, [](float x, float y) { return x > y ? x : y; }); }
+    static Type Min(Type a, Type b) { return Apply(a, b, [](float x, float y) { return x < y ? x : y; }); }
+};
+
+// Vector traits. A vector holds texelsCount consecutive rgba texels.
+#if CPUCOLORPIPELINE_AVX512
+struct VectorTexels
+{
+    using Type = __m512;
+    static const size_t texelsCount = 4;
+
+    static Type Set(float r, float g, float b, float a) { return _mm512_setr4_ps(r, g, b, a); }
+    static Type Load(const float* src) { return _mm512_loadu_ps(src); }
+    static void Store(float* dst, Type v) { _mm512_storeu_ps(dst, v); }
+    template<int Channel>
+    static Type Broadcast(Type v) { return _mm512_permute_ps(v, _MM_SHUFFLE(Channel, Channel, Channel, Channel)); }
+    static Type SelectRgb(Type a, Type b) { return _mm512_mask_blend_ps(0x8888, a, b); }
+    static Type Add(Type a, Type b) { return _mm512_add_ps(a, b); }
+    static Type Mul(Type a, Type b) { return _mm512_mul_ps(a, b); }
+    static Type Div(Type a, Type b) { return _mm512_div_ps(a, b); }
+    static Type Max(Type a, Type b) { return _mm512_max_ps(a, b); }
+    static Type Min(Type a, Type b) { return _mm512_min_ps(a, b); }
+};
+#elif CPUCOLORPIPELINE_AVX
+struct VectorTexels
+{
+    using Type = __m256;
+    static const size_t texelsCount = 2;
+
+    static Type Set(float r, float g, float b, float a) { return _mm256_setr_ps(r, g, b, a, r, g, b, a); }
+    static Type Load(const float* src) { return _mm256_loadu_ps(src); }
+    static void Store(float* dst, Type v) { _mm256_storeu_ps(dst, v); }
+    template<int Channel>
+    static Type Broadcast(Type v) { return _mm256_permute_ps(v, _MM_SHUFFLE(Channel, Channel, Channel, Channel)); }
+    static Type SelectRgb(Type a, Type b) { return _mm256_blend_ps(a, b, 0x88); }
+    static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+    static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+    static Type Div(Type a, Type b) { return _mm256_div_ps(a, b); }
+    static Type Max(Type a, Type b) { return _mm256_max_ps(a, b); }
+    static Type Min(Type a, Type b) { return _mm256_min_ps(a, b); }
+};
+#elif CPUCOLORPIPELINE_SSE
+struct VectorTexels
+{
+    using Type = __m128;
+    static const size_t texelsCount = 1;
+
+    static Type Set(float r, float g, float b, float a) { return _mm_setr_ps(r, g, b, a); }
+    static Type Load(const float* src) { return _mm_loadu_ps(src); }
+    static void Store(float* dst, Type v) { _mm_storeu_ps(dst, v); }
+    template<int Channel>
+    static Type Broadcast(Type v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(Channel, Channel, Channel, Channel)); }
+    // Note sse2 doesnt have blendps
+    static Type SelectRgb(Type a, Type b)
+    {
+        const Type alphaMask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+        return _mm_or_ps(_mm_andnot_ps(alphaMask, a), _mm_and_ps(alphaMask, b));
+    }
+    static Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+    static Type Mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+    static Type Div(Type a, Type b) { return _mm_div_ps(a, b); }
+    static Type Max(Type a, Type b) { return _mm_max_ps(a, b); }
+    static Type Min(Type a, Type b) { return _mm_min_ps(a, b); }
+};
+#else
+using VectorTexels = ScalarTexels;
+#endif
+
+// Steps. Every one takes what it needs of the desc when the pipeline is built and applies it to a vector.
+template<typename V>
+class ExposureStep
+{
+public:
+    ExposureStep(const ColorPipelineDesc& desc)
+    {
+        const float scale = std::exp2(desc.m_exposure);
+        m_scale = V::Set(scale, scale, scale, 1.0f);
+    }
+
+    typename V::Type Apply(typename V::Type texels) const { return V::Mul(texels, m_scale); }
+
+private:
+    typename V::Type m_scale;
+};
+
+template<typename V>
+class ColorMatrixStep
+{
+public:
+    // Note the columns of the matrix, plus one keeping the alpha
+    ColorMatrixStep(const ColorPipelineDesc& desc)
+    {
+        const float* m = desc.m_colorMatrix;
+        m_columns[0] = V::Set(m[0], m[3], m[6], 0.0f);
+        m_columns[1] = V::Set(m[1], m[4], m[7], 0.0f);
+        m_columns[2] = V::Set(m[2], m[5], m[8], 0.0f);
+        m_columns[3] = V::Set(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    typename V::Type Apply(typename V::Type texels) const
+    {
+        typename V::Type result = V::Mul(V::template Broadcast<0>(texels), m_columns[0]);
+        result = V::Add(result, V::Mul(V::template Broadcast<1>(texels), m_columns[1]));
+        result = V::Add(result, V::Mul(V::template Broadcast<2>(texels), m_columns[2]));
+        return V::Add(result, V::Mul(V::template Broadcast<3>(texels), m_columns[3]));
+    }
+
+private:
+    typename V::Type m_columns[g_channelsCount];
+};
+
+// Note negative values are clamped to 0 by the tone curves
+template<typename V>
+class ReinhardStep
+{
+public:
+    ReinhardStep(const ColorPipelineDesc&) : m_zero(V::Set(0.0f, 0.0f, 0.0f, 0.0f)), m_one(V::Set(1.0f, 1.0f, 1.0f, 1.0f)) {}
+
+    typename V::Type Apply(typename V::Type texels) const
+    {
+        const typename V::Type x = V::Max(texels, m_zero);
+        return V::SelectRgb(V::Div(x, V::Add(x, m_one)), texels);
+    }
+
+private:
+    typename V::Type m_zero;
+    typename V::Type m_one;
+};
+
+// x * (a * x + b) / (x * (c * x + d) + e)
+template<typename V>
+class AcesFilmicStep
+{
+public:
+    AcesFilmicStep(const ColorPipelineDesc&) :
+        m_a(V::Set(2.51f, 2.51f, 2.51f, 2.51f)), m_b(V::Set(0.03f, 0.03f, 0.03f, 0.03f)),
+        m_c(V::Set(2.43f, 2.43f, 2.43f, 2.43f)), m_d(V::Set(0.59f, 0.59f, 0.59f, 0.59f)),
+        m_e(V::Set(0.14f, 0.14f, 0.14f, 0.14f)), m_zero(V::Set(0.0f, 0.0f, 0.0f, 0.0f)),
+        m_one(V::Set(1.0f, 1.0f, 1.0f, 1.0f))
+    {
+    }
+
+    typename V::Type Apply(typename V::Type texels) const
+    {
+        const typename V::Type x = V::Max(texels, m_zero);
+        const typename V::Type numerator = V::Mul(x, V::Add(V::Mul(m_a, x), m_b));
+        const typename V::Type denominator = V::Add(V::Mul(x, V::Add(V::Mul(m_c, x), m_d)), m_e);
+        return V::SelectRgb(V::Min(V::Div(numerator, denominator), m_one), texels);
+    }
+
+private:
+    typename V::Type m_a;
+    typename V::Type m_b;
+    typename V::Type m_c;
+    typename V::Type m_d;
+    typename V::Type m_e;
+    typename V::Type m_zero;
+    typename V::Type m_one;
+};
+
+// Composes Steps, applied from the first to the last
+template<typename V, template<typename> class... Steps>
+class Pipeline;
+
+template<typename V>
+class Pipeline<V>
+{
+public:
+    Pipeline(const ColorPipelineDesc&) {}
+
+    typename V::Type Apply(typename V::Type texels) const { return texels; }
+};
+
+template<typename V, template<typename> class Step, template<typename> class... Steps>
+class Pipeline<V, Step, Steps...>
+{
+public:
+    Pipeline(const ColorPipelineDesc& desc) : m_step(desc), m_steps(desc) {}
+
+    typename V::Type Apply(typename V::Type texels) const { return m_steps.Apply(m_step.Apply(texels)); }
+
+private:
+    Step<V>                 m_step;
+    Pipeline<V, Steps...>   m_steps;
+};
+
+// Applies the pipeline to the whole vectors in [begin, end) and returns where they end
+template<typename V, template<typename> class... Steps>
+size_t ApplyPipeline(const float* src, size_t begin, size_t end, const ColorPipelineDesc& desc, float* dst)
+{
+    const Pipeline<V, Steps...> pipeline(desc);
+
+    size_t i = begin;
+    for (; i + V::texelsCount <= end; i += V::texelsCount)
+        V::Store(dst + i * g_channelsCount, pipeline.Apply(V::Load(src + i * g_channelsCount)));
+
+    return i;
+}
+
+template<template<typename> class... Steps>
+void ApplySteps(const float* src, size_t texelsCount, const ColorPipelineDesc& desc, float* dst, uint32_t threadsCount)
+{
+    auto applyRange = [=, &desc](size_t begin, size_t end)
+    {
+        const size_t vectorsEnd = ApplyPipeline<VectorTexels, Steps...>(src, begin, end, desc, dst);
+        ApplyPipeline<ScalarTexels, Steps...>(src, vectorsEnd, end, desc, dst);
+    };
+
+    const size_t linesCount = (texelsCount + g_texelsPerCacheLine - 1) / g_texelsPerCacheLine;
+    const size_t texelsPerThread = (linesCount + threadsCount - 1) / threadsCount * g_texelsPerCacheLine;
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount - 1);
+    for (uint32_t t = 1; t < threadsCount; ++t)
+    {
+        const size_t begin = std::min(t * texelsPerThread, texelsCount);
+        const size_t end = std::min(begin + texelsPerThread, texelsCount);
+        threads.emplace_back(applyRange, begin, end);
+    }
+    applyRange(0, std::min(texelsPerThread, texelsCount));
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+// Note every selection appends a step, so every combination of steps gets its own loop
+template<template<typename> class... Steps>
+void SelectToneCurve(const float* src, size_t texelsCount, const ColorPipelineDesc& desc, float* dst,
+                     uint32_t threadsCount)
+{
+    switch (desc.m_toneCurve)
+    {
+    case ComputeBasics::ToneCurve::Reinhard:
+        ApplySteps<Steps..., ReinhardStep>(src, texelsCount, desc, dst, threadsCount);
+        break;
+    case ComputeBasics::ToneCurve::AcesFilmic:
+        ApplySteps<Steps..., AcesFilmicStep>(src, texelsCount, desc, dst, threadsCount);
+        break;
+    default:
+        ApplySteps<Steps...>(src, texelsCount, desc, dst, threadsCount);
+        break;
+    }
+}
+
+template<template<typename> class... Steps>
+void SelectColorMatrix(const float* src, size_t texelsCount, const ColorPipelineDesc& desc, float* dst,
+                       uint32_t threadsCount)
+{
+    if (desc.m_useColorMatrix)
+        SelectToneCurve<Steps..., ColorMatrixStep>(src, texelsCount, desc, dst, threadsCount);
+    else
+        SelectToneCurve<Steps...>(src, texelsCount, desc, dst, threadsCount);
+}
+
+uint32_t CalculateThreadsCount(size_t texelsCount, uint32_t threadsCount)
+{
+    if (threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    return static_cast<uint32_t>(std::min<size_t>(threadsCount, std::max<size_t>(texelsCount / g_minTexelsPerThread, 1)));
+}
+}
+
+using namespace ComputeBasics;
+
+void Cpu::ApplyColorPipeline(const float* src, size_t texelsCount, const ColorPipelineDesc& desc, float* dst,
+                             uint32_t threadsCount)
+{
+    assert((src && dst) || texelsCount == 0);
+
+    if (texelsCount == 0)
+        return;
+
+    threadsCount = CalculateThreadsCount(texelsCount, threadsCount);
+    if (desc.m_useExposure)
+        SelectColorMatrix<ExposureStep>(src, texelsCount, desc, dst, threadsCount);
+    else
+        SelectColorMatrix<>(src, texelsCount, desc, dst, threadsCount);
+}
+
+void Cpu::ApplyColorPipelineUnfused(const float* src, size_t texelsCount, const ColorPipelineDesc& desc, float* dst,
+                                    uint32_t threadsCount)
+{
+    assert((src && dst) || texelsCount == 0);
+
+    if (texelsCount == 0)
+        return;
+
+    threadsCount = CalculateThreadsCount(texelsCount, threadsCount);
+
+    // Note the first step reads src and the next ones work in place in dst
+    const float* stepSrc = src;
+    if (desc.m_useExposure)
+    {
+        ApplySteps<ExposureStep>(stepSrc, texelsCount, desc, dst, threadsCount);
+        stepSrc = dst;
+    }
+    if (desc.m_useColorMatrix)
+    {
+        ApplySteps<ColorMatrixStep>(stepSrc, texelsCount, desc, dst, threadsCount);
+        stepSrc = dst;
+    }
+    if (desc.m_toneCurve != ToneCurve::None || stepSrc == src)
+        SelectToneCurve<>(stepSrc, texelsCount, desc, dst, threadsCount);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Cpu version of data/shaders/colorpipeline.hlsl. The enabled steps are composed at compile time into a single
+// loop, a few texels per vector, so the chain reads and writes every texel once. It doesnt depend on d3d12.
+// Note the gpu can use fused multiply adds, so results can differ in the last bits.
+namespace ComputeBasics
+{
+
+enum class ToneCurve
+{
+    None,
+    // x / (1 + x)
+    Reinhard,
+    // Narkowicz fit of the aces filmic curve, saturates at 1
+    AcesFilmic
+};
+
+// Steps applied to the rgb of every texel, in the order of the members. Alpha is kept as it is.
+struct ColorPipelineDesc
+{
+    bool        m_useExposure;
+    // In stops, the rgb is scaled by 2^m_exposure
+    float       m_exposure;
+    bool        m_useColorMatrix;
+    // Row major 3x3 matrix multiplying the rgb as a column
+    float       m_colorMatrix[9];
+    ToneCurve   m_toneCurve;
+};
+
+// Linear rec 709 primaries to linear rec 2020 ones, both with a D65 white point
+const float g_rec709ToRec2020Matrix[9] =
+{
+    0.627404f, 0.329283f, 0.043313f,
+    0.069097f, 0.919540f, 0.011362f,
+    0.016391f, 0.088013f, 0.895595f
+};
+
+namespace Cpu
+{
+
+// Applies the enabled steps of desc to texelsCount rgba float texels, tightly packed, in a single pass.
+// dst can be src, so it can run in place on the TexRawData::m_data of ReadTexRawDataFromFile before
+// WriteTexRawDataToFile.
+// threadsCount = 0 uses all the hardware threads. Small images use less threads than requested.
+void ApplyColorPipeline(const float* src, size_t texelsCount, const ColorPipelineDesc& desc, float* dst,
+                        uint32_t threadsCount = 0);
+
+// Same result than ApplyColorPipeline with a pass over all the texels per enabled step, as running the steps
+// one after the other. Meant to measure what fusing them saves.
+void ApplyColorPipelineUnfused(const float* src, size_t texelsCount, const ColorPipelineDesc& desc, float* dst,
+                               uint32_t threadsCount = 0);
+
+}
+}
@@ -0,0 +1,136 @@
+#include "cpucommandlist.h"
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+struct WaveDispatch
+{
+    const ComputeBasics::DispatchArguments* m_arguments;
+    const ComputeBasics::Cpu::GroupKernel*  m_kernel;
+    // Groups of the dispatches before this one in the wave
+    uint64_t                                m_firstGroup;
+};
+
+void RunWaveGroups(const std::vector<WaveDispatch>& wave, std::atomic<uint64_t>& nextGroup, uint64_t groupsCount)
+{
+    for (uint64_t group = nextGroup++; group < groupsCount; group = nextGroup++)
+    {
+        const auto dispatch = std::upper_bound(wave.begin(), wave.end(), group,
+                                               [](uint64_t group, const WaveDispatch& dispatch)
+        {
+            return group < dispatch.m_firstGroup;
+        }) - 1;
+
+        const ComputeBasics::DispatchArguments& arguments = *dispatch->m_arguments;
+        const uint64_t dispatchGroup = group - dispatch->m_firstGroup;
+        const uint64_t sliceGroupsCount = static_cast<uint64_t>(arguments.m_groupsCountX) * arguments.m_groupsCountY;
+        const uint64_t sliceGroup = dispatchGroup % sliceGroupsCount;
+        (*dispatch->m_kernel)(static_cast<uint32_t>(sliceGroup % arguments.m_groupsCountX),
+                              static_cast<uint32_t>(sliceGroup / arguments.m_groupsCountX),
+                              static_cast<uint32_t>(dispatchGroup / sliceGroupsCount));
+    }
+}
+
+// Gathers the dispatches up to the next barrier and runs them as a single wave
+class WaveRunner
+{
+public:
+    explicit WaveRunner(uint32_t threadsCount) :
+        m_threadsCount(threadsCount == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : threadsCount),
+        m_groupsCount(0)
+    {
+    }
+
+    void Add(const ComputeBasics::DispatchArguments& arguments, const ComputeBasics::Cpu::GroupKernel& kernel)
+    {
+        const uint64_t groupsCount = static_cast<uint64_t>(arguments.m_groupsCountX) * arguments.m_groupsCountY *
+                                     arguments.m_groupsCountZ;
+        if (groupsCount == 0)
+            return;
+
+        m_wave.push_back({ &arguments, &kernel, m_groupsCount });
+        m_groupsCount += groupsCount;
+    }
+
+    void Run()
+    {
+        if (m_groupsCount == 0)
+            return;
+
+        const uint32_t threadsCount = static_cast<uint32_t>(std::min<uint64_t>(m_threadsCount, m_groupsCount));
+
+        // Note groups are taken one at a time so small dispatches and uneven groups dont leave threads idle
+        std::atomic<uint64_t> nextGroup(0);
+        std::vector<std::thread> threads;
+        threads.reserve(threadsCount - 1);
+        for (uint32_t t = 1; t < threadsCount; ++t)
+        {
+            threads.emplace_back([&]()
+            {
+                RunWaveGroups(m_wave, nextGroup, m_groupsCount);
+            });
+        }
+        RunWaveGroups(m_wave, nextGroup, m_groupsCount);
+
+        for (auto& thread : threads)
+            thread.join();
+
+        m_wave.clear();
+        m_groupsCount = 0;
+    }
+
+private:
+    uint32_t                    m_threadsCount;
+    std::vector<WaveDispatch>   m_wave;
+    uint64_t                    m_groupsCount;
+};
+}
+
+using namespace ComputeBasics;
+
+void Cpu::CommandList::Dispatch(const DispatchArguments& arguments, const GroupKernel& kernel)
+{
+    assert(kernel);
+    assert(arguments.m_groupsCountX <= g_maxDispatchGroupsCount && arguments.m_groupsCountY <= g_maxDispatchGroupsCount &&
+           arguments.m_groupsCountZ <= g_maxDispatchGroupsCount);
+
+    m_commands.push_back({ arguments, kernel });
+}
+
+void Cpu::CommandList::UAVBarrier()
+{
+    m_commands.push_back({ { 0, 0, 0 }, nullptr });
+}
+
+void ComputeBasics::Cpu::ExecuteCommandLists(const std::vector<CommandList>& cmdLists, uint32_t threadsCount)
+{
+    WaveRunner waveRunner(threadsCount);
+    for (const auto& cmdList : cmdLists)
+    {
+        for (const auto& command : cmdList.m_commands)
+        {
+            if (command.m_kernel)
+                waveRunner.Add(command.m_arguments, command.m_kernel);
+            else
+                waveRunner.Run();
+        }
+    }
+    waveRunner.Run();
+}
+
+void ComputeBasics::Cpu::ExecuteCommandList(const CommandList& cmdList, uint32_t threadsCount)
+{
+    WaveRunner waveRunner(threadsCount);
+    for (const auto& command : cmdList.m_commands)
+    {
+        if (command.m_kernel)
+            waveRunner.Add(command.m_arguments, command.m_kernel);
+        else
+            waveRunner.Run();
+    }
+    waveRunner.Run();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "cpuindirectdispatch.h"
+
+// Cpu version of a compute cmd list, so batches of dispatches can be recorded in parallel with
+// src/parallelrecording.h and executed in order as in the gpu. It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+namespace Cpu
+{
+
+// Recording only stores the dispatches, they run when the cmd list is executed.
+// Note a cmd list is meant to be recorded by a single thread
+class CommandList
+{
+public:
+    void Dispatch(const DispatchArguments& arguments, const GroupKernel& kernel);
+    // Same than a global uav barrier, the dispatches after it start once the ones before it are done
+    void UAVBarrier();
+
+    void Reset() { m_commands.clear(); }
+    size_t GetCommandsCount() const { return m_commands.size(); }
+
+private:
+    // Note a barrier is a command without kernel
+    struct Command
+    {
+        DispatchArguments   m_arguments;
+        GroupKernel         m_kernel;
+    };
+
+    std::vector<Command> m_commands;
+
+    friend void ExecuteCommandLists(const std::vector<CommandList>& cmdLists, uint32_t threadsCount);
+    friend void ExecuteCommandList(const CommandList& cmdList, uint32_t threadsCount);
+};
+
+// Runs the cmd lists in order. Dispatches with no barrier in between run as a single wave, their groups spread
+// over the threads in no particular order as in the gpu. There is no barrier between cmd lists either.
+// threadsCount = 0 uses all the hardware threads.
+void ExecuteCommandLists(const std::vector<CommandList>& cmdLists, uint32_t threadsCount = 0);
+
+void ExecuteCommandList(const CommandList& cmdList, uint32_t threadsCount = 0);
+
+}
+}
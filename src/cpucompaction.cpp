@@ -0,0 +1,363 @@
+#include "cpucompaction.h"
+
+#include <cassert>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX512F__)
+#define CPUCOMPACTION_AVX512 ( 1 )
+#define CPUCOMPACTION_AVX2 ( 0 )
+#define CPUCOMPACTION_SSE ( 0 )
+#include <immintrin.h>
+#elif defined(__AVX2__)
+#define CPUCOMPACTION_AVX512 ( 0 )
+#define CPUCOMPACTION_AVX2 ( 1 )
+#define CPUCOMPACTION_SSE ( 0 )
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__)
+#define CPUCOMPACTION_AVX512 ( 0 )
+#define CPUCOMPACTION_AVX2 ( 0 )
+#define CPUCOMPACTION_SSE ( 1 )
+#include <emmintrin.h>
+#else
+#define CPUCOMPACTION_AVX512 ( 0 )
+#define CPUCOMPACTION_AVX2 ( 0 )
+#define CPUCOMPACTION_SSE ( 0 )
+#endif
+
+namespace
+{
+using ComputeBasics::CompactionPredicate;
+
+// Note below this amount the cost of launching a thread is higher than the work itself
+const size_t g_minElementsPerThread = 64 * 1024;
+
+template<CompactionPredicate Predicate, typename T>
+bool Survives(T element, T value)
+{
+    return Predicate == CompactionPredicate::NotEqual ? element != value :
+           (Predicate == CompactionPredicate::Greater ? element > value : element < value);
+}
+
+uint32_t CountBits(uint32_t bits)
+{
+    bits = bits - ((bits >> 1) & 0x55555555);
+    bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+    return (((bits + (bits >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+// Vector traits. Mask returns a bit per survivor of the lanesCount elements at src.
+// CompressStore writes the survivors at dst in order and may write up to lanesCount elements.
+#if CPUCOMPACTION_AVX512
+template<typename T> struct Vector;
+
+template<> struct Vector<float>
+{
+    static const size_t lanesCount = 16;
+
+    template<CompactionPredicate Predicate>
+    static uint32_t Mask(const float* src, float value)
+    {
+        const int compare = Predicate == CompactionPredicate::NotEqual ? _CMP_NEQ_UQ :
+                            (Predicate == CompactionPredicate::Greater ? _CMP_GT_OQ : _CMP_LT_OQ);
+        return _mm512_cmp_ps_mask(_mm512_loadu_ps(src), _mm512_set1_ps(value), compare);
+    }
+
+    static void CompressStore(float* dst, const float* src, uint32_t mask)
+    {
+        _mm512_mask_compressstoreu_ps(dst, static_cast<__mmask16>(mask), _mm512_loadu_ps(src));
+    }
+};
+
+template<typename T> struct IntVector
+{
+    static const size_t lanesCount = 16;
+
+    template<CompactionPredicate Predicate>
+    static uint32_t Mask(const T* src, T value)
+    {
+        const __m512i elements = _mm512_loadu_si512(src);
+        const __m512i values = _mm512_set1_epi32(static_cast<int>(value));
+        const int compare = Predicate == CompactionPredicate::NotEqual ? _MM_CMPINT_NE :
+                            (Predicate == CompactionPredicate::Greater ? _MM_CMPINT_NLE : _MM_CMPINT_LT);
+        return std::numeric_limits<T>::is_signed ? _mm512_cmp_epi32_mask(elements, values, compare) :
+                                                   _mm512_cmp_epu32_mask(elements, values, compare);
+    }
+
+    static void CompressStore(T* dst, const T* src, uint32_t mask)
+    {
+        _mm512_mask_compressstoreu_epi32(dst, static_cast<__mmask16>(mask), _mm512_loadu_si512(src));
+    }
+};
+
+template<> struct Vector<uint32_t> : IntVector<uint32_t> {};
+template<> struct Vector<int32_t> : IntVector<int32_t> {};
+#elif CPUCOMPACTION_AVX2
+// Lanes of every 8 bits mask packed at the front, 4 bits per lane index
+struct PermutationTable
+{
+    PermutationTable()
+    {
+        for (uint32_t mask = 0; mask < 256; ++mask)
+        {
+            uint32_t packed = 0;
+            uint32_t shift = 0;
+            for (uint32_t lane = 0; lane < 8; ++lane)
+            {
+                if (mask & (1 << lane))
+                {
+                    packed |= lane << shift;
+                    shift += 4;
+                }
+            }
+            m_packedLanes[mask] = packed;
+        }
+    }
+
+    __m256i GetPermutation(uint32_t mask) const
+    {
+        const __m256i shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+        const __m256i lanes = _mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(m_packedLanes[mask])), shifts);
+        return _mm256_and_si256(lanes, _mm256_set1_epi32(0xF));
+    }
+
+    uint32_t m_packedLanes[256];
+};
+const PermutationTable g_permutationTable;
+
+template<typename T> struct Vector;
+
+template<> struct Vector<float>
+{
+    static const size_t lanesCount = 8;
+
+    template<CompactionPredicate Predicate>
+    static uint32_t Mask(const float* src, float value)
+    {
+        const __m256 elements = _mm256_loadu_ps(src);
+        const __m256 values = _mm256_set1_ps(value);
+        const __m256 compare = Predicate == CompactionPredicate::NotEqual ? _mm256_cmp_ps(elements, values, _CMP_NEQ_UQ) :
+                               (Predicate == CompactionPredicate::Greater ? _mm256_cmp_ps(elements, values, _CMP_GT_OQ) :
+                                                                            _mm256_cmp_ps(elements, values, _CMP_LT_OQ));
+        return static_cast<uint32_t>(_mm256_movemask_ps(compare));
+    }
+
+    static void CompressStore(float* dst, const float* src, uint32_t mask)
+    {
+        const __m256 packed = _mm256_permutevar8x32_ps(_mm256_loadu_ps(src), g_permutationTable.GetPermutation(mask));
+        _mm256_storeu_ps(dst, packed);
+    }
+};
+
+template<typename T> struct IntVector
+{
+    static const size_t lanesCount = 8;
+
+    // Note flipping the sign bit maps unsigned order to signed order
+    template<CompactionPredicate Predicate>
+    static uint32_t Mask(const T* src, T value)
+    {
+        const __m256i signBit = _mm256_set1_epi32(std::numeric_limits<T>::is_signed ? 0 : static_cast<int>(0x80000000));
+        const __m256i elements = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), signBit);
+        const __m256i values = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(value)), signBit);
+        const __m256i compare = Predicate == CompactionPredicate::NotEqual ?
+                                _mm256_xor_si256(_mm256_cmpeq_epi32(elements, values), _mm256_set1_epi32(-1)) :
+                                (Predicate == CompactionPredicate::Greater ? _mm256_cmpgt_epi32(elements, values) :
+                                                                             _mm256_cmpgt_epi32(values, elements));
+        return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(compare)));
+    }
+
+    static void CompressStore(T* dst, const T* src, uint32_t mask)
+    {
+        const __m256i elements = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        const __m256i packed = _mm256_permutevar8x32_epi32(elements, g_permutationTable.GetPermutation(mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), packed);
+    }
+};
+
+template<> struct Vector<uint32_t> : IntVector<uint32_t> {};
+template<> struct Vector<int32_t> : IntVector<int32_t> {};
+#elif CPUCOMPACTION_SSE
+// Note sse2 has no permutes with a variable index, every lane is stored and the output advances by its bit
+template<typename T>
+void StoreLanes(T* dst, const T* src, uint32_t mask)
+{
+    size_t n = 0;
+    dst[n] = src[0];
+    n += mask & 1;
+    dst[n] = src[1];
+    n += (mask >> 1) & 1;
+    dst[n] = src[2];
+    n += (mask >> 2) & 1;
+    dst[n] = src[3];
+}
+
+template<typename T> struct Vector;
+
+template<> struct Vector<float>
+{
+    static const size_t lanesCount = 4;
+
+    template<CompactionPredicate Predicate>
+    static uint32_t Mask(const float* src, float value)
+    {
+        const __m128 elements = _mm_loadu_ps(src);
+        const __m128 values = _mm_set1_ps(value);
+        const __m128 compare = Predicate == CompactionPredicate::NotEqual ? _mm_cmpneq_ps(elements, values) :
+                               (Predicate == CompactionPredicate::Greater ? _mm_cmpgt_ps(elements, values) :
+                                                                            _mm_cmplt_ps(elements, values));
+        return static_cast<uint32_t>(_mm_movemask_ps(compare));
+    }
+
+    static void CompressStore(float* dst, const float* src, uint32_t mask) { StoreLanes(dst, src, mask); }
+};
+
+template<typename T> struct IntVector
+{
+    static const size_t lanesCount = 4;
+
+    // Note flipping the sign bit maps unsigned order to signed order
+    template<CompactionPredicate Predicate>
+    static uint32_t Mask(const T* src, T value)
+    {
+        const __m128i signBit = _mm_set1_epi32(std::numeric_limits<T>::is_signed ? 0 : static_cast<int>(0x80000000));
+        const __m128i elements = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), signBit);
+        const __m128i values = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(value)), signBit);
+        const __m128i compare = Predicate == CompactionPredicate::NotEqual ?
+                                _mm_xor_si128(_mm_cmpeq_epi32(elements, values), _mm_set1_epi32(-1)) :
+                                (Predicate == CompactionPredicate::Greater ? _mm_cmpgt_epi32(elements, values) :
+                                                                             _mm_cmplt_epi32(elements, values));
+        return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(compare)));
+    }
+
+    static void CompressStore(T* dst, const T* src, uint32_t mask) { StoreLanes(dst, src, mask); }
+};
+
+template<> struct Vector<uint32_t> : IntVector<uint32_t> {};
+template<> struct Vector<int32_t> : IntVector<int32_t> {};
+#endif
+
+template<typename T, CompactionPredicate Predicate>
+size_t CountRange(const T* src, size_t count, T value)
+{
+    size_t survivorsCount = 0;
+    size_t i = 0;
+
+#if CPUCOMPACTION_AVX512 || CPUCOMPACTION_AVX2 || CPUCOMPACTION_SSE
+    using V = Vector<T>;
+    for (; i + V::lanesCount <= count; i += V::lanesCount)
+        survivorsCount += CountBits(V::template Mask<Predicate>(src + i, value));
+#endif
+
+    for (; i < count; ++i)
+        survivorsCount += Survives<Predicate>(src[i], value);
+
+    return survivorsCount;
+}
+
+// Writes the survivorsCount survivors of src to dst. Note nothing is written past them, so the
+// chunks of the other threads are left untouched.
+template<typename T, CompactionPredicate Predicate>
+void CompactRange(const T* src, size_t count, T value, T* dst, size_t survivorsCount)
+{
+    size_t n = 0;
+    size_t i = 0;
+
+#if CPUCOMPACTION_AVX512 || CPUCOMPACTION_AVX2 || CPUCOMPACTION_SSE
+    using V = Vector<T>;
+    for (; i + V::lanesCount <= count && n + V::lanesCount <= survivorsCount; i += V::lanesCount)
+    {
+        const uint32_t mask = V::template Mask<Predicate>(src + i, value);
+        V::CompressStore(dst + n, src + i, mask);
+        n += CountBits(mask);
+    }
+#endif
+
+    // Note once all the survivors are written the rest of the chunk cant have any
+    for (; i < count && n < survivorsCount; ++i)
+    {
+        dst[n] = src[i];
+        n += Survives<Predicate>(src[i], value);
+    }
+}
+
+template<typename T, CompactionPredicate Predicate>
+size_t CompactParallel(const T* src, size_t count, T value, T* dst, uint32_t threadsCount)
+{
+    if (threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadsCount = static_cast<uint32_t>(std::min<size_t>(threadsCount, std::max<size_t>(count / g_minElementsPerThread, 1)));
+
+    // Note the chunks are multiple of the widest vector so only the last one has a scalar tail
+    const size_t chunkSize = (count / threadsCount + 15) & ~size_t(15);
+    auto chunkBegin = [=](uint32_t t) { return std::min(t * chunkSize, count); };
+    auto chunkEnd = [=](uint32_t t) { return t + 1 == threadsCount ? count : std::min((t + 1) * chunkSize, count); };
+
+    auto forEachChunk = [&](auto work)
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(threadsCount - 1);
+        for (uint32_t t = 1; t < threadsCount; ++t)
+            threads.emplace_back([=]() { work(t); });
+        work(0);
+
+        for (auto& thread : threads)
+            thread.join();
+    };
+
+    std::vector<size_t> survivorsCounts(threadsCount);
+    forEachChunk([&](uint32_t t)
+    {
+        survivorsCounts[t] = CountRange<T, Predicate>(src + chunkBegin(t), chunkEnd(t) - chunkBegin(t), value);
+    });
+
+    std::vector<size_t> offsets(threadsCount, 0);
+    for (uint32_t t = 1; t < threadsCount; ++t)
+        offsets[t] = offsets[t - 1] + survivorsCounts[t - 1];
+
+    forEachChunk([&](uint32_t t)
+    {
+        CompactRange<T, Predicate>(src + chunkBegin(t), chunkEnd(t) - chunkBegin(t), value, dst + offsets[t],
+                                   survivorsCounts[t]);
+    });
+
+    return offsets.back() + survivorsCounts.back();
+}
+
+template<typename T>
+size_t CompactTyped(const T* src, size_t count, CompactionPredicate predicate, T value, T* dst, uint32_t threadsCount)
+{
+    assert((src && dst) || count == 0);
+    assert(dst + count <= src || src + count <= dst || count == 0);
+
+    switch (predicate)
+    {
+    case CompactionPredicate::Greater:
+        return CompactParallel<T, CompactionPredicate::Greater>(src, count, value, dst, threadsCount);
+    case CompactionPredicate::Less:
+        return CompactParallel<T, CompactionPredicate::Less>(src, count, value, dst, threadsCount);
+    default:
+        return CompactParallel<T, CompactionPredicate::NotEqual>(src, count, value, dst, threadsCount);
+    }
+}
+}
+
+size_t ComputeBasics::Cpu::Compact(const float* src, size_t count, CompactionPredicate predicate, float value, float* dst,
+                                   uint32_t threadsCount)
+{
+    return CompactTyped(src, count, predicate, value, dst, threadsCount);
+}
+
+size_t ComputeBasics::Cpu::Compact(const uint32_t* src, size_t count, CompactionPredicate predicate, uint32_t value,
+                                   uint32_t* dst, uint32_t threadsCount)
+{
+    return CompactTyped(src, count, predicate, value, dst, threadsCount);
+}
+
+size_t ComputeBasics::Cpu::Compact(const int32_t* src, size_t count, CompactionPredicate predicate, int32_t value,
+                                   int32_t* dst, uint32_t threadsCount)
+{
+    return CompactTyped(src, count, predicate, value, dst, threadsCount);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Cpu version of data/shaders/compaction.hlsl. Every thread counts the survivors of a chunk, the counts are
+// scanned and every thread compresses its chunk to its offset. The compress doesnt branch on the predicate:
+// vectors are compared at once and the survivors are packed with compress stores (avx-512), permutes (avx2)
+// or by storing every lane and advancing the output by its predicate (sse2 and scalar).
+// It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+// Elements survive when element <predicate> value
+enum class CompactionPredicate
+{
+    NotEqual,
+    Greater,
+    Less
+};
+
+namespace Cpu
+{
+
+// Writes the elements of src that survive the predicate to dst in the same order. Returns the survivors count.
+// dst has to hold count elements and cant overlap src.
+// threadsCount = 0 uses all the hardware threads. Small inputs use less threads than requested.
+size_t Compact(const float* src, size_t count, CompactionPredicate predicate, float value, float* dst,
+               uint32_t threadsCount = 0);
+size_t Compact(const uint32_t* src, size_t count, CompactionPredicate predicate, uint32_t value, uint32_t* dst,
+               uint32_t threadsCount = 0);
+size_t Compact(const int32_t* src, size_t count, CompactionPredicate predicate, int32_t value, int32_t* dst,
+               uint32_t threadsCount = 0);
+
+}
+}
@@ -0,0 +1,240 @@
+#include "cpuconvolution.h"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+
+#if defined(__AVX512F__)
+#define CPUCONVOLUTION_AVX512 ( 1 )
+#define CPUCONVOLUTION_AVX ( 0 )
+#define CPUCONVOLUTION_SSE ( 0 )
+#include <immintrin.h>
+#elif defined(__AVX__)
+#define CPUCONVOLUTION_AVX512 ( 0 )
+#define CPUCONVOLUTION_AVX ( 1 )
+#define CPUCONVOLUTION_SSE ( 0 )
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__)
+#define CPUCONVOLUTION_AVX512 ( 0 )
+#define CPUCONVOLUTION_AVX ( 0 )
+#define CPUCONVOLUTION_SSE ( 1 )
+#include <emmintrin.h>
+#else
+#define CPUCONVOLUTION_AVX512 ( 0 )
+#define CPUCONVOLUTION_AVX ( 0 )
+#define CPUCONVOLUTION_SSE ( 0 )
+#endif
+
+namespace
+{
+const size_t g_channelsCount = 4;
+// Note 32x32 rgba float texels are 16KB, so a block of the src and one of the dst fit in the l1
+const uint32_t g_transposeBlockSize = 32;
+const size_t g_windowsPerBlock = 4;
+// Note below this amount of texels the cost of launching a thread is higher than the work itself
+const size_t g_minTexelsPerThread = 64 * 1024;
+
+// Vector traits. A vector holds lanesCount / 4 consecutive rgba texels.
+#if CPUCONVOLUTION_AVX512
+struct Vector
+{
+    using Type = __m512;
+    static const size_t lanesCount = 16;
+
+    static Type Zero() { return _mm512_setzero_ps(); }
+    static Type Set(float value) { return _mm512_set1_ps(value); }
+    static Type Load(const float* src) { return _mm512_loadu_ps(src); }
+    static void Store(float* dst, Type v) { _mm512_storeu_ps(dst, v); }
+    static Type MulAdd(Type a, Type b, Type c) { return _mm512_add_ps(_mm512_mul_ps(a, b), c); }
+};
+#elif CPUCONVOLUTION_AVX
+struct Vector
+{
+    using Type = __m256;
+    static const size_t lanesCount = 8;
+
+    static Type Zero() { return _mm256_setzero_ps(); }
+    static Type Set(float value) { return _mm256_set1_ps(value); }
+    static Type Load(const float* src) { return _mm256_loadu_ps(src); }
+    static void Store(float* dst, Type v) { _mm256_storeu_ps(dst, v); }
+    static Type MulAdd(Type a, Type b, Type c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+};
+#elif CPUCONVOLUTION_SSE
+struct Vector
+{
+    using Type = __m128;
+    static const size_t lanesCount = 4;
+
+    static Type Zero() { return _mm_setzero_ps(); }
+    static Type Set(float value) { return _mm_set1_ps(value); }
+    static Type Load(const float* src) { return _mm_loadu_ps(src); }
+    static void Store(float* dst, Type v) { _mm_storeu_ps(dst, v); }
+    static Type MulAdd(Type a, Type b, Type c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+};
+#else
+struct Vector
+{
+    using Type = float;
+    static const size_t lanesCount = 1;
+
+    static Type Zero() { return 0.0f; }
+    static Type Set(float value) { return value; }
+    static Type Load(const float* src) { return *src; }
+    static void Store(float* dst, Type v) { *dst = v; }
+    static Type MulAdd(Type a, Type b, Type c) { return a * b + c; }
+};
+#endif
+
+// Note the sums are done in the same order than in the gpu, from the first tap to the last one
+void ConvolveRow(const float* row, uint32_t width, const std::vector<float>& weights, float* paddedRow, float* dst)
+{
+    const uint32_t radius = static_cast<uint32_t>(weights.size() / 2);
+
+    // Note the apron is clamped to the edges so the window never branches
+    for (uint32_t x = 0; x < radius; ++x)
+        std::copy(row, row + g_channelsCount, paddedRow + x * g_channelsCount);
+    std::copy(row, row + width * g_channelsCount, paddedRow + radius * g_channelsCount);
+    for (uint32_t x = 0; x < radius; ++x)
+    {
+        std::copy(row + (width - 1) * g_channelsCount, row + width * g_channelsCount,
+                  paddedRow + (radius + width + x) * g_channelsCount);
+    }
+
+    const size_t rowSize = width * g_channelsCount;
+    size_t i = 0;
+    // Note several windows at a time so the sums dont wait for the previous add
+    const size_t blockSize = g_windowsPerBlock * Vector::lanesCount;
+    for (; i + blockSize <= rowSize; i += blockSize)
+    {
+        Vector::Type sums[g_windowsPerBlock];
+        for (size_t w = 0; w < g_windowsPerBlock; ++w)
+            sums[w] = Vector::Zero();
+
+        for (size_t tap = 0; tap < weights.size(); ++tap)
+        {
+            const Vector::Type weight = Vector::Set(weights[tap]);
+            const float* window = paddedRow + i + tap * g_channelsCount;
+            for (size_t w = 0; w < g_windowsPerBlock; ++w)
+                sums[w] = Vector::MulAdd(weight, Vector::Load(window + w * Vector::lanesCount), sums[w]);
+        }
+
+        for (size_t w = 0; w < g_windowsPerBlock; ++w)
+            Vector::Store(dst + i + w * Vector::lanesCount, sums[w]);
+    }
+    for (; i + Vector::lanesCount <= rowSize; i += Vector::lanesCount)
+    {
+        Vector::Type sum = Vector::Zero();
+        for (size_t tap = 0; tap < weights.size(); ++tap)
+            sum = Vector::MulAdd(Vector::Set(weights[tap]), Vector::Load(paddedRow + i + tap * g_channelsCount), sum);
+        Vector::Store(dst + i, sum);
+    }
+    for (; i < rowSize; ++i)
+    {
+        float sum = 0.0f;
+        for (size_t tap = 0; tap < weights.size(); ++tap)
+            sum += weights[tap] * paddedRow[i + tap * g_channelsCount];
+        dst[i] = sum;
+    }
+}
+
+// Convolves rows [beginRow, endRow) of src, width x height texels, and writes them transposed to dst,
+// height x width texels. Rows go in bands of g_transposeBlockSize, the transposed band is written a block at a time.
+void ConvolveRowsTransposed(const float* src, uint32_t width, uint32_t height, uint32_t beginRow, uint32_t endRow,
+                            const std::vector<float>& weights, float* dst)
+{
+    const size_t radius = weights.size() / 2;
+    std::vector<float> paddedRow((width + 2 * radius) * g_channelsCount);
+    std::vector<float> band(static_cast<size_t>(g_transposeBlockSize) * width * g_channelsCount);
+
+    for (uint32_t bandRow = beginRow; bandRow < endRow; bandRow += g_transposeBlockSize)
+    {
+        const uint32_t bandRowsCount = std::min(g_transposeBlockSize, endRow - bandRow);
+        for (uint32_t y = 0; y < bandRowsCount; ++y)
+        {
+            ConvolveRow(src + static_cast<size_t>(bandRow + y) * width * g_channelsCount, width, weights, &paddedRow[0],
+                        &band[static_cast<size_t>(y) * width * g_channelsCount]);
+        }
+
+        for (uint32_t blockColumn = 0; blockColumn < width; blockColumn += g_transposeBlockSize)
+        {
+            const uint32_t blockColumnsCount = std::min(g_transposeBlockSize, width - blockColumn);
+            for (uint32_t x = 0; x < blockColumnsCount; ++x)
+            {
+                float* dstRow = dst + (static_cast<size_t>(blockColumn + x) * height + bandRow) * g_channelsCount;
+                for (uint32_t y = 0; y < bandRowsCount; ++y)
+                {
+                    const float* texel = &band[(static_cast<size_t>(y) * width + blockColumn + x) * g_channelsCount];
+                    std::copy(texel, texel + g_channelsCount, dstRow + y * g_channelsCount);
+                }
+            }
+        }
+    }
+}
+
+void ConvolveTransposed(const float* src, uint32_t width, uint32_t height, const std::vector<float>& weights, float* dst,
+                        uint32_t threadsCount)
+{
+    // Note bands of whole blocks so threads dont share cache lines of dst
+    const uint32_t blocksCount = (height + g_transposeBlockSize - 1) / g_transposeBlockSize;
+    threadsCount = std::min(threadsCount, blocksCount);
+    const uint32_t rowsPerThread = (blocksCount + threadsCount - 1) / threadsCount * g_transposeBlockSize;
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount - 1);
+    for (uint32_t t = 1; t < threadsCount; ++t)
+    {
+        const uint32_t beginRow = std::min(t * rowsPerThread, height);
+        const uint32_t endRow = std::min(beginRow + rowsPerThread, height);
+        threads.emplace_back([=, &weights]()
+        {
+            ConvolveRowsTransposed(src, width, height, beginRow, endRow, weights, dst);
+        });
+    }
+    ConvolveRowsTransposed(src, width, height, 0, std::min(rowsPerThread, height), weights, dst);
+
+    for (auto& thread : threads)
+        thread.join();
+}
+}
+
+std::vector<float> ComputeBasics::CreateGaussianWeights(uint32_t radius, float sigma)
+{
+    assert(radius <= g_maxConvolutionRadius);
+
+    if (sigma <= 0.0f)
+        sigma = std::max(radius / 3.0f, 0.5f);
+
+    std::vector<float> weights(2 * radius + 1);
+    float sum = 0.0f;
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+        const float x = static_cast<float>(i) - radius;
+        weights[i] = std::exp(-x * x / (2.0f * sigma * sigma));
+        sum += weights[i];
+    }
+    for (auto& weight : weights)
+        weight /= sum;
+
+    return weights;
+}
+
+void ComputeBasics::Cpu::ConvolveSeparable(const float* src, uint32_t width, uint32_t height,
+                                           const std::vector<float>& weights, float* dst, uint32_t threadsCount)
+{
+    assert(weights.size() % 2 == 1 && weights.size() / 2 <= g_maxConvolutionRadius);
+    assert((src && dst) || width * height == 0);
+
+    if (width == 0 || height == 0)
+        return;
+
+    if (threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    const size_t texelsCount = static_cast<size_t>(width) * height;
+    threadsCount = static_cast<uint32_t>(std::min<size_t>(threadsCount, std::max<size_t>(texelsCount / g_minTexelsPerThread, 1)));
+
+    // Note the rows pass writes the columns as rows, and the columns pass writes them back
+    std::vector<float> transposed(texelsCount * g_channelsCount);
+    ConvolveTransposed(src, width, height, weights, &transposed[0], threadsCount);
+    ConvolveTransposed(&transposed[0], height, width, weights, dst, threadsCount);
+}
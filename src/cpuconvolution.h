@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Cpu version of data/shaders/convolution.hlsl. Every pass slides a window over a copy of every row with its
+// apron, a few texels per vector, and writes the rows transposed through cache sized blocks. So the second pass
+// convolves the columns as rows and transposes them back. Edges are clamped as in the gpu.
+// It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+const uint32_t g_maxConvolutionRadius = 64;
+
+// Normalized gaussian weights of a 2 * radius + 1 kernel. sigma = 0 uses radius / 3.
+std::vector<float> CreateGaussianWeights(uint32_t radius, float sigma = 0.0f);
+
+namespace Cpu
+{
+
+// Convolves rgba float texels, tightly packed, with weights along the rows and then along the columns.
+// weights has 2 * radius + 1 elements, radius up to g_maxConvolutionRadius. dst cant overlap src.
+// threadsCount = 0 uses all the hardware threads. Small images use less threads than requested.
+void ConvolveSeparable(const float* src, uint32_t width, uint32_t height, const std::vector<float>& weights, float* dst,
+                       uint32_t threadsCount = 0);
+
+}
+}
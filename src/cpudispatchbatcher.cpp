@@ -0,0 +1,78 @@
+#include "cpudispatchbatcher.h"
+
+#include <cassert>
+
+using namespace ComputeBasics;
+
+DispatchBatchPolicy::DispatchBatchPolicy(const DispatchBatchLimits& limits) : m_limits(limits), m_jobsCount(0)
+{
+    assert(m_limits.m_maxJobsCount > 0);
+    assert(m_limits.m_maxLatencySeconds >= 0.0);
+}
+
+DispatchBatchFlushReason DispatchBatchPolicy::AddJob()
+{
+    if (m_jobsCount++ == 0)
+        m_firstJobTime = Clock::now();
+
+    return m_jobsCount >= m_limits.m_maxJobsCount ? DispatchBatchFlushReason::Size : Poll();
+}
+
+DispatchBatchFlushReason DispatchBatchPolicy::Poll() const
+{
+    if (m_jobsCount == 0)
+        return DispatchBatchFlushReason::None;
+
+    const double waitedSeconds = std::chrono::duration<double>(Clock::now() - m_firstJobTime).count();
+    if (waitedSeconds >= m_limits.m_maxLatencySeconds)
+        return DispatchBatchFlushReason::Latency;
+    return DispatchBatchFlushReason::None;
+}
+
+Cpu::DispatchBatcher::DispatchBatcher(const DispatchBatchLimits& limits, uint32_t threadsCount) :
+    m_policy(limits), m_threadsCount(threadsCount), m_stats{}
+{
+}
+
+Cpu::DispatchBatcher::~DispatchBatcher()
+{
+    Flush();
+}
+
+void Cpu::DispatchBatcher::Add(const DispatchArguments& arguments, const GroupKernel& kernel)
+{
+    m_cmdList.Dispatch(arguments, kernel);
+    ++m_stats.m_jobsCount;
+
+    const DispatchBatchFlushReason reason = m_policy.AddJob();
+    if (reason != DispatchBatchFlushReason::None)
+        Flush(reason);
+}
+
+void Cpu::DispatchBatcher::Poll()
+{
+    const DispatchBatchFlushReason reason = m_policy.Poll();
+    if (reason != DispatchBatchFlushReason::None)
+        Flush(reason);
+}
+
+void Cpu::DispatchBatcher::Flush()
+{
+    Flush(DispatchBatchFlushReason::None);
+}
+
+void Cpu::DispatchBatcher::Flush(DispatchBatchFlushReason reason)
+{
+    if (m_policy.GetJobsCount() == 0)
+        return;
+
+    ExecuteCommandList(m_cmdList, m_threadsCount);
+    m_cmdList.Reset();
+    m_policy.Reset();
+
+    ++m_stats.m_batchesCount;
+    if (reason == DispatchBatchFlushReason::Size)
+        ++m_stats.m_sizeFlushesCount;
+    else if (reason == DispatchBatchFlushReason::Latency)
+        ++m_stats.m_latencyFlushesCount;
+}
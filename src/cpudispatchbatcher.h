@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "cpucommandlist.h"
+
+// Coalescing of small jobs in batches, so they pay once for the submission and the wait instead of once per job.
+// A batch is flushed when it holds the max amount of jobs or when its oldest job waited longer than the max
+// latency. The policy is shared with the gpu batcher in src/dispatchbatcher.h. It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+struct DispatchBatchLimits
+{
+    uint32_t    m_maxJobsCount;
+    double      m_maxLatencySeconds;
+};
+
+struct DispatchBatchStats
+{
+    uint64_t    m_jobsCount;
+    uint64_t    m_batchesCount;
+    // Note the rest of the batches were flushed explicitly
+    uint64_t    m_sizeFlushesCount;
+    uint64_t    m_latencyFlushesCount;
+};
+
+enum class DispatchBatchFlushReason
+{
+    None,
+    Size,
+    Latency
+};
+
+// Tracks the open batch and tells when it has to be flushed
+class DispatchBatchPolicy
+{
+public:
+    explicit DispatchBatchPolicy(const DispatchBatchLimits& limits);
+
+    uint32_t GetJobsCount() const { return m_jobsCount; }
+
+    DispatchBatchFlushReason AddJob();
+    // Note only the latency can flush a batch with no new jobs
+    DispatchBatchFlushReason Poll() const;
+    void Reset() { m_jobsCount = 0; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    DispatchBatchLimits m_limits;
+    uint32_t            m_jobsCount;
+    Clock::time_point   m_firstJobTime;
+};
+
+namespace Cpu
+{
+
+// Cpu version of ComputeBasics::DispatchBatcher. Jobs are recorded in a cmd list and every batch runs as a single
+// wave, the groups of all its jobs spread over the threads.
+// Note jobs of a batch run at the same time, they have to be independent
+class DispatchBatcher
+{
+public:
+    // threadsCount = 0 uses all the hardware threads
+    DispatchBatcher(const DispatchBatchLimits& limits, uint32_t threadsCount = 0);
+    // Note runs the jobs left
+    ~DispatchBatcher();
+
+    // Note the batch may run, this job included, before returning
+    void Add(const DispatchArguments& arguments, const GroupKernel& kernel);
+    // Runs the batch if its oldest job waited longer than the max latency
+    void Poll();
+    // Runs the batch whatever its size
+    void Flush();
+
+    const DispatchBatchStats& GetStats() const { return m_stats; }
+
+private:
+    DispatchBatchPolicy m_policy;
+    uint32_t            m_threadsCount;
+    CommandList         m_cmdList;
+    DispatchBatchStats  m_stats;
+
+    void Flush(DispatchBatchFlushReason reason);
+};
+
+}
+}
@@ -0,0 +1,495 @@
+#include "cpufft.h"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+
+#if defined(__AVX__)
+#define CPUFFT_AVX ( 1 )
+#define CPUFFT_SSE ( 0 )
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__)
+#define CPUFFT_AVX ( 0 )
+#define CPUFFT_SSE ( 1 )
+#include <emmintrin.h>
+#else
+#define CPUFFT_AVX ( 0 )
+#define CPUFFT_SSE ( 0 )
+#endif
+
+namespace
+{
+using ComputeBasics::Cpu::Complex;
+
+const uint32_t g_maxFft1DSize = 1 << 24;
+const uint32_t g_maxFft2DSize = 8192;
+// Note 32x32 complex elements are 8KB, so a block of the src and one of the dst fit in the l1
+const size_t g_transposeBlockSize = 32;
+// Note below this amount of butterflies the cost of launching a thread is higher than the work itself
+const size_t g_minElementsPerThread = 64 * 1024;
+const double g_pi = 3.14159265358979323846;
+
+bool IsPowerOf2(uint32_t value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+Complex Polar(double angle)
+{
+    return { static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)) };
+}
+
+// Runs function(begin, end) over [0, count) split in threadsCount ranges of multiples of granularity
+template<typename Function>
+void ParallelFor(size_t count, size_t granularity, uint32_t threadsCount, Function function)
+{
+    const size_t unitsCount = (count + granularity - 1) / granularity;
+    threadsCount = static_cast<uint32_t>(std::min<size_t>(std::max(threadsCount, 1u), std::max<size_t>(unitsCount, 1)));
+    const size_t rangeSize = (unitsCount + threadsCount - 1) / threadsCount * granularity;
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount - 1);
+    for (uint32_t t = 1; t < threadsCount; ++t)
+    {
+        const size_t begin = std::min(t * rangeSize, count);
+        const size_t end = std::min(begin + rangeSize, count);
+        threads.emplace_back(function, begin, end);
+    }
+    function(0, std::min(rangeSize, count));
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+// Complex vector traits. A vector holds count consecutive complex elements.
+struct ScalarComplex
+{
+    using Type = Complex;
+    static const size_t count = 1;
+
+    static Type Load(const Complex* src) { return *src; }
+    static void Store(Complex* dst, Type v) { *dst = v; }
+    static Type Set(Complex c) { return c; }
+    static Type Add(Type a, Type b) { return { a.m_re + b.m_re, a.m_im + b.m_im }; }
+    static Type Sub(Type a, Type b) { return { a.m_re - b.m_re, a.m_im - b.m_im }; }
+    static Type Mul(Type a, Type b) { return { a.m_re * b.m_re - a.m_im * b.m_im, a.m_im * b.m_re + a.m_re * b.m_im }; }
+    static Type MulConj(Type a, Type b) { return { a.m_re * b.m_re + a.m_im * b.m_im, a.m_im * b.m_re - a.m_re * b.m_im }; }
+    static Type MulI(Type a) { return { -a.m_im, a.m_re }; }
+    static Type MulNegI(Type a) { return { a.m_im, -a.m_re }; }
+};
+
+#if CPUFFT_AVX
+struct VectorComplex
+{
+    using Type = __m256;
+    static const size_t count = 4;
+
+    static Type Load(const Complex* src) { return _mm256_loadu_ps(&src->m_re); }
+    static void Store(Complex* dst, Type v) { _mm256_storeu_ps(&dst->m_re, v); }
+    static Type Set(Complex c) { return _mm256_setr_ps(c.m_re, c.m_im, c.m_re, c.m_im, c.m_re, c.m_im, c.m_re, c.m_im); }
+    static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+    static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+    static Type Swap(Type a) { return _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1)); }
+    static Type Mul(Type a, Type b)
+    {
+        const Type re = _mm256_moveldup_ps(b);
+        const Type im = _mm256_movehdup_ps(b);
+        return _mm256_addsub_ps(_mm256_mul_ps(a, re), _mm256_mul_ps(Swap(a), im));
+    }
+    static Type MulConj(Type a, Type b)
+    {
+        const Type re = _mm256_moveldup_ps(b);
+        const Type im = _mm256_movehdup_ps(b);
+        return Swap(_mm256_addsub_ps(_mm256_mul_ps(Swap(a), re), _mm256_mul_ps(a, im)));
+    }
+    static Type MulI(Type a) { return _mm256_addsub_ps(_mm256_setzero_ps(), Swap(a)); }
+    static Type MulNegI(Type a) { return Swap(_mm256_addsub_ps(_mm256_setzero_ps(), a)); }
+};
+#elif CPUFFT_SSE
+struct VectorComplex
+{
+    using Type = __m128;
+    static const size_t count = 2;
+
+    static Type Load(const Complex* src) { return _mm_loadu_ps(&src->m_re); }
+    static void Store(Complex* dst, Type v) { _mm_storeu_ps(&dst->m_re, v); }
+    static Type Set(Complex c) { return _mm_setr_ps(c.m_re, c.m_im, c.m_re, c.m_im); }
+    static Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+    static Type Sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+    static Type Swap(Type a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)); }
+    // Note sse2 doesnt have addsub, the signs are applied with a multiply
+    static Type Mul(Type a, Type b)
+    {
+        const Type re = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0));
+        const Type im = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+        return _mm_add_ps(_mm_mul_ps(a, re), _mm_mul_ps(_mm_mul_ps(Swap(a), im), _mm_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f)));
+    }
+    static Type MulConj(Type a, Type b)
+    {
+        const Type re = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0));
+        const Type im = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+        return _mm_add_ps(_mm_mul_ps(a, re), _mm_mul_ps(_mm_mul_ps(Swap(a), im), _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f)));
+    }
+    static Type MulI(Type a) { return _mm_mul_ps(Swap(a), _mm_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f)); }
+    static Type MulNegI(Type a) { return _mm_mul_ps(Swap(a), _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f)); }
+};
+#else
+using VectorComplex = ScalarComplex;
+#endif
+
+// Multiplies by exp(-i pi / 2) forward and by exp(i pi / 2) inverse
+template<typename V, bool Inverse>
+typename V::Type RotateQuarter(typename V::Type a)
+{
+    return Inverse ? V::MulI(a) : V::MulNegI(a);
+}
+
+template<typename V, bool Inverse>
+void Butterfly2(typename V::Type* v)
+{
+    const typename V::Type v0 = v[0];
+    v[0] = V::Add(v0, v[1]);
+    v[1] = V::Sub(v0, v[1]);
+}
+
+template<typename V, bool Inverse>
+void Butterfly4(typename V::Type* v)
+{
+    const typename V::Type t0 = V::Add(v[0], v[2]);
+    const typename V::Type t1 = V::Sub(v[0], v[2]);
+    const typename V::Type t2 = V::Add(v[1], v[3]);
+    const typename V::Type t3 = RotateQuarter<V, Inverse>(V::Sub(v[1], v[3]));
+    v[0] = V::Add(t0, t2);
+    v[1] = V::Add(t1, t3);
+    v[2] = V::Sub(t0, t2);
+    v[3] = V::Sub(t1, t3);
+}
+
+// Note two radix 4 butterflies of the even and odd elements combined with the eighth roots of unity
+template<typename V, bool Inverse>
+void Butterfly8(typename V::Type* v)
+{
+    const float sqrtHalf = 0.70710678118654752f;
+    const float sign = Inverse ? 1.0f : -1.0f;
+
+    typename V::Type even[4] = { v[0], v[2], v[4], v[6] };
+    typename V::Type odd[4] = { v[1], v[3], v[5], v[7] };
+    Butterfly4<V, Inverse>(even);
+    Butterfly4<V, Inverse>(odd);
+    odd[1] = V::Mul(odd[1], V::Set({ sqrtHalf, sign * sqrtHalf }));
+    odd[2] = RotateQuarter<V, Inverse>(odd[2]);
+    odd[3] = V::Mul(odd[3], V::Set({ -sqrtHalf, sign * sqrtHalf }));
+
+    for (size_t k = 0; k < 4; ++k)
+    {
+        v[k] = V::Add(even[k], odd[k]);
+        v[k + 4] = V::Sub(even[k], odd[k]);
+    }
+}
+
+// Butterflies [jBegin, jEnd) of a Stockham stage. Every butterfly combines the elements j + r * size / R of R
+// transforms of stride elements into a transform of stride * R elements.
+template<typename V, bool Inverse, size_t R>
+void Stage(const Complex* src, Complex* dst, size_t size, size_t stride, const Complex* twiddles, size_t jBegin,
+           size_t jEnd)
+{
+    const size_t srcStride = size / R;
+    for (size_t j = jBegin; j < jEnd; j += V::count)
+    {
+        // Note the count butterflies of a vector share the transform since stride is a multiple of count
+        const size_t k = j % stride;
+
+        typename V::Type v[R];
+        v[0] = V::Load(src + j);
+        for (size_t r = 1; r < R; ++r)
+        {
+            const typename V::Type twiddle = V::Load(twiddles + (r - 1) * stride + k);
+            const typename V::Type element = V::Load(src + j + r * srcStride);
+            v[r] = Inverse ? V::MulConj(element, twiddle) : V::Mul(element, twiddle);
+        }
+
+        if (R == 8)
+            Butterfly8<V, Inverse>(v);
+        else if (R == 4)
+            Butterfly4<V, Inverse>(v);
+        else
+            Butterfly2<V, Inverse>(v);
+
+        const size_t dstIndex = (j - k) * R + k;
+        for (size_t r = 0; r < R; ++r)
+            V::Store(dst + dstIndex + r * stride, v[r]);
+    }
+}
+
+template<bool Inverse, size_t R>
+void Stage(const Complex* src, Complex* dst, size_t size, size_t stride, const Complex* twiddles, size_t jBegin,
+           size_t jEnd)
+{
+    if (stride % VectorComplex::count == 0 && (jEnd - jBegin) % VectorComplex::count == 0)
+        Stage<VectorComplex, Inverse, R>(src, dst, size, stride, twiddles, jBegin, jEnd);
+    else
+        Stage<ScalarComplex, Inverse, R>(src, dst, size, stride, twiddles, jBegin, jEnd);
+}
+
+template<bool Inverse>
+void Stage(uint32_t radix, const Complex* src, Complex* dst, size_t size, size_t stride, const Complex* twiddles,
+           size_t jBegin, size_t jEnd)
+{
+    switch (radix)
+    {
+    case 8:
+        Stage<Inverse, 8>(src, dst, size, stride, twiddles, jBegin, jEnd);
+        break;
+    case 4:
+        Stage<Inverse, 4>(src, dst, size, stride, twiddles, jBegin, jEnd);
+        break;
+    default:
+        Stage<Inverse, 2>(src, dst, size, stride, twiddles, jBegin, jEnd);
+        break;
+    }
+}
+
+void Stage(uint32_t radix, const Complex* src, Complex* dst, size_t size, size_t stride, const Complex* twiddles,
+           ComputeBasics::FftDirection direction, size_t jBegin, size_t jEnd)
+{
+    if (direction == ComputeBasics::FftDirection::Inverse)
+        Stage<true>(radix, src, dst, size, stride, twiddles, jBegin, jEnd);
+    else
+        Stage<false>(radix, src, dst, size, stride, twiddles, jBegin, jEnd);
+}
+
+// Transposes rows x columns elements of src into columns x rows elements of dst, a block at a time
+void Transpose(const Complex* src, size_t rows, size_t columns, Complex* dst, uint32_t threadsCount)
+{
+    ParallelFor(rows, g_transposeBlockSize, threadsCount, [=](size_t beginRow, size_t endRow)
+    {
+        for (size_t blockRow = beginRow; blockRow < endRow; blockRow += g_transposeBlockSize)
+        {
+            const size_t blockRowsCount = std::min(g_transposeBlockSize, endRow - blockRow);
+            for (size_t blockColumn = 0; blockColumn < columns; blockColumn += g_transposeBlockSize)
+            {
+                const size_t blockColumnsCount = std::min(g_transposeBlockSize, columns - blockColumn);
+                for (size_t x = 0; x < blockColumnsCount; ++x)
+                {
+                    for (size_t y = 0; y < blockRowsCount; ++y)
+                        dst[(blockColumn + x) * rows + blockRow + y] = src[(blockRow + y) * columns + blockColumn + x];
+                }
+            }
+        }
+    });
+}
+}
+
+using namespace ComputeBasics;
+
+bool ComputeBasics::IsValidFftDesc(const FftDesc& desc)
+{
+    const uint32_t minWidth = desc.m_type == FftType::RealToComplex ? 4 : 2;
+    if (!IsPowerOf2(desc.m_width) || !IsPowerOf2(desc.m_height) || desc.m_width < minWidth)
+        return false;
+
+    if (desc.m_height == 1)
+        return desc.m_width <= g_maxFft1DSize;
+
+    return desc.m_width <= g_maxFft2DSize && desc.m_height <= g_maxFft2DSize;
+}
+
+uint32_t ComputeBasics::CalculateFftComplexWidth(const FftDesc& desc)
+{
+    return desc.m_type == FftType::RealToComplex ? desc.m_width / 2 + 1 : desc.m_width;
+}
+
+std::vector<uint32_t> ComputeBasics::CalculateFftRadices(uint32_t size)
+{
+    assert(IsPowerOf2(size));
+
+    uint32_t log2Size = 0;
+    while ((1u << log2Size) < size)
+        ++log2Size;
+
+    // Note the small radix goes first, its stage has a single transform per butterfly and no twiddles
+    std::vector<uint32_t> radices;
+    if (log2Size % 3 != 0)
+        radices.push_back(1u << (log2Size % 3));
+    radices.insert(radices.end(), log2Size / 3, 8u);
+
+    return radices;
+}
+
+std::vector<Cpu::Complex> Cpu::CalculateFftTwiddles(uint32_t size)
+{
+    // Note exp(-2 pi i r k / (stride * R)) multiplies the element r of the transform k of a stage
+    std::vector<Complex> twiddles;
+    size_t stride = 1;
+    for (uint32_t radix : CalculateFftRadices(size))
+    {
+        for (size_t r = 1; r < radix; ++r)
+        {
+            for (size_t k = 0; k < stride; ++k)
+                twiddles.push_back(Polar(-2.0 * g_pi * r * k / (stride * radix)));
+        }
+        stride *= radix;
+    }
+
+    return twiddles;
+}
+
+std::vector<Cpu::Complex> Cpu::CalculateFftRealTwiddles(uint32_t width)
+{
+    assert(IsPowerOf2(width));
+
+    std::vector<Complex> twiddles(width / 2 + 1);
+    for (size_t k = 0; k < twiddles.size(); ++k)
+        twiddles[k] = Polar(-2.0 * g_pi * k / width);
+
+    return twiddles;
+}
+
+Cpu::FftPlan::FftPlan(const FftDesc& desc) : m_desc(desc)
+{
+    assert(IsValidFftDesc(m_desc));
+
+    const bool isReal = m_desc.m_type == FftType::RealToComplex;
+    m_rowStages = CreateStages(isReal ? m_desc.m_width / 2 : m_desc.m_width);
+    if (m_desc.m_height > 1)
+        m_columnStages = CreateStages(m_desc.m_height);
+
+    if (isReal)
+        m_realTwiddles = CalculateFftRealTwiddles(m_desc.m_width);
+}
+
+Cpu::FftPlan::Stages Cpu::FftPlan::CreateStages(uint32_t size)
+{
+    return { CalculateFftRadices(size), CalculateFftTwiddles(size) };
+}
+
+void Cpu::FftPlan::TransformRows(const Stages& stages, uint32_t size, Complex* data, uint32_t rowsCount,
+                                 FftDirection direction, uint32_t threadsCount)
+{
+    const size_t rowsPerThread = std::max<size_t>(g_minElementsPerThread / size, 1);
+    threadsCount = static_cast<uint32_t>(std::min<size_t>(threadsCount, (rowsCount + rowsPerThread - 1) / rowsPerThread));
+    const uint32_t stageThreadsCount = rowsCount == 1 ?
+                                       static_cast<uint32_t>(std::min<size_t>(threadsCount, size / g_minElementsPerThread)) : 1;
+    const bool isParallelStage = stageThreadsCount > 1;
+
+    // Note a single row splits every stage among the threads, several rows go a row per thread
+    ParallelFor(rowsCount, 1, isParallelStage ? 1 : threadsCount, [&](size_t beginRow, size_t endRow)
+    {
+        std::vector<Complex> scratch(size);
+        for (size_t row = beginRow; row < endRow; ++row)
+        {
+            Complex* src = data + row * size;
+            Complex* dst = &scratch[0];
+            size_t stride = 1;
+            const Complex* twiddles = stages.m_twiddles.empty() ? nullptr : &stages.m_twiddles[0];
+            for (uint32_t radix : stages.m_radices)
+            {
+                const size_t butterfliesCount = size / radix;
+                ParallelFor(butterfliesCount, VectorComplex::count, std::max(stageThreadsCount, 1u),
+                            [&](size_t jBegin, size_t jEnd)
+                {
+                    Stage(radix, src, dst, size, stride, twiddles, direction, jBegin, jEnd);
+                });
+
+                twiddles += (radix - 1) * stride;
+                stride *= radix;
+                std::swap(src, dst);
+            }
+
+            if (src != data + row * size)
+                std::copy(src, src + size, data + row * size);
+        }
+    });
+}
+
+void Cpu::FftPlan::PostprocessReal(const Complex* src, Complex* dst) const
+{
+    // Note the even and odd elements were transformed as the real and imaginary parts of a half size transform
+    const size_t halfWidth = m_desc.m_width / 2;
+    for (size_t k = 0; k <= halfWidth; ++k)
+    {
+        const Complex z = src[k % halfWidth];
+        const Complex zConj = { src[(halfWidth - k) % halfWidth].m_re, -src[(halfWidth - k) % halfWidth].m_im };
+        const Complex even = { 0.5f * (z.m_re + zConj.m_re), 0.5f * (z.m_im + zConj.m_im) };
+        // Note (z - zConj) * -i / 2
+        const Complex odd = { 0.5f * (z.m_im - zConj.m_im), -0.5f * (z.m_re - zConj.m_re) };
+        const Complex rotatedOdd = ScalarComplex::Mul(odd, m_realTwiddles[k]);
+        dst[k] = { even.m_re + rotatedOdd.m_re, even.m_im + rotatedOdd.m_im };
+    }
+}
+
+void Cpu::FftPlan::PreprocessReal(const Complex* src, Complex* dst) const
+{
+    // Note undoes PostprocessReal scaled by 2, so the inverse transform scales by m_width as complex ones do
+    const size_t halfWidth = m_desc.m_width / 2;
+    for (size_t k = 0; k < halfWidth; ++k)
+    {
+        const Complex x = src[k];
+        const Complex xConj = { src[halfWidth - k].m_re, -src[halfWidth - k].m_im };
+        const Complex even = { x.m_re + xConj.m_re, x.m_im + xConj.m_im };
+        const Complex odd = ScalarComplex::MulConj({ x.m_re - xConj.m_re, x.m_im - xConj.m_im }, m_realTwiddles[k]);
+        // Note even + i * odd
+        dst[k] = { even.m_re - odd.m_im, even.m_im + odd.m_re };
+    }
+}
+
+void Cpu::FftPlan::Execute(const void* src, void* dst, FftDirection direction, uint32_t threadsCount) const
+{
+    assert(src && dst);
+
+    if (threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    const uint32_t width = m_desc.m_width;
+    const uint32_t height = m_desc.m_height;
+    const uint32_t complexWidth = CalculateFftComplexWidth(m_desc);
+    const size_t complexCount = static_cast<size_t>(complexWidth) * height;
+    const bool isReal = m_desc.m_type == FftType::RealToComplex;
+
+    auto transformColumns = [&](Complex* data)
+    {
+        if (height == 1)
+            return;
+
+        std::vector<Complex> transposed(complexCount);
+        Transpose(data, height, complexWidth, &transposed[0], threadsCount);
+        TransformRows(m_columnStages, height, &transposed[0], complexWidth, direction, threadsCount);
+        Transpose(&transposed[0], complexWidth, height, data, threadsCount);
+    };
+
+    if (!isReal)
+    {
+        Complex* data = static_cast<Complex*>(dst);
+        if (src != dst)
+            std::copy(static_cast<const Complex*>(src), static_cast<const Complex*>(src) + complexCount, data);
+        TransformRows(m_rowStages, width, data, height, direction, threadsCount);
+        transformColumns(data);
+        return;
+    }
+
+    // Note a row of real elements is a row of half as many complex ones
+    const uint32_t halfWidth = width / 2;
+    if (direction == FftDirection::Forward)
+    {
+        const Complex* packed = static_cast<const Complex*>(src);
+        std::vector<Complex> rows(packed, packed + static_cast<size_t>(halfWidth) * height);
+        TransformRows(m_rowStages, halfWidth, &rows[0], height, direction, threadsCount);
+
+        Complex* data = static_cast<Complex*>(dst);
+        for (size_t row = 0; row < height; ++row)
+            PostprocessReal(&rows[row * halfWidth], data + row * complexWidth);
+        transformColumns(data);
+    }
+    else
+    {
+        const Complex* spectrum = static_cast<const Complex*>(src);
+        std::vector<Complex> columns(spectrum, spectrum + complexCount);
+        transformColumns(&columns[0]);
+
+        Complex* data = static_cast<Complex*>(dst);
+        for (size_t row = 0; row < height; ++row)
+            PreprocessReal(&columns[row * complexWidth], data + row * halfWidth);
+        TransformRows(m_rowStages, halfWidth, data, height, direction, threadsCount);
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Cpu version of data/shaders/fft.hlsl. Stockham transforms made of radix 8 stages, plus a radix 4 or 2 one,
+// that read and write the whole transform from one buffer to another so the output comes out in order without
+// a bit reversal. Every stage computes consecutive butterflies at once with sse or avx. Columns of 2d transforms are
+// transposed to rows and back. It doesnt depend on d3d12.
+// Note the sums are done in a different order than in the gpu so they can differ in the last bits.
+namespace ComputeBasics
+{
+
+enum class FftType
+{
+    ComplexToComplex,
+    // Forward transforms are real to complex and inverse ones complex to real
+    RealToComplex
+};
+
+enum class FftDirection
+{
+    Forward,
+    Inverse
+};
+
+// Note 1d transforms have m_height = 1. Sizes are powers of 2, up to 2^24 for 1d transforms and up to 8192
+// per dimension for 2d ones. Real transforms need m_width >= 4.
+struct FftDesc
+{
+    FftType     m_type;
+    uint32_t    m_width;
+    uint32_t    m_height;
+};
+
+bool IsValidFftDesc(const FftDesc& desc);
+
+// Complex elements per row of the complex side of the transform, m_width / 2 + 1 for real transforms
+uint32_t CalculateFftComplexWidth(const FftDesc& desc);
+
+// Radices of the stages of a transform of size elements, from the first stage to the last one
+std::vector<uint32_t> CalculateFftRadices(uint32_t size);
+
+namespace Cpu
+{
+
+// Interleaved real and imaginary parts, as float2 in the gpu
+struct Complex
+{
+    float m_re;
+    float m_im;
+};
+
+// Twiddles of the stages of a transform of size elements, as used by FftPlan and data/shaders/fft.hlsl.
+// (radix - 1) x stride twiddles per stage one after the other, stride being the product of the previous radices.
+std::vector<Complex> CalculateFftTwiddles(uint32_t size);
+
+// exp(-2 pi i k / width) for k in [0, width / 2], combining the two halves of real transforms
+std::vector<Complex> CalculateFftRealTwiddles(uint32_t width);
+
+// Caches the twiddles of a transform to run it many times.
+// Complex data is interleaved and rows are tightly packed. Inverse transforms arent scaled, so a forward and an
+// inverse one scale the data by m_width * m_height.
+class FftPlan
+{
+public:
+    FftPlan(const FftDesc& desc);
+
+    const FftDesc& GetDesc() const { return m_desc; }
+
+    // Complex transforms read and write m_width x m_height complex elements.
+    // Real forward transforms read m_width x m_height floats and write CalculateFftComplexWidth x m_height complex
+    // elements, the other half of the spectrum being the conjugate of this one. Real inverse ones do the reverse.
+    // src and dst can be the same buffer for complex transforms.
+    // threadsCount = 0 uses all the hardware threads. Small transforms use less threads than requested.
+    void Execute(const void* src, void* dst, FftDirection direction, uint32_t threadsCount = 0) const;
+
+private:
+    // Twiddles of the stages of a transform of a size
+    struct Stages
+    {
+        std::vector<uint32_t>   m_radices;
+        std::vector<Complex>    m_twiddles;
+    };
+
+    FftDesc                 m_desc;
+    Stages                  m_rowStages;
+    Stages                  m_columnStages;
+    std::vector<Complex>    m_realTwiddles;
+
+    static Stages CreateStages(uint32_t size);
+    static void TransformRows(const Stages& stages, uint32_t size, Complex* data, uint32_t rowsCount,
+                              FftDirection direction, uint32_t threadsCount);
+    void PostprocessReal(const Complex* src, Complex* dst) const;
+    void PreprocessReal(const Complex* src, Complex* dst) const;
+};
+
+}
+}
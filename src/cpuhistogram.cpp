@@ -0,0 +1,147 @@
+#include "cpuhistogram.h"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+// Note below this amount the cost of launching a thread is higher than the work itself
+const size_t g_minTexelsPerThread = 64 * 1024;
+
+// Log2 of the range computed once instead of per texel
+struct BinMapping
+{
+    BinMapping(const ComputeBasics::HistogramDesc& desc) :
+        m_minLuminance(desc.m_minLuminance), m_minLog2(std::log2(desc.m_minLuminance)),
+        m_scale(desc.m_binsCount / (std::log2(desc.m_maxLuminance) - m_minLog2)), m_lastBin(desc.m_binsCount - 1)
+    {
+        assert(desc.m_binsCount > 0);
+        assert(desc.m_minLuminance > 0.0f && desc.m_minLuminance < desc.m_maxLuminance);
+    }
+
+    // Note written so nans go to the first bin. The bin is clamped as a float, converting infinities or values
+    // out of the uint32_t range is undefined, the gpu saturates them to the last bin.
+    uint32_t GetBin(float luminance) const
+    {
+        if (!(luminance > m_minLuminance))
+            return 0;
+        const float bin = (std::log2(luminance) - m_minLog2) * m_scale;
+        return static_cast<uint32_t>(std::min(bin, static_cast<float>(m_lastBin)));
+    }
+
+    float       m_minLuminance;
+    float       m_minLog2;
+    float       m_scale;
+    uint32_t    m_lastBin;
+};
+
+void AccumulateRows(const float* rgba, uint32_t width, uint32_t beginRow, uint32_t endRow,
+                    const BinMapping& binMapping, std::vector<uint32_t>& bins)
+{
+    const float* texel = rgba + static_cast<size_t>(beginRow) * width * 4;
+    const float* end = rgba + static_cast<size_t>(endRow) * width * 4;
+    for (; texel != end; texel += 4)
+    {
+        const float luminance = ComputeBasics::CalculateLuminance(texel[0], texel[1], texel[2]);
+        ++bins[binMapping.GetBin(luminance)];
+    }
+}
+}
+
+float ComputeBasics::CalculateLuminance(float r, float g, float b)
+{
+    return 0.2126f * r + 0.7152f * g + 0.0722f * b;
+}
+
+uint32_t ComputeBasics::CalculateHistogramBin(float luminance, const HistogramDesc& desc)
+{
+    return BinMapping(desc).GetBin(luminance);
+}
+
+float ComputeBasics::CalculateHistogramBinLuminance(float bin, const HistogramDesc& desc)
+{
+    const float minLog2 = std::log2(desc.m_minLuminance);
+    const float log2Range = std::log2(desc.m_maxLuminance) - minLog2;
+    return std::exp2(minLog2 + bin / desc.m_binsCount * log2Range);
+}
+
+std::vector<uint32_t> ComputeBasics::Cpu::CalculateLuminanceHistogram(const float* rgba, uint32_t width, uint32_t height,
+                                                                      const HistogramDesc& desc, uint32_t threadsCount)
+{
+    assert(rgba || width * height == 0);
+
+    const BinMapping binMapping(desc);
+
+    if (threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    const size_t texelsCount = static_cast<size_t>(width) * height;
+    const size_t maxThreadsCount = std::min<size_t>(std::max<size_t>(texelsCount / g_minTexelsPerThread, 1),
+                                                    std::max(height, 1u));
+    threadsCount = static_cast<uint32_t>(std::min<size_t>(threadsCount, maxThreadsCount));
+
+    // Note a histogram per thread so there is no contention, merged at the end
+    std::vector<std::vector<uint32_t>> threadsBins(threadsCount, std::vector<uint32_t>(desc.m_binsCount, 0));
+    const uint32_t rowsPerThread = (height + threadsCount - 1) / threadsCount;
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount - 1);
+    for (uint32_t t = 1; t < threadsCount; ++t)
+    {
+        const uint32_t beginRow = std::min(t * rowsPerThread, height);
+        const uint32_t endRow = std::min(beginRow + rowsPerThread, height);
+        threads.emplace_back([=, &binMapping, &threadsBins]()
+        {
+            AccumulateRows(rgba, width, beginRow, endRow, binMapping, threadsBins[t]);
+        });
+    }
+    AccumulateRows(rgba, width, 0, std::min(rowsPerThread, height), binMapping, threadsBins[0]);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    std::vector<uint32_t>& bins = threadsBins[0];
+    for (uint32_t t = 1; t < threadsCount; ++t)
+    {
+        for (uint32_t i = 0; i < desc.m_binsCount; ++i)
+            bins[i] += threadsBins[t][i];
+    }
+
+    return std::move(bins);
+}
+
+std::vector<float> ComputeBasics::Cpu::CalculatePercentiles(const std::vector<uint32_t>& bins, const HistogramDesc& desc,
+                                                            const std::vector<float>& percentiles)
+{
+    assert(bins.size() == desc.m_binsCount);
+
+    std::vector<uint32_t> cumulative(bins.size());
+    uint32_t total = 0;
+    for (size_t i = 0; i < bins.size(); ++i)
+    {
+        total += bins[i];
+        cumulative[i] = total;
+    }
+
+    std::vector<float> results(percentiles.size(), 0.0f);
+    if (total == 0)
+        return results;
+
+    for (size_t p = 0; p < percentiles.size(); ++p)
+    {
+        // Note at least the first texel so empty leading bins are skipped
+        const float target = std::min(std::max(percentiles[p] * total, 1.0f), static_cast<float>(total));
+        for (size_t i = 0; i < bins.size(); ++i)
+        {
+            if (static_cast<float>(cumulative[i]) >= target)
+            {
+                const float previous = static_cast<float>(cumulative[i] - bins[i]);
+                const float binFraction = (target - previous) / bins[i];
+                results[p] = CalculateHistogramBinLuminance(static_cast<float>(i) + binFraction, desc);
+                break;
+            }
+        }
+    }
+
+    return results;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Cpu version of data/shaders/histogram.hlsl. Every thread builds the histogram of a band of rows and the
+// histograms are merged at the end. It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+// Luminance histogram with log2 scale bins between m_minLuminance and m_maxLuminance. Luminances below the
+// range, zero, negative or nan go to the first bin and the ones above the range go to the last bin.
+struct HistogramDesc
+{
+    uint32_t    m_binsCount;
+    float       m_minLuminance;
+    float       m_maxLuminance;
+};
+
+// Rec. 709 luminance of a linear rgb texel
+float CalculateLuminance(float r, float g, float b);
+
+uint32_t CalculateHistogramBin(float luminance, const HistogramDesc& desc);
+
+// Luminance at a fractional bin position. 0 is the lower edge of the first bin and m_binsCount the upper edge
+// of the last one.
+float CalculateHistogramBinLuminance(float bin, const HistogramDesc& desc);
+
+namespace Cpu
+{
+
+// Histogram of the luminance of width * height rgba float texels, tightly packed.
+// threadsCount = 0 uses all the hardware threads. Small images use less threads than requested.
+std::vector<uint32_t> CalculateLuminanceHistogram(const float* rgba, uint32_t width, uint32_t height,
+                                                  const HistogramDesc& desc, uint32_t threadsCount = 0);
+
+// Luminance below which percentiles[i] (0..1) of the texels are, interpolated inside the bins.
+// Same search than the gpu percentiles pass.
+std::vector<float> CalculatePercentiles(const std::vector<uint32_t>& bins, const HistogramDesc& desc,
+                                        const std::vector<float>& percentiles);
+
+}
+}
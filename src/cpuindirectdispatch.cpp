@@ -0,0 +1,133 @@
+#include "cpuindirectdispatch.h"
+
+#include <cassert>
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "The counts have to keep the layout of a uint buffer");
+
+uint32_t ToIndex(uint32_t offsetBytes)
+{
+    assert(offsetBytes % sizeof(uint32_t) == 0);
+    return offsetBytes / sizeof(uint32_t);
+}
+
+void RunGroups(const ComputeBasics::DispatchArguments& arguments, const ComputeBasics::Cpu::GroupKernel& kernel,
+               std::atomic<uint64_t>& nextGroup, uint64_t groupsCount)
+{
+    const uint64_t sliceGroupsCount = static_cast<uint64_t>(arguments.m_groupsCountX) * arguments.m_groupsCountY;
+    for (uint64_t group = nextGroup++; group < groupsCount; group = nextGroup++)
+    {
+        const uint64_t sliceGroup = group % sliceGroupsCount;
+        kernel(static_cast<uint32_t>(sliceGroup % arguments.m_groupsCountX),
+               static_cast<uint32_t>(sliceGroup / arguments.m_groupsCountX),
+               static_cast<uint32_t>(group / sliceGroupsCount));
+    }
+}
+}
+
+using namespace ComputeBasics;
+
+DispatchArguments ComputeBasics::CalculateDispatchArguments(uint32_t elementsCount, uint32_t groupSize)
+{
+    assert(groupSize > 0);
+
+    // Note written so it doesnt overflow with counts close to the uint max
+    const uint32_t groupsCount = elementsCount / groupSize + (elementsCount % groupSize != 0 ? 1 : 0);
+    return { std::min(groupsCount, g_maxDispatchGroupsCount), 1, 1 };
+}
+
+void ComputeBasics::Cpu::Dispatch(const DispatchArguments& arguments, const GroupKernel& kernel, uint32_t threadsCount)
+{
+    assert(kernel);
+    assert(arguments.m_groupsCountX <= g_maxDispatchGroupsCount && arguments.m_groupsCountY <= g_maxDispatchGroupsCount &&
+           arguments.m_groupsCountZ <= g_maxDispatchGroupsCount);
+
+    const uint64_t groupsCount = static_cast<uint64_t>(arguments.m_groupsCountX) * arguments.m_groupsCountY *
+                                 arguments.m_groupsCountZ;
+    if (groupsCount == 0)
+        return;
+
+    if (threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadsCount = static_cast<uint32_t>(std::min<uint64_t>(threadsCount, groupsCount));
+
+    // Note groups are taken one at a time so uneven groups dont leave threads idle
+    std::atomic<uint64_t> nextGroup(0);
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount - 1);
+    for (uint32_t t = 1; t < threadsCount; ++t)
+    {
+        threads.emplace_back([&]()
+        {
+            RunGroups(arguments, kernel, nextGroup, groupsCount);
+        });
+    }
+    RunGroups(arguments, kernel, nextGroup, groupsCount);
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+void ComputeBasics::Cpu::DispatchIndirect(const uint32_t* arguments, uint32_t argumentsOffset, const GroupKernel& kernel,
+                                          uint32_t threadsCount)
+{
+    assert(arguments);
+
+    const uint32_t* dispatchArguments = arguments + ToIndex(argumentsOffset);
+    Dispatch({ dispatchArguments[0], dispatchArguments[1], dispatchArguments[2] }, kernel, threadsCount);
+}
+
+Cpu::DispatchChain::DispatchChain(const std::vector<uint32_t>& initialCounts, uint32_t argumentsSizeBytes) :
+    m_initialCounts(initialCounts), m_counts(std::max<size_t>(initialCounts.size(), 1)),
+    m_arguments(std::max<uint32_t>(ToIndex(argumentsSizeBytes), 1), 0)
+{
+    for (auto& count : m_counts)
+        count = 0;
+}
+
+void Cpu::DispatchChain::AddStage(const StageFunction& stage)
+{
+    assert(stage);
+    m_stages.push_back({ stage, nullptr, 0 });
+}
+
+void Cpu::DispatchChain::AddIndirectStage(const GroupKernel& kernel, uint32_t argumentsOffset)
+{
+    assert(kernel);
+    assert(ToIndex(argumentsOffset) + 3 <= m_arguments.size());
+    m_stages.push_back({ nullptr, kernel, argumentsOffset });
+}
+
+void Cpu::DispatchChain::AddArgumentsStage(uint32_t countOffset, uint32_t argumentsOffset, uint32_t groupSize)
+{
+    assert(ToIndex(countOffset) < m_counts.size());
+    assert(ToIndex(argumentsOffset) + 3 <= m_arguments.size());
+    assert(groupSize > 0);
+
+    AddStage([this, countOffset, argumentsOffset, groupSize]()
+    {
+        const auto dispatchArguments = CalculateDispatchArguments(m_counts[ToIndex(countOffset)], groupSize);
+        uint32_t* arguments = &m_arguments[ToIndex(argumentsOffset)];
+        arguments[0] = dispatchArguments.m_groupsCountX;
+        arguments[1] = dispatchArguments.m_groupsCountY;
+        arguments[2] = dispatchArguments.m_groupsCountZ;
+    });
+}
+
+void Cpu::DispatchChain::Execute(uint32_t threadsCount)
+{
+    for (size_t i = 0; i < m_initialCounts.size(); ++i)
+        m_counts[i] = m_initialCounts[i];
+
+    // Note every stage finishes before the next one starts, as with the uav barriers in the gpu
+    for (const auto& stage : m_stages)
+    {
+        if (stage.m_function)
+            stage.m_function();
+        else
+            DispatchIndirect(&m_arguments[0], stage.m_argumentsOffset, stage.m_kernel, threadsCount);
+    }
+}
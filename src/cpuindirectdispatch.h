@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+// Cpu interpreter of the indirect dispatch arguments used by src/indirectdispatch.h, with the same buffers
+// layout, so chains of dispatches sized by previous ones can be run and checked without a gpu.
+// It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+// D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION
+const uint32_t g_maxDispatchGroupsCount = 65535;
+
+// Same layout than D3D12_DISPATCH_ARGUMENTS
+struct DispatchArguments
+{
+    uint32_t m_groupsCountX;
+    uint32_t m_groupsCountY;
+    uint32_t m_groupsCountZ;
+};
+
+// Arguments to launch a thread per element with groups of groupSize threads.
+// Note the groups are clamped to the dispatch limit, kernels with more elements have to loop.
+// Same than data/shaders/dispatcharguments.hlsl.
+DispatchArguments CalculateDispatchArguments(uint32_t elementsCount, uint32_t groupSize);
+
+namespace Cpu
+{
+
+// Runs a group of a dispatch
+using GroupKernel = std::function<void(uint32_t groupX, uint32_t groupY, uint32_t groupZ)>;
+
+// Runs kernel for every group of the arguments. Groups run in parallel in no particular order, as in the gpu.
+// threadsCount = 0 uses all the hardware threads. Small dispatches use less threads than requested.
+void Dispatch(const DispatchArguments& arguments, const GroupKernel& kernel, uint32_t threadsCount = 0);
+
+// Same than Dispatch with the arguments at argumentsOffset bytes of arguments, as ExecuteIndirect reads them
+void DispatchIndirect(const uint32_t* arguments, uint32_t argumentsOffset, const GroupKernel& kernel,
+                      uint32_t threadsCount = 0);
+
+// Cpu version of ComputeBasics::DispatchChain. Stages run in order and their sizes come from the arguments
+// buffer. The counts buffer holds the uint counters the stages append to, reset to its initial values at
+// every execution. Offsets are in bytes in both buffers, as in the gpu.
+class DispatchChain
+{
+public:
+    // Runs a stage that sizes itself. It can write the arguments buffer.
+    using StageFunction = std::function<void()>;
+
+    DispatchChain(const std::vector<uint32_t>& initialCounts, uint32_t argumentsSizeBytes);
+
+    // Note atomics so parallel groups can append, the layout is the one of a uint buffer
+    std::atomic<uint32_t>* GetCounts() { return &m_counts[0]; }
+    uint32_t* GetArguments() { return &m_arguments[0]; }
+
+    void AddStage(const StageFunction& stage);
+    // Stage sized by the arguments at argumentsOffset
+    void AddIndirectStage(const GroupKernel& kernel, uint32_t argumentsOffset);
+    // Writes at argumentsOffset the arguments to launch a thread per element of the count at countOffset
+    void AddArgumentsStage(uint32_t countOffset, uint32_t argumentsOffset, uint32_t groupSize);
+
+    void Execute(uint32_t threadsCount = 0);
+
+private:
+    struct Stage
+    {
+        StageFunction   m_function;
+        GroupKernel     m_kernel;
+        uint32_t        m_argumentsOffset;
+    };
+
+    std::vector<uint32_t>               m_initialCounts;
+    std::vector<std::atomic<uint32_t>>  m_counts;
+    std::vector<uint32_t>               m_arguments;
+    std::vector<Stage>                  m_stages;
+};
+
+}
+}
@@ -0,0 +1,91 @@
+#include "cpumipsgenerator.h"
+
+#include <cassert>
+#include <algorithm>
+
+#include "texturelayout.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define CPUMIPSGENERATOR_SSE ( 1 )
+#include <xmmintrin.h>
+#else
+#define CPUMIPSGENERATOR_SSE ( 0 )
+#endif
+
+namespace
+{
+const uint32_t g_channelsCount = 4;
+
+// Same operations order than Average in mipsgen.hlsl
+void AverageTexels(const float* a, const float* b, const float* c, const float* d, float* dst)
+{
+#if CPUMIPSGENERATOR_SSE
+    __m128 sum = _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b));
+    sum = _mm_add_ps(sum, _mm_loadu_ps(c));
+    sum = _mm_add_ps(sum, _mm_loadu_ps(d));
+    _mm_storeu_ps(dst, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+    for (uint32_t i = 0; i < g_channelsCount; ++i)
+        dst[i] = (a[i] + b[i] + c[i] + d[i]) * 0.25f;
+#endif
+}
+}
+
+void ComputeBasics::Cpu::GenerateMip(const float* src, uint32_t srcWidth, uint32_t srcHeight, float* dst)
+{
+    assert(src);
+    assert(dst);
+    assert(srcWidth > 0 && srcHeight > 0);
+
+    const uint32_t dstWidth = std::max(srcWidth / 2, 1u);
+    const uint32_t dstHeight = std::max(srcHeight / 2, 1u);
+
+    // Note when a dimension is already 1 the texel is reused instead of reading past the edge
+    const size_t srcRowSize = static_cast<size_t>(srcWidth) * g_channelsCount;
+    const size_t nextRowOffset = srcHeight > 1 ? srcRowSize : 0;
+    const size_t nextTexelOffset = srcWidth > 1 ? g_channelsCount : 0;
+
+    for (uint32_t y = 0; y < dstHeight; ++y)
+    {
+        const float* srcRow0 = src + (2 * y) * srcRowSize;
+        const float* srcRow1 = srcRow0 + nextRowOffset;
+        float* dstRow = dst + static_cast<size_t>(y) * dstWidth * g_channelsCount;
+
+        for (uint32_t x = 0; x < dstWidth; ++x)
+        {
+            const size_t srcTexel = 2 * x * g_channelsCount;
+            AverageTexels(srcRow0 + srcTexel, srcRow0 + srcTexel + nextTexelOffset,
+                          srcRow1 + srcTexel, srcRow1 + srcTexel + nextTexelOffset,
+                          dstRow + x * g_channelsCount);
+        }
+    }
+}
+
+std::vector<ComputeBasics::Cpu::MipLevel> ComputeBasics::Cpu::GenerateMips(const float* src, uint32_t width,
+                                                                           uint32_t height, uint32_t mipsCount)
+{
+    assert(src);
+
+    if (mipsCount == 0)
+        mipsCount = CalculateMipsCount(width, height, 1);
+
+    std::vector<MipLevel> mips(mipsCount > 1 ? mipsCount - 1 : 0);
+
+    const float* srcMip = src;
+    uint32_t srcWidth = width;
+    uint32_t srcHeight = height;
+    for (auto& mip : mips)
+    {
+        mip.m_width = std::max(srcWidth / 2, 1u);
+        mip.m_height = std::max(srcHeight / 2, 1u);
+        mip.m_texels.resize(static_cast<size_t>(mip.m_width) * mip.m_height * g_channelsCount);
+
+        GenerateMip(srcMip, srcWidth, srcHeight, &mip.m_texels[0]);
+
+        srcMip = &mip.m_texels[0];
+        srcWidth = mip.m_width;
+        srcHeight = mip.m_height;
+    }
+
+    return mips;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Cpu version of data/shaders/mipsgen.hlsl. Same box filter and same edge rules so the results
+// can be used to validate the gpu ones. It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+namespace Cpu
+{
+
+// Rgba float texels, tightly packed
+struct MipLevel
+{
+    std::vector<float>  m_texels;
+    uint32_t            m_width;
+    uint32_t            m_height;
+};
+
+// Generates the dst mip from the src one. dst has to hold max(srcWidth / 2, 1) * max(srcHeight / 2, 1) texels.
+void GenerateMip(const float* src, uint32_t srcWidth, uint32_t srcHeight, float* dst);
+
+// Generates mipsCount - 1 mips from src. mipsCount = 0 generates the full chain.
+// Returns the generated mips, mips[i] being mip i + 1.
+std::vector<MipLevel> GenerateMips(const float* src, uint32_t width, uint32_t height, uint32_t mipsCount);
+
+}
+}
@@ -0,0 +1,288 @@
+#include "cpuoutofcore.h"
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace ComputeBasics;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Steps done by a queue, as the fences of the gpu executor, with the time every step was done
+class StepsFence
+{
+public:
+    explicit StepsFence(size_t stepsCount) : m_completedCount(0), m_completionTimes(stepsCount) {}
+
+    void Signal()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_completionTimes[m_completedCount++] = Clock::now();
+        }
+        m_condition.notify_all();
+    }
+
+    // Returns the time the step was done, the min time for g_invalidOutOfCoreStep
+    Clock::time_point WaitForStep(uint32_t step)
+    {
+        if (step == g_invalidOutOfCoreStep)
+            return Clock::time_point::min();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this, step]() { return m_completedCount > step; });
+        return m_completionTimes[step];
+    }
+
+private:
+    std::mutex                      m_mutex;
+    std::condition_variable         m_condition;
+    uint32_t                        m_completedCount;
+    std::vector<Clock::time_point>  m_completionTimes;
+};
+
+double CalculateStepSeconds(const OutOfCoreDesc& desc, const OutOfCoreStep& step, const OutOfCoreRates& rates)
+{
+    double rate;
+    double amount;
+    switch (step.m_type)
+    {
+    case OutOfCoreStepType::Upload:
+        rate = rates.m_uploadBytesPerSecond;
+        amount = static_cast<double>(CalculateOutOfCoreInputBytes(desc, step.m_elementsCount));
+        break;
+    case OutOfCoreStepType::Readback:
+        rate = rates.m_readbackBytesPerSecond;
+        amount = static_cast<double>(CalculateOutOfCoreOutputBytes(desc, step.m_elementsCount));
+        break;
+    default:
+        rate = rates.m_dispatchElementsPerSecond;
+        amount = static_cast<double>(step.m_elementsCount);
+        break;
+    }
+    return rate > 0.0 ? amount / rate : 0.0;
+}
+
+OutOfCoreStep CreateStep(const OutOfCoreSchedule& schedule, const OutOfCoreDesc& desc, OutOfCoreStepType type,
+                         uint32_t chunk, uint32_t waitStep)
+{
+    const uint64_t firstElement = static_cast<uint64_t>(chunk) * schedule.m_chunkElementsCount;
+    const uint64_t elementsCount = std::min<uint64_t>(schedule.m_chunkElementsCount,
+                                                      desc.m_elementsCount - firstElement);
+    return { type, chunk, chunk % schedule.m_buffersCount, firstElement, static_cast<uint32_t>(elementsCount),
+             waitStep };
+}
+}
+
+uint32_t ComputeBasics::CalculateOutOfCoreChunkElementsCount(const OutOfCoreDesc& desc)
+{
+    assert(desc.m_elementsCount > 0);
+    assert(desc.m_inputElementSizeBytes > 0 && desc.m_outputElementSizeBytes > 0);
+    assert(desc.m_chunkAlignment > 0);
+    assert(desc.m_buffersCount > 0);
+
+    // Note reductions have a single output element per buffer whatever the size of the chunk
+    const bool isElementwise = desc.m_kernelType == OutOfCoreKernelType::Elementwise;
+    const uint64_t elementSizeBytes = desc.m_inputElementSizeBytes +
+                                      (isElementwise ? desc.m_outputElementSizeBytes : 0);
+    const uint64_t fixedSizeBytes = isElementwise ? 0 : desc.m_outputElementSizeBytes;
+
+    const uint64_t bufferSizeBytes = desc.m_budgetBytes / desc.m_buffersCount;
+    if (bufferSizeBytes <= fixedSizeBytes)
+        return 0;
+
+    const uint64_t alignedElementsCount = (desc.m_elementsCount + desc.m_chunkAlignment - 1) /
+                                          desc.m_chunkAlignment * desc.m_chunkAlignment;
+    uint64_t elementsCount = std::min<uint64_t>((bufferSizeBytes - fixedSizeBytes) / elementSizeBytes, UINT32_MAX);
+    elementsCount -= elementsCount % desc.m_chunkAlignment;
+    return static_cast<uint32_t>(std::min(elementsCount, alignedElementsCount));
+}
+
+OutOfCoreSchedule ComputeBasics::CreateOutOfCoreSchedule(const OutOfCoreDesc& desc)
+{
+    OutOfCoreSchedule schedule = {};
+    schedule.m_buffersCount = desc.m_buffersCount;
+    schedule.m_chunkElementsCount = CalculateOutOfCoreChunkElementsCount(desc);
+    if (schedule.m_chunkElementsCount == 0)
+        return schedule;
+
+    const uint64_t chunksCount = (desc.m_elementsCount + schedule.m_chunkElementsCount - 1) /
+                                 schedule.m_chunkElementsCount;
+    assert(chunksCount < g_invalidOutOfCoreStep);
+    schedule.m_chunksCount = static_cast<uint32_t>(chunksCount);
+
+    // Note the copy step of every upload, for the dispatches to wait for them
+    std::vector<uint32_t> uploadSteps(schedule.m_chunksCount);
+    const auto addUpload = [&](uint32_t chunk)
+    {
+        const uint32_t waitStep = chunk >= desc.m_buffersCount ? chunk - desc.m_buffersCount : g_invalidOutOfCoreStep;
+        uploadSteps[chunk] = static_cast<uint32_t>(schedule.m_copySteps.size());
+        schedule.m_copySteps.push_back(CreateStep(schedule, desc, OutOfCoreStepType::Upload, chunk, waitStep));
+    };
+
+    const uint32_t uploadsAhead = desc.m_buffersCount - 1;
+    for (uint32_t chunk = 0; chunk < std::min(uploadsAhead, schedule.m_chunksCount); ++chunk)
+        addUpload(chunk);
+    for (uint32_t chunk = 0; chunk < schedule.m_chunksCount; ++chunk)
+    {
+        if (chunk + uploadsAhead < schedule.m_chunksCount)
+            addUpload(chunk + uploadsAhead);
+        schedule.m_copySteps.push_back(CreateStep(schedule, desc, OutOfCoreStepType::Readback, chunk, chunk));
+    }
+
+    for (uint32_t chunk = 0; chunk < schedule.m_chunksCount; ++chunk)
+        schedule.m_computeSteps.push_back(CreateStep(schedule, desc, OutOfCoreStepType::Dispatch, chunk,
+                                                     uploadSteps[chunk]));
+
+    return schedule;
+}
+
+uint64_t ComputeBasics::CalculateOutOfCoreInputBytes(const OutOfCoreDesc& desc, uint32_t elementsCount)
+{
+    return static_cast<uint64_t>(elementsCount) * desc.m_inputElementSizeBytes;
+}
+
+uint64_t ComputeBasics::CalculateOutOfCoreOutputBytes(const OutOfCoreDesc& desc, uint32_t elementsCount)
+{
+    return desc.m_kernelType == OutOfCoreKernelType::Elementwise ?
+           static_cast<uint64_t>(elementsCount) * desc.m_outputElementSizeBytes : desc.m_outputElementSizeBytes;
+}
+
+uint64_t ComputeBasics::CalculateOutOfCoreOutputElementsCount(const OutOfCoreDesc& desc,
+                                                              const OutOfCoreSchedule& schedule)
+{
+    return desc.m_kernelType == OutOfCoreKernelType::Elementwise ? desc.m_elementsCount : schedule.m_chunksCount;
+}
+
+OutOfCoreTimeline ComputeBasics::SimulateOutOfCoreSchedule(const OutOfCoreDesc& desc,
+                                                           const OutOfCoreSchedule& schedule,
+                                                           const OutOfCoreRates& rates)
+{
+    OutOfCoreTimeline timeline = {};
+    std::vector<double> copyEnds(schedule.m_copySteps.size());
+    std::vector<double> computeEnds(schedule.m_computeSteps.size());
+
+    // Note a step runs once the steps before it in its queue are done and the step it waits for too. The queues
+    // take turns, every one runs its steps until one waits for a step the other queue hasnt run yet.
+    size_t copyStep = 0;
+    size_t computeStep = 0;
+    double copyEnd = 0.0;
+    double computeEnd = 0.0;
+    while (copyStep < schedule.m_copySteps.size() || computeStep < schedule.m_computeSteps.size())
+    {
+        bool isBlocked = true;
+        while (copyStep < schedule.m_copySteps.size())
+        {
+            const OutOfCoreStep& step = schedule.m_copySteps[copyStep];
+            if (step.m_waitStep != g_invalidOutOfCoreStep && step.m_waitStep >= computeStep)
+                break;
+
+            const double start = step.m_waitStep != g_invalidOutOfCoreStep ?
+                                 std::max(copyEnd, computeEnds[step.m_waitStep]) : copyEnd;
+            const double seconds = CalculateStepSeconds(desc, step, rates);
+            copyEnd = start + seconds;
+            copyEnds[copyStep++] = copyEnd;
+            timeline.m_copySeconds += seconds;
+            isBlocked = false;
+        }
+        while (computeStep < schedule.m_computeSteps.size())
+        {
+            const OutOfCoreStep& step = schedule.m_computeSteps[computeStep];
+            if (step.m_waitStep != g_invalidOutOfCoreStep && step.m_waitStep >= copyStep)
+                break;
+
+            const double start = step.m_waitStep != g_invalidOutOfCoreStep ?
+                                 std::max(computeEnd, copyEnds[step.m_waitStep]) : computeEnd;
+            const double seconds = CalculateStepSeconds(desc, step, rates);
+            computeEnd = start + seconds;
+            computeEnds[computeStep++] = computeEnd;
+            timeline.m_computeSeconds += seconds;
+            isBlocked = false;
+        }
+        assert(!isBlocked);
+        (void)isBlocked;
+    }
+
+    timeline.m_seconds = std::max(copyEnd, computeEnd);
+    return timeline;
+}
+
+Cpu::OutOfCoreExecutor::OutOfCoreExecutor(const OutOfCoreDesc& desc, const OutOfCoreRates& simulatedRates) :
+    m_desc(desc), m_simulatedRates(simulatedRates), m_schedule(CreateOutOfCoreSchedule(desc)), m_timeline{}
+{
+    if (!IsValid())
+        return;
+
+    m_inputBuffers.resize(m_desc.m_buffersCount *
+                          CalculateOutOfCoreInputBytes(m_desc, m_schedule.m_chunkElementsCount));
+    m_outputBuffers.resize(m_desc.m_buffersCount *
+                           CalculateOutOfCoreOutputBytes(m_desc, m_schedule.m_chunkElementsCount));
+}
+
+void Cpu::OutOfCoreExecutor::Execute(const void* input, void* output, const OutOfCoreKernel& kernel)
+{
+    assert(IsValid());
+    assert(input && output);
+
+    const uint64_t inputBufferSizeBytes = CalculateOutOfCoreInputBytes(m_desc, m_schedule.m_chunkElementsCount);
+    const uint64_t outputBufferSizeBytes = CalculateOutOfCoreOutputBytes(m_desc, m_schedule.m_chunkElementsCount);
+    const bool isElementwise = m_desc.m_kernelType == OutOfCoreKernelType::Elementwise;
+
+    StepsFence copyFence(m_schedule.m_copySteps.size());
+    StepsFence computeFence(m_schedule.m_computeSteps.size());
+    m_timeline = {};
+    const Clock::time_point start = Clock::now();
+
+    std::thread copyThread([&]()
+    {
+        // Note the transfers follow the simulated clock of the queue, they start when the previous one ends there or
+        // when the dispatch they wait for is done, so the time sleep_until oversleeps doesnt add up over the steps
+        Clock::time_point transferEnd = start;
+        for (const OutOfCoreStep& step : m_schedule.m_copySteps)
+        {
+            const Clock::time_point stepStart = std::max(transferEnd, computeFence.WaitForStep(step.m_waitStep));
+            if (step.m_type == OutOfCoreStepType::Upload)
+            {
+                memcpy(&m_inputBuffers[step.m_buffer * inputBufferSizeBytes],
+                       static_cast<const uint8_t*>(input) + step.m_firstElement * m_desc.m_inputElementSizeBytes,
+                       CalculateOutOfCoreInputBytes(m_desc, step.m_elementsCount));
+            }
+            else
+            {
+                const uint64_t outputElement = isElementwise ? step.m_firstElement : step.m_chunk;
+                memcpy(static_cast<uint8_t*>(output) + outputElement * m_desc.m_outputElementSizeBytes,
+                       &m_outputBuffers[step.m_buffer * outputBufferSizeBytes],
+                       CalculateOutOfCoreOutputBytes(m_desc, step.m_elementsCount));
+            }
+
+            // Note the memcpy is usually faster than the bus, the rest of the transfer time is waited
+            const std::chrono::duration<double> seconds(CalculateStepSeconds(m_desc, step, m_simulatedRates));
+            transferEnd = std::max(Clock::now(), stepStart + std::chrono::duration_cast<Clock::duration>(seconds));
+            std::this_thread::sleep_until(transferEnd);
+            m_timeline.m_copySeconds += std::chrono::duration<double>(transferEnd - stepStart).count();
+
+            copyFence.Signal();
+        }
+    });
+
+    for (const OutOfCoreStep& step : m_schedule.m_computeSteps)
+    {
+        copyFence.WaitForStep(step.m_waitStep);
+
+        const Clock::time_point stepStart = Clock::now();
+        kernel(&m_inputBuffers[step.m_buffer * inputBufferSizeBytes],
+               &m_outputBuffers[step.m_buffer * outputBufferSizeBytes], step.m_elementsCount, step);
+        m_timeline.m_computeSeconds += std::chrono::duration<double>(Clock::now() - stepStart).count();
+
+        computeFence.Signal();
+    }
+
+    copyThread.join();
+    m_timeline.m_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+}
\ No newline at end of file
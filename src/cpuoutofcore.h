@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Out of core execution of kernels over inputs bigger than the memory of the device. The input is split in chunks
+// that fit in the memory budget and every chunk is uploaded, dispatched and read back, with buffersCount chunks in
+// flight so the transfers of a chunk overlap the dispatch of another one. The schedule, the chunk size and a
+// simulation of the timeline are shared with the gpu executor in src/outofcore.h, and the cpu executor below runs
+// the schedule with a thread per queue and simulated transfers. It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+const uint32_t g_invalidOutOfCoreStep = UINT32_MAX;
+
+enum class OutOfCoreKernelType
+{
+    // An output element per input element
+    Elementwise,
+    // An output element per chunk, the partial result of the chunk, as the result of Reduce
+    Reduction
+};
+
+struct OutOfCoreDesc
+{
+    OutOfCoreKernelType m_kernelType;
+    uint64_t            m_elementsCount;
+    uint32_t            m_inputElementSizeBytes;
+    uint32_t            m_outputElementSizeBytes;
+    // Chunks are a multiple of it but for the last one, as the group size of the kernel
+    uint32_t            m_chunkAlignment;
+    // Chunks in flight, 1 doesnt overlap anything, 2 double buffers and 3 triple buffers the chunks
+    uint32_t            m_buffersCount;
+    // Device memory of the input and output buffers of all the chunks in flight
+    uint64_t            m_budgetBytes;
+};
+
+enum class OutOfCoreStepType
+{
+    Upload,
+    Dispatch,
+    Readback
+};
+
+struct OutOfCoreStep
+{
+    OutOfCoreStepType   m_type;
+    uint32_t            m_chunk;
+    // Input and output buffers of the chunk, chunk % buffersCount
+    uint32_t            m_buffer;
+    uint64_t            m_firstElement;
+    uint32_t            m_elementsCount;
+    // Step of the other queue it waits for, g_invalidOutOfCoreStep for none. The steps before it in the other
+    // queue are done too.
+    uint32_t            m_waitStep;
+};
+
+// Copy steps run in a queue and dispatches in another one, in the order of their vectors. The copy queue takes the
+// upload of the chunk buffersCount - 1 chunks ahead before the readback of every chunk, so uploads run while the
+// chunks before are dispatched.
+// Note an upload waits for the dispatch that read its buffer before and a readback for the dispatch of its chunk.
+// The dispatches only wait for their upload, which comes after the readback of the chunk that used the buffer before.
+struct OutOfCoreSchedule
+{
+    uint32_t                    m_chunkElementsCount;
+    uint32_t                    m_chunksCount;
+    uint32_t                    m_buffersCount;
+    std::vector<OutOfCoreStep>  m_copySteps;
+    std::vector<OutOfCoreStep>  m_computeSteps;
+};
+
+// Simulated rates of the queues
+struct OutOfCoreRates
+{
+    double m_uploadBytesPerSecond;
+    double m_readbackBytesPerSecond;
+    double m_dispatchElementsPerSecond;
+};
+
+struct OutOfCoreTimeline
+{
+    double m_seconds;
+    double m_copySeconds;
+    double m_computeSeconds;
+};
+
+// Biggest chunk whose input and output buffers fit buffersCount times in the budget, 0 if not even the alignment
+// fits. Never more than the aligned elements count.
+uint32_t CalculateOutOfCoreChunkElementsCount(const OutOfCoreDesc& desc);
+// Note the schedule is empty if the chunk doesnt fit in the budget
+OutOfCoreSchedule CreateOutOfCoreSchedule(const OutOfCoreDesc& desc);
+
+// Bytes of a chunk buffer, or moved by a copy step
+uint64_t CalculateOutOfCoreInputBytes(const OutOfCoreDesc& desc, uint32_t elementsCount);
+uint64_t CalculateOutOfCoreOutputBytes(const OutOfCoreDesc& desc, uint32_t elementsCount);
+// Elements of the output, one per chunk for reductions
+uint64_t CalculateOutOfCoreOutputElementsCount(const OutOfCoreDesc& desc, const OutOfCoreSchedule& schedule);
+
+// Times of the steps run at the given rates, with every step starting once its queue and the step it waits for
+// are done. m_copySeconds and m_computeSeconds are the time the queues are busy, m_seconds the time of all of it.
+OutOfCoreTimeline SimulateOutOfCoreSchedule(const OutOfCoreDesc& desc, const OutOfCoreSchedule& schedule,
+                                            const OutOfCoreRates& rates);
+
+namespace Cpu
+{
+
+// Runs the kernel of a chunk. input holds the elements of the chunk and output the space of its output elements,
+// a single one for reductions.
+using OutOfCoreKernel = std::function<void(const void* input, void* output, uint32_t elementsCount,
+                                           const OutOfCoreStep& step)>;
+
+// Cpu version of ComputeBasics::OutOfCoreExecutor. The buffers of the chunks in flight are the device memory, the
+// copy steps run in a thread and the dispatches in the calling one. Transfers are memcpys held until the simulated
+// bandwidth would have moved their bytes, so they take the time they would in the gpu.
+class OutOfCoreExecutor
+{
+public:
+    // Rates of 0 dont hold the transfers. The dispatch rate isnt used, dispatches take as long as the kernel.
+    OutOfCoreExecutor(const OutOfCoreDesc& desc, const OutOfCoreRates& simulatedRates);
+
+    bool IsValid() const { return m_schedule.m_chunksCount > 0; }
+    const OutOfCoreSchedule& GetSchedule() const { return m_schedule; }
+
+    // output has the space of CalculateOutOfCoreOutputElementsCount elements
+    // Note returns once the last chunk is read back
+    void Execute(const void* input, void* output, const OutOfCoreKernel& kernel);
+
+    // Times of the last execution, as in SimulateOutOfCoreSchedule
+    const OutOfCoreTimeline& GetTimeline() const { return m_timeline; }
+
+private:
+    OutOfCoreDesc           m_desc;
+    OutOfCoreRates          m_simulatedRates;
+    OutOfCoreSchedule       m_schedule;
+    std::vector<uint8_t>    m_inputBuffers;
+    std::vector<uint8_t>    m_outputBuffers;
+    OutOfCoreTimeline       m_timeline;
+};
+
+}
+}
\ No newline at end of file
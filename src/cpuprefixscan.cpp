@@ -0,0 +1,117 @@
+#include "cpuprefixscan.h"
+
+#include <cassert>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "cpureduction.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define CPUPREFIXSCAN_SSE ( 1 )
+#include <emmintrin.h>
+#else
+#define CPUPREFIXSCAN_SSE ( 0 )
+#endif
+
+namespace
+{
+using ComputeBasics::ScanType;
+
+// Note below this amount the cost of launching a thread is higher than the scan itself
+const size_t g_minElementsPerThread = 64 * 1024;
+
+// Scans count elements of src into dst starting from prefix. Returns prefix plus the sum of the elements.
+template<ScanType Type>
+uint32_t ScanRange(const uint32_t* src, uint32_t* dst, size_t count, uint32_t prefix)
+{
+    size_t i = 0;
+
+#if CPUPREFIXSCAN_SSE
+    // Note the inclusive scan of 4 lanes is 2 shifted adds, the carry is the last lane broadcasted
+    __m128i carry = _mm_set1_epi32(static_cast<int>(prefix));
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i elements = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i scan = _mm_add_epi32(elements, _mm_slli_si128(elements, 4));
+        scan = _mm_add_epi32(scan, _mm_slli_si128(scan, 8));
+        scan = _mm_add_epi32(scan, carry);
+        const __m128i result = Type == ScanType::Inclusive ? scan : _mm_sub_epi32(scan, elements);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+        carry = _mm_shuffle_epi32(scan, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    prefix = static_cast<uint32_t>(_mm_cvtsi128_si32(carry));
+#endif
+
+    for (; i < count; ++i)
+    {
+        const uint32_t element = src[i];
+        dst[i] = Type == ScanType::Inclusive ? prefix + element : prefix;
+        prefix += element;
+    }
+
+    return prefix;
+}
+
+template<ScanType Type>
+void ScanParallel(const uint32_t* src, uint32_t* dst, size_t count, uint32_t threadsCount)
+{
+    if (threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadsCount = static_cast<uint32_t>(std::min<size_t>(threadsCount,
+                                                          std::max<size_t>(count / g_minElementsPerThread, 1)));
+    if (threadsCount == 1)
+    {
+        ScanRange<Type>(src, dst, count, 0);
+        return;
+    }
+
+    const size_t chunkSize = (count / threadsCount + 15) & ~size_t(15);
+    auto chunkBegin = [=](uint32_t t) { return std::min(t * chunkSize, count); };
+    auto chunkEnd = [=](uint32_t t) { return t + 1 == threadsCount ? count : std::min((t + 1) * chunkSize, count); };
+
+    // Note the last chunk sum isnt needed by any other chunk
+    std::vector<uint32_t> prefixes(threadsCount, 0);
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount - 1);
+    for (uint32_t t = 0; t + 1 < threadsCount; ++t)
+    {
+        threads.emplace_back([=, &prefixes]()
+        {
+            const size_t begin = chunkBegin(t);
+            prefixes[t + 1] = ComputeBasics::Cpu::Reduce(src + begin, chunkEnd(t) - begin,
+                                                         ComputeBasics::ReductionOp::Sum, 1);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (uint32_t t = 1; t < threadsCount; ++t)
+        prefixes[t] += prefixes[t - 1];
+
+    // Note the first chunk doesnt need its prefix so it runs in this thread
+    threads.clear();
+    for (uint32_t t = 1; t < threadsCount; ++t)
+    {
+        threads.emplace_back([=, &prefixes]()
+        {
+            const size_t begin = chunkBegin(t);
+            ScanRange<Type>(src + begin, dst + begin, chunkEnd(t) - begin, prefixes[t]);
+        });
+    }
+    ScanRange<Type>(src, dst, chunkEnd(0), 0);
+
+    for (auto& thread : threads)
+        thread.join();
+}
+}
+
+void ComputeBasics::Cpu::Scan(const uint32_t* src, uint32_t* dst, size_t count, ScanType type, uint32_t threadsCount)
+{
+    assert((src && dst) || count == 0);
+
+    if (type == ScanType::Inclusive)
+        ScanParallel<ScanType::Inclusive>(src, dst, count, threadsCount);
+    else
+        ScanParallel<ScanType::Exclusive>(src, dst, count, threadsCount);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Cpu version of data/shaders/scan.hlsl. Every thread sums a contiguous chunk, the chunks sums are scanned
+// and then every thread scans its chunk starting from its prefix, 4 elements at a time in sse registers.
+// It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+enum class ScanType
+{
+    Exclusive,
+    Inclusive
+};
+
+namespace Cpu
+{
+
+// Prefix sum of count elements of src into dst. dst can be src to scan in place.
+// threadsCount = 0 uses all the hardware threads. Small inputs use less threads than requested.
+// Note sums wrap around as they do in the gpu.
+void Scan(const uint32_t* src, uint32_t* dst, size_t count, ScanType type, uint32_t threadsCount = 0);
+
+}
+}
@@ -0,0 +1,184 @@
+#include "cpuradixsort.h"
+
+#include <cassert>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const uint32_t g_digitBits = 8;
+const uint32_t g_digitsCount = 1 << g_digitBits;
+const uint32_t g_passesCount = 32 / g_digitBits;
+// Note a cache line of keys per digit
+const uint32_t g_bufferedKeysCount = 16;
+// Note below this amount the cost of launching a thread is higher than the work itself
+const size_t g_minElementsPerThread = 64 * 1024;
+
+using Histogram = std::array<size_t, g_digitsCount>;
+
+uint32_t GetDigit(uint32_t key, uint32_t shift)
+{
+    return (key >> shift) & (g_digitsCount - 1);
+}
+
+// Runs work(t, begin, end) for every chunk, the first one in this thread
+template<typename Work>
+void ForEachChunk(size_t count, uint32_t threadsCount, Work work)
+{
+    const size_t chunkSize = (count + threadsCount - 1) / threadsCount;
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount - 1);
+    for (uint32_t t = 1; t < threadsCount; ++t)
+    {
+        const size_t begin = std::min(t * chunkSize, count);
+        const size_t end = std::min(begin + chunkSize, count);
+        threads.emplace_back([=]() { work(t, begin, end); });
+    }
+    work(0, 0, std::min(chunkSize, count));
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+// Note the per digit buffers are kept apart from the offsets so a flush only touches one line of each
+template<bool HasValues>
+class ScatterBuffers
+{
+public:
+    ScatterBuffers(uint32_t* dstKeys, uint32_t* dstValues, const Histogram& offsets) :
+        m_dstKeys(dstKeys), m_dstValues(dstValues), m_offsets(offsets)
+    {
+        m_counts.fill(0);
+    }
+
+    void Push(uint32_t digit, uint32_t key, uint32_t value)
+    {
+        uint32_t& count = m_counts[digit];
+        m_keys[digit][count] = key;
+        if (HasValues)
+            m_values[digit][count] = value;
+
+        if (++count == g_bufferedKeysCount)
+            Flush(digit);
+    }
+
+    void FlushAll()
+    {
+        for (uint32_t digit = 0; digit < g_digitsCount; ++digit)
+            Flush(digit);
+    }
+
+private:
+    uint32_t*   m_dstKeys;
+    uint32_t*   m_dstValues;
+    Histogram   m_offsets;
+    std::array<uint32_t, g_digitsCount> m_counts;
+    uint32_t    m_keys[g_digitsCount][g_bufferedKeysCount];
+    uint32_t    m_values[HasValues ? g_digitsCount : 1][g_bufferedKeysCount];
+
+    void Flush(uint32_t digit)
+    {
+        const uint32_t count = m_counts[digit];
+        const size_t offset = m_offsets[digit];
+        std::copy(m_keys[digit], m_keys[digit] + count, m_dstKeys + offset);
+        if (HasValues)
+            std::copy(m_values[digit], m_values[digit] + count, m_dstValues + offset);
+
+        m_offsets[digit] = offset + count;
+        m_counts[digit] = 0;
+    }
+};
+
+template<bool HasValues>
+void RadixSortTyped(uint32_t* keys, uint32_t* values, size_t count, uint32_t threadsCount)
+{
+    assert(keys || count == 0);
+    assert(!HasValues || values || count == 0);
+
+    if (count < 2)
+        return;
+
+    if (threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadsCount = static_cast<uint32_t>(std::min<size_t>(threadsCount, std::max<size_t>(count / g_minElementsPerThread, 1)));
+
+    std::vector<uint32_t> tempKeys(count);
+    std::vector<uint32_t> tempValues(HasValues ? count : 0);
+    uint32_t* srcKeys = keys;
+    uint32_t* srcValues = values;
+    uint32_t* dstKeys = &tempKeys[0];
+    uint32_t* dstValues = HasValues ? &tempValues[0] : nullptr;
+
+    std::vector<Histogram> histograms(threadsCount);
+    for (uint32_t pass = 0; pass < g_passesCount; ++pass)
+    {
+        const uint32_t shift = pass * g_digitBits;
+
+        ForEachChunk(count, threadsCount, [&](uint32_t t, size_t begin, size_t end)
+        {
+            Histogram& histogram = histograms[t];
+            histogram.fill(0);
+            for (size_t i = begin; i < end; ++i)
+                ++histogram[GetDigit(srcKeys[i], shift)];
+        });
+
+        // Digit major offsets so every thread writes after the previous threads keys of the same digit
+        size_t offset = 0;
+        bool isTrivialPass = false;
+        for (uint32_t digit = 0; digit < g_digitsCount; ++digit)
+        {
+            const size_t digitStart = offset;
+            for (auto& histogram : histograms)
+            {
+                const size_t digitCount = histogram[digit];
+                histogram[digit] = offset;
+                offset += digitCount;
+            }
+            isTrivialPass |= offset - digitStart == count;
+        }
+
+        // Note the keys would stay in the same place
+        if (isTrivialPass)
+            continue;
+
+        ForEachChunk(count, threadsCount, [&](uint32_t t, size_t begin, size_t end)
+        {
+            // Note too big for the stack
+            std::unique_ptr<ScatterBuffers<HasValues>> buffers(new ScatterBuffers<HasValues>(dstKeys, dstValues,
+                                                                                             histograms[t]));
+            for (size_t i = begin; i < end; ++i)
+            {
+                const uint32_t key = srcKeys[i];
+                buffers->Push(GetDigit(key, shift), key, HasValues ? srcValues[i] : 0);
+            }
+            buffers->FlushAll();
+        });
+
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcValues, dstValues);
+    }
+
+    if (srcKeys != keys)
+    {
+        ForEachChunk(count, threadsCount, [&](uint32_t, size_t begin, size_t end)
+        {
+            std::copy(srcKeys + begin, srcKeys + end, keys + begin);
+            if (HasValues)
+                std::copy(srcValues + begin, srcValues + end, values + begin);
+        });
+    }
+}
+}
+
+void ComputeBasics::Cpu::RadixSort(uint32_t* keys, size_t count, uint32_t threadsCount)
+{
+    RadixSortTyped<false>(keys, nullptr, count, threadsCount);
+}
+
+void ComputeBasics::Cpu::RadixSort(uint32_t* keys, uint32_t* values, size_t count, uint32_t threadsCount)
+{
+    RadixSortTyped<true>(keys, values, count, threadsCount);
+}
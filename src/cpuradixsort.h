@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Cpu version of data/shaders/radixsort.hlsl. Lsd radix sort with 8 bits digits. Every pass the threads
+// count the digits of their chunk and then scatter it through small per digit buffers of a cache line, so
+// the writes to the 256 output streams are full lines. Passes where all the keys share the digit are skipped.
+// It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+namespace Cpu
+{
+
+// Sorts count keys in place in ascending order. The sort is stable.
+// threadsCount = 0 uses all the hardware threads. Small inputs use less threads than requested.
+void RadixSort(uint32_t* keys, size_t count, uint32_t threadsCount = 0);
+
+// Same as above, moving values[i] along with keys[i]
+void RadixSort(uint32_t* keys, uint32_t* values, size_t count, uint32_t threadsCount = 0);
+
+}
+}
@@ -0,0 +1,216 @@
+#include "cpureduction.h"
+
+#include <cassert>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define CPUREDUCTION_SSE ( 1 )
+#include <emmintrin.h>
+#else
+#define CPUREDUCTION_SSE ( 0 )
+#endif
+
+namespace
+{
+using ComputeBasics::ReductionOp;
+
+// Note below this amount the cost of launching a thread is higher than the reduction itself
+const size_t g_minElementsPerThread = 64 * 1024;
+
+template<typename T>
+T Identity(ReductionOp op)
+{
+    switch (op)
+    {
+    case ReductionOp::Min:
+        return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+    case ReductionOp::Max:
+        return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+    default:
+        return T(0);
+    }
+}
+
+template<ReductionOp Op>
+float Apply(float a, float b)
+{
+    return Op == ReductionOp::Sum ? a + b : (Op == ReductionOp::Min ? std::min(a, b) : std::max(a, b));
+}
+
+template<ReductionOp Op>
+uint32_t Apply(uint32_t a, uint32_t b)
+{
+    return Op == ReductionOp::Sum ? a + b : (Op == ReductionOp::Min ? std::min(a, b) : std::max(a, b));
+}
+
+// Note the sum goes through uint32_t so overflows wrap around instead of being undefined
+template<ReductionOp Op>
+int32_t Apply(int32_t a, int32_t b)
+{
+    if (Op == ReductionOp::Sum)
+        return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+    return Op == ReductionOp::Min ? std::min(a, b) : std::max(a, b);
+}
+
+#if CPUREDUCTION_SSE
+// Sse2 doesnt have 32 bits integer min/max, they are emulated with compares
+__m128i Select(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+struct FloatVector
+{
+    using Type = __m128;
+
+    static Type Load(const float* data) { return _mm_loadu_ps(data); }
+    static Type Set(float value) { return _mm_set1_ps(value); }
+    static void Store(float* dst, Type v) { _mm_storeu_ps(dst, v); }
+    static Type Sum(Type a, Type b) { return _mm_add_ps(a, b); }
+    static Type Min(Type a, Type b) { return _mm_min_ps(a, b); }
+    static Type Max(Type a, Type b) { return _mm_max_ps(a, b); }
+};
+
+template<typename T>
+struct IntVector
+{
+    using Type = __m128i;
+
+    static Type Load(const T* data) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)); }
+    static Type Set(T value) { return _mm_set1_epi32(static_cast<int>(value)); }
+    static void Store(T* dst, Type v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v); }
+    static Type Sum(Type a, Type b) { return _mm_add_epi32(a, b); }
+    static Type Min(Type a, Type b) { return Select(GreaterThan(a, b), b, a); }
+    static Type Max(Type a, Type b) { return Select(GreaterThan(a, b), a, b); }
+
+    // Note flipping the sign bit maps unsigned order to signed order
+    static Type GreaterThan(Type a, Type b)
+    {
+        if (std::numeric_limits<T>::is_signed)
+            return _mm_cmpgt_epi32(a, b);
+        const __m128i signBit = _mm_set1_epi32(static_cast<int>(0x80000000));
+        return _mm_cmpgt_epi32(_mm_xor_si128(a, signBit), _mm_xor_si128(b, signBit));
+    }
+};
+
+template<typename T> struct Vector;
+template<> struct Vector<float> : FloatVector {};
+template<> struct Vector<uint32_t> : IntVector<uint32_t> {};
+template<> struct Vector<int32_t> : IntVector<int32_t> {};
+
+template<ReductionOp Op, typename V>
+typename V::Type ApplyVector(typename V::Type a, typename V::Type b)
+{
+    return Op == ReductionOp::Sum ? V::Sum(a, b) : (Op == ReductionOp::Min ? V::Min(a, b) : V::Max(a, b));
+}
+#endif
+
+template<typename T, ReductionOp Op>
+T ReduceRange(const T* data, size_t count)
+{
+    T result = Identity<T>(Op);
+    size_t i = 0;
+
+#if CPUREDUCTION_SSE
+    using V = Vector<T>;
+    const size_t lanesCount = 4;
+
+    // Note 4 accumulators to hide the latency of the dependent operations
+    auto acc0 = V::Set(result);
+    auto acc1 = acc0;
+    auto acc2 = acc0;
+    auto acc3 = acc0;
+    for (; i + 4 * lanesCount <= count; i += 4 * lanesCount)
+    {
+        acc0 = ApplyVector<Op, V>(acc0, V::Load(data + i));
+        acc1 = ApplyVector<Op, V>(acc1, V::Load(data + i + lanesCount));
+        acc2 = ApplyVector<Op, V>(acc2, V::Load(data + i + 2 * lanesCount));
+        acc3 = ApplyVector<Op, V>(acc3, V::Load(data + i + 3 * lanesCount));
+    }
+    for (; i + lanesCount <= count; i += lanesCount)
+        acc0 = ApplyVector<Op, V>(acc0, V::Load(data + i));
+
+    acc0 = ApplyVector<Op, V>(ApplyVector<Op, V>(acc0, acc1), ApplyVector<Op, V>(acc2, acc3));
+    T lanes[lanesCount];
+    V::Store(lanes, acc0);
+    result = Apply<Op>(Apply<Op>(lanes[0], lanes[1]), Apply<Op>(lanes[2], lanes[3]));
+#endif
+
+    for (; i < count; ++i)
+        result = Apply<Op>(result, data[i]);
+
+    return result;
+}
+
+uint32_t CalculateThreadsCount(size_t count, uint32_t threadsCount)
+{
+    if (threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    const size_t maxThreadsCount = std::max<size_t>(count / g_minElementsPerThread, 1);
+    return static_cast<uint32_t>(std::min<size_t>(threadsCount, maxThreadsCount));
+}
+
+template<typename T, ReductionOp Op>
+T ReduceParallel(const T* data, size_t count, uint32_t threadsCount)
+{
+    threadsCount = CalculateThreadsCount(count, threadsCount);
+    if (threadsCount == 1)
+        return ReduceRange<T, Op>(data, count);
+
+    // Note the chunks are multiple of the sse loop size so only the last one has a scalar tail
+    const size_t chunkSize = (count / threadsCount + 15) & ~size_t(15);
+    std::vector<T> partials(threadsCount, Identity<T>(Op));
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount - 1);
+    for (uint32_t t = 1; t < threadsCount; ++t)
+    {
+        const size_t begin = std::min(t * chunkSize, count);
+        const size_t end = t + 1 == threadsCount ? count : std::min(begin + chunkSize, count);
+        threads.emplace_back([data, begin, end, &partials, t]()
+        {
+            partials[t] = ReduceRange<T, Op>(data + begin, end - begin);
+        });
+    }
+    partials[0] = ReduceRange<T, Op>(data, std::min(chunkSize, count));
+
+    for (auto& thread : threads)
+        thread.join();
+
+    return ReduceRange<T, Op>(&partials[0], partials.size());
+}
+
+template<typename T>
+T ReduceTyped(const T* data, size_t count, ReductionOp op, uint32_t threadsCount)
+{
+    assert(data || count == 0);
+
+    switch (op)
+    {
+    case ReductionOp::Min:
+        return ReduceParallel<T, ReductionOp::Min>(data, count, threadsCount);
+    case ReductionOp::Max:
+        return ReduceParallel<T, ReductionOp::Max>(data, count, threadsCount);
+    default:
+        return ReduceParallel<T, ReductionOp::Sum>(data, count, threadsCount);
+    }
+}
+}
+
+float ComputeBasics::Cpu::Reduce(const float* data, size_t count, ReductionOp op, uint32_t threadsCount)
+{
+    return ReduceTyped(data, count, op, threadsCount);
+}
+
+uint32_t ComputeBasics::Cpu::Reduce(const uint32_t* data, size_t count, ReductionOp op, uint32_t threadsCount)
+{
+    return ReduceTyped(data, count, op, threadsCount);
+}
+
+int32_t ComputeBasics::Cpu::Reduce(const int32_t* data, size_t count, ReductionOp op, uint32_t threadsCount)
+{
+    return ReduceTyped(data, count, op, threadsCount);
+}
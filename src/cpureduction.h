@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Cpu version of data/shaders/reduction.hlsl. Every thread reduces a contiguous chunk with sse and the
+// partial results are reduced at the end. It doesnt depend on d3d12.
+// Note float sums are done in a different order than in the gpu so they can differ in the last bits.
+namespace ComputeBasics
+{
+
+enum class ReductionOp
+{
+    Sum,
+    Min,
+    Max
+};
+
+namespace Cpu
+{
+
+// threadsCount = 0 uses all the hardware threads. Small inputs use less threads than requested.
+// Note integer sums wrap around as they do in the gpu.
+float Reduce(const float* data, size_t count, ReductionOp op, uint32_t threadsCount = 0);
+uint32_t Reduce(const uint32_t* data, size_t count, ReductionOp op, uint32_t threadsCount = 0);
+int32_t Reduce(const int32_t* data, size_t count, ReductionOp op, uint32_t threadsCount = 0);
+
+}
+}
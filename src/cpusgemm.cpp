@@ -0,0 +1,289 @@
+#include "cpusgemm.h"
+
+#include <cassert>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX512F__)
+#define CPUSGEMM_AVX512 ( 1 )
+#define CPUSGEMM_AVX2 ( 0 )
+#define CPUSGEMM_SSE ( 0 )
+#include <immintrin.h>
+// Note msvc doesnt define __FMA__, its /arch:AVX2 enables fma as well
+#elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define CPUSGEMM_AVX512 ( 0 )
+#define CPUSGEMM_AVX2 ( 1 )
+#define CPUSGEMM_SSE ( 0 )
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__)
+#define CPUSGEMM_AVX512 ( 0 )
+#define CPUSGEMM_AVX2 ( 0 )
+#define CPUSGEMM_SSE ( 1 )
+#include <emmintrin.h>
+#else
+#define CPUSGEMM_AVX512 ( 0 )
+#define CPUSGEMM_AVX2 ( 0 )
+#define CPUSGEMM_SSE ( 0 )
+#endif
+
+namespace
+{
+// Vector traits. The microkernel computes a g_mr x (g_vectorsPerRow * lanesCount) block of c.
+// Note g_mr * g_vectorsPerRow sums plus the vectors of b and a have to fit in the registers.
+#if CPUSGEMM_AVX512
+struct Vector
+{
+    using Type = __m512;
+    static const size_t lanesCount = 16;
+
+    static Type Zero() { return _mm512_setzero_ps(); }
+    static Type Set(float value) { return _mm512_set1_ps(value); }
+    static Type Load(const float* src) { return _mm512_loadu_ps(src); }
+    static void Store(float* dst, Type v) { _mm512_storeu_ps(dst, v); }
+    static Type Mul(Type a, Type b) { return _mm512_mul_ps(a, b); }
+    static Type MulAdd(Type a, Type b, Type c) { return _mm512_fmadd_ps(a, b, c); }
+};
+const size_t g_mr = 12;
+const size_t g_vectorsPerRow = 2;
+#elif CPUSGEMM_AVX2
+struct Vector
+{
+    using Type = __m256;
+    static const size_t lanesCount = 8;
+
+    static Type Zero() { return _mm256_setzero_ps(); }
+    static Type Set(float value) { return _mm256_set1_ps(value); }
+    static Type Load(const float* src) { return _mm256_loadu_ps(src); }
+    static void Store(float* dst, Type v) { _mm256_storeu_ps(dst, v); }
+    static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+    static Type MulAdd(Type a, Type b, Type c) { return _mm256_fmadd_ps(a, b, c); }
+};
+const size_t g_mr = 6;
+const size_t g_vectorsPerRow = 2;
+#elif CPUSGEMM_SSE
+struct Vector
+{
+    using Type = __m128;
+    static const size_t lanesCount = 4;
+
+    static Type Zero() { return _mm_setzero_ps(); }
+    static Type Set(float value) { return _mm_set1_ps(value); }
+    static Type Load(const float* src) { return _mm_loadu_ps(src); }
+    static void Store(float* dst, Type v) { _mm_storeu_ps(dst, v); }
+    static Type Mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+    // Note sse2 doesnt have fma
+    static Type MulAdd(Type a, Type b, Type c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+};
+const size_t g_mr = 6;
+const size_t g_vectorsPerRow = 2;
+#else
+struct Vector
+{
+    using Type = float;
+    static const size_t lanesCount = 1;
+
+    static Type Zero() { return 0.0f; }
+    static Type Set(float value) { return value; }
+    static Type Load(const float* src) { return *src; }
+    static void Store(float* dst, Type v) { *dst = v; }
+    static Type Mul(Type a, Type b) { return a * b; }
+    static Type MulAdd(Type a, Type b, Type c) { return a * b + c; }
+};
+const size_t g_mr = 4;
+const size_t g_vectorsPerRow = 4;
+#endif
+
+const size_t g_nr = g_vectorsPerRow * Vector::lanesCount;
+// Note the packed block of a stays in the l2 and the packed panel of b in the l3 together with the other threads ones.
+// g_kc x g_nr of b fits in the l1 while the microkernel walks the block of a.
+const size_t g_kc = 256;
+const size_t g_mc = g_mr * 16;
+const size_t g_nc = 1024;
+// Note below this amount of multiply adds the cost of launching a thread is higher than the work itself
+const uint64_t g_minMulAddsPerThread = 1 << 22;
+
+struct Matrix
+{
+    const float*    m_data;
+    size_t          m_stride;
+};
+
+// Packs rows x cols of a into panels of g_mr rows, stored column by column. Rows past the end are zeroes.
+void PackA(const float* a, size_t stride, size_t rows, size_t columns, float* dst)
+{
+    for (size_t panel = 0; panel < rows; panel += g_mr)
+    {
+        const size_t panelRows = std::min(g_mr, rows - panel);
+        for (size_t column = 0; column < columns; ++column)
+        {
+            for (size_t i = 0; i < g_mr; ++i)
+                *dst++ = i < panelRows ? a[(panel + i) * stride + column] : 0.0f;
+        }
+    }
+}
+
+// Packs rows x cols of b into panels of g_nr columns, stored row by row. Columns past the end are zeroes.
+void PackB(const float* b, size_t stride, size_t rows, size_t columns, float* dst)
+{
+    for (size_t panel = 0; panel < columns; panel += g_nr)
+    {
+        const size_t panelColumns = std::min(g_nr, columns - panel);
+        for (size_t row = 0; row < rows; ++row)
+        {
+            const float* src = b + row * stride + panel;
+            for (size_t j = 0; j < g_nr; ++j)
+                *dst++ = j < panelColumns ? src[j] : 0.0f;
+        }
+    }
+}
+
+// c += alpha * a * b of a packed g_mr x kc panel of a and a packed kc x g_nr panel of b.
+// Only rows x columns of c are written.
+void MicroKernel(size_t kc, const float* a, const float* b, float alpha, float* c, size_t stride, size_t rows,
+                 size_t columns)
+{
+    Vector::Type sums[g_mr][g_vectorsPerRow];
+    for (size_t i = 0; i < g_mr; ++i)
+    {
+        for (size_t v = 0; v < g_vectorsPerRow; ++v)
+            sums[i][v] = Vector::Zero();
+    }
+
+    for (size_t p = 0; p < kc; ++p)
+    {
+        Vector::Type bVectors[g_vectorsPerRow];
+        for (size_t v = 0; v < g_vectorsPerRow; ++v)
+            bVectors[v] = Vector::Load(b + v * Vector::lanesCount);
+
+        for (size_t i = 0; i < g_mr; ++i)
+        {
+            const Vector::Type aVector = Vector::Set(a[i]);
+            for (size_t v = 0; v < g_vectorsPerRow; ++v)
+                sums[i][v] = Vector::MulAdd(aVector, bVectors[v], sums[i][v]);
+        }
+
+        a += g_mr;
+        b += g_nr;
+    }
+
+    const Vector::Type alphaVector = Vector::Set(alpha);
+    if (rows == g_mr && columns == g_nr)
+    {
+        for (size_t i = 0; i < g_mr; ++i)
+        {
+            for (size_t v = 0; v < g_vectorsPerRow; ++v)
+            {
+                float* dst = c + i * stride + v * Vector::lanesCount;
+                Vector::Store(dst, Vector::MulAdd(alphaVector, sums[i][v], Vector::Load(dst)));
+            }
+        }
+        return;
+    }
+
+    // Note the edges go through a full block so the vectors dont write past the end of c
+    float block[g_mr][g_nr];
+    for (size_t i = 0; i < g_mr; ++i)
+    {
+        for (size_t v = 0; v < g_vectorsPerRow; ++v)
+            Vector::Store(&block[i][v * Vector::lanesCount], Vector::Mul(alphaVector, sums[i][v]));
+    }
+    for (size_t i = 0; i < rows; ++i)
+    {
+        for (size_t j = 0; j < columns; ++j)
+            c[i * stride + j] += block[i][j];
+    }
+}
+
+void ScaleRows(float* c, size_t stride, size_t rows, size_t columns, float beta)
+{
+    if (beta == 1.0f)
+        return;
+
+    for (size_t i = 0; i < rows; ++i)
+    {
+        float* row = c + i * stride;
+        if (beta == 0.0f)
+            std::fill(row, row + columns, 0.0f);
+        else
+            std::transform(row, row + columns, row, [beta](float value) { return beta * value; });
+    }
+}
+
+// c = alpha * a * b + beta * c of a block of the matrices, a is m x k, b is k x n and c is m x n
+void Gemm(size_t m, size_t n, size_t k, float alpha, Matrix a, Matrix b, float beta, float* c, size_t cStride)
+{
+    ScaleRows(c, cStride, m, n, beta);
+    if (k == 0 || alpha == 0.0f)
+        return;
+
+    std::vector<float> packedA(g_mc * g_kc);
+    std::vector<float> packedB(g_kc * ((std::min(g_nc, n) + g_nr - 1) / g_nr * g_nr));
+    for (size_t jc = 0; jc < n; jc += g_nc)
+    {
+        const size_t nc = std::min(g_nc, n - jc);
+        for (size_t pc = 0; pc < k; pc += g_kc)
+        {
+            const size_t kc = std::min(g_kc, k - pc);
+            PackB(b.m_data + pc * b.m_stride + jc, b.m_stride, kc, nc, &packedB[0]);
+
+            for (size_t ic = 0; ic < m; ic += g_mc)
+            {
+                const size_t mc = std::min(g_mc, m - ic);
+                PackA(a.m_data + ic * a.m_stride + pc, a.m_stride, mc, kc, &packedA[0]);
+
+                for (size_t jr = 0; jr < nc; jr += g_nr)
+                {
+                    const float* panelB = &packedB[jr * kc];
+                    for (size_t ir = 0; ir < mc; ir += g_mr)
+                    {
+                        MicroKernel(kc, &packedA[ir * kc], panelB, alpha, c + (ic + ir) * cStride + jc + jr, cStride,
+                                    std::min(g_mr, mc - ir), std::min(g_nr, nc - jr));
+                    }
+                }
+            }
+        }
+    }
+}
+}
+
+void ComputeBasics::Cpu::Sgemm(uint32_t m, uint32_t n, uint32_t k, float alpha, const float* a, const float* b,
+                               float beta, float* c, uint32_t threadsCount)
+{
+    assert(c || m * n == 0);
+    assert((a && b) || m * n * k == 0);
+
+    if (m == 0 || n == 0)
+        return;
+
+    if (threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    const uint64_t mulAddsCount = static_cast<uint64_t>(m) * n * std::max(k, 1u);
+    threadsCount = static_cast<uint32_t>(std::min<uint64_t>(threadsCount, std::max<uint64_t>(mulAddsCount / g_minMulAddsPerThread, 1)));
+
+    // Note bands along the biggest dimension, in whole microkernel blocks
+    const bool splitRows = m >= n;
+    const size_t blockSize = splitRows ? g_mr : g_nr;
+    const size_t blocksCount = ((splitRows ? m : n) + blockSize - 1) / blockSize;
+    threadsCount = static_cast<uint32_t>(std::min<size_t>(threadsCount, blocksCount));
+    const size_t bandSize = (blocksCount + threadsCount - 1) / threadsCount * blockSize;
+
+    auto computeBand = [=](uint32_t band)
+    {
+        const size_t begin = std::min<size_t>(band * bandSize, splitRows ? m : n);
+        const size_t end = std::min<size_t>(begin + bandSize, splitRows ? m : n);
+        if (splitRows)
+            Gemm(end - begin, n, k, alpha, { a + begin * k, k }, { b, n }, beta, c + begin * n, n);
+        else
+            Gemm(m, end - begin, k, alpha, { a, k }, { b + begin, n }, beta, c + begin, n);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount - 1);
+    for (uint32_t t = 1; t < threadsCount; ++t)
+        threads.emplace_back(computeBand, t);
+    computeBand(0);
+
+    for (auto& thread : threads)
+        thread.join();
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Cpu version of data/shaders/sgemm.hlsl. Blocks of a and b are packed so the microkernel reads them
+// contiguously from the caches and the microkernel keeps a block of c in registers, updated with fmas (avx-512
+// and avx2) or multiplies and adds (sse2 and scalar). Every thread computes a band of rows or columns of c.
+// It doesnt depend on d3d12.
+// Note the sums are done in a different order than in the gpu so they can differ in the last bits.
+namespace ComputeBasics
+{
+namespace Cpu
+{
+
+// c = alpha * a * b + beta * c with row major matrices, a is m x k, b is k x n and c is m x n.
+// With beta 0 c isnt read, so it can hold nans.
+// threadsCount = 0 uses all the hardware threads. Small products use less threads than requested.
+void Sgemm(uint32_t m, uint32_t n, uint32_t k, float alpha, const float* a, const float* b, float beta, float* c,
+           uint32_t threadsCount = 0);
+
+}
+}
@@ -1,6 +1,8 @@
 #include "descriptors.h"
 
 #include <cassert>
+#include <iostream>
+#include <algorithm>
 #include "Utils.h"
 
 namespace 
@@ -55,6 +57,37 @@ namespace
             CreateBufferSRV(device, resource, format, elementsCount, structuredStride, isRAW, cpuHandle);
         }
     }
+
+    void CreateTexture2DView(ID3D12Device* device, ID3D12Resource* resource, DXGI_FORMAT format, uint32_t mip,
+                             bool isRW, D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle)
+    {
+        assert(device);
+        assert(format != DXGI_FORMAT_UNKNOWN);
+
+        if (isRW)
+        {
+            D3D12_UNORDERED_ACCESS_VIEW_DESC desc;
+            desc.Format = format;
+            desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+            desc.Texture2D.MipSlice = mip;
+            desc.Texture2D.PlaneSlice = 0;
+
+            device->CreateUnorderedAccessView(resource, nullptr, &desc, cpuHandle);
+        }
+        else
+        {
+            D3D12_SHADER_RESOURCE_VIEW_DESC desc;
+            desc.Format = format;
+            desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+            desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+            desc.Texture2D.MostDetailedMip = mip;
+            desc.Texture2D.MipLevels = 1;
+            desc.Texture2D.PlaneSlice = 0;
+            desc.Texture2D.ResourceMinLODClamp = 0.0f;
+
+            device->CreateShaderResourceView(resource, &desc, cpuHandle);
+        }
+    }
 }
 
 using namespace ComputeBasics;
@@ -114,7 +147,8 @@ Descriptor DescriptorHeap::CreateByteBufferDescriptor(const GpuMemAllocation& al
     assert(allocation.m_resource);
 
     auto currentDescriptor = Top();
-    CreateBufferView(m_device, allocation.m_resource.Get(), DXGI_FORMAT_UNKNOWN, elementsCount, 0, 
+    // Note raw views have to be typeless and count 32 bits elements
+    CreateBufferView(m_device, allocation.m_resource.Get(), DXGI_FORMAT_R32_TYPELESS, elementsCount, 0, 
                      true, isRW, currentDescriptor.m_cpuHandle);
     Push();
     return currentDescriptor;
@@ -132,6 +166,25 @@ Descriptor DescriptorHeap::CreateStructuredBufferDescriptor(const GpuMemAllocati
     return currentDescriptor;
 }
 
+Descriptor DescriptorHeap::CreateTexture2DDescriptor(const GpuMemAllocation& allocation, DXGI_FORMAT format, 
+                                                     uint32_t mip, bool isRW)
+{
+    assert(allocation.m_resource);
+
+    auto currentDescriptor = Top();
+    CreateTexture2DView(m_device, allocation.m_resource.Get(), format, mip, isRW, currentDescriptor.m_cpuHandle);
+    Push();
+    return currentDescriptor;
+}
+
+Descriptor DescriptorHeap::CreateNullTexture2DDescriptor(DXGI_FORMAT format, bool isRW)
+{
+    auto currentDescriptor = Top();
+    CreateTexture2DView(m_device, nullptr, format, 0, isRW, currentDescriptor.m_cpuHandle);
+    Push();
+    return currentDescriptor;
+}
+
 Descriptor DescriptorHeap::Top()
 {
     return Descriptor{ m_currentGpuHandle, m_currentCpuHandle };
@@ -142,3 +195,123 @@ void DescriptorHeap::Push()
     m_currentCpuHandle.ptr += m_descriptorHandleIncrementSize;
     m_currentGpuHandle.ptr += m_descriptorHandleIncrementSize;
 }
+
+BindlessDescriptorHeap::BindlessDescriptorHeap(ID3D12Device* device, uint32_t descriptorsCount) :
+    m_device(device), m_beginGpuHandle{}, m_beginCpuHandle{}, m_descriptorHandleIncrementSize(0),
+    m_allocator(descriptorsCount), m_fenceValue(0)
+{
+    assert(m_device);
+    assert(descriptorsCount > 0);
+
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+    Utils::AssertIfFailed(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options)));
+    if (options.ResourceBindingTier < D3D12_RESOURCE_BINDING_TIER_3)
+    {
+        std::wcout << g_outputTag << " [BindlessDescriptorHeap] resource binding tier 3 not supported\n";
+        return;
+    }
+
+    D3D12_DESCRIPTOR_HEAP_DESC heapDesc;
+    heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    heapDesc.NumDescriptors = descriptorsCount;
+    heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    heapDesc.NodeMask = 0;
+
+    Utils::AssertIfFailed(m_device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_d3d12DescriptorHeap)));
+    m_d3d12DescriptorHeap->SetName(L"Bindless Descriptor Heap");
+
+    m_beginGpuHandle = m_d3d12DescriptorHeap->GetGPUDescriptorHandleForHeapStart();
+    m_beginCpuHandle = m_d3d12DescriptorHeap->GetCPUDescriptorHandleForHeapStart();
+    m_descriptorHandleIncrementSize =
+        m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+    Utils::AssertIfFailed(m_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+    assert(m_fence);
+}
+
+uint32_t BindlessDescriptorHeap::CreateBufferDescriptor(const GpuMemAllocation& allocation, DXGI_FORMAT format,
+                                                        uint32_t elementsCount, bool isRW)
+{
+    assert(allocation.m_resource);
+    assert(format != DXGI_FORMAT_UNKNOWN);
+
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle;
+    const uint32_t index = Allocate(cpuHandle);
+    if (index != g_invalidBindlessIndex)
+        CreateBufferView(m_device, allocation.m_resource.Get(), format, elementsCount, 0, false, isRW, cpuHandle);
+    return index;
+}
+
+uint32_t BindlessDescriptorHeap::CreateByteBufferDescriptor(const GpuMemAllocation& allocation, uint32_t elementsCount,
+                                                            bool isRW)
+{
+    assert(allocation.m_resource);
+
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle;
+    const uint32_t index = Allocate(cpuHandle);
+    // Note raw views have to be typeless and count 32 bits elements
+    if (index != g_invalidBindlessIndex)
+        CreateBufferView(m_device, allocation.m_resource.Get(), DXGI_FORMAT_R32_TYPELESS, elementsCount, 0, true, isRW,
+                         cpuHandle);
+    return index;
+}
+
+uint32_t BindlessDescriptorHeap::CreateStructuredBufferDescriptor(const GpuMemAllocation& allocation,
+                                                                  uint32_t elementsCount, uint32_t structureByteStride,
+                                                                  bool isRW)
+{
+    assert(allocation.m_resource);
+
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle;
+    const uint32_t index = Allocate(cpuHandle);
+    if (index != g_invalidBindlessIndex)
+        CreateBufferView(m_device, allocation.m_resource.Get(), DXGI_FORMAT_UNKNOWN, elementsCount, structureByteStride,
+                         false, isRW, cpuHandle);
+    return index;
+}
+
+uint32_t BindlessDescriptorHeap::CreateTexture2DDescriptor(const GpuMemAllocation& allocation, DXGI_FORMAT format,
+                                                           uint32_t mip, bool isRW)
+{
+    assert(allocation.m_resource);
+
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle;
+    const uint32_t index = Allocate(cpuHandle);
+    if (index != g_invalidBindlessIndex)
+        CreateTexture2DView(m_device, allocation.m_resource.Get(), format, mip, isRW, cpuHandle);
+    return index;
+}
+
+void BindlessDescriptorHeap::Free(uint32_t index, ID3D12CommandQueue* cmdQueue)
+{
+    assert(IsValid());
+    assert(index != g_invalidBindlessIndex);
+    assert(cmdQueue);
+
+    Utils::AssertIfFailed(cmdQueue->Signal(m_fence.Get(), ++m_fenceValue));
+    m_pendingFrees.push_back({ m_fenceValue, index });
+}
+
+uint32_t BindlessDescriptorHeap::Allocate(D3D12_CPU_DESCRIPTOR_HANDLE& cpuHandle)
+{
+    assert(IsValid());
+
+    ReleaseFreedIndices();
+    const uint32_t index = m_allocator.Allocate();
+    cpuHandle.ptr = m_beginCpuHandle.ptr + static_cast<SIZE_T>(index) * m_descriptorHandleIncrementSize;
+    return index;
+}
+
+void BindlessDescriptorHeap::ReleaseFreedIndices()
+{
+    const uint64_t completedValue = m_fence->GetCompletedValue();
+    const auto firstPending = std::find_if(m_pendingFrees.begin(), m_pendingFrees.end(),
+                                           [completedValue](const PendingFree& pendingFree)
+    {
+        return pendingFree.m_fenceValue > completedValue;
+    });
+
+    for (auto pendingFree = m_pendingFrees.begin(); pendingFree != firstPending; ++pendingFree)
+        m_allocator.Free(pendingFree->m_index);
+    m_pendingFrees.erase(m_pendingFrees.begin(), firstPending);
+}
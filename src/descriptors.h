@@ -3,6 +3,10 @@
 #include "common.h"
 
 #include "gpumemory.h"
+#include "cpubindless.h"
+
+#include <memory>
+#include <vector>
 
 namespace ComputeBasics
 {
@@ -29,6 +33,10 @@ public:
     Descriptor CreateByteBufferDescriptor(const GpuMemAllocation& allocation, uint32_t elementsCount, bool isRW);
     Descriptor CreateStructuredBufferDescriptor(const GpuMemAllocation& allocation, uint32_t elementsCount,
                                                 uint32_t structureByteStride, bool isRW);
+    // Single mip view of a 2d texture
+    Descriptor CreateTexture2DDescriptor(const GpuMemAllocation& allocation, DXGI_FORMAT format, uint32_t mip, bool isRW);
+    // Note null descriptors are meant to fill the unused slots of descriptor tables
+    Descriptor CreateNullTexture2DDescriptor(DXGI_FORMAT format, bool isRW);
 
 private:
     ID3D12Device* m_device;
@@ -44,5 +52,63 @@ private:
     Descriptor Top();
     void Push();
 };
+using DescriptorHeapPtr = std::unique_ptr<DescriptorHeap>;
+
+// One large shader visible heap for the views of all the resources, every view at a persistent index given by a
+// BindlessIndexAllocator. The heap is bound once as a single table, with unbounded ranges of every type starting at
+// its first descriptor as in data/shaders/bindless.hlsl, and shaders find their resources by the indices passed
+// in their root constants, so dispatches dont create, copy nor bind descriptors.
+// Note the table can have uninitialized descriptors, which needs resource binding tier 3. A freed index is reused
+// once the queue passed to Free is done with the work submitted before, all the frees have to use the same queue.
+class BindlessDescriptorHeap
+{
+public:
+    BindlessDescriptorHeap(ID3D12Device* device, uint32_t descriptorsCount);
+
+    // False if the device doesnt support resource binding tier 3
+    bool IsValid() const { return m_d3d12DescriptorHeap != nullptr; }
+
+    ID3D12DescriptorHeap* GetD3D12DescriptorHeap() const { return m_d3d12DescriptorHeap.Get(); }
+    // The start of the table
+    D3D12_GPU_DESCRIPTOR_HANDLE BeginGpuHandle() const { return m_beginGpuHandle; }
+    uint32_t GetAllocatedCount() const { return m_allocator.GetAllocatedCount(); }
+
+    // Return the index of the view, g_invalidBindlessIndex if the heap is full
+    uint32_t CreateBufferDescriptor(const GpuMemAllocation& allocation, DXGI_FORMAT format, uint32_t elementsCount,
+                                    bool isRW);
+    uint32_t CreateByteBufferDescriptor(const GpuMemAllocation& allocation, uint32_t elementsCount, bool isRW);
+    uint32_t CreateStructuredBufferDescriptor(const GpuMemAllocation& allocation, uint32_t elementsCount,
+                                              uint32_t structureByteStride, bool isRW);
+    // Single mip view of a 2d texture
+    uint32_t CreateTexture2DDescriptor(const GpuMemAllocation& allocation, DXGI_FORMAT format, uint32_t mip,
+                                       bool isRW);
+
+    void Free(uint32_t index, ID3D12CommandQueue* cmdQueue);
+
+private:
+    struct PendingFree
+    {
+        uint64_t m_fenceValue;
+        uint32_t m_index;
+    };
+
+    ID3D12Device*               m_device;
+
+    ID3D12DescriptorHeapComPtr  m_d3d12DescriptorHeap;
+    D3D12_GPU_DESCRIPTOR_HANDLE m_beginGpuHandle;
+    D3D12_CPU_DESCRIPTOR_HANDLE m_beginCpuHandle;
+    uint32_t                    m_descriptorHandleIncrementSize;
+
+    BindlessIndexAllocator      m_allocator;
+    ID3D12FenceComPtr           m_fence;
+    uint64_t                    m_fenceValue;
+    // Note sorted by fence value
+    std::vector<PendingFree>    m_pendingFrees;
+
+    // Returns g_invalidBindlessIndex if the heap is full
+    uint32_t Allocate(D3D12_CPU_DESCRIPTOR_HANDLE& cpuHandle);
+    // Gives the indices the gpu is done with back to the allocator
+    void ReleaseFreedIndices();
+};
 
 }
\ No newline at end of file
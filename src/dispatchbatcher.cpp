@@ -0,0 +1,124 @@
+#include "dispatchbatcher.h"
+
+#include <algorithm>
+
+#include "utils.h"
+
+using namespace ComputeBasics;
+
+DispatchBatcher::DispatchBatcher(ID3D12Device* device, ID3D12CommandQueue* computeCmdQueue,
+                                 const DispatchBatcherDesc& desc) :
+    m_device(device), m_cmdQueue(computeCmdQueue), m_desc(desc),
+    m_cmdListPool(device, D3D12_COMMAND_LIST_TYPE_COMPUTE, L"Dispatch Batch"), m_fenceValue(0),
+    m_policy(desc.m_limits), m_stats{}
+{
+    assert(m_device);
+    assert(m_cmdQueue);
+    assert(m_cmdQueue->GetDesc().Type == D3D12_COMMAND_LIST_TYPE_COMPUTE);
+    assert(m_desc.m_constantsCount <= g_maxBatchedDispatchConstantsCount);
+    assert(m_desc.m_buffers.size() <= g_maxBatchedDispatchBuffersCount);
+
+    Utils::AssertIfFailed(m_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+    assert(m_fence);
+}
+
+DispatchBatcher::~DispatchBatcher()
+{
+    Flush();
+    Wait();
+}
+
+void DispatchBatcher::Add(const BatchedDispatch& job)
+{
+    assert(IsValid());
+
+    if (!m_cmdList.m_cmdList)
+        BeginBatch();
+
+    ID3D12GraphicsCommandList* cmdList = m_cmdList.m_cmdList.Get();
+    if (m_desc.m_constantsCount > 0)
+        cmdList->SetComputeRoot32BitConstants(0, m_desc.m_constantsCount, job.m_constants, 0);
+
+    // Note the buffers follow the constants in the root signature
+    const UINT firstBufferParameter = m_desc.m_constantsCount > 0 ? 1 : 0;
+    for (uint32_t buffer = 0; buffer < m_desc.m_buffers.size(); ++buffer)
+    {
+        if (m_desc.m_buffers[buffer] == BatchedBufferType::ShaderResource)
+            cmdList->SetComputeRootShaderResourceView(firstBufferParameter + buffer, job.m_buffers[buffer]);
+        else
+            cmdList->SetComputeRootUnorderedAccessView(firstBufferParameter + buffer, job.m_buffers[buffer]);
+    }
+    cmdList->Dispatch(job.m_groupsCountX, job.m_groupsCountY, job.m_groupsCountZ);
+    ++m_stats.m_jobsCount;
+
+    const DispatchBatchFlushReason reason = m_policy.AddJob();
+    if (reason != DispatchBatchFlushReason::None)
+        Flush(reason);
+}
+
+void DispatchBatcher::Poll()
+{
+    const DispatchBatchFlushReason reason = m_policy.Poll();
+    if (reason != DispatchBatchFlushReason::None)
+        Flush(reason);
+
+    ReleaseFinishedBatches();
+}
+
+void DispatchBatcher::Flush()
+{
+    Flush(DispatchBatchFlushReason::None);
+}
+
+void DispatchBatcher::Wait()
+{
+    // Note a null event blocks until the fence reaches the value
+    Utils::AssertIfFailed(m_fence->SetEventOnCompletion(m_fenceValue, nullptr));
+    ReleaseFinishedBatches();
+}
+
+void DispatchBatcher::BeginBatch()
+{
+    ReleaseFinishedBatches();
+
+    m_cmdList = m_cmdListPool.Acquire();
+    ID3D12GraphicsCommandList* cmdList = m_cmdList.m_cmdList.Get();
+    cmdList->SetComputeRootSignature(m_desc.m_pipelineState.m_rootSignature.Get());
+    cmdList->SetPipelineState(m_desc.m_pipelineState.m_pso.Get());
+}
+
+void DispatchBatcher::Flush(DispatchBatchFlushReason reason)
+{
+    if (m_policy.GetJobsCount() == 0)
+        return;
+
+    ID3D12GraphicsCommandList* cmdList = m_cmdList.m_cmdList.Get();
+    Utils::AssertIfFailed(cmdList->Close());
+    ID3D12CommandList* cmdLists[] = { cmdList };
+    m_cmdQueue->ExecuteCommandLists(1, cmdLists);
+    Utils::AssertIfFailed(m_cmdQueue->Signal(m_fence.Get(), ++m_fenceValue));
+
+    m_submittedBatches.push_back({ m_fenceValue, m_cmdList });
+    m_cmdList = CommandList();
+    m_policy.Reset();
+
+    ++m_stats.m_batchesCount;
+    if (reason == DispatchBatchFlushReason::Size)
+        ++m_stats.m_sizeFlushesCount;
+    else if (reason == DispatchBatchFlushReason::Latency)
+        ++m_stats.m_latencyFlushesCount;
+}
+
+void DispatchBatcher::ReleaseFinishedBatches()
+{
+    const uint64_t completedValue = m_fence->GetCompletedValue();
+    const auto firstPending = std::find_if(m_submittedBatches.begin(), m_submittedBatches.end(),
+                                           [completedValue](const SubmittedBatch& batch)
+    {
+        return batch.m_fenceValue > completedValue;
+    });
+
+    for (auto batch = m_submittedBatches.begin(); batch != firstPending; ++batch)
+        m_cmdListPool.Release(batch->m_cmdList);
+    m_submittedBatches.erase(m_submittedBatches.begin(), firstPending);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "common.h"
+
+#include <vector>
+
+#include "pipelinestate.h"
+#include "commandlistpool.h"
+#include "cpudispatchbatcher.h"
+
+namespace ComputeBasics
+{
+
+const uint32_t g_maxBatchedDispatchConstantsCount = 16;
+const uint32_t g_maxBatchedDispatchBuffersCount = 4;
+
+enum class BatchedBufferType
+{
+    ShaderResource,
+    UnorderedAccess
+};
+
+// The root signature of the pipeline state has the root constants of a job, if any, as parameter 0 and a root
+// descriptor per buffer of a job after them, as data/shaders/scalebias.hlsl.
+struct DispatchBatcherDesc
+{
+    PipelineState                   m_pipelineState;
+    uint32_t                        m_constantsCount;
+    std::vector<BatchedBufferType>  m_buffers;
+    DispatchBatchLimits             m_limits;
+};
+
+// A job with the constants and buffers it is launched with. Only the first constants and buffers of the desc
+// are used. The buffers are gpu virtual addresses of raw or structured buffers.
+struct BatchedDispatch
+{
+    uint32_t                    m_constants[g_maxBatchedDispatchConstantsCount];
+    D3D12_GPU_VIRTUAL_ADDRESS   m_buffers[g_maxBatchedDispatchBuffersCount];
+    uint32_t                    m_groupsCountX;
+    uint32_t                    m_groupsCountY;
+    uint32_t                    m_groupsCountZ;
+};
+
+// Coalesces small jobs of the same pipeline state in a single cmd list, so they pay once for the submission
+// instead of once per job. Every job is a dispatch with its own root constants and root descriptors, recorded
+// as it is added. Batches are submitted when they reach the max jobs count or the max latency, without waiting
+// for them, and their cmd lists go back to a pool once the gpu is done with them.
+// Note jobs of a batch can run at the same time, they have to be independent. The buffers of the jobs have to
+// be in NON_PIXEL_SHADER_RESOURCE or UNORDERED_ACCESS state as their type, or promotable to it, and they have
+// to live until the jobs finish.
+class DispatchBatcher
+{
+public:
+    DispatchBatcher(ID3D12Device* device, ID3D12CommandQueue* computeCmdQueue, const DispatchBatcherDesc& desc);
+    // Note submits the jobs left and waits for them
+    ~DispatchBatcher();
+
+    bool IsValid() const { return m_desc.m_pipelineState.m_rootSignature && m_desc.m_pipelineState.m_pso; }
+
+    // Note the batch may be submitted, this job included, before returning
+    void Add(const BatchedDispatch& job);
+    // Submits the batch if its oldest job waited longer than the max latency
+    void Poll();
+    // Submits the batch whatever its size
+    void Flush();
+    // Waits for the batches submitted to finish in the gpu
+    void Wait();
+
+    const DispatchBatchStats& GetStats() const { return m_stats; }
+
+private:
+    struct SubmittedBatch
+    {
+        uint64_t    m_fenceValue;
+        CommandList m_cmdList;
+    };
+
+    ID3D12Device*               m_device;
+    ID3D12CommandQueue*         m_cmdQueue;
+    DispatchBatcherDesc         m_desc;
+
+    CommandListPool             m_cmdListPool;
+    // Note no cmd list while the batch is empty
+    CommandList                 m_cmdList;
+    std::vector<SubmittedBatch> m_submittedBatches;
+    ID3D12FenceComPtr           m_fence;
+    uint64_t                    m_fenceValue;
+
+    DispatchBatchPolicy         m_policy;
+    DispatchBatchStats          m_stats;
+
+    void BeginBatch();
+    void Flush(DispatchBatchFlushReason reason);
+    // Gives the cmd lists of the batches done back to the pool
+    void ReleaseFinishedBatches();
+};
+
+}
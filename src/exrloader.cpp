@@ -0,0 +1,593 @@
+#include "exrloader.h"
+
+#include <cassert>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+
+#include "tinyexr/tinyexr.h"
+
+namespace
+{
+// Magic number + version
+const size_t g_exrVersionSize = 8;
+const size_t g_exrHeaderReadSize = 64 * 1024;
+// Scanline chunks start with the first line and the data size
+const size_t g_scanlineChunkPrefixSize = 2 * sizeof(int);
+// Tile chunks start with the tile x, tile y, level x, level y and the data size
+const size_t g_tileChunkPrefixSize = 5 * sizeof(int);
+
+class ExrFile
+{
+public:
+    ExrFile(const std::wstring& fileName) : m_file(fileName.c_str(), std::ios::in | std::ios::binary), m_size(0)
+    {
+        if (m_file.is_open())
+        {
+            m_file.seekg(0, std::ios::end);
+            m_size = static_cast<uint64_t>(m_file.tellg());
+        }
+    }
+
+    bool IsOpen() const { return m_file.is_open(); }
+    uint64_t GetSize() const { return m_size; }
+
+    bool Read(uint64_t offset, size_t sizeBytes, unsigned char* dst)
+    {
+        if (offset + sizeBytes > m_size)
+            return false;
+
+        m_file.seekg(static_cast<std::streamoff>(offset));
+        m_file.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(sizeBytes));
+        return m_file.good();
+    }
+
+private:
+    std::ifstream   m_file;
+    uint64_t        m_size;
+};
+
+struct ScopedExrHeader
+{
+    ScopedExrHeader() { InitEXRHeader(&m_header); }
+    ~ScopedExrHeader() { FreeEXRHeader(&m_header); }
+    ScopedExrHeader(const ScopedExrHeader&) = delete;
+    ScopedExrHeader& operator=(const ScopedExrHeader&) = delete;
+
+    EXRHeader m_header;
+};
+
+struct ScopedExrImage
+{
+    ScopedExrImage() { InitEXRImage(&m_image); }
+    ~ScopedExrImage() { FreeEXRImage(&m_image); }
+    ScopedExrImage(const ScopedExrImage&) = delete;
+    ScopedExrImage& operator=(const ScopedExrImage&) = delete;
+
+    EXRImage m_image;
+};
+
+// Rectangle of decoded pixels, in coordinates of the level. Scanline files decode into a single block.
+struct DecodedBlock
+{
+    unsigned char** m_channels;
+    int             m_x;
+    int             m_y;
+    int             m_width;
+    int             m_height;
+    int             m_rowPitch; // in pixels
+};
+
+// Parses the header growing the read prefix of the file until the whole header fits.
+// headerBytes keeps the version and the header, which is what tinyexr expects before the offsets table.
+bool ReadHeader(ExrFile& file, EXRHeader& header, std::vector<unsigned char>& headerBytes)
+{
+    size_t readSize = g_exrHeaderReadSize;
+    while (true)
+    {
+        readSize = static_cast<size_t>(std::min<uint64_t>(readSize, file.GetSize()));
+        headerBytes.resize(readSize);
+        if (readSize <= g_exrVersionSize || !file.Read(0, readSize, &headerBytes[0]))
+            return false;
+
+        EXRVersion version;
+        if (ParseEXRVersionFromMemory(&version, &headerBytes[0], readSize) != TINYEXR_SUCCESS)
+            return false;
+
+        // Note multipart and deep files are not supported
+        if (version.multipart || version.non_image)
+            return false;
+
+        const char* error = nullptr;
+        if (ParseEXRHeaderFromMemory(&header, &version, &headerBytes[0], readSize, &error) == TINYEXR_SUCCESS)
+        {
+            headerBytes.resize(g_exrVersionSize + header.header_len);
+            return true;
+        }
+        FreeEXRErrorMessage(error);
+        FreeEXRHeader(&header);
+        InitEXRHeader(&header);
+
+        if (readSize == file.GetSize())
+            return false;
+        readSize *= 2;
+    }
+}
+
+int ScanlinesPerChunk(int compressionType)
+{
+    switch (compressionType)
+    {
+    case TINYEXR_COMPRESSIONTYPE_ZIP:
+    case TINYEXR_COMPRESSIONTYPE_ZFP:
+        return 16;
+    case TINYEXR_COMPRESSIONTYPE_PIZ:
+        return 32;
+    default:
+        return 1;
+    }
+}
+
+int LevelSize(int size, int level, int roundingMode)
+{
+    int levelSize = size >> level;
+    if (roundingMode == TINYEXR_TILE_ROUND_UP && (levelSize << level) < size)
+        ++levelSize;
+    return std::max(levelSize, 1);
+}
+
+int LevelsCount(int size, int roundingMode)
+{
+    int levelsCount = 1;
+    while (size > 1)
+    {
+        size = roundingMode == TINYEXR_TILE_ROUND_UP ? (size + 1) / 2 : size / 2;
+        ++levelsCount;
+    }
+    return levelsCount;
+}
+
+int TilesCount(int size, int tileSize)
+{
+    return (size + tileSize - 1) / tileSize;
+}
+
+int DataWidth(const EXRHeader& header)
+{
+    return header.data_window[2] - header.data_window[0] + 1;
+}
+
+int DataHeight(const EXRHeader& header)
+{
+    return header.data_window[3] - header.data_window[1] + 1;
+}
+
+int LevelsCount(const EXRHeader& header)
+{
+    if (!header.tiled)
+        return 1;
+
+    const int width = DataWidth(header);
+    const int height = DataHeight(header);
+    switch (header.tile_level_mode)
+    {
+    case TINYEXR_TILE_MIPMAP_LEVELS:
+        return LevelsCount(std::max(width, height), header.tile_rounding_mode);
+    case TINYEXR_TILE_RIPMAP_LEVELS:
+        return std::min(LevelsCount(width, header.tile_rounding_mode), LevelsCount(height, header.tile_rounding_mode));
+    default:
+        return 1;
+    }
+}
+
+int LevelTilesCount(const EXRHeader& header, int levelX, int levelY)
+{
+    const int width = LevelSize(DataWidth(header), levelX, header.tile_rounding_mode);
+    const int height = LevelSize(DataHeight(header), levelY, header.tile_rounding_mode);
+    return TilesCount(width, header.tile_size_x) * TilesCount(height, header.tile_size_y);
+}
+
+// Index in the offsets table of the first tile of the level. Tiles are stored level after level,
+// ripmaps with the x level changing fastest.
+int FirstTileIndex(const EXRHeader& header, int level)
+{
+    int tileIndex = 0;
+    if (header.tile_level_mode == TINYEXR_TILE_MIPMAP_LEVELS)
+    {
+        for (int i = 0; i < level; ++i)
+            tileIndex += LevelTilesCount(header, i, i);
+    }
+    else if (header.tile_level_mode == TINYEXR_TILE_RIPMAP_LEVELS)
+    {
+        const int levelsCountX = LevelsCount(DataWidth(header), header.tile_rounding_mode);
+        for (int levelY = 0; levelY < level; ++levelY)
+        {
+            for (int levelX = 0; levelX < levelsCountX; ++levelX)
+                tileIndex += LevelTilesCount(header, levelX, levelY);
+        }
+        for (int levelX = 0; levelX < level; ++levelX)
+            tileIndex += LevelTilesCount(header, levelX, level);
+    }
+    return tileIndex;
+}
+
+bool ReadOffsets(ExrFile& file, const EXRHeader& header, int firstChunk, int chunksCount, uint64_t* offsets)
+{
+    const uint64_t tableOffset = g_exrVersionSize + header.header_len + static_cast<uint64_t>(firstChunk) * sizeof(uint64_t);
+    if (!file.Read(tableOffset, chunksCount * sizeof(uint64_t), reinterpret_cast<unsigned char*>(offsets)))
+        return false;
+
+    // Note incomplete offsets tables are not reconstructed
+    for (int i = 0; i < chunksCount; ++i)
+    {
+        if (offsets[i] == 0 || offsets[i] >= file.GetSize())
+            return false;
+    }
+    return true;
+}
+
+// Appends the chunk to memory and stores its new offset in the offsets table at offsetsTableStart
+bool AppendChunk(ExrFile& file, uint64_t offset, size_t prefixSize, size_t offsetsTableStart, size_t chunkIndex,
+                 std::vector<unsigned char>& memory)
+{
+    const size_t chunkStart = memory.size();
+    const uint64_t newOffset = chunkStart;
+    memcpy(&memory[offsetsTableStart + chunkIndex * sizeof(uint64_t)], &newOffset, sizeof(uint64_t));
+
+    memory.resize(chunkStart + prefixSize);
+    if (!file.Read(offset, prefixSize, &memory[chunkStart]))
+        return false;
+
+    int dataSize = 0;
+    memcpy(&dataSize, &memory[chunkStart + prefixSize - sizeof(int)], sizeof(int));
+    if (dataSize <= 0)
+        return false;
+
+    memory.resize(chunkStart + prefixSize + dataSize);
+    return file.Read(offset + prefixSize, dataSize, &memory[chunkStart + prefixSize]);
+}
+
+// Reads only the chunks intersecting region and decodes them. The header is patched so tinyexr sees an
+// image made only of those chunks.
+// Note this tinyexr doesnt decode levels other than 0, so the tiles of the level are relabeled as level 0 tiles
+// of an image that starts at the first selected tile.
+bool DecodeRegion(const std::wstring& fileName, const Utils::ExrRegion& region, int level, bool halfAsFloat,
+                  EXRHeader& header, EXRImage& image, std::vector<DecodedBlock>& blocks)
+{
+    ExrFile file(fileName);
+    if (!file.IsOpen())
+        return false;
+
+    std::vector<unsigned char> memory;
+    if (!ReadHeader(file, header, memory))
+        return false;
+
+    if (level < 0 || level >= LevelsCount(header))
+        return false;
+
+    // Note tinyexr flips decreasing y scanline files, which doesnt map to a region of the file
+    if (!header.tiled && header.line_order != 0)
+        return false;
+
+    const int levelWidth = header.tiled ? LevelSize(DataWidth(header), level, header.tile_rounding_mode) : DataWidth(header);
+    const int levelHeight = header.tiled ? LevelSize(DataHeight(header), level, header.tile_rounding_mode) : DataHeight(header);
+    if (region.m_x < 0 || region.m_y < 0 || region.m_width <= 0 || region.m_height <= 0 ||
+        region.m_x + region.m_width > levelWidth || region.m_y + region.m_height > levelHeight)
+        return false;
+
+    for (int i = 0; i < header.num_channels; ++i)
+    {
+        if (halfAsFloat && header.pixel_types[i] == TINYEXR_PIXELTYPE_HALF)
+            header.requested_pixel_types[i] = TINYEXR_PIXELTYPE_FLOAT;
+    }
+
+    const size_t offsetsTableStart = memory.size();
+    const char* error = nullptr;
+    if (!header.tiled)
+    {
+        const int scanlinesPerChunk = ScanlinesPerChunk(header.compression_type);
+        const int firstChunk = region.m_y / scanlinesPerChunk;
+        const int lastChunk = (region.m_y + region.m_height - 1) / scanlinesPerChunk;
+        const int chunksCount = lastChunk - firstChunk + 1;
+
+        std::vector<uint64_t> offsets(chunksCount);
+        if (!ReadOffsets(file, header, firstChunk, chunksCount, &offsets[0]))
+            return false;
+
+        memory.resize(offsetsTableStart + chunksCount * sizeof(uint64_t));
+        for (int i = 0; i < chunksCount; ++i)
+        {
+            if (!AppendChunk(file, offsets[i], g_scanlineChunkPrefixSize, offsetsTableStart, i, memory))
+                return false;
+        }
+
+        const int firstLine = firstChunk * scanlinesPerChunk;
+        const int originalDataHeight = DataHeight(header);
+        header.data_window[1] += firstLine;
+        header.data_window[3] = std::min(header.data_window[1] + chunksCount * scanlinesPerChunk,
+                                         header.data_window[1] - firstLine + originalDataHeight) - 1;
+        header.chunk_count = chunksCount;
+
+        if (LoadEXRImageFromMemory(&image, &header, &memory[0], memory.size(), &error) != TINYEXR_SUCCESS)
+        {
+            FreeEXRErrorMessage(error);
+            return false;
+        }
+
+        DecodedBlock block;
+        block.m_channels    = image.images;
+        block.m_x           = 0;
+        block.m_y           = firstLine;
+        block.m_width       = image.width;
+        block.m_height      = image.height;
+        block.m_rowPitch    = image.width;
+        blocks.push_back(block);
+    }
+    else
+    {
+        const int tileWidth = header.tile_size_x;
+        const int tileHeight = header.tile_size_y;
+        const int levelTilesCountX = TilesCount(levelWidth, tileWidth);
+        const int firstTileX = region.m_x / tileWidth;
+        const int firstTileY = region.m_y / tileHeight;
+        const int tilesCountX = (region.m_x + region.m_width - 1) / tileWidth - firstTileX + 1;
+        const int tilesCountY = (region.m_y + region.m_height - 1) / tileHeight - firstTileY + 1;
+        const int levelFirstTile = FirstTileIndex(header, level);
+
+        memory.resize(offsetsTableStart + tilesCountX * tilesCountY * sizeof(uint64_t));
+        std::vector<uint64_t> offsets(tilesCountX);
+        for (int y = 0; y < tilesCountY; ++y)
+        {
+            const int firstChunk = levelFirstTile + (firstTileY + y) * levelTilesCountX + firstTileX;
+            if (!ReadOffsets(file, header, firstChunk, tilesCountX, &offsets[0]))
+                return false;
+
+            for (int x = 0; x < tilesCountX; ++x)
+            {
+                const size_t chunkStart = memory.size();
+                if (!AppendChunk(file, offsets[x], g_tileChunkPrefixSize, offsetsTableStart, y * tilesCountX + x, memory))
+                    return false;
+
+                const int tileCoordinates[4] = { x, y, 0, 0 };
+                memcpy(&memory[chunkStart], tileCoordinates, sizeof(tileCoordinates));
+            }
+        }
+
+        const int selectionX = firstTileX * tileWidth;
+        const int selectionY = firstTileY * tileHeight;
+        header.data_window[0] = 0;
+        header.data_window[1] = 0;
+        header.data_window[2] = std::min(levelWidth, selectionX + tilesCountX * tileWidth) - selectionX - 1;
+        header.data_window[3] = std::min(levelHeight, selectionY + tilesCountY * tileHeight) - selectionY - 1;
+        header.chunk_count = tilesCountX * tilesCountY;
+
+        if (LoadEXRImageFromMemory(&image, &header, &memory[0], memory.size(), &error) != TINYEXR_SUCCESS)
+        {
+            FreeEXRErrorMessage(error);
+            return false;
+        }
+
+        for (int i = 0; i < image.num_tiles; ++i)
+        {
+            const EXRTile& tile = image.tiles[i];
+            DecodedBlock block;
+            block.m_channels    = tile.images;
+            block.m_x           = selectionX + tile.offset_x * tileWidth;
+            block.m_y           = selectionY + tile.offset_y * tileHeight;
+            block.m_width       = tile.width;
+            block.m_height      = tile.height;
+            block.m_rowPitch    = tileWidth;
+            blocks.push_back(block);
+        }
+    }
+
+    return true;
+}
+
+int FindChannel(const EXRHeader& header, const std::string& name)
+{
+    for (int c = 0; c < header.num_channels; ++c)
+    {
+        if (name == header.channels[c].name)
+            return c;
+    }
+    return -1;
+}
+
+float ReadChannelValue(const unsigned char* channel, int pixelType, size_t index)
+{
+    if (pixelType == TINYEXR_PIXELTYPE_UINT)
+        return static_cast<float>(reinterpret_cast<const unsigned int*>(channel)[index]);
+    return reinterpret_cast<const float*>(channel)[index];
+}
+}
+
+size_t Utils::GetExrPixelTypeSize(ExrPixelType pixelType)
+{
+    return pixelType == ExrPixelType::Half ? 2 : 4;
+}
+
+size_t Utils::ExrChannelsData::GetRowPitch(size_t channel) const
+{
+    if (m_layout == ExrLayout::Planar)
+        return m_width * GetExrPixelTypeSize(m_pixelTypes[channel]);
+    return m_width * GetExrPixelTypeSize(m_pixelTypes[0]) * GetChannelsCount();
+}
+
+bool Utils::ReadExrInfo(const std::wstring& fileName, ExrInfo& info)
+{
+    ExrFile file(fileName);
+    if (!file.IsOpen())
+        return false;
+
+    ScopedExrHeader header;
+    std::vector<unsigned char> headerBytes;
+    if (!ReadHeader(file, header.m_header, headerBytes))
+        return false;
+
+    info.m_width            = DataWidth(header.m_header);
+    info.m_height           = DataHeight(header.m_header);
+    info.m_channelsCount    = header.m_header.num_channels;
+    info.m_isTiled          = header.m_header.tiled != 0;
+    info.m_tileWidth        = info.m_isTiled ? header.m_header.tile_size_x : 0;
+    info.m_tileHeight       = info.m_isTiled ? header.m_header.tile_size_y : 0;
+    info.m_levelsCount      = LevelsCount(header.m_header);
+    return true;
+}
+
+bool Utils::ReadTexRawDataRegionFromFile(const std::wstring& fileName, const ExrRegion& region, int level,
+                                         float* dst, size_t dstRowPitchBytes)
+{
+    assert(dst);
+    assert(dstRowPitchBytes >= region.m_width * 4 * sizeof(float));
+
+    ScopedExrHeader header;
+    ScopedExrImage image;
+    std::vector<DecodedBlock> blocks;
+    if (!DecodeRegion(fileName, region, level, true, header.m_header, image.m_image, blocks))
+        return false;
+
+    // Same mapping than LoadEXRFromMemory: a single channel is replicated, otherwise r, g and b are required
+    int rgbaChannels[4] = { -1, -1, -1, -1 };
+    const EXRHeader& exrHeader = header.m_header;
+    if (exrHeader.num_channels == 1)
+    {
+        std::fill(rgbaChannels, rgbaChannels + 4, 0);
+    }
+    else
+    {
+        const char* names[4] = { "R", "G", "B", "A" };
+        for (int c = 0; c < exrHeader.num_channels; ++c)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                if (strcmp(exrHeader.channels[c].name, names[i]) == 0)
+                    rgbaChannels[i] = c;
+            }
+        }
+        if (rgbaChannels[0] < 0 || rgbaChannels[1] < 0 || rgbaChannels[2] < 0)
+            return false;
+    }
+
+    for (const auto& block : blocks)
+    {
+        const int x0 = std::max(block.m_x, region.m_x);
+        const int y0 = std::max(block.m_y, region.m_y);
+        const int x1 = std::min(block.m_x + block.m_width, region.m_x + region.m_width);
+        const int y1 = std::min(block.m_y + block.m_height, region.m_y + region.m_height);
+
+        for (int y = y0; y < y1; ++y)
+        {
+            float* dstRow = reinterpret_cast<float*>(reinterpret_cast<unsigned char*>(dst) + (y - region.m_y) * dstRowPitchBytes);
+            const size_t srcRow = static_cast<size_t>(y - block.m_y) * block.m_rowPitch;
+            for (int x = x0; x < x1; ++x)
+            {
+                const size_t srcIndex = srcRow + (x - block.m_x);
+                float* dstTexel = dstRow + (x - region.m_x) * 4;
+                for (int i = 0; i < 4; ++i)
+                {
+                    const int c = rgbaChannels[i];
+                    dstTexel[i] = c < 0 ? 1.0f : ReadChannelValue(block.m_channels[c], exrHeader.requested_pixel_types[c], srcIndex);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+Utils::ExrChannelsDataPtr Utils::ReadExrChannelsRegionFromFile(const std::wstring& fileName, const ExrRegion& region,
+                                                               int level, const std::vector<std::string>& channelNames,
+                                                               ExrLayout layout)
+{
+    ScopedExrHeader header;
+    ScopedExrImage image;
+    std::vector<DecodedBlock> blocks;
+    if (!DecodeRegion(fileName, region, level, false, header.m_header, image.m_image, blocks))
+        return nullptr;
+
+    const EXRHeader& exrHeader = header.m_header;
+    std::vector<int> channels;
+    if (channelNames.empty())
+    {
+        for (int c = 0; c < exrHeader.num_channels; ++c)
+            channels.push_back(c);
+    }
+    else
+    {
+        for (const auto& name : channelNames)
+        {
+            const int c = FindChannel(exrHeader, name);
+            if (c < 0)
+                return nullptr;
+            channels.push_back(c);
+        }
+    }
+
+    auto data = std::make_unique<ExrChannelsData>();
+    data->m_layout = layout;
+    data->m_width = region.m_width;
+    data->m_height = region.m_height;
+
+    const size_t pixelsCount = static_cast<size_t>(region.m_width) * region.m_height;
+    size_t offset = 0;
+    for (int c : channels)
+    {
+        const auto pixelType = static_cast<ExrPixelType>(exrHeader.requested_pixel_types[c]);
+        if (layout == ExrLayout::Interleaved && !data->m_pixelTypes.empty() && pixelType != data->m_pixelTypes.front())
+            return nullptr;
+
+        data->m_channelNames.push_back(exrHeader.channels[c].name);
+        data->m_pixelTypes.push_back(pixelType);
+        data->m_channelOffsets.push_back(offset);
+        offset += layout == ExrLayout::Planar ? pixelsCount * GetExrPixelTypeSize(pixelType) : GetExrPixelTypeSize(pixelType);
+    }
+    const size_t pixelSize = layout == ExrLayout::Planar ? 0 : offset;
+    data->m_data.resize(layout == ExrLayout::Planar ? offset : pixelsCount * pixelSize);
+
+    for (const auto& block : blocks)
+    {
+        const int x0 = std::max(block.m_x, region.m_x);
+        const int y0 = std::max(block.m_y, region.m_y);
+        const int x1 = std::min(block.m_x + block.m_width, region.m_x + region.m_width);
+        const int y1 = std::min(block.m_y + block.m_height, region.m_y + region.m_height);
+        if (x0 >= x1 || y0 >= y1)
+            continue;
+
+        for (size_t i = 0; i < channels.size(); ++i)
+        {
+            const size_t channelSize = GetExrPixelTypeSize(data->m_pixelTypes[i]);
+            const unsigned char* src = block.m_channels[channels[i]];
+            for (int y = y0; y < y1; ++y)
+            {
+                const unsigned char* srcRow = src + (static_cast<size_t>(y - block.m_y) * block.m_rowPitch + (x0 - block.m_x)) * channelSize;
+                const size_t dstPixel = static_cast<size_t>(y - region.m_y) * region.m_width + (x0 - region.m_x);
+                if (layout == ExrLayout::Planar)
+                {
+                    memcpy(&data->m_data[data->m_channelOffsets[i] + dstPixel * channelSize], srcRow, (x1 - x0) * channelSize);
+                }
+                else
+                {
+                    unsigned char* dst = &data->m_data[dstPixel * pixelSize + data->m_channelOffsets[i]];
+                    for (int x = x0; x < x1; ++x, srcRow += channelSize, dst += pixelSize)
+                        memcpy(dst, srcRow, channelSize);
+                }
+            }
+        }
+    }
+
+    return data;
+}
+
+Utils::ExrChannelsDataPtr Utils::ReadExrChannelsFromFile(const std::wstring& fileName,
+                                                         const std::vector<std::string>& channelNames, ExrLayout layout)
+{
+    ExrInfo info;
+    if (!ReadExrInfo(fileName, info))
+        return nullptr;
+
+    const ExrRegion region = { 0, 0, info.m_width, info.m_height };
+    return ReadExrChannelsRegionFromFile(fileName, region, 0, channelNames, layout);
+}
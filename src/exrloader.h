@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace Utils
+{
+
+struct ExrInfo
+{
+    int  m_width;
+    int  m_height;
+    int  m_channelsCount;
+    bool m_isTiled;
+    int  m_tileWidth;
+    int  m_tileHeight;
+    // 1 for scanline files. Ripmapped files only expose their diagonal levels.
+    int  m_levelsCount;
+};
+
+// Rectangle relative to the origin of the data window of the requested level
+struct ExrRegion
+{
+    int m_x;
+    int m_y;
+    int m_width;
+    int m_height;
+};
+
+// Same values than TINYEXR_PIXELTYPE_*
+enum class ExrPixelType
+{
+    UInt = 0,
+    Half = 1,
+    Float = 2
+};
+
+enum class ExrLayout
+{
+    // Every channel is stored in its own plane, one after the other. Planes can have different pixel types.
+    Planar,
+    // Channels are stored pixel by pixel. All the channels have to share the pixel type.
+    Interleaved
+};
+
+// Channels of an exr region as stored in the file, without any conversion. Rows are tightly packed.
+struct ExrChannelsData
+{
+    std::vector<unsigned char>  m_data;
+    std::vector<std::string>    m_channelNames;
+    std::vector<ExrPixelType>   m_pixelTypes;
+    // Offset of every channel in m_data. For interleaved data it's the offset inside the pixel.
+    std::vector<size_t>         m_channelOffsets;
+    ExrLayout                   m_layout;
+    int                         m_width;
+    int                         m_height;
+
+    size_t GetChannelsCount() const { return m_channelNames.size(); }
+
+    // Planar data has a plane per channel, interleaved data a single plane
+    const unsigned char* GetPlane(size_t channel) const
+    {
+        return &m_data[m_layout == ExrLayout::Planar ? m_channelOffsets[channel] : 0];
+    }
+    size_t GetRowPitch(size_t channel) const;
+};
+using ExrChannelsDataPtr = std::unique_ptr<ExrChannelsData>;
+
+size_t GetExrPixelTypeSize(ExrPixelType pixelType);
+
+// Only reads and parses the header
+bool ReadExrInfo(const std::wstring& fileName, ExrInfo& info);
+
+// Reads and decodes only the chunks (scanline blocks or tiles) intersecting region and writes the
+// region as rgba floats into dst. dstRowPitchBytes is the distance between rows in dst.
+// Channels are mapped as ReadTexRawDataFromFile does. level has to be 0 for scanline files.
+bool ReadTexRawDataRegionFromFile(const std::wstring& fileName, const ExrRegion& region, int level,
+                                  float* dst, size_t dstRowPitchBytes);
+
+// Reads only the channels in channelNames, in that order, keeping the pixel type they have in the file.
+// An empty channelNames reads all the channels in the order of the file.
+// Returns nullptr if a channel is missing or if interleaving channels with different pixel types.
+// Note tinyexr still decodes all the channels of the chunks intersecting region, only the result is trimmed.
+ExrChannelsDataPtr ReadExrChannelsRegionFromFile(const std::wstring& fileName, const ExrRegion& region, int level,
+                                                 const std::vector<std::string>& channelNames, ExrLayout layout);
+
+// Same as ReadExrChannelsRegionFromFile with the full level 0
+ExrChannelsDataPtr ReadExrChannelsFromFile(const std::wstring& fileName, const std::vector<std::string>& channelNames,
+                                           ExrLayout layout);
+
+}
@@ -0,0 +1,295 @@
+#include "fft.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "cmdlists.h"
+
+namespace
+{
+const wchar_t* g_fftShaderFileName      = L"./data/shaders/fft.hlsl";
+const char* g_fftRootSignatureName      = "FftRootSig";
+const uint32_t g_fftDescriptorsPerPass  = 3;
+// Note the radix of the passes after the groupshared one, CalculateFftRadices puts the smaller radix first
+const uint32_t g_fftStageRadix          = 8;
+const uint32_t g_fftStageGroupSize      = 64;
+const uint32_t g_fftRealGroupSize       = 256;
+
+// Root parameters as laid out in FftRootSig
+enum FftRootParameters
+{
+    FftRootParameters_Constants = 0,
+    FftRootParameters_Table
+};
+
+enum FftBuffer
+{
+    FftBuffer_Src = 0,
+    FftBuffer_Dst,
+    FftBuffer_Temp0,
+    FftBuffer_Temp1
+};
+
+uint32_t DivideRoundingUp(uint32_t value, uint32_t divisor)
+{
+    return (value + divisor - 1) / divisor;
+}
+
+// Note complex elements, real ones are read and written two at a time
+uint32_t CalculateElementsCount(const ComputeBasics::FftDesc& desc, bool isComplexSide)
+{
+    const uint32_t width = isComplexSide ? ComputeBasics::CalculateFftComplexWidth(desc) :
+                           desc.m_type == ComputeBasics::FftType::RealToComplex ? desc.m_width / 2 : desc.m_width;
+    return width * desc.m_height;
+}
+}
+
+using namespace ComputeBasics;
+
+const uint32_t FftPlan::g_maxGroupSharedSize;
+
+FftPlan::FftPlan(ID3D12Device* device, const FftDesc& desc) : m_device(device), m_desc(desc), m_areTwiddlesCopied(false)
+{
+    assert(m_device);
+    assert(IsValidFftDesc(m_desc));
+
+    const bool isReal = m_desc.m_type == FftType::RealToComplex;
+    const uint32_t rowSize = isReal ? m_desc.m_width / 2 : m_desc.m_width;
+
+    // Note all the twiddles in a buffer, the rows ones then the columns ones and the real ones
+    std::vector<Cpu::Complex> twiddles = Cpu::CalculateFftTwiddles(rowSize);
+    const uint32_t columnTwiddlesOffset = static_cast<uint32_t>(twiddles.size());
+    if (m_desc.m_height > 1)
+    {
+        const auto columnTwiddles = Cpu::CalculateFftTwiddles(m_desc.m_height);
+        twiddles.insert(twiddles.end(), columnTwiddles.begin(), columnTwiddles.end());
+    }
+    const uint32_t realTwiddlesOffset = static_cast<uint32_t>(twiddles.size());
+    if (isReal)
+    {
+        const auto realTwiddles = Cpu::CalculateFftRealTwiddles(m_desc.m_width);
+        twiddles.insert(twiddles.end(), realTwiddles.begin(), realTwiddles.end());
+    }
+    // Note sizes of 2 dont have twiddles
+    if (twiddles.empty())
+        twiddles.push_back({ 1.0f, 0.0f });
+    m_twiddlesCount = static_cast<uint32_t>(twiddles.size());
+
+    const uint64_t twiddlesSizeBytes = twiddles.size() * sizeof(Cpu::Complex);
+    m_twiddlesUpload = AllocateUpload(m_device, twiddlesSizeBytes, L"Fft Twiddles Upload");
+    {
+        ScopedMappedGpuMemAlloc mapped(m_twiddlesUpload);
+        memcpy(mapped.GetBuffer(), &twiddles[0], twiddlesSizeBytes);
+    }
+    m_twiddles = Allocate(m_device, twiddlesSizeBytes, false, L"Fft Twiddles");
+
+    for (uint32_t direction = 0; direction < g_directionsCount; ++direction)
+        CreatePasses(static_cast<FftDirection>(direction), 0, columnTwiddlesOffset, realTwiddlesOffset);
+
+    const uint32_t columnsGroupSharedSize = m_desc.m_height > 1 ? CalculateGroupSharedSize(m_desc.m_height) : 0;
+    const uint32_t groupSharedSizes[FftKernel_Count] = { CalculateGroupSharedSize(rowSize), columnsGroupSharedSize,
+                                                         0, 0 };
+    size_t passesCount = 0;
+    for (uint32_t direction = 0; direction < g_directionsCount; ++direction)
+    {
+        passesCount = std::max(passesCount, m_passes[direction].size());
+        for (const Pass& pass : m_passes[direction])
+        {
+            PipelineState& pipelineState = m_pipelineStates[pass.m_kernel][direction];
+            if (pipelineState.m_pso)
+                continue;
+
+            const uint32_t groupSharedSize = groupSharedSizes[pass.m_kernel];
+            const uint32_t passType = pass.m_kernel == FftKernel_Stage ? 1 : pass.m_kernel == FftKernel_Real ? 2 : 0;
+            ShaderDefines defines
+            {
+                { "FFT_PASS", std::to_string(passType) },
+                { "FFT_INVERSE", std::to_string(direction) },
+                { "FFT_RADIX", std::to_string(g_fftStageRadix) }
+            };
+            if (groupSharedSize > 0)
+            {
+                defines.push_back({ "FFT_GROUPSHARED_SIZE", std::to_string(groupSharedSize) });
+                defines.push_back({ "FFT_GROUP_SIZE", std::to_string(std::max(groupSharedSize / 8, 1u)) });
+            }
+            pipelineState = CreatePipelineState(m_device, g_fftShaderFileName, g_fftRootSignatureName, defines,
+                                                L"Fft Kernel " + std::to_wstring(pass.m_kernel) + L" Direction " +
+                                                std::to_wstring(direction));
+        }
+    }
+
+    // Note the last pass writes dst and the ones before alternate between the temps
+    const uint32_t tempElementsCount = CalculateElementsCount(m_desc, true);
+    for (size_t i = 0; i + 1 < passesCount && i < 2; ++i)
+        m_temps[i] = Allocate(m_device, tempElementsCount * sizeof(Cpu::Complex), true,
+                              L"Fft Temp " + std::to_wstring(i));
+}
+
+uint32_t FftPlan::CalculateGroupSharedSize(uint32_t size)
+{
+    // Note the first stages up to g_maxGroupSharedSize elements
+    uint32_t groupSharedSize = 1;
+    for (uint32_t radix : CalculateFftRadices(size))
+    {
+        if (groupSharedSize * radix > g_maxGroupSharedSize)
+            break;
+        groupSharedSize *= radix;
+    }
+
+    return groupSharedSize;
+}
+
+void FftPlan::AddTransformPasses(FftKernel groupSharedKernel, uint32_t size, uint32_t batchesCount,
+                                 uint32_t elementStride, uint32_t batchStride, uint32_t twiddlesOffset,
+                                 std::vector<Pass>& passes)
+{
+    const uint32_t groupSharedSize = CalculateGroupSharedSize(size);
+    const PassConstants groupSharedConstants = { size, 1, twiddlesOffset, elementStride, batchStride, 0, 0, 0 };
+    passes.push_back({ groupSharedKernel, groupSharedConstants, size / groupSharedSize, batchesCount });
+
+    // Note the twiddles of the stages of the groupshared pass come first, as many as its elements minus 1 per
+    // radix 8 stage and the same for the first stage
+    const std::vector<uint32_t> radices = CalculateFftRadices(size);
+    uint32_t stride = 1;
+    for (uint32_t radix : radices)
+    {
+        if (stride < groupSharedSize)
+        {
+            twiddlesOffset += (radix - 1) * stride;
+            stride *= radix;
+            continue;
+        }
+
+        assert(radix == g_fftStageRadix);
+        const uint32_t butterfliesCount = size / radix;
+        const PassConstants constants = { size, stride, twiddlesOffset, elementStride, batchStride, 0,
+                                          butterfliesCount, 0 };
+        passes.push_back({ FftKernel_Stage, constants, DivideRoundingUp(butterfliesCount, g_fftStageGroupSize),
+                           batchesCount });
+        twiddlesOffset += (radix - 1) * stride;
+        stride *= radix;
+    }
+}
+
+void FftPlan::CreatePasses(FftDirection direction, uint32_t rowTwiddlesOffset, uint32_t columnTwiddlesOffset,
+                           uint32_t realTwiddlesOffset)
+{
+    std::vector<Pass>& passes = m_passes[static_cast<uint32_t>(direction)];
+    const uint32_t width = m_desc.m_width;
+    const uint32_t height = m_desc.m_height;
+    const uint32_t complexWidth = CalculateFftComplexWidth(m_desc);
+
+    auto addColumnsPasses = [&]()
+    {
+        if (height > 1)
+            AddTransformPasses(FftKernel_ColumnsGroupShared, height, complexWidth, complexWidth, 1,
+                               columnTwiddlesOffset, passes);
+    };
+
+    if (m_desc.m_type == FftType::ComplexToComplex)
+    {
+        AddTransformPasses(FftKernel_RowsGroupShared, width, height, 1, width, rowTwiddlesOffset, passes);
+        addColumnsPasses();
+        return;
+    }
+
+    // Note a row of real elements is transformed as a row of half as many complex ones
+    const uint32_t halfWidth = width / 2;
+    if (direction == FftDirection::Forward)
+    {
+        AddTransformPasses(FftKernel_RowsGroupShared, halfWidth, height, 1, halfWidth, rowTwiddlesOffset, passes);
+        const PassConstants constants = { halfWidth, 0, realTwiddlesOffset, 0, halfWidth, complexWidth,
+                                          complexWidth, 0 };
+        passes.push_back({ FftKernel_Real, constants, DivideRoundingUp(complexWidth, g_fftRealGroupSize), height });
+        addColumnsPasses();
+    }
+    else
+    {
+        addColumnsPasses();
+        const PassConstants constants = { halfWidth, 0, realTwiddlesOffset, 0, complexWidth, halfWidth, halfWidth, 0 };
+        passes.push_back({ FftKernel_Real, constants, DivideRoundingUp(halfWidth, g_fftRealGroupSize), height });
+        AddTransformPasses(FftKernel_RowsGroupShared, halfWidth, height, 1, halfWidth, rowTwiddlesOffset, passes);
+    }
+}
+
+bool FftPlan::IsValid() const
+{
+    for (uint32_t direction = 0; direction < g_directionsCount; ++direction)
+    {
+        for (const Pass& pass : m_passes[direction])
+        {
+            if (!m_pipelineStates[pass.m_kernel][direction].m_pso)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+DescriptorHeapPtr FftPlan::EnqueueFft(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& src,
+                                      const GpuMemAllocation& dst, FftDirection direction)
+{
+    assert(IsValid());
+    assert(computeCmdList);
+    assert(src.m_resource);
+    assert(dst.m_resource);
+    assert(src.m_resource != dst.m_resource);
+
+    ID3D12Resource* twiddles = m_twiddles.m_resource.Get();
+    if (!m_areTwiddlesCopied)
+    {
+        // Note the buffer is promoted from COMMON to COPY_DEST. Afterwards buffers decay back to COMMON and are
+        // promoted to NON_PIXEL_SHADER_RESOURCE when the passes read them
+        computeCmdList->CopyBufferRegion(twiddles, 0, m_twiddlesUpload.m_resource.Get(), 0,
+                                         m_twiddlesCount * sizeof(Cpu::Complex));
+        const auto barrier = CreateTransition(twiddles, D3D12_RESOURCE_STATE_COPY_DEST,
+                                              D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        computeCmdList->ResourceBarrier(1, &barrier);
+        m_areTwiddlesCopied = true;
+    }
+
+    const std::vector<Pass>& passes = m_passes[static_cast<uint32_t>(direction)];
+    const bool isForward = direction == FftDirection::Forward;
+    const GpuMemAllocation* buffers[] = { &src, &dst, &m_temps[0], &m_temps[1] };
+    const uint32_t tempElementsCount = CalculateElementsCount(m_desc, true);
+    const uint32_t elementsCounts[] = { CalculateElementsCount(m_desc, !isForward),
+                                        CalculateElementsCount(m_desc, isForward),
+                                        tempElementsCount, tempElementsCount };
+
+    auto descriptorHeap = std::make_unique<DescriptorHeap>(m_device,
+                                                           static_cast<uint32_t>(passes.size()) * g_fftDescriptorsPerPass);
+    ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { descriptorHeap->GetD3D12DescriptorHeap() };
+    computeCmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+
+    uint32_t input = FftBuffer_Src;
+    for (size_t i = 0; i < passes.size(); ++i)
+    {
+        const Pass& pass = passes[i];
+        const size_t remainingPassesCount = passes.size() - 1 - i;
+        const uint32_t output = remainingPassesCount == 0 ? FftBuffer_Dst :
+                                remainingPassesCount % 2 == 1 ? FftBuffer_Temp0 : FftBuffer_Temp1;
+
+        auto table = descriptorHeap->CreateStructuredBufferDescriptor(m_twiddles, m_twiddlesCount,
+                                                                      sizeof(Cpu::Complex), false);
+        descriptorHeap->CreateStructuredBufferDescriptor(*buffers[input], elementsCounts[input],
+                                                         sizeof(Cpu::Complex), true);
+        descriptorHeap->CreateStructuredBufferDescriptor(*buffers[output], elementsCounts[output],
+                                                         sizeof(Cpu::Complex), true);
+
+        const auto& pipelineState = m_pipelineStates[pass.m_kernel][static_cast<uint32_t>(direction)];
+        computeCmdList->SetComputeRootSignature(pipelineState.m_rootSignature.Get());
+        computeCmdList->SetPipelineState(pipelineState.m_pso.Get());
+        computeCmdList->SetComputeRoot32BitConstants(FftRootParameters_Constants,
+                                                     sizeof(pass.m_constants) / sizeof(uint32_t), &pass.m_constants, 0);
+        computeCmdList->SetComputeRootDescriptorTable(FftRootParameters_Table, table.m_gpuHandle);
+        computeCmdList->Dispatch(pass.m_groupsCountX, pass.m_groupsCountY, 1);
+
+        // Note the next pass reads what this one wrote
+        const auto barrier = CreateUAVBarrier(buffers[output]->m_resource.Get());
+        computeCmdList->ResourceBarrier(1, &barrier);
+        input = output;
+    }
+
+    return descriptorHeap;
+}
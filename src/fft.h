@@ -0,0 +1,93 @@
+#pragma once
+
+#include "common.h"
+
+#include <vector>
+
+#include "gpumemory.h"
+#include "descriptors.h"
+#include "pipelinestate.h"
+#include "cpufft.h"
+
+namespace ComputeBasics
+{
+
+// Fft on the gpu using data/shaders/fft.hlsl, same transforms and layouts than Cpu::FftPlan.
+// Transforms of up to g_maxGroupSharedSize elements run in groupshared memory in a single pass, bigger ones do
+// their first stages in groupshared memory and a pass per remaining radix 8 stage. 2d transforms run the rows
+// and then the columns as strided batches, so the columns are read and written g_width elements apart.
+// The plan caches the pipeline states, the twiddles and the temporary buffers the passes ping pong between.
+class FftPlan
+{
+public:
+    static const uint32_t g_maxGroupSharedSize = 4096;
+
+    FftPlan(ID3D12Device* device, const FftDesc& desc);
+
+    bool IsValid() const;
+    const FftDesc& GetDesc() const { return m_desc; }
+
+    // Reads and writes the same elements than Cpu::FftPlan::Execute. src and dst have to be different buffers
+    // allocated as RW, they are read and written as float2 structured buffers. src isnt modified.
+    // src and dst have to be in UNORDERED_ACCESS state. They are left as they are.
+    // Note the descriptor heaps of the cmd list are replaced.
+    // Note the first call copies the twiddles to the gpu, so the cmd lists have to execute in the order they
+    // were enqueued.
+    // Note calls share the temporary buffers, so they have to execute in the order they were enqueued.
+    // Note returning the descriptor heap so it outlives the execution in the gpu
+    DescriptorHeapPtr EnqueueFft(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& src,
+                                 const GpuMemAllocation& dst, FftDirection direction);
+
+private:
+    enum FftKernel
+    {
+        FftKernel_RowsGroupShared = 0,
+        FftKernel_ColumnsGroupShared,
+        FftKernel_Stage,
+        FftKernel_Real,
+        FftKernel_Count
+    };
+
+    // Same layout than FftConstants in data/shaders/fft.hlsl
+    struct PassConstants
+    {
+        uint32_t m_size;
+        uint32_t m_stride;
+        uint32_t m_twiddlesOffset;
+        uint32_t m_elementStride;
+        uint32_t m_batchStride;
+        uint32_t m_outputBatchStride;
+        uint32_t m_itemsCount;
+        uint32_t m_padding;
+    };
+
+    struct Pass
+    {
+        FftKernel       m_kernel;
+        PassConstants   m_constants;
+        uint32_t        m_groupsCountX;
+        uint32_t        m_groupsCountY;
+    };
+
+    static const uint32_t g_directionsCount = 2;
+
+    ID3D12Device*           m_device;
+    FftDesc                 m_desc;
+    PipelineState           m_pipelineStates[FftKernel_Count][g_directionsCount];
+    std::vector<Pass>       m_passes[g_directionsCount];
+    uint32_t                m_twiddlesCount;
+    GpuMemAllocation        m_twiddlesUpload;
+    GpuMemAllocation        m_twiddles;
+    bool                    m_areTwiddlesCopied;
+    GpuMemAllocation        m_temps[2];
+
+    void CreatePasses(FftDirection direction, uint32_t rowTwiddlesOffset, uint32_t columnTwiddlesOffset,
+                      uint32_t realTwiddlesOffset);
+    // Passes of batchesCount transforms of size elements, groupSharedKernel for the first stages
+    static void AddTransformPasses(FftKernel groupSharedKernel, uint32_t size, uint32_t batchesCount,
+                                   uint32_t elementStride, uint32_t batchStride, uint32_t twiddlesOffset,
+                                   std::vector<Pass>& passes);
+    static uint32_t CalculateGroupSharedSize(uint32_t size);
+};
+
+}
@@ -0,0 +1,1057 @@
+#include "gpubenchmarks.h"
+
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "benchmark.h"
+#include "cmdlists.h"
+#include "gpumemory.h"
+#include "mipsgenerator.h"
+#include "reduction.h"
+#include "prefixscan.h"
+#include "radixsort.h"
+#include "histogram.h"
+#include "compaction.h"
+#include "sgemm.h"
+#include "convolution.h"
+#include "fft.h"
+#include "colorpipeline.h"
+#include "commandlistpool.h"
+#include "dispatchbatcher.h"
+#include "constantring.h"
+#include "rootbinder.h"
+#include "residencymanager.h"
+#include "outofcore.h"
+
+namespace
+{
+// Note 16K rgba float textures need more than 5GB with their mips
+const uint32_t g_mipsBenchmarkSizes[] = { 1024, 2048, 4096, 8192, 16384 };
+const uint32_t g_reductionBenchmarkSizes[] = { 1 << 20, 1 << 24, 1 << 26, 1 << 28 };
+// Note a group per partition, 1 << 27 elements would go over the max dispatch size
+const uint32_t g_scanBenchmarkSizes[] = { 1 << 20, 1 << 24, 1 << 26 };
+const uint32_t g_radixSortBenchmarkSizes[] = { 1 << 10, 1 << 14, 1 << 18, 1 << 22, 1 << 26, 1 << 28 };
+// 4K and 8K uhd
+const uint32_t g_histogramBenchmarkSizes[][2] = { { 3840, 2160 }, { 7680, 4320 } };
+const uint32_t g_histogramBenchmarkBinsCounts[] = { 256, 1024 };
+const uint32_t g_compactionBenchmarkSizes[] = { 1 << 20, 1 << 24, 1 << 26 };
+// Note thresholds for Greater on uniform random keys, so about 5% and 50% of them survive
+const struct
+{
+    uint32_t    m_threshold;
+    const char* m_name;
+} g_compactionBenchmarkSelectivities[] = { { 0xF3333333, " 5%" }, { 0x80000000, " 50%" } };
+// m x n x k, square and skinny ones
+const uint32_t g_sgemmBenchmarkShapes[][3] =
+{
+    { 512, 512, 512 }, { 1024, 1024, 1024 }, { 2048, 2048, 2048 }, { 4096, 4096, 4096 },
+    { 4096, 64, 4096 }, { 64, 4096, 4096 }, { 4096, 4096, 64 }
+};
+// Note 256 threads per group in all of them. The small tiles keep more groups busy with the skinny shapes.
+const ComputeBasics::SgemmTileDesc g_sgemmBenchmarkTileDescs[] =
+{
+    { 32, 32, 16, 2, 2 }, { 64, 64, 16, 4, 4 }, { 128, 128, 8, 8, 8 }
+};
+// 4K and 8K uhd
+const uint32_t g_convolutionBenchmarkSizes[][2] = { { 3840, 2160 }, { 7680, 4320 } };
+const uint32_t g_convolutionBenchmarkRadii[] = { 1, 4, 16, 64 };
+// 1d sizes and 2d square ones
+const uint32_t g_fftBenchmarkSizes[] = { 1 << 10, 1 << 14, 1 << 18, 1 << 22, 1 << 24 };
+const uint32_t g_fft2DBenchmarkSizes[] = { 1024, 4096, 8192 };
+// 4K and 8K uhd
+const uint32_t g_colorPipelineBenchmarkSizes[][2] = { { 3840, 2160 }, { 7680, 4320 } };
+// Note small dispatches of data/shaders/simple.hlsl, as in the batches where recording costs as much as the work
+const uint32_t g_parallelRecordingBenchmarkDispatchesCounts[] = { 1024, 16384, 65536 };
+const uint32_t g_parallelRecordingBenchmarkGroupsPerDispatch = 4;
+const uint32_t g_parallelRecordingBenchmarkThreadsPerGroup = 64;
+const uint32_t g_parallelRecordingBenchmarkMinDispatchesPerThread = 64;
+const uint32_t g_dispatchBatchingBenchmarkJobsCount = 16384;
+const uint32_t g_dispatchBatchingBenchmarkBatchSizes[] = { 1, 8, 64, 512, 4096 };
+const uint32_t g_dispatchBatchingBenchmarkElementsPerJob = 256;
+const uint32_t g_dispatchBatchingBenchmarkGroupSize = 64;
+// Note sizes of constant blocks, from a single block to the 4KB max of a constant buffer view
+const uint32_t g_constantRingBenchmarkBlockSizes[] = { 256, 1024, 4096 };
+const uint64_t g_constantRingBenchmarkFrameSizeBytes = 4 << 20;
+const uint32_t g_constantRingBenchmarkFramesCount = 3;
+// Note a buffer per job, as distinct resources, and committed buffers take 64KB at least
+const uint32_t g_bindlessBenchmarkJobsCount = 1024;
+const uint32_t g_bindlessBenchmarkElementsPerJob = 256;
+const uint32_t g_bindlessBenchmarkGroupSize = 64;
+// Note 1GB of buffers against stand-in budgets of a part of them, the jobs sweep them so every one is evicted
+const uint32_t g_residencyBenchmarkBuffersCount = 64;
+const uint64_t g_residencyBenchmarkBufferSizeBytes = 16 << 20;
+const uint64_t g_residencyBenchmarkBudgetsBytes[] = { 256 << 20, 512 << 20 };
+const uint32_t g_residencyBenchmarkJobsCount = 256;
+const uint32_t g_residencyBenchmarkBuffersPerJob = 4;
+// Note 1GB of floats through a 64MB budget, as an input several times bigger than the video memory
+const uint64_t g_outOfCoreBenchmarkElementsCount = 1 << 28;
+const uint64_t g_outOfCoreBenchmarkBudgetBytes = 64 << 20;
+const uint32_t g_outOfCoreBenchmarkBuffersCounts[] = { 1, 2, 3 };
+const uint32_t g_outOfCoreBenchmarkGroupSize = 64;
+const uint32_t g_timestampsCount = 2;
+
+std::string SizeToString(uint32_t width, uint32_t height)
+{
+    return std::to_string(width) + "x" + std::to_string(height);
+}
+
+// Note the customary 5 N log2 N flops of a complex transform, half of them for a real one
+double CalculateFftFlops(const ComputeBasics::FftDesc& desc)
+{
+    const double size = static_cast<double>(desc.m_width) * desc.m_height;
+    const double flops = 5.0 * size * std::log2(size);
+    return desc.m_type == ComputeBasics::FftType::RealToComplex ? 0.5 * flops : flops;
+}
+
+// Note all the steps, as a batch job taking a linear rec 709 exr to a tone mapped rec 2020 one
+ComputeBasics::ColorPipelineDesc CreateColorPipelineBenchmarkDesc()
+{
+    ComputeBasics::ColorPipelineDesc desc = {};
+    desc.m_useExposure = true;
+    desc.m_exposure = 1.0f;
+    desc.m_useColorMatrix = true;
+    std::copy(std::begin(ComputeBasics::g_rec709ToRec2020Matrix), std::end(ComputeBasics::g_rec709ToRec2020Matrix),
+              desc.m_colorMatrix);
+    desc.m_toneCurve = ComputeBasics::ToneCurve::AcesFilmic;
+    return desc;
+}
+
+// Note xorshift, deterministic and fast enough to fill big inputs
+ComputeBasics::GpuMemAllocation AllocateRandomUpload(ID3D12Device* device, uint32_t count, const std::wstring& name)
+{
+    auto upload = ComputeBasics::AllocateUpload(device, static_cast<uint64_t>(count) * sizeof(uint32_t), name);
+    ComputeBasics::ScopedMappedGpuMemAlloc mapped(upload);
+    uint32_t* data = static_cast<uint32_t*>(mapped.GetBuffer());
+
+    uint32_t state = 0x9E3779B9;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        data[i] = state;
+    }
+
+    return upload;
+}
+
+// Note values in [-1, 1) so the sums stay small
+ComputeBasics::GpuMemAllocation AllocateRandomFloatsUpload(ID3D12Device* device, uint32_t count, const std::wstring& name)
+{
+    auto upload = AllocateRandomUpload(device, count, name);
+    ComputeBasics::ScopedMappedGpuMemAlloc mapped(upload);
+    uint32_t* data = static_cast<uint32_t*>(mapped.GetBuffer());
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const float value = static_cast<float>(data[i] >> 8) / (1 << 23) - 1.0f;
+        memcpy(&data[i], &value, sizeof(value));
+    }
+
+    return upload;
+}
+
+// Note one queue and one cmd list. Every measurement waits for the gpu to finish.
+class GpuBenchmarkContext
+{
+public:
+    GpuBenchmarkContext(ID3D12Device* device) : m_device(device)
+    {
+        assert(m_device);
+
+        m_cmdQueue = ComputeBasics::CreateComputeCmdQueue(m_device);
+        m_cmdList = ComputeBasics::CreateComputeCommandList(m_device, L"Benchmark");
+        Utils::AssertIfFailed(m_cmdList.m_cmdList->Close());
+        m_copyCmdQueue = ComputeBasics::CreateCopyCmdQueue(m_device);
+        m_copyCmdList = ComputeBasics::CreateCopyCommandList(m_device, L"Benchmark Upload");
+        Utils::AssertIfFailed(m_copyCmdList.m_cmdList->Close());
+
+        m_queryHeap = ComputeBasics::CreateTimestampQueryHeap(m_device, g_timestampsCount);
+        m_timestampsBuffer = ComputeBasics::AllocateReadback(m_device, g_timestampsCount * sizeof(uint64_t), 
+                                                             L"Benchmark Timestamps");
+    }
+
+    ID3D12Device* GetDevice() const { return m_device; }
+
+    // Records the work of recordWork between two timestamps, executes it and waits for it.
+    // Returns the gpu time in seconds.
+    template<typename RecordWork>
+    double Measure(RecordWork recordWork)
+    {
+        auto cmdList = m_cmdList.m_cmdList.Get();
+        Utils::AssertIfFailed(m_cmdList.m_allocator->Reset());
+        Utils::AssertIfFailed(cmdList->Reset(m_cmdList.m_allocator.Get(), nullptr));
+
+        ComputeBasics::EnqueueTimestampQuery(cmdList, m_queryHeap.Get(), 0);
+        recordWork(cmdList);
+        ComputeBasics::EnqueueTimestampQuery(cmdList, m_queryHeap.Get(), 1);
+        ComputeBasics::EnqueueResolveTimestampQueries(cmdList, m_queryHeap.Get(), g_timestampsCount, 
+                                                      m_timestampsBuffer.m_resource.Get());
+
+        ComputeBasics::ExecuteCmdList(m_device, m_cmdQueue.m_cmdQueue.Get(), cmdList);
+
+        auto timestamps = ComputeBasics::ReadbackTimestamps(m_timestampsBuffer, g_timestampsCount, 
+                                                            m_cmdQueue.m_timestampFrequency);
+        return timestamps[1] - timestamps[0];
+    }
+
+    // Uploads mip 0 of texture and waits for it. The texture decays to common state after it.
+    void UploadTexture(const ComputeBasics::GpuMemAllocation& texture, const ComputeBasics::SubresourceData& mip0)
+    {
+        auto cmdList = m_copyCmdList.m_cmdList.Get();
+        Utils::AssertIfFailed(m_copyCmdList.m_allocator->Reset());
+        Utils::AssertIfFailed(cmdList->Reset(m_copyCmdList.m_allocator.Get(), nullptr));
+
+        // Note the upload buffer has to live until the copy is done
+        auto upload = ComputeBasics::EnqueueUploadDataToTexture(m_device, cmdList, texture.m_resource.Get(), &mip0, 0, 1);
+        ComputeBasics::ExecuteCmdList(m_device, m_copyCmdQueue.m_cmdQueue.Get(), cmdList);
+    }
+
+private:
+    ID3D12Device*                   m_device;
+    ComputeBasics::CommandQueue     m_cmdQueue;
+    ComputeBasics::CommandList      m_cmdList;
+    ComputeBasics::CommandQueue     m_copyCmdQueue;
+    ComputeBasics::CommandList      m_copyCmdList;
+    ID3D12QueryHeapComPtr           m_queryHeap;
+    ComputeBasics::GpuMemAllocation m_timestampsBuffer;
+};
+}
+
+void ComputeBasics::RunGpuBenchmarks(ID3D12Device* device)
+{
+    BenchmarkGpuMipsGeneration(device);
+    BenchmarkGpuReduction(device);
+    BenchmarkGpuPrefixScan(device);
+    BenchmarkGpuRadixSort(device);
+    BenchmarkGpuHistogram(device);
+    BenchmarkGpuCompaction(device);
+    BenchmarkGpuSgemm(device);
+    BenchmarkGpuConvolution(device);
+    BenchmarkGpuFft(device);
+    BenchmarkGpuColorPipeline(device);
+    BenchmarkGpuParallelRecording(device);
+    BenchmarkGpuDispatchBatching(device);
+    BenchmarkGpuConstantRing(device);
+    BenchmarkGpuBindless(device);
+    BenchmarkGpuResidency(device);
+    BenchmarkGpuOutOfCore(device);
+}
+
+void ComputeBasics::BenchmarkGpuMipsGeneration(ID3D12Device* device)
+{
+    GpuBenchmarkContext context(device);
+
+    MipsGenerator mipsGenerator(device);
+    if (!mipsGenerator.IsValid())
+        return;
+
+    for (uint32_t size : g_mipsBenchmarkSizes)
+    {
+        TextureDesc desc;
+        desc.m_type         = TextureType::Texture2D;
+        desc.m_width        = size;
+        desc.m_height       = size;
+        desc.m_arraySize    = 1;
+        desc.m_mipsCount    = 0;
+        desc.m_format       = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        auto texture = Allocate(device, desc, true, L"Mips Benchmark");
+
+        // Note the first run pays for the first use of the texture
+        DescriptorHeapPtr descriptorHeap;
+        for (uint32_t run = 0; run < 2; ++run)
+        {
+            const double seconds = context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+            {
+                descriptorHeap = mipsGenerator.EnqueueGenerateMips(cmdList, texture, desc, 
+                                                                   D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+            });
+
+            if (run == 1)
+            {
+                const double mip0Bytes = static_cast<double>(size) * size * 4 * sizeof(float);
+                // Mip 0 read once and a third of it written for the rest of the chain
+                ReportBenchmark("Gpu Mips Generation", SizeToString(size, size), seconds, mip0Bytes * (1.0 + 1.0 / 3.0));
+            }
+        }
+    }
+}
+
+void ComputeBasics::BenchmarkGpuReduction(ID3D12Device* device)
+{
+    GpuBenchmarkContext context(device);
+
+    Reduction reduction(device, ReductionOp::Sum, ReductionDataType::Float);
+    if (!reduction.IsValid())
+        return;
+
+    const std::string permutation = reduction.UsesWaveIntrinsics() ? " wave" : " groupshared";
+    auto output = Allocate(device, sizeof(float), true, L"Reduction Benchmark Output");
+    for (uint32_t count : g_reductionBenchmarkSizes)
+    {
+        // Note the contents dont matter for the timing. The buffer is promoted from common to shader resource.
+        auto input = Allocate(device, static_cast<uint64_t>(count) * sizeof(float), false, L"Reduction Benchmark Input");
+
+        DescriptorHeapPtr descriptorHeap;
+        for (uint32_t run = 0; run < 2; ++run)
+        {
+            const double seconds = context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+            {
+                descriptorHeap = reduction.EnqueueReduce(cmdList, input, count, output);
+            });
+
+            if (run == 1)
+                ReportBenchmark("Gpu Reduction Sum", std::to_string(count) + permutation, seconds, 
+                                static_cast<double>(count) * sizeof(float));
+        }
+    }
+}
+
+void ComputeBasics::BenchmarkGpuPrefixScan(ID3D12Device* device)
+{
+    GpuBenchmarkContext context(device);
+
+    const uint32_t maxCount = g_scanBenchmarkSizes[_countof(g_scanBenchmarkSizes) - 1];
+    PrefixScan lookBackScan(device, ScanType::Exclusive, ScanAlgorithm::DecoupledLookBack, maxCount);
+    PrefixScan reduceThenScan(device, ScanType::Exclusive, ScanAlgorithm::ReduceThenScan, maxCount);
+    if (!lookBackScan.IsValid() || !reduceThenScan.IsValid())
+        return;
+
+    const std::string permutation = lookBackScan.UsesWaveIntrinsics() ? " wave" : " groupshared";
+    for (uint32_t count : g_scanBenchmarkSizes)
+    {
+        // Note the input is promoted from common to shader resource
+        const uint64_t sizeBytes = static_cast<uint64_t>(count) * sizeof(uint32_t);
+        auto input = Allocate(device, sizeBytes, false, L"Scan Benchmark Input");
+        auto output = Allocate(device, sizeBytes, true, L"Scan Benchmark Output");
+
+        PrefixScan* scans[] = { &lookBackScan, &reduceThenScan };
+        const char* algorithms[] = { " look-back", " reduce-then-scan" };
+        for (size_t i = 0; i < _countof(scans); ++i)
+        {
+            DescriptorHeapPtr descriptorHeap;
+            for (uint32_t run = 0; run < 2; ++run)
+            {
+                const double seconds = context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+                {
+                    descriptorHeap = scans[i]->EnqueueScan(cmdList, input, output, count);
+                });
+
+                // Every element is read once and written once
+                if (run == 1)
+                    ReportBenchmark("Gpu Prefix Scan", std::to_string(count) + algorithms[i] + permutation, seconds,
+                                    2.0 * sizeBytes);
+            }
+        }
+    }
+}
+
+void ComputeBasics::BenchmarkGpuRadixSort(ID3D12Device* device)
+{
+    GpuBenchmarkContext context(device);
+
+    const uint32_t maxCount = g_radixSortBenchmarkSizes[_countof(g_radixSortBenchmarkSizes) - 1];
+    const RadixSortType types[] = { RadixSortType::KeysOnly, RadixSortType::KeysValues };
+    for (RadixSortType type : types)
+    {
+        // Note one type at a time, the temporary buffers of the biggest sizes take gigabytes
+        RadixSort radixSort(device, type, maxCount);
+        if (!radixSort.IsValid())
+            return;
+
+        const bool hasValues = type == RadixSortType::KeysValues;
+        const std::string name = hasValues ? "Gpu Radix Sort Keys Values" : "Gpu Radix Sort Keys";
+        const std::string permutation = radixSort.UsesWaveIntrinsics() ? " wave" : " groupshared";
+        for (uint32_t count : g_radixSortBenchmarkSizes)
+        {
+            const uint64_t sizeBytes = static_cast<uint64_t>(count) * sizeof(uint32_t);
+            auto randomKeys = AllocateRandomUpload(device, count, L"Radix Sort Benchmark Random Keys");
+            auto keys = Allocate(device, sizeBytes, true, L"Radix Sort Benchmark Keys");
+            GpuMemAllocation values;
+            if (hasValues)
+                values = Allocate(device, sizeBytes, true, L"Radix Sort Benchmark Values");
+
+            DescriptorHeapPtr descriptorHeap;
+            for (uint32_t run = 0; run < 2; ++run)
+            {
+                // Note the sorts are in place so the keys are copied again before every run, out of the timing
+                context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+                {
+                    auto barrier = CreateTransition(keys.m_resource.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+                                                    D3D12_RESOURCE_STATE_COPY_DEST);
+                    cmdList->ResourceBarrier(1, &barrier);
+                    cmdList->CopyBufferRegion(keys.m_resource.Get(), 0, randomKeys.m_resource.Get(), 0, sizeBytes);
+                    barrier = CreateTransition(keys.m_resource.Get(), D3D12_RESOURCE_STATE_COPY_DEST,
+                                               D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+                    cmdList->ResourceBarrier(1, &barrier);
+                });
+
+                const double seconds = context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+                {
+                    descriptorHeap = hasValues ? radixSort.EnqueueSort(cmdList, keys, values, count) :
+                                                 radixSort.EnqueueSort(cmdList, keys, count);
+                });
+
+                if (run == 1)
+                    ReportBenchmark(name, std::to_string(count) + permutation, seconds, count / seconds / 1e6,
+                                    "Mkeys/s");
+            }
+        }
+    }
+}
+
+void ComputeBasics::BenchmarkGpuHistogram(ID3D12Device* device)
+{
+    GpuBenchmarkContext context(device);
+
+    const std::vector<float> percentiles = { 0.01f, 0.5f, 0.99f };
+    auto percentilesLuminance = Allocate(device, percentiles.size() * sizeof(float), true,
+                                         L"Histogram Benchmark Percentiles");
+    auto bins = Allocate(device, LuminanceHistogram::g_maxBinsCount * sizeof(uint32_t), true, L"Histogram Benchmark Bins");
+    for (auto& size : g_histogramBenchmarkSizes)
+    {
+        TextureDesc desc;
+        desc.m_type         = TextureType::Texture2D;
+        desc.m_width        = size[0];
+        desc.m_height       = size[1];
+        desc.m_arraySize    = 1;
+        desc.m_mipsCount    = 1;
+        desc.m_format       = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        auto texture = Allocate(device, desc, false, L"Histogram Benchmark Image");
+
+        // Note hdr values spread over the luminance range, a constant image would serialize the atomics
+        std::vector<float> texels(static_cast<size_t>(size[0]) * size[1] * 4);
+        uint32_t state = 0x9E3779B9;
+        for (size_t i = 0; i < texels.size(); ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            texels[i] = std::exp2(static_cast<float>(state >> 8) / (1 << 24) * 32.0f - 16.0f);
+        }
+        const SubresourceData mip0 = { &texels[0], size[0] * 4 * sizeof(float), texels.size() * sizeof(float) };
+        context.UploadTexture(texture, mip0);
+
+        for (uint32_t binsCount : g_histogramBenchmarkBinsCounts)
+        {
+            LuminanceHistogram histogram(device, HistogramDesc{ binsCount, 1.0f / 65536.0f, 65536.0f });
+            if (!histogram.IsValid())
+                return;
+
+            DescriptorHeapPtr descriptorHeap;
+            for (uint32_t run = 0; run < 2; ++run)
+            {
+                const double seconds = context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+                {
+                    descriptorHeap = histogram.EnqueueHistogram(cmdList, texture, desc, percentiles, bins,
+                                                                percentilesLuminance);
+                });
+
+                if (run == 1)
+                    ReportBenchmark("Gpu Luminance Histogram", SizeToString(size[0], size[1]) + " " +
+                                    std::to_string(binsCount) + " bins", seconds, 
+                                    static_cast<double>(texels.size()) * sizeof(float));
+            }
+        }
+    }
+}
+
+void ComputeBasics::BenchmarkGpuCompaction(ID3D12Device* device)
+{
+    GpuBenchmarkContext context(device);
+
+    const uint32_t maxCount = g_compactionBenchmarkSizes[_countof(g_compactionBenchmarkSizes) - 1];
+    Compaction compaction(device, CompactionDataType::UInt, CompactionPredicate::Greater, maxCount);
+    if (!compaction.IsValid())
+        return;
+
+    const std::string permutation = compaction.UsesWaveIntrinsics() ? " wave" : " groupshared";
+    auto arguments = Allocate(device, sizeof(CompactionArguments), true, L"Compaction Benchmark Arguments");
+    for (uint32_t count : g_compactionBenchmarkSizes)
+    {
+        const uint64_t sizeBytes = static_cast<uint64_t>(count) * sizeof(uint32_t);
+        auto randomKeys = AllocateRandomUpload(device, count, L"Compaction Benchmark Random Keys");
+        auto input = Allocate(device, sizeBytes, false, L"Compaction Benchmark Input");
+        auto output = Allocate(device, sizeBytes, true, L"Compaction Benchmark Output");
+
+        // Note the input decays to common state after the copy and is promoted when the shaders read it
+        context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+        {
+            cmdList->CopyBufferRegion(input.m_resource.Get(), 0, randomKeys.m_resource.Get(), 0, sizeBytes);
+        });
+
+        for (auto& selectivity : g_compactionBenchmarkSelectivities)
+        {
+            DescriptorHeapPtr descriptorHeap;
+            for (uint32_t run = 0; run < 2; ++run)
+            {
+                const double seconds = context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+                {
+                    descriptorHeap = compaction.EnqueueCompact(cmdList, input, count, selectivity.m_threshold, output,
+                                                               arguments, 64);
+                });
+
+                // Note the survivors count stays in the gpu, so only the input is accounted
+                if (run == 1)
+                    ReportBenchmark("Gpu Compaction", std::to_string(count) + selectivity.m_name + permutation,
+                                    seconds, static_cast<double>(sizeBytes));
+            }
+        }
+    }
+}
+
+void ComputeBasics::BenchmarkGpuSgemm(ID3D12Device* device)
+{
+    GpuBenchmarkContext context(device);
+
+    for (auto& shape : g_sgemmBenchmarkShapes)
+    {
+        const uint32_t m = shape[0];
+        const uint32_t n = shape[1];
+        const uint32_t k = shape[2];
+        const uint64_t aSizeBytes = static_cast<uint64_t>(m) * k * sizeof(float);
+        const uint64_t bSizeBytes = static_cast<uint64_t>(k) * n * sizeof(float);
+        auto randomValues = AllocateRandomFloatsUpload(device, m * k + k * n, L"Sgemm Benchmark Random Values");
+        auto a = Allocate(device, aSizeBytes, false, L"Sgemm Benchmark A");
+        auto b = Allocate(device, bSizeBytes, false, L"Sgemm Benchmark B");
+        auto c = Allocate(device, static_cast<uint64_t>(m) * n * sizeof(float), true, L"Sgemm Benchmark C");
+
+        // Note the inputs decay to common state after the copy and are promoted when the shader reads them
+        context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+        {
+            cmdList->CopyBufferRegion(a.m_resource.Get(), 0, randomValues.m_resource.Get(), 0, aSizeBytes);
+            cmdList->CopyBufferRegion(b.m_resource.Get(), 0, randomValues.m_resource.Get(), aSizeBytes, bSizeBytes);
+        });
+
+        for (auto& tileDesc : g_sgemmBenchmarkTileDescs)
+        {
+            Sgemm sgemm(device, tileDesc);
+            if (!sgemm.IsValid())
+                return;
+
+            const std::string config = std::to_string(m) + "x" + std::to_string(n) + "x" + std::to_string(k) +
+                                       " tile " + std::to_string(tileDesc.m_tileM) + "x" +
+                                       std::to_string(tileDesc.m_tileN) + "x" + std::to_string(tileDesc.m_tileK);
+            DescriptorHeapPtr descriptorHeap;
+            for (uint32_t run = 0; run < 2; ++run)
+            {
+                const double seconds = context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+                {
+                    descriptorHeap = sgemm.EnqueueSgemm(cmdList, m, n, k, 1.0f, a, b, 0.0f, c);
+                });
+
+                // Note a multiply add per m, n and k
+                if (run == 1)
+                    ReportBenchmark("Gpu Sgemm", config, seconds, 2.0 * m * n * k / seconds / 1e9, "GFLOP/s");
+            }
+        }
+    }
+}
+
+void ComputeBasics::BenchmarkGpuConvolution(ID3D12Device* device)
+{
+    GpuBenchmarkContext context(device);
+
+    for (auto& size : g_convolutionBenchmarkSizes)
+    {
+        TextureDesc desc;
+        desc.m_type         = TextureType::Texture2D;
+        desc.m_width        = size[0];
+        desc.m_height       = size[1];
+        desc.m_arraySize    = 1;
+        desc.m_mipsCount    = 1;
+        desc.m_format       = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        auto src = Allocate(device, desc, false, L"Convolution Benchmark Src");
+        auto intermediate = Allocate(device, desc, true, L"Convolution Benchmark Intermediate");
+        auto dst = Allocate(device, desc, true, L"Convolution Benchmark Dst");
+
+        std::vector<float> texels(static_cast<size_t>(size[0]) * size[1] * 4);
+        uint32_t state = 0x9E3779B9;
+        for (size_t i = 0; i < texels.size(); ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            texels[i] = static_cast<float>(state >> 8) / (1 << 24);
+        }
+        const SubresourceData mip0 = { &texels[0], size[0] * 4 * sizeof(float), texels.size() * sizeof(float) };
+        context.UploadTexture(src, mip0);
+
+        for (uint32_t radius : g_convolutionBenchmarkRadii)
+        {
+            SeparableConvolution convolution(device, CreateGaussianWeights(radius));
+            if (!convolution.IsValid())
+                return;
+
+            DescriptorHeapPtr descriptorHeap;
+            for (uint32_t run = 0; run < 2; ++run)
+            {
+                const double seconds = context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+                {
+                    descriptorHeap = convolution.EnqueueConvolution(cmdList, src, intermediate, dst, desc);
+                });
+
+                if (run == 1)
+                    ReportBenchmark("Gpu Separable Convolution", SizeToString(size[0], size[1]) + " radius " +
+                                    std::to_string(radius), seconds,
+                                    static_cast<double>(size[0]) * size[1] / seconds / 1e6, "Mpixels/s");
+            }
+        }
+    }
+}
+
+void ComputeBasics::BenchmarkGpuFft(ID3D12Device* device)
+{
+    GpuBenchmarkContext context(device);
+
+    std::vector<FftDesc> descs;
+    for (FftType type : { FftType::ComplexToComplex, FftType::RealToComplex })
+    {
+        for (uint32_t size : g_fftBenchmarkSizes)
+            descs.push_back({ type, size, 1 });
+        for (uint32_t size : g_fft2DBenchmarkSizes)
+            descs.push_back({ type, size, size });
+    }
+
+    for (const FftDesc& desc : descs)
+    {
+        const bool isReal = desc.m_type == FftType::RealToComplex;
+        const uint32_t elementsCount = desc.m_width * desc.m_height;
+        const uint32_t srcFloatsCount = isReal ? elementsCount : 2 * elementsCount;
+        const uint64_t srcSizeBytes = static_cast<uint64_t>(srcFloatsCount) * sizeof(float);
+        auto randomValues = AllocateRandomFloatsUpload(device, srcFloatsCount, L"Fft Benchmark Random Values");
+        auto src = Allocate(device, srcSizeBytes, true, L"Fft Benchmark Src");
+        auto dst = Allocate(device, static_cast<uint64_t>(CalculateFftComplexWidth(desc)) * desc.m_height *
+                            2 * sizeof(float), true, L"Fft Benchmark Dst");
+
+        context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+        {
+            auto barrier = CreateTransition(src.m_resource.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+                                            D3D12_RESOURCE_STATE_COPY_DEST);
+            cmdList->ResourceBarrier(1, &barrier);
+            cmdList->CopyBufferRegion(src.m_resource.Get(), 0, randomValues.m_resource.Get(), 0, srcSizeBytes);
+            barrier = CreateTransition(src.m_resource.Get(), D3D12_RESOURCE_STATE_COPY_DEST,
+                                       D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+            cmdList->ResourceBarrier(1, &barrier);
+        });
+
+        FftPlan plan(device, desc);
+        if (!plan.IsValid())
+            return;
+
+        const std::string config = (desc.m_height == 1 ? std::to_string(desc.m_width) :
+                                    SizeToString(desc.m_width, desc.m_height)) + (isReal ? " real" : " complex");
+        DescriptorHeapPtr descriptorHeap;
+        for (uint32_t run = 0; run < 2; ++run)
+        {
+            // Note the first run also copies the twiddles
+            const double seconds = context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+            {
+                descriptorHeap = plan.EnqueueFft(cmdList, src, dst, FftDirection::Forward);
+            });
+
+            if (run == 1)
+                ReportBenchmark("Gpu Fft", config, seconds, CalculateFftFlops(desc) / seconds / 1e9, "GFLOP/s");
+        }
+    }
+}
+
+void ComputeBasics::BenchmarkGpuColorPipeline(ID3D12Device* device)
+{
+    GpuBenchmarkContext context(device);
+
+    ColorPipeline colorPipeline(device, CreateColorPipelineBenchmarkDesc());
+    if (!colorPipeline.IsValid())
+        return;
+
+    for (auto& size : g_colorPipelineBenchmarkSizes)
+    {
+        TextureDesc desc;
+        desc.m_type         = TextureType::Texture2D;
+        desc.m_width        = size[0];
+        desc.m_height       = size[1];
+        desc.m_arraySize    = 1;
+        desc.m_mipsCount    = 1;
+        desc.m_format       = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        auto src = Allocate(device, desc, false, L"Color Pipeline Benchmark Src");
+        auto intermediate = Allocate(device, desc, true, L"Color Pipeline Benchmark Intermediate");
+        auto dst = Allocate(device, desc, true, L"Color Pipeline Benchmark Dst");
+
+        // Note hdr values, some of them negative as out of gamut ones
+        std::vector<float> texels(static_cast<size_t>(size[0]) * size[1] * 4);
+        uint32_t state = 0x9E3779B9;
+        for (size_t i = 0; i < texels.size(); ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            texels[i] = static_cast<float>(state >> 8) / (1 << 20) - 1.0f;
+        }
+        const SubresourceData mip0 = { &texels[0], size[0] * 4 * sizeof(float), texels.size() * sizeof(float) };
+        context.UploadTexture(src, mip0);
+
+        for (uint32_t isFused = 0; isFused < 2; ++isFused)
+        {
+            DescriptorHeapPtr descriptorHeap;
+            for (uint32_t run = 0; run < 2; ++run)
+            {
+                const double seconds = context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+                {
+                    descriptorHeap = isFused ? colorPipeline.EnqueueColorPipeline(cmdList, src, dst, desc) :
+                                               colorPipeline.EnqueueColorPipelineUnfused(cmdList, src, intermediate,
+                                                                                         dst, desc);
+                });
+
+                if (run == 1)
+                    ReportBenchmark("Gpu Color Pipeline", SizeToString(size[0], size[1]) +
+                                    (isFused ? " fused" : " unfused"), seconds,
+                                    static_cast<double>(size[0]) * size[1] / seconds / 1e6, "Mpixels/s");
+            }
+        }
+    }
+}
+
+void ComputeBasics::BenchmarkGpuParallelRecording(ID3D12Device* device)
+{
+    PipelineState pipelineState = CreatePipelineState(device, L"./data/shaders/simple.hlsl", L"Simple",
+                                                      L"Parallel Recording Benchmark");
+    if (!pipelineState.m_rootSignature || !pipelineState.m_pso || !pipelineState.m_bindingMap)
+        return;
+
+    const RootBindingMap& bindingMap = *pipelineState.m_bindingMap;
+    const uint32_t tableParameter = bindingMap.GetRootParameter("g_inputData");
+    const uint32_t constantsParameter = bindingMap.GetRootParameter("ConstantData");
+    const uint32_t inputPerGroupParameter = bindingMap.GetRootParameter("g_inputData1");
+
+    auto cmdQueue = CreateComputeCmdQueue(device);
+    CommandListPool cmdListPool(device, D3D12_COMMAND_LIST_TYPE_COMPUTE, L"Parallel Recording Benchmark");
+
+    // Note more than the usual 1 thread and all threads, to see how recording scales
+    const uint32_t threadsCounts[] = { 1, 2, 4, 0 };
+    const uint32_t elementsPerDispatch = g_parallelRecordingBenchmarkGroupsPerDispatch *
+                                         g_parallelRecordingBenchmarkThreadsPerGroup;
+
+    // Note the contents dont matter for the timing. All the dispatches write the same output, only the constants
+    // and the per group input change from one dispatch to the next.
+    auto input = Allocate(device, elementsPerDispatch * sizeof(float), false, L"Parallel Recording Benchmark Input");
+    auto output = Allocate(device, elementsPerDispatch * sizeof(float), true, L"Parallel Recording Benchmark Output");
+    DescriptorHeap descriptorHeap(device, 2);
+    descriptorHeap.CreateBufferDescriptor(input, DXGI_FORMAT_R32_FLOAT, elementsPerDispatch, false);
+    descriptorHeap.CreateBufferDescriptor(output, DXGI_FORMAT_R32_FLOAT, elementsPerDispatch, true);
+
+    for (uint32_t dispatchesCount : g_parallelRecordingBenchmarkDispatchesCounts)
+    {
+        auto inputPerGroup = Allocate(device, static_cast<uint64_t>(dispatchesCount) *
+                                      g_parallelRecordingBenchmarkGroupsPerDispatch * sizeof(float), false,
+                                      L"Parallel Recording Benchmark Input Per Thread Group");
+
+        const auto recordSlice = [&](ID3D12GraphicsCommandList* cmdList, const WorkSlice& workSlice)
+        {
+            // Note every cmd list starts with no state
+            ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { descriptorHeap.GetD3D12DescriptorHeap() };
+            cmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+
+            // Note the table is the same for all the dispatches, the binder sets it only once per cmd list
+            RootBinder rootBinder;
+            BindingBlock bindings(bindingMap.GetLayout());
+            for (uint32_t item = workSlice.m_firstItem; item < workSlice.m_firstItem + workSlice.m_itemsCount; ++item)
+            {
+                const uint64_t inputPerGroupOffset = static_cast<uint64_t>(item) *
+                                                     g_parallelRecordingBenchmarkGroupsPerDispatch * sizeof(float);
+                bindings.SetAddress(tableParameter, descriptorHeap.BeginGpuHandle().ptr);
+                const float constant = static_cast<float>(item);
+                bindings.SetConstants(constantsParameter, &constant, 1);
+                bindings.SetAddress(inputPerGroupParameter, inputPerGroup.m_resource->GetGPUVirtualAddress() +
+                                                            inputPerGroupOffset);
+                rootBinder.Apply(cmdList, pipelineState, bindings);
+                cmdList->Dispatch(g_parallelRecordingBenchmarkGroupsPerDispatch, 1, 1);
+            }
+        };
+
+        for (uint32_t threadsCount : threadsCounts)
+        {
+            const std::vector<WorkSlice> slices = SplitWork(dispatchesCount, threadsCount,
+                                                            g_parallelRecordingBenchmarkMinDispatchesPerThread);
+
+            // Note the first run pays for creating the cmd lists of the pool
+            for (uint32_t run = 0; run < 2; ++run)
+            {
+                BenchmarkTimer timer;
+                RecordAndExecuteInParallel(device, cmdQueue.m_cmdQueue.Get(), cmdListPool, slices, recordSlice);
+                const double seconds = timer.ElapsedSeconds();
+
+                if (run == 1)
+                {
+                    const std::string config = std::to_string(dispatchesCount) + " dispatches " +
+                                               (threadsCount == 0 ? "all" : std::to_string(threadsCount)) +
+                                               (threadsCount == 1 ? " thread" : " threads");
+                    ReportBenchmark("Gpu Parallel Recording", config, seconds, dispatchesCount / seconds / 1e3,
+                                    "Kdispatches/s");
+                }
+            }
+        }
+    }
+}
+
+void ComputeBasics::BenchmarkGpuDispatchBatching(ID3D12Device* device)
+{
+    auto cmdQueue = CreateComputeCmdQueue(device);
+
+    DispatchBatcherDesc desc;
+    desc.m_pipelineState = CreatePipelineState(device, L"./data/shaders/scalebias.hlsl", "ScaleBiasRootSig", {},
+                                               L"Dispatch Batching Benchmark");
+    desc.m_constantsCount = 4;
+    desc.m_buffers = { BatchedBufferType::ShaderResource, BatchedBufferType::UnorderedAccess };
+    if (!desc.m_pipelineState.m_rootSignature || !desc.m_pipelineState.m_pso)
+        return;
+
+    // Note the contents dont matter for the timing. The input is promoted from common to shader resource.
+    const uint64_t jobSizeBytes = g_dispatchBatchingBenchmarkElementsPerJob * sizeof(float);
+    auto input = Allocate(device, g_dispatchBatchingBenchmarkJobsCount * jobSizeBytes, false,
+                          L"Dispatch Batching Benchmark Input");
+    auto output = Allocate(device, g_dispatchBatchingBenchmarkJobsCount * jobSizeBytes, true,
+                           L"Dispatch Batching Benchmark Output");
+
+    for (uint32_t batchSize : g_dispatchBatchingBenchmarkBatchSizes)
+    {
+        // Note a latency long enough for the size to flush all the batches but the last one
+        desc.m_limits = { batchSize, 1.0 };
+        DispatchBatcher batcher(device, cmdQueue.m_cmdQueue.Get(), desc);
+
+        // Note the first run pays for creating the cmd lists of the pool
+        for (uint32_t run = 0; run < 2; ++run)
+        {
+            BenchmarkTimer timer;
+            for (uint32_t job = 0; job < g_dispatchBatchingBenchmarkJobsCount; ++job)
+            {
+                // Same layout than ScaleBiasConstants
+                const float scale = static_cast<float>(job);
+                const float bias = 1.0f;
+                BatchedDispatch batchedDispatch = {};
+                batchedDispatch.m_constants[0] = g_dispatchBatchingBenchmarkElementsPerJob;
+                memcpy(&batchedDispatch.m_constants[1], &scale, sizeof(scale));
+                memcpy(&batchedDispatch.m_constants[2], &bias, sizeof(bias));
+                batchedDispatch.m_buffers[0] = input.m_resource->GetGPUVirtualAddress() + job * jobSizeBytes;
+                batchedDispatch.m_buffers[1] = output.m_resource->GetGPUVirtualAddress() + job * jobSizeBytes;
+                batchedDispatch.m_groupsCountX = g_dispatchBatchingBenchmarkElementsPerJob /
+                                                 g_dispatchBatchingBenchmarkGroupSize;
+                batchedDispatch.m_groupsCountY = 1;
+                batchedDispatch.m_groupsCountZ = 1;
+                batcher.Add(batchedDispatch);
+            }
+            batcher.Flush();
+            batcher.Wait();
+            const double seconds = timer.ElapsedSeconds();
+
+            if (run == 1)
+            {
+                const uint32_t batchesCount = (g_dispatchBatchingBenchmarkJobsCount + batchSize - 1) / batchSize;
+                const std::string config = "batch " + std::to_string(batchSize) + ", " +
+                                           std::to_string(batchesCount) + " batches";
+                ReportBenchmark("Gpu Dispatch Batching", config, seconds,
+                                g_dispatchBatchingBenchmarkJobsCount / seconds / 1e3, "Kjobs/s");
+            }
+        }
+    }
+}
+
+void ComputeBasics::BenchmarkGpuConstantRing(ID3D12Device* device)
+{
+    auto cmdQueue = CreateComputeCmdQueue(device);
+    ConstantRing constantRing(device, g_constantRingBenchmarkFrameSizeBytes, g_constantRingBenchmarkFramesCount,
+                              L"Constant Ring Benchmark");
+
+    const uint32_t framesCount = 4 * g_constantRingBenchmarkFramesCount;
+    for (uint32_t blockSize : g_constantRingBenchmarkBlockSizes)
+    {
+        const std::vector<uint8_t> constants(blockSize, 0xFF);
+        const uint32_t blocksPerFrame = static_cast<uint32_t>(g_constantRingBenchmarkFrameSizeBytes / blockSize);
+
+        // Note going around the ring a few times, the frames are not used by any cmd list so they are never waited
+        BenchmarkTimer timer;
+        for (uint32_t frame = 0; frame < framesCount; ++frame)
+        {
+            for (uint32_t block = 0; block < blocksPerFrame; ++block)
+            {
+                volatile D3D12_GPU_VIRTUAL_ADDRESS address = constantRing.Push(&constants[0], blockSize);
+                assert(address != 0);
+            }
+            constantRing.EndFrame(cmdQueue.m_cmdQueue.Get());
+        }
+        const double seconds = timer.ElapsedSeconds();
+
+        const uint64_t blocksCount = static_cast<uint64_t>(blocksPerFrame) * framesCount;
+        ReportBenchmark("Gpu Constant Ring Push", std::to_string(blockSize) + " bytes blocks", seconds,
+                        static_cast<double>(blocksCount) * blockSize);
+    }
+}
+
+void ComputeBasics::BenchmarkGpuBindless(ID3D12Device* device)
+{
+    GpuBenchmarkContext context(device);
+
+    PipelineState pipelineState = CreatePipelineState(device, L"./data/shaders/bindless.hlsl", "BindlessRootSig", {},
+                                                      L"Bindless Benchmark");
+    if (!pipelineState.m_rootSignature || !pipelineState.m_pso || !pipelineState.m_bindingMap)
+        return;
+
+    BindlessDescriptorHeap bindlessHeap(device, 2 * g_bindlessBenchmarkJobsCount);
+    if (!bindlessHeap.IsValid())
+        return;
+
+    // Note the contents dont matter for the timing. The inputs are promoted from common to shader resource.
+    std::vector<GpuMemAllocation> buffers;
+    std::vector<uint32_t> inputIndices(g_bindlessBenchmarkJobsCount);
+    std::vector<uint32_t> outputIndices(g_bindlessBenchmarkJobsCount);
+    for (uint32_t job = 0; job < g_bindlessBenchmarkJobsCount; ++job)
+    {
+        buffers.push_back(Allocate(device, g_bindlessBenchmarkElementsPerJob * sizeof(float), false,
+                                   L"Bindless Benchmark Input"));
+        inputIndices[job] = bindlessHeap.CreateByteBufferDescriptor(buffers.back(), g_bindlessBenchmarkElementsPerJob,
+                                                                    false);
+        buffers.push_back(Allocate(device, g_bindlessBenchmarkElementsPerJob * sizeof(float), true,
+                                   L"Bindless Benchmark Output"));
+        outputIndices[job] = bindlessHeap.CreateByteBufferDescriptor(buffers.back(), g_bindlessBenchmarkElementsPerJob,
+                                                                     true);
+    }
+
+    const RootBindingMap& bindingMap = *pipelineState.m_bindingMap;
+    const uint32_t tableParameter = bindingMap.GetRootParameter("g_buffers");
+    const uint32_t constantsParameter = bindingMap.GetRootParameter("BindlessConstants");
+
+    for (uint32_t run = 0; run < 2; ++run)
+    {
+        const double seconds = context.Measure([&](ID3D12GraphicsCommandList* cmdList)
+        {
+            ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { bindlessHeap.GetD3D12DescriptorHeap() };
+            cmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+
+            // Note the table is set once, the jobs only change the indices and constants
+            RootBinder rootBinder;
+            BindingBlock bindings(bindingMap.GetLayout());
+            bindings.SetAddress(tableParameter, bindlessHeap.BeginGpuHandle().ptr);
+            for (uint32_t job = 0; job < g_bindlessBenchmarkJobsCount; ++job)
+            {
+                // Same layout than BindlessConstants
+                const float scale = static_cast<float>(job);
+                const float bias = 1.0f;
+                uint32_t constants[5] = { inputIndices[job], outputIndices[job], g_bindlessBenchmarkElementsPerJob };
+                memcpy(&constants[3], &scale, sizeof(scale));
+                memcpy(&constants[4], &bias, sizeof(bias));
+                bindings.SetConstants(constantsParameter, constants, 5);
+                rootBinder.Apply(cmdList, pipelineState, bindings);
+                cmdList->Dispatch(g_bindlessBenchmarkElementsPerJob / g_bindlessBenchmarkGroupSize, 1, 1);
+            }
+        });
+
+        if (run == 1)
+            ReportBenchmark("Gpu Bindless Dispatches", std::to_string(g_bindlessBenchmarkJobsCount) + " jobs", seconds,
+                            g_bindlessBenchmarkJobsCount / seconds / 1e3, "Kjobs/s");
+    }
+}
+
+
+void ComputeBasics::BenchmarkGpuResidency(ID3D12Device* device)
+{
+    std::vector<GpuMemAllocation> buffers;
+    for (uint32_t i = 0; i < g_residencyBenchmarkBuffersCount; ++i)
+        buffers.push_back(Allocate(device, g_residencyBenchmarkBufferSizeBytes, true, L"Residency Benchmark"));
+
+    for (uint64_t budgetBytes : g_residencyBenchmarkBudgetsBytes)
+    {
+        // Note no work uses the buffers, so they can be evicted right away
+        ResidencyManager residencyManager(device, nullptr, budgetBytes);
+        std::vector<uint32_t> allocations;
+        for (const GpuMemAllocation& buffer : buffers)
+            allocations.push_back(residencyManager.Track(buffer, ResidencyHeapType::Default));
+
+        BenchmarkTimer timer;
+        for (uint32_t job = 0; job < g_residencyBenchmarkJobsCount; ++job)
+        {
+            for (uint32_t i = 0; i < g_residencyBenchmarkBuffersPerJob; ++i)
+                residencyManager.Use(allocations[(job * g_residencyBenchmarkBuffersPerJob + i) %
+                                                 g_residencyBenchmarkBuffersCount]);
+            residencyManager.PrepareJob();
+        }
+        const double seconds = timer.ElapsedSeconds();
+
+        const ResidencyCounters& counters = residencyManager.GetCounters();
+        const std::string config = "budget " + std::to_string(budgetBytes >> 20) + "MB, " +
+                                   std::to_string(counters.m_evictionsCount) + " evictions";
+        ReportBenchmark("Gpu Residency Evict MakeResident", config, seconds,
+                        static_cast<double>(counters.m_madeResidentBytes));
+
+        for (uint32_t allocation : allocations)
+            residencyManager.Untrack(allocation);
+    }
+}
+
+void ComputeBasics::BenchmarkGpuOutOfCore(ID3D12Device* device)
+{
+    auto computeCmdQueue = CreateComputeCmdQueue(device);
+    auto copyCmdQueue = CreateCopyCmdQueue(device);
+
+    PipelineState pipelineState = CreatePipelineState(device, L"./data/shaders/scalebias.hlsl", "ScaleBiasRootSig",
+                                                      {}, L"Out Of Core Benchmark");
+    if (!pipelineState.m_rootSignature || !pipelineState.m_pso || !pipelineState.m_bindingMap)
+        return;
+
+    const RootBindingMap& bindingMap = *pipelineState.m_bindingMap;
+    const uint32_t constantsParameter = bindingMap.GetRootParameter("ScaleBiasConstants");
+    const uint32_t inputParameter = bindingMap.GetRootParameter("g_input");
+    const uint32_t outputParameter = bindingMap.GetRootParameter("g_output");
+
+    std::vector<float> input(g_outOfCoreBenchmarkElementsCount, 1.0f);
+    std::vector<float> output(g_outOfCoreBenchmarkElementsCount);
+
+    for (uint32_t buffersCount : g_outOfCoreBenchmarkBuffersCounts)
+    {
+        const OutOfCoreDesc desc = { OutOfCoreKernelType::Elementwise, g_outOfCoreBenchmarkElementsCount,
+                                     sizeof(float), sizeof(float), g_outOfCoreBenchmarkGroupSize, buffersCount,
+                                     g_outOfCoreBenchmarkBudgetBytes };
+        OutOfCoreExecutor executor(device, computeCmdQueue.m_cmdQueue.Get(), copyCmdQueue.m_cmdQueue.Get(), desc);
+        if (!executor.IsValid())
+            return;
+
+        // Note run 0 warms up the staging memory and the cmd lists
+        for (uint32_t run = 0; run < 2; ++run)
+        {
+            BenchmarkTimer timer;
+            executor.Execute(&input[0], &output[0], [&](ID3D12GraphicsCommandList* cmdList,
+                                                        const GpuMemAllocation& chunkInput,
+                                                        const GpuMemAllocation& chunkOutput,
+                                                        const OutOfCoreStep& step)
+            {
+                // Same layout than ScaleBiasConstants
+                const float scale = 2.0f;
+                const float bias = 1.0f;
+                uint32_t constants[4] = { step.m_elementsCount };
+                memcpy(&constants[1], &scale, sizeof(scale));
+                memcpy(&constants[2], &bias, sizeof(bias));
+
+                BindingBlock bindings(bindingMap.GetLayout());
+                bindings.SetConstants(constantsParameter, constants, 4);
+                bindings.SetAddress(inputParameter, chunkInput.m_resource->GetGPUVirtualAddress());
+                bindings.SetAddress(outputParameter, chunkOutput.m_resource->GetGPUVirtualAddress());
+                RootBinder rootBinder;
+                rootBinder.Apply(cmdList, pipelineState, bindings);
+                cmdList->Dispatch((step.m_elementsCount + g_outOfCoreBenchmarkGroupSize - 1) /
+                                  g_outOfCoreBenchmarkGroupSize, 1, 1);
+            });
+            const double seconds = timer.ElapsedSeconds();
+
+            if (run == 1)
+            {
+                const std::string config = std::to_string(buffersCount) + " buffers, " +
+                                           std::to_string(executor.GetSchedule().m_chunksCount) + " chunks";
+                ReportBenchmark("Gpu Out Of Core Scale Bias", config, seconds,
+                                static_cast<double>(g_outOfCoreBenchmarkElementsCount) * 2 * sizeof(float));
+            }
+        }
+    }
+}
\ No newline at end of file
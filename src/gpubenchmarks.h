@@ -0,0 +1,49 @@
+#pragma once
+
+#include "common.h"
+
+// Benchmarks of the gpu implementations. Timings come from timestamp queries around the work.
+namespace ComputeBasics
+{
+
+void RunGpuBenchmarks(ID3D12Device* device);
+
+void BenchmarkGpuMipsGeneration(ID3D12Device* device);
+
+void BenchmarkGpuReduction(ID3D12Device* device);
+
+void BenchmarkGpuPrefixScan(ID3D12Device* device);
+
+void BenchmarkGpuRadixSort(ID3D12Device* device);
+
+void BenchmarkGpuHistogram(ID3D12Device* device);
+
+void BenchmarkGpuCompaction(ID3D12Device* device);
+
+void BenchmarkGpuSgemm(ID3D12Device* device);
+
+void BenchmarkGpuConvolution(ID3D12Device* device);
+
+void BenchmarkGpuFft(ID3D12Device* device);
+
+void BenchmarkGpuColorPipeline(ID3D12Device* device);
+
+// Note cpu times of recording, executing and waiting for batches of small dispatches
+void BenchmarkGpuParallelRecording(ID3D12Device* device);
+
+// Note cpu times of submitting small jobs in batches of different sizes and waiting for them
+void BenchmarkGpuDispatchBatching(ID3D12Device* device);
+
+// Note cpu times of writing constant blocks to upload memory
+void BenchmarkGpuConstantRing(ID3D12Device* device);
+
+// Note gpu times of small jobs finding their buffers by index in the bindless heap
+void BenchmarkGpuBindless(ID3D12Device* device);
+
+// Note cpu times of evicting and making resident buffers between jobs against stand-in budgets
+void BenchmarkGpuResidency(ID3D12Device* device);
+
+// Note cpu times of streaming an input bigger than the budget through the copy and compute queues, to the output
+void BenchmarkGpuOutOfCore(ID3D12Device* device);
+
+}
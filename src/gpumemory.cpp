@@ -1,6 +1,7 @@
 #include "gpumemory.h"
 
 #include "utils.h"
+#include "texturelayout.h"
 
 namespace
 {
@@ -67,16 +68,21 @@ namespace
 
     D3D12_RESOURCE_DESC CreateTextureDesc(const ComputeBasics::TextureDesc& desc, bool isUA)
     {
+        assert(desc.m_type != ComputeBasics::TextureType::Texture1D || desc.m_height == 1);
+
+        // Note leaving the layout to the driver. Row major textures are only allowed
+        // in a few cases (ie cross adapter) and prevent the swizzled layouts that keep
+        // 2d neighbourhoods in the same cache lines.
         D3D12_RESOURCE_DESC resourceDesc;
         resourceDesc.Dimension          = TextureDescToResourceDimension(desc.m_type);
         resourceDesc.Alignment          = 0;
         resourceDesc.Width              = desc.m_width;
         resourceDesc.Height             = desc.m_height;
         resourceDesc.DepthOrArraySize   = desc.m_depth;
-        resourceDesc.MipLevels          = desc.m_mipsCount;
+        resourceDesc.MipLevels          = static_cast<UINT16>(ComputeBasics::CalculateMipsCount(desc));
         resourceDesc.Format             = desc.m_format;
         resourceDesc.SampleDesc         = { 1, 0 };
-        resourceDesc.Layout             = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        resourceDesc.Layout             = D3D12_TEXTURE_LAYOUT_UNKNOWN;
         resourceDesc.Flags              = isUA? D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS : D3D12_RESOURCE_FLAG_NONE;
 
         return resourceDesc;
@@ -101,11 +107,8 @@ namespace
     {
         assert(device);
         assert(Utils::CheckFormatSupport(device, textureDesc.m_format, TextureTypeToSupportFormat(textureDesc.m_type)));
-        assert(!isUA || 
-               (isUA && Utils::CheckFormatSupport(device, textureDesc.m_format, 
-                                                  static_cast<D3D12_FORMAT_SUPPORT2>
-                                                  (D3D12_FORMAT_SUPPORT2_UAV_TYPED_STORE ||
-                                                  D3D12_FORMAT_SUPPORT2_UAV_TYPED_LOAD))));
+        assert(!isUA || Utils::CheckFormatSupport(device, textureDesc.m_format, D3D12_FORMAT_SUPPORT1_TYPED_UNORDERED_ACCESS_VIEW));
+        assert(!isUA || Utils::CheckFormatSupport(device, textureDesc.m_format, D3D12_FORMAT_SUPPORT2_UAV_TYPED_STORE));
 
         D3D12_RESOURCE_DESC resourceDesc = CreateTextureDesc(textureDesc, isUA);
 
@@ -155,11 +158,28 @@ ComputeBasics::GpuMemAllocation ComputeBasics::AllocateReadback(ID3D12Device* de
     return CreateBuffer(device, sizeBytes, heapType, initialState, false, name);
 }
 
+// Note textures cant live in a readback heap. The allocation is a buffer big enough to hold
+// all the subresources of desc as laid out by GetCopyableFootprints.
 ComputeBasics::GpuMemAllocation ComputeBasics::AllocateReadback(ID3D12Device* device, const TextureDesc& desc, const std::wstring& name)
 {
-    const auto heapType = D3D12_HEAP_TYPE_READBACK;
-    const auto initialState = D3D12_RESOURCE_STATE_COPY_DEST;
-    return CreateTexture(device, desc, heapType, initialState, false, name);
+    assert(device);
+
+    const D3D12_RESOURCE_DESC textureDesc = CreateTextureDesc(desc, false);
+    const UINT subresourcesCount = textureDesc.MipLevels * 
+                                   (desc.m_type == TextureType::Texture3D ? 1 : textureDesc.DepthOrArraySize);
+    UINT64 sizeBytes = 0;
+    device->GetCopyableFootprints(&textureDesc, 0, subresourcesCount, 0, nullptr, nullptr, nullptr, &sizeBytes);
+
+    return AllocateReadback(device, sizeBytes, name);
+}
+
+uint32_t ComputeBasics::CalculateMipsCount(const TextureDesc& desc)
+{
+    if (desc.m_mipsCount != 0)
+        return desc.m_mipsCount;
+
+    const uint32_t depth = desc.m_type == TextureType::Texture3D ? desc.m_depth : 1;
+    return ComputeBasics::CalculateMipsCount(desc.m_width, desc.m_height, depth);
 }
 
 void* ComputeBasics::MemMap(const ComputeBasics::GpuMemAllocation& allocation)
@@ -50,6 +50,9 @@ GpuMemAllocation AllocateUpload(ID3D12Device* device, uint64_t sizeBytes, const
 GpuMemAllocation AllocateReadback(ID3D12Device* device, uint64_t sizeBytes, const std::wstring& name);
 GpuMemAllocation AllocateReadback(ID3D12Device* device, const TextureDesc& desc, const std::wstring& name);
 
+// Resolves m_mipsCount = 0 to the full mip chain
+uint32_t CalculateMipsCount(const TextureDesc& desc);
+
 void* MemMap(const GpuMemAllocation& allocation);
 void MemUnmap(const GpuMemAllocation& allocation);
 void MemCpy(GpuMemAllocation& dst, const void* src, size_t sizeBytes);
@@ -0,0 +1,130 @@
+#include "histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "utils.h"
+#include "cmdlists.h"
+
+namespace
+{
+const wchar_t* g_histogramShaderFileName    = L"./data/shaders/histogram.hlsl";
+const char* g_histogramRootSignatureName    = "HistogramRootSig";
+const uint32_t g_histogramThreadsCount      = 256;
+// Note every group covers a tile of 64x64 texels
+const uint32_t g_histogramTileSize          = 64;
+const uint32_t g_histogramDescriptorsCount  = 3;
+
+// Root parameters as laid out in HistogramRootSig
+enum HistogramRootParameters
+{
+    HistogramRootParameters_Constants = 0,
+    HistogramRootParameters_Table
+};
+
+// Note laid out as the cbuffer, the percentiles start in a new 16 bytes register
+struct HistogramConstants
+{
+    uint32_t    m_imageSize[2];
+    uint32_t    m_binsCount;
+    uint32_t    m_percentilesCount;
+    float       m_minLuminance;
+    float       m_minLog2Luminance;
+    float       m_log2LuminanceRange;
+    uint32_t    m_padding;
+    float       m_percentiles[ComputeBasics::LuminanceHistogram::g_maxPercentilesCount];
+};
+}
+
+using namespace ComputeBasics;
+
+const uint32_t LuminanceHistogram::g_maxBinsCount;
+const uint32_t LuminanceHistogram::g_maxPercentilesCount;
+
+LuminanceHistogram::LuminanceHistogram(ID3D12Device* device, const HistogramDesc& desc) : m_device(device), m_desc(desc)
+{
+    assert(m_device);
+    assert(m_desc.m_binsCount > 0 && m_desc.m_binsCount <= g_maxBinsCount);
+    assert(m_desc.m_minLuminance > 0.0f && m_desc.m_minLuminance < m_desc.m_maxLuminance);
+
+    for (uint32_t pass = 0; pass < HistogramPass_Count; ++pass)
+    {
+        const ShaderDefines defines
+        {
+            { "HISTOGRAM_PASS", std::to_string(pass) }
+        };
+        m_pipelineStates[pass] = CreatePipelineState(m_device, g_histogramShaderFileName, g_histogramRootSignatureName,
+                                                     defines, L"Histogram Pass " + std::to_wstring(pass));
+    }
+}
+
+bool LuminanceHistogram::IsValid() const
+{
+    return m_pipelineStates[HistogramPass_Clear].m_pso && m_pipelineStates[HistogramPass_Accumulate].m_pso &&
+           m_pipelineStates[HistogramPass_Percentiles].m_pso;
+}
+
+DescriptorHeapPtr LuminanceHistogram::EnqueueHistogram(ID3D12GraphicsCommandList* computeCmdList,
+                                                       const GpuMemAllocation& texture, const TextureDesc& textureDesc,
+                                                       const std::vector<float>& percentiles,
+                                                       const GpuMemAllocation& bins,
+                                                       const GpuMemAllocation& percentilesLuminance)
+{
+    assert(IsValid());
+    assert(computeCmdList);
+    assert(texture.m_resource);
+    assert(textureDesc.m_type == TextureType::Texture2D);
+    assert(bins.m_resource);
+    assert(percentilesLuminance.m_resource || percentiles.empty());
+    assert(percentiles.size() <= g_maxPercentilesCount);
+
+    HistogramConstants constants = {};
+    constants.m_imageSize[0]        = static_cast<uint32_t>(textureDesc.m_width);
+    constants.m_imageSize[1]        = textureDesc.m_height;
+    constants.m_binsCount           = m_desc.m_binsCount;
+    constants.m_percentilesCount    = static_cast<uint32_t>(percentiles.size());
+    constants.m_minLuminance        = m_desc.m_minLuminance;
+    constants.m_minLog2Luminance    = std::log2(m_desc.m_minLuminance);
+    constants.m_log2LuminanceRange  = std::log2(m_desc.m_maxLuminance) - constants.m_minLog2Luminance;
+    std::copy(percentiles.begin(), percentiles.end(), constants.m_percentiles);
+
+    // Note without percentiles the bins are bound again so all the descriptors are valid
+    const GpuMemAllocation& percentilesOutput = percentiles.empty() ? bins : percentilesLuminance;
+    const uint32_t percentilesOutputCount = percentiles.empty() ? m_desc.m_binsCount : constants.m_percentilesCount;
+    const uint32_t percentilesOutputStride = percentiles.empty() ? sizeof(uint32_t) : sizeof(float);
+    auto descriptorHeap = std::make_unique<DescriptorHeap>(m_device, g_histogramDescriptorsCount);
+    auto table = descriptorHeap->CreateTexture2DDescriptor(texture, textureDesc.m_format, 0, false);
+    descriptorHeap->CreateStructuredBufferDescriptor(bins, m_desc.m_binsCount, sizeof(uint32_t), true);
+    descriptorHeap->CreateStructuredBufferDescriptor(percentilesOutput, percentilesOutputCount, percentilesOutputStride,
+                                                     true);
+
+    ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { descriptorHeap->GetD3D12DescriptorHeap() };
+    computeCmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+
+    const uint32_t passesCount = percentiles.empty() ? HistogramPass_Percentiles : HistogramPass_Count;
+    const uint32_t dispatchSizes[HistogramPass_Count][2] =
+    {
+        { (m_desc.m_binsCount + g_histogramThreadsCount - 1) / g_histogramThreadsCount, 1 },
+        { (constants.m_imageSize[0] + g_histogramTileSize - 1) / g_histogramTileSize,
+          (constants.m_imageSize[1] + g_histogramTileSize - 1) / g_histogramTileSize },
+        { 1, 1 }
+    };
+    const auto binsBarrier = CreateUAVBarrier(bins.m_resource.Get());
+    for (uint32_t pass = 0; pass < passesCount; ++pass)
+    {
+        // Note every pass depends on the bins written by the previous one
+        if (pass > 0)
+            computeCmdList->ResourceBarrier(1, &binsBarrier);
+
+        const auto& pipelineState = m_pipelineStates[pass];
+        computeCmdList->SetComputeRootSignature(pipelineState.m_rootSignature.Get());
+        computeCmdList->SetPipelineState(pipelineState.m_pso.Get());
+        computeCmdList->SetComputeRoot32BitConstants(HistogramRootParameters_Constants,
+                                                     sizeof(constants) / sizeof(uint32_t), &constants, 0);
+        computeCmdList->SetComputeRootDescriptorTable(HistogramRootParameters_Table, table.m_gpuHandle);
+        computeCmdList->Dispatch(dispatchSizes[pass][0], dispatchSizes[pass][1], 1);
+    }
+
+    return descriptorHeap;
+}
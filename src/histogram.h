@@ -0,0 +1,53 @@
+#pragma once
+
+#include "common.h"
+
+#include <vector>
+
+#include "gpumemory.h"
+#include "descriptors.h"
+#include "pipelinestate.h"
+#include "cpuhistogram.h"
+
+namespace ComputeBasics
+{
+
+// Luminance histogram and percentiles of 2d textures on the gpu using data/shaders/histogram.hlsl.
+// Every group accumulates a 64x64 tile in groupshared bins and merges them in the output bins with atomics.
+// A single group pass then extracts the percentiles from the bins.
+class LuminanceHistogram
+{
+public:
+    static const uint32_t g_maxBinsCount = 1024;
+    static const uint32_t g_maxPercentilesCount = 8;
+
+    LuminanceHistogram(ID3D12Device* device, const HistogramDesc& desc);
+
+    bool IsValid() const;
+    const HistogramDesc& GetDesc() const { return m_desc; }
+
+    // Writes the m_binsCount bins of mip 0 of texture to bins and the luminance of every percentile (0..1)
+    // to percentilesLuminance. Both are structured buffers, uint and float.
+    // texture has to be in NON_PIXEL_SHADER_RESOURCE state and the outputs in UNORDERED_ACCESS state.
+    // They are left as they are.
+    // Note the descriptor heaps of the cmd list are replaced.
+    // Note returning the descriptor heap so it outlives the execution in the gpu
+    DescriptorHeapPtr EnqueueHistogram(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& texture,
+                                       const TextureDesc& textureDesc, const std::vector<float>& percentiles,
+                                       const GpuMemAllocation& bins, const GpuMemAllocation& percentilesLuminance);
+
+private:
+    enum HistogramPass
+    {
+        HistogramPass_Clear = 0,
+        HistogramPass_Accumulate,
+        HistogramPass_Percentiles,
+        HistogramPass_Count
+    };
+
+    ID3D12Device*   m_device;
+    HistogramDesc   m_desc;
+    PipelineState   m_pipelineStates[HistogramPass_Count];
+};
+
+}
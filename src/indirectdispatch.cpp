@@ -0,0 +1,180 @@
+#include "indirectdispatch.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils.h"
+#include "cmdlists.h"
+
+namespace
+{
+const wchar_t* g_dispatchArgumentsShaderFileName    = L"./data/shaders/dispatcharguments.hlsl";
+const char* g_dispatchArgumentsRootSignatureName    = "DispatchArgumentsRootSig";
+
+// Root parameters as laid out in DispatchArgumentsRootSig
+enum DispatchArgumentsRootParameters
+{
+    DispatchArgumentsRootParameters_Constants = 0,
+    DispatchArgumentsRootParameters_Counts,
+    DispatchArgumentsRootParameters_Arguments
+};
+
+struct DispatchArgumentsConstants
+{
+    uint32_t m_countOffset;
+    uint32_t m_argumentsOffset;
+    uint32_t m_groupSize;
+};
+
+static_assert(sizeof(ComputeBasics::DispatchArguments) == sizeof(D3D12_DISPATCH_ARGUMENTS),
+              "The cpu arguments have to keep the layout of the d3d12 ones");
+}
+
+using namespace ComputeBasics;
+
+DispatchCommandSignature::DispatchCommandSignature(ID3D12Device* device, uint32_t byteStride) : m_byteStride(byteStride)
+{
+    assert(device);
+    assert(m_byteStride >= sizeof(D3D12_DISPATCH_ARGUMENTS) && m_byteStride % sizeof(uint32_t) == 0);
+
+    D3D12_INDIRECT_ARGUMENT_DESC argumentDesc = {};
+    argumentDesc.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH;
+
+    D3D12_COMMAND_SIGNATURE_DESC desc = {};
+    desc.ByteStride = m_byteStride;
+    desc.NumArgumentDescs = 1;
+    desc.pArgumentDescs = &argumentDesc;
+    desc.NodeMask = 0;
+
+    // Note a dispatch alone doesnt change root arguments, so no root signature is needed
+    Utils::AssertIfFailed(device->CreateCommandSignature(&desc, nullptr, IID_PPV_ARGS(&m_commandSignature)));
+}
+
+void DispatchCommandSignature::EnqueueDispatchIndirect(ID3D12GraphicsCommandList* computeCmdList,
+                                                       const GpuMemAllocation& arguments, uint64_t argumentsOffset,
+                                                       uint32_t maxCommandsCount, const GpuMemAllocation* commandsCount,
+                                                       uint64_t commandsCountOffset) const
+{
+    assert(IsValid());
+    assert(computeCmdList);
+    assert(arguments.m_resource);
+    assert(argumentsOffset % sizeof(uint32_t) == 0);
+    assert(!commandsCount || (commandsCount->m_resource && commandsCountOffset % sizeof(uint32_t) == 0));
+
+    computeCmdList->ExecuteIndirect(m_commandSignature.Get(), maxCommandsCount, arguments.m_resource.Get(),
+                                    argumentsOffset, commandsCount ? commandsCount->m_resource.Get() : nullptr,
+                                    commandsCountOffset);
+}
+
+DispatchChain::DispatchChain(ID3D12Device* device, const std::vector<uint32_t>& initialCounts,
+                             uint32_t argumentsSizeBytes) :
+    m_device(device), m_commandSignature(device),
+    m_countsSizeBytes(static_cast<uint32_t>(std::max<size_t>(initialCounts.size(), 1) * sizeof(uint32_t))),
+    m_argumentsSizeBytes(std::max<uint32_t>(argumentsSizeBytes, sizeof(D3D12_DISPATCH_ARGUMENTS)))
+{
+    assert(m_device);
+    assert(argumentsSizeBytes % sizeof(uint32_t) == 0);
+
+    m_argumentsPipelineState = CreatePipelineState(m_device, g_dispatchArgumentsShaderFileName,
+                                                   g_dispatchArgumentsRootSignatureName, {}, L"Dispatch Arguments");
+
+    m_initialCounts = AllocateUpload(m_device, m_countsSizeBytes, L"Dispatch Chain Initial Counts");
+    {
+        ScopedMappedGpuMemAlloc mapped(m_initialCounts);
+        memset(mapped.GetBuffer(), 0, m_countsSizeBytes);
+        if (!initialCounts.empty())
+            memcpy(mapped.GetBuffer(), &initialCounts[0], initialCounts.size() * sizeof(uint32_t));
+    }
+    m_counts = Allocate(m_device, m_countsSizeBytes, true, L"Dispatch Chain Counts");
+    m_arguments = Allocate(m_device, m_argumentsSizeBytes, true, L"Dispatch Chain Arguments");
+}
+
+bool DispatchChain::IsValid() const
+{
+    return m_commandSignature.IsValid() && m_argumentsPipelineState.m_pso;
+}
+
+void DispatchChain::AddStage(const RecordStage& record)
+{
+    assert(record);
+    m_stages.push_back({ record, false, 0 });
+}
+
+void DispatchChain::AddIndirectStage(const RecordStage& bind, uint32_t argumentsOffset)
+{
+    assert(bind);
+    assert(argumentsOffset % sizeof(uint32_t) == 0);
+    assert(argumentsOffset + sizeof(D3D12_DISPATCH_ARGUMENTS) <= m_argumentsSizeBytes);
+    m_stages.push_back({ bind, true, argumentsOffset });
+}
+
+void DispatchChain::AddArgumentsStage(uint32_t countOffset, uint32_t argumentsOffset, uint32_t groupSize)
+{
+    assert(countOffset % sizeof(uint32_t) == 0 && countOffset < m_countsSizeBytes);
+    assert(argumentsOffset % sizeof(uint32_t) == 0);
+    assert(argumentsOffset + sizeof(D3D12_DISPATCH_ARGUMENTS) <= m_argumentsSizeBytes);
+    assert(groupSize > 0);
+
+    const DispatchArgumentsConstants constants = { countOffset, argumentsOffset, groupSize };
+    AddStage([this, constants](ID3D12GraphicsCommandList* computeCmdList)
+    {
+        computeCmdList->SetComputeRootSignature(m_argumentsPipelineState.m_rootSignature.Get());
+        computeCmdList->SetPipelineState(m_argumentsPipelineState.m_pso.Get());
+        computeCmdList->SetComputeRoot32BitConstants(DispatchArgumentsRootParameters_Constants,
+                                                     sizeof(constants) / sizeof(uint32_t), &constants, 0);
+        computeCmdList->SetComputeRootUnorderedAccessView(DispatchArgumentsRootParameters_Counts,
+                                                          m_counts.m_resource->GetGPUVirtualAddress());
+        computeCmdList->SetComputeRootUnorderedAccessView(DispatchArgumentsRootParameters_Arguments,
+                                                          m_arguments.m_resource->GetGPUVirtualAddress());
+        computeCmdList->Dispatch(1, 1, 1);
+    });
+}
+
+void DispatchChain::EnqueueChain(ID3D12GraphicsCommandList* computeCmdList) const
+{
+    assert(IsValid());
+    assert(computeCmdList);
+
+    ID3D12Resource* counts = m_counts.m_resource.Get();
+    ID3D12Resource* arguments = m_arguments.m_resource.Get();
+
+    // Note copies are allowed in compute cmd lists
+    auto barrier = CreateTransition(counts, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_DEST);
+    computeCmdList->ResourceBarrier(1, &barrier);
+    computeCmdList->CopyBufferRegion(counts, 0, m_initialCounts.m_resource.Get(), 0, m_countsSizeBytes);
+    barrier = CreateTransition(counts, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    computeCmdList->ResourceBarrier(1, &barrier);
+
+    const auto uavBarrier = CreateGlobalUAVBarrier();
+    D3D12_RESOURCE_STATES argumentsState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    for (size_t i = 0; i < m_stages.size(); ++i)
+    {
+        const Stage& stage = m_stages[i];
+
+        // Note batching the transition of the arguments with the barrier of the previous stage
+        D3D12_RESOURCE_BARRIER barriers[2];
+        uint32_t barriersCount = 0;
+        if (i > 0)
+            barriers[barriersCount++] = uavBarrier;
+        const D3D12_RESOURCE_STATES stageArgumentsState = stage.m_isIndirect ? D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT :
+                                                                               D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        if (argumentsState != stageArgumentsState)
+        {
+            barriers[barriersCount++] = CreateTransition(arguments, argumentsState, stageArgumentsState);
+            argumentsState = stageArgumentsState;
+        }
+        if (barriersCount > 0)
+            computeCmdList->ResourceBarrier(barriersCount, barriers);
+
+        stage.m_record(computeCmdList);
+        if (stage.m_isIndirect)
+            m_commandSignature.EnqueueDispatchIndirect(computeCmdList, m_arguments, stage.m_argumentsOffset);
+    }
+
+    D3D12_RESOURCE_BARRIER barriers[2];
+    uint32_t barriersCount = 0;
+    barriers[barriersCount++] = uavBarrier;
+    if (argumentsState != D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+        barriers[barriersCount++] = CreateTransition(arguments, argumentsState, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    computeCmdList->ResourceBarrier(barriersCount, barriers);
+}
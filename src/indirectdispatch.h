@@ -0,0 +1,95 @@
+#pragma once
+
+#include "common.h"
+
+#include <functional>
+#include <vector>
+
+#include "gpumemory.h"
+#include "pipelinestate.h"
+#include "cpuindirectdispatch.h"
+
+namespace ComputeBasics
+{
+
+// Command signature of a single dispatch, to launch dispatches whose size is in a gpu buffer.
+// byteStride is the distance between consecutive commands, so records with more data after the
+// D3D12_DISPATCH_ARGUMENTS, such as CompactionArguments, can be used as they are.
+class DispatchCommandSignature
+{
+public:
+    DispatchCommandSignature(ID3D12Device* device, uint32_t byteStride = sizeof(D3D12_DISPATCH_ARGUMENTS));
+
+    bool IsValid() const { return m_commandSignature != nullptr; }
+    uint32_t GetByteStride() const { return m_byteStride; }
+    ID3D12CommandSignature* GetD3D12CommandSignature() const { return m_commandSignature.Get(); }
+
+    // Launches up to maxCommandsCount dispatches from argumentsOffset bytes of arguments. With a commandsCount
+    // buffer the uint at commandsCountOffset bytes of it limits the dispatches launched.
+    // The root signature, pipeline state and bindings have to be set. The buffers have to be in
+    // INDIRECT_ARGUMENT state.
+    void EnqueueDispatchIndirect(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& arguments,
+                                 uint64_t argumentsOffset, uint32_t maxCommandsCount = 1,
+                                 const GpuMemAllocation* commandsCount = nullptr,
+                                 uint64_t commandsCountOffset = 0) const;
+
+private:
+    uint32_t                        m_byteStride;
+    ID3D12CommandSignatureComPtr    m_commandSignature;
+};
+
+// Chain of dispatches where a stage can be sized by counts written by the previous ones, without reading
+// them back. The chain owns two buffers:
+//  counts      uint counters the stages append to. Reset to their initial values at the start of the chain.
+//  arguments   D3D12_DISPATCH_ARGUMENTS of the indirect stages, written by the arguments stages or by other
+//              stages, such as Compaction.
+// Offsets are in bytes in both. Cpu::DispatchChain runs chains with the same layout.
+class DispatchChain
+{
+public:
+    // Records the work of a stage in the cmd list
+    using RecordStage = std::function<void(ID3D12GraphicsCommandList* computeCmdList)>;
+
+    DispatchChain(ID3D12Device* device, const std::vector<uint32_t>& initialCounts, uint32_t argumentsSizeBytes);
+
+    bool IsValid() const;
+
+    // Always in UNORDERED_ACCESS state for the stages
+    const GpuMemAllocation& GetCounts() const { return m_counts; }
+    // In UNORDERED_ACCESS state for the stages but the indirect ones, which cant access it
+    const GpuMemAllocation& GetArguments() const { return m_arguments; }
+
+    // Stage that sizes itself. record sets everything it needs and dispatches.
+    void AddStage(const RecordStage& record);
+    // Stage sized by the arguments at argumentsOffset. bind sets the root signature, pipeline state and
+    // bindings, the chain dispatches.
+    void AddIndirectStage(const RecordStage& bind, uint32_t argumentsOffset);
+    // Writes at argumentsOffset the arguments to launch a thread per element of the count at countOffset,
+    // with groups of groupSize threads
+    void AddArgumentsStage(uint32_t countOffset, uint32_t argumentsOffset, uint32_t groupSize);
+
+    // Records all the stages with uav barriers between them. The chain buffers are left in
+    // UNORDERED_ACCESS state.
+    // Note executions of the same chain share its buffers, so they have to execute in the order they were enqueued.
+    void EnqueueChain(ID3D12GraphicsCommandList* computeCmdList) const;
+
+private:
+    struct Stage
+    {
+        RecordStage m_record;
+        bool        m_isIndirect;
+        uint32_t    m_argumentsOffset;
+    };
+
+    ID3D12Device*               m_device;
+    DispatchCommandSignature    m_commandSignature;
+    PipelineState               m_argumentsPipelineState;
+    uint32_t                    m_countsSizeBytes;
+    uint32_t                    m_argumentsSizeBytes;
+    GpuMemAllocation            m_initialCounts;
+    GpuMemAllocation            m_counts;
+    GpuMemAllocation            m_arguments;
+    std::vector<Stage>          m_stages;
+};
+
+}
@@ -0,0 +1,116 @@
+#include "mipsgenerator.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "cmdlists.h"
+
+namespace
+{
+const wchar_t* g_mipsGenShaderFileName  = L"./data/shaders/mipsgen.hlsl";
+const char* g_mipsGenRootSignatureName  = "MipsGenRootSig";
+const uint32_t g_mipsGenGroupSize       = 8;
+const D3D12_RESOURCE_STATES g_srcMipState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+
+// Root parameters as laid out in MipsGenRootSig
+enum MipsGenRootParameters
+{
+    MipsGenRootParameters_Constants = 0,
+    MipsGenRootParameters_Table
+};
+
+struct MipsGenConstants
+{
+    uint32_t m_mipsCount;
+    uint32_t m_mip1Width;
+    uint32_t m_mip1Height;
+};
+
+uint32_t MipDimension(uint64_t dimension, uint32_t mip)
+{
+    return static_cast<uint32_t>(std::max<uint64_t>(dimension >> mip, 1));
+}
+}
+
+using namespace ComputeBasics;
+
+const uint32_t MipsGenerator::g_mipsPerDispatch;
+
+MipsGenerator::MipsGenerator(ID3D12Device* device) : m_device(device)
+{
+    assert(m_device);
+
+    m_pipelineState = CreatePipelineState(m_device, g_mipsGenShaderFileName, g_mipsGenRootSignatureName, {}, L"MipsGen");
+}
+
+DescriptorHeapPtr MipsGenerator::EnqueueGenerateMips(ID3D12GraphicsCommandList* computeCmdList,
+                                                     const GpuMemAllocation& texture, const TextureDesc& desc,
+                                                     D3D12_RESOURCE_STATES textureState)
+{
+    assert(IsValid());
+    assert(computeCmdList);
+    assert(computeCmdList->GetType() == D3D12_COMMAND_LIST_TYPE_COMPUTE);
+    assert(texture.m_resource);
+    assert(desc.m_type == TextureType::Texture2D && desc.m_arraySize == 1);
+
+    const uint32_t mipsCount = CalculateMipsCount(desc);
+    if (mipsCount < 2)
+        return nullptr;
+
+    const uint32_t dispatchesCount = (mipsCount - 1 + g_mipsPerDispatch - 1) / g_mipsPerDispatch;
+    const uint32_t descriptorsPerDispatch = 1 + g_mipsPerDispatch;
+    auto descriptorHeap = std::make_unique<DescriptorHeap>(m_device, dispatchesCount * descriptorsPerDispatch);
+
+    ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { descriptorHeap->GetD3D12DescriptorHeap() };
+    computeCmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+    computeCmdList->SetComputeRootSignature(m_pipelineState.m_rootSignature.Get());
+    computeCmdList->SetPipelineState(m_pipelineState.m_pso.Get());
+
+    ID3D12Resource* resource = texture.m_resource.Get();
+
+    // Note batching up the transitions of consecutive dispatches
+    std::vector<D3D12_RESOURCE_BARRIER> barriers;
+    if (textureState != D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+        barriers.push_back(CreateTransition(resource, textureState, D3D12_RESOURCE_STATE_UNORDERED_ACCESS));
+
+    for (uint32_t srcMip = 0; srcMip + 1 < mipsCount; srcMip += g_mipsPerDispatch)
+    {
+        const uint32_t dispatchMipsCount = std::min(g_mipsPerDispatch, mipsCount - 1 - srcMip);
+
+        // The src mip was written by the previous dispatch as uav
+        barriers.push_back(CreateTransition(resource, srcMip, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, g_srcMipState));
+        computeCmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), &barriers[0]);
+        barriers.clear();
+
+        auto table = descriptorHeap->CreateTexture2DDescriptor(texture, desc.m_format, srcMip, false);
+        for (uint32_t i = 0; i < g_mipsPerDispatch; ++i)
+        {
+            if (i < dispatchMipsCount)
+                descriptorHeap->CreateTexture2DDescriptor(texture, desc.m_format, srcMip + 1 + i, true);
+            else
+                descriptorHeap->CreateNullTexture2DDescriptor(desc.m_format, true);
+        }
+
+        MipsGenConstants constants;
+        constants.m_mipsCount   = dispatchMipsCount;
+        constants.m_mip1Width   = MipDimension(desc.m_width, srcMip + 1);
+        constants.m_mip1Height  = MipDimension(desc.m_height, srcMip + 1);
+        computeCmdList->SetComputeRoot32BitConstants(MipsGenRootParameters_Constants, sizeof(constants) / sizeof(uint32_t),
+                                                     &constants, 0);
+        computeCmdList->SetComputeRootDescriptorTable(MipsGenRootParameters_Table, table.m_gpuHandle);
+
+        const uint32_t groupsX = (constants.m_mip1Width + g_mipsGenGroupSize - 1) / g_mipsGenGroupSize;
+        const uint32_t groupsY = (constants.m_mip1Height + g_mipsGenGroupSize - 1) / g_mipsGenGroupSize;
+        computeCmdList->Dispatch(groupsX, groupsY, 1);
+
+        barriers.push_back(CreateTransition(resource, srcMip, g_srcMipState, D3D12_RESOURCE_STATE_UNORDERED_ACCESS));
+    }
+
+    if (textureState != D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+        barriers.push_back(CreateTransition(resource, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, textureState));
+    else
+        barriers.push_back(CreateUAVBarrier(resource));
+    computeCmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), &barriers[0]);
+
+    return descriptorHeap;
+}
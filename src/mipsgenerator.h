@@ -0,0 +1,37 @@
+#pragma once
+
+#include "common.h"
+
+#include "gpumemory.h"
+#include "descriptors.h"
+#include "pipelinestate.h"
+
+namespace ComputeBasics
+{
+
+// Generates the mip chain of 2d textures on the gpu using data/shaders/mipsgen.hlsl.
+// Every dispatch generates up to g_mipsPerDispatch mips from the last mip written.
+// Note the texture has to be allocated as RW and its format has to support typed uav stores.
+class MipsGenerator
+{
+public:
+    static const uint32_t g_mipsPerDispatch = 4;
+
+    MipsGenerator(ID3D12Device* device);
+
+    bool IsValid() const { return m_pipelineState.m_pso != nullptr; }
+
+    // Fills mips 1..n from mip 0. textureState is the state of all the subresources before the call
+    // and is restored after it.
+    // Note the descriptor heaps of the cmd list are replaced.
+    // Note returning the descriptor heap so it outlives the execution in the gpu
+    DescriptorHeapPtr EnqueueGenerateMips(ID3D12GraphicsCommandList* computeCmdList,
+                                          const GpuMemAllocation& texture, const TextureDesc& desc,
+                                          D3D12_RESOURCE_STATES textureState);
+
+private:
+    ID3D12Device*   m_device;
+    PipelineState   m_pipelineState;
+};
+
+}
@@ -0,0 +1,174 @@
+#include "outofcore.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include "utils.h"
+
+using namespace ComputeBasics;
+
+OutOfCoreExecutor::ExecutionQueue::ExecutionQueue(ID3D12Device* device, ID3D12CommandQueue* cmdQueue,
+                                                  const std::wstring& name) :
+    m_cmdQueue(cmdQueue), m_cmdListPool(device, cmdQueue->GetDesc().Type, name), m_fenceValue(0)
+{
+    Utils::AssertIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+    assert(m_fence);
+}
+
+OutOfCoreExecutor::OutOfCoreExecutor(ID3D12Device* device, ID3D12CommandQueue* computeCmdQueue,
+                                     ID3D12CommandQueue* copyCmdQueue, const OutOfCoreDesc& desc) :
+    m_device(device), m_desc(desc), m_schedule(CreateOutOfCoreSchedule(desc)),
+    m_computeQueue(device, computeCmdQueue, L"Out Of Core Dispatch"),
+    m_copyQueue(device, copyCmdQueue, L"Out Of Core Copy")
+{
+    assert(m_device);
+    assert(computeCmdQueue->GetDesc().Type == D3D12_COMMAND_LIST_TYPE_COMPUTE);
+    assert(copyCmdQueue->GetDesc().Type == D3D12_COMMAND_LIST_TYPE_COPY);
+
+    if (!IsValid())
+        return;
+
+    const uint64_t inputSizeBytes = CalculateOutOfCoreInputBytes(m_desc, m_schedule.m_chunkElementsCount);
+    const uint64_t outputSizeBytes = CalculateOutOfCoreOutputBytes(m_desc, m_schedule.m_chunkElementsCount);
+    m_chunkBuffers.resize(m_desc.m_buffersCount);
+    for (ChunkBuffers& buffers : m_chunkBuffers)
+    {
+        buffers.m_input = Allocate(m_device, inputSizeBytes, false, L"Out Of Core Input");
+        buffers.m_output = Allocate(m_device, outputSizeBytes, true, L"Out Of Core Output");
+        buffers.m_upload = AllocateUpload(m_device, inputSizeBytes, L"Out Of Core Upload");
+        buffers.m_readback = AllocateReadback(m_device, outputSizeBytes, L"Out Of Core Readback");
+        // Note the staging memory stays mapped, the fences tell when the gpu is done with it
+        buffers.m_uploadAddress = static_cast<uint8_t*>(MemMap(buffers.m_upload));
+        buffers.m_readbackAddress = static_cast<const uint8_t*>(MemMap(buffers.m_readback));
+    }
+}
+
+OutOfCoreExecutor::~OutOfCoreExecutor()
+{
+    for (ChunkBuffers& buffers : m_chunkBuffers)
+    {
+        MemUnmap(buffers.m_upload);
+        MemUnmap(buffers.m_readback);
+    }
+}
+
+void OutOfCoreExecutor::Execute(const void* input, void* output, const RecordOutOfCoreChunk& recordChunk)
+{
+    assert(IsValid());
+    assert(input && output);
+
+    // Note every step is a submission of its own, so step i of a queue signals the value base + i + 1
+    const uint64_t computeBaseValue = m_computeQueue.m_fenceValue;
+    const uint64_t copyBaseValue = m_copyQueue.m_fenceValue;
+    const bool isElementwise = m_desc.m_kernelType == OutOfCoreKernelType::Elementwise;
+
+    const auto copyReadback = [&](uint32_t chunk)
+    {
+        const OutOfCoreStep& dispatchStep = m_schedule.m_computeSteps[chunk];
+        const uint64_t outputElement = isElementwise ? dispatchStep.m_firstElement : chunk;
+        memcpy(static_cast<uint8_t*>(output) + outputElement * m_desc.m_outputElementSizeBytes,
+               m_chunkBuffers[dispatchStep.m_buffer].m_readbackAddress,
+               CalculateOutOfCoreOutputBytes(m_desc, dispatchStep.m_elementsCount));
+    };
+
+    // Indexed by chunk, the copy steps of the readbacks submitted
+    std::vector<uint32_t> readbackSteps(m_schedule.m_chunksCount);
+    for (uint32_t copyStep = 0; copyStep < m_schedule.m_copySteps.size(); ++copyStep)
+    {
+        const OutOfCoreStep& step = m_schedule.m_copySteps[copyStep];
+        const ChunkBuffers& buffers = m_chunkBuffers[step.m_buffer];
+        const uint64_t waitValue = step.m_waitStep != g_invalidOutOfCoreStep ?
+                                   computeBaseValue + step.m_waitStep + 1 : 0;
+
+        CommandList copyCmdList = m_copyQueue.m_cmdListPool.Acquire();
+        if (step.m_type == OutOfCoreStepType::Upload)
+        {
+            // Note the upload buffer holds the chunk buffersCount chunks before until its upload is done
+            if (step.m_chunk >= m_desc.m_buffersCount)
+            {
+                const uint32_t previousUploadStep = m_schedule.m_computeSteps[step.m_chunk -
+                                                                              m_desc.m_buffersCount].m_waitStep;
+                Wait(m_copyQueue, copyBaseValue + previousUploadStep + 1);
+            }
+
+            const uint64_t sizeBytes = CalculateOutOfCoreInputBytes(m_desc, step.m_elementsCount);
+            memcpy(buffers.m_uploadAddress,
+                   static_cast<const uint8_t*>(input) + step.m_firstElement * m_desc.m_inputElementSizeBytes,
+                   sizeBytes);
+            copyCmdList.m_cmdList->CopyBufferRegion(buffers.m_input.m_resource.Get(), 0,
+                                                    buffers.m_upload.m_resource.Get(), 0, sizeBytes);
+            const uint64_t uploadValue = Submit(m_copyQueue, copyCmdList, m_computeQueue, waitValue);
+
+            // Note the dispatches go in chunk order too, right after the upload they wait for
+            const OutOfCoreStep& dispatchStep = m_schedule.m_computeSteps[step.m_chunk];
+            assert(dispatchStep.m_waitStep == copyStep);
+            CommandList computeCmdList = m_computeQueue.m_cmdListPool.Acquire();
+            recordChunk(computeCmdList.m_cmdList.Get(), buffers.m_input, buffers.m_output, dispatchStep);
+            Submit(m_computeQueue, computeCmdList, m_copyQueue, uploadValue);
+        }
+        else
+        {
+            // Note the readback buffer holds the chunk buffersCount chunks before until it is copied out
+            if (step.m_chunk >= m_desc.m_buffersCount)
+            {
+                const uint32_t previousChunk = step.m_chunk - m_desc.m_buffersCount;
+                Wait(m_copyQueue, copyBaseValue + readbackSteps[previousChunk] + 1);
+                copyReadback(previousChunk);
+            }
+
+            copyCmdList.m_cmdList->CopyBufferRegion(buffers.m_readback.m_resource.Get(), 0,
+                                                    buffers.m_output.m_resource.Get(), 0,
+                                                    CalculateOutOfCoreOutputBytes(m_desc, step.m_elementsCount));
+            Submit(m_copyQueue, copyCmdList, m_computeQueue, waitValue);
+            readbackSteps[step.m_chunk] = copyStep;
+        }
+
+        ReleaseFinishedSteps(m_computeQueue);
+        ReleaseFinishedSteps(m_copyQueue);
+    }
+
+    // Note the last readback waits for the last dispatch, so both queues are done after it
+    Wait(m_copyQueue, m_copyQueue.m_fenceValue);
+    Wait(m_computeQueue, m_computeQueue.m_fenceValue);
+    const uint32_t firstPendingChunk = m_schedule.m_chunksCount > m_desc.m_buffersCount ?
+                                       m_schedule.m_chunksCount - m_desc.m_buffersCount : 0;
+    for (uint32_t chunk = firstPendingChunk; chunk < m_schedule.m_chunksCount; ++chunk)
+        copyReadback(chunk);
+}
+
+uint64_t OutOfCoreExecutor::Submit(ExecutionQueue& queue, const CommandList& cmdList,
+                                   const ExecutionQueue& waitQueue, uint64_t waitValue)
+{
+    if (waitValue > 0)
+        Utils::AssertIfFailed(queue.m_cmdQueue->Wait(waitQueue.m_fence.Get(), waitValue));
+
+    ID3D12GraphicsCommandList* d3d12CmdList = cmdList.m_cmdList.Get();
+    Utils::AssertIfFailed(d3d12CmdList->Close());
+    ID3D12CommandList* cmdLists[] = { d3d12CmdList };
+    queue.m_cmdQueue->ExecuteCommandLists(1, cmdLists);
+    Utils::AssertIfFailed(queue.m_cmdQueue->Signal(queue.m_fence.Get(), ++queue.m_fenceValue));
+
+    queue.m_submittedSteps.push_back({ queue.m_fenceValue, cmdList });
+    return queue.m_fenceValue;
+}
+
+void OutOfCoreExecutor::Wait(ExecutionQueue& queue, uint64_t value)
+{
+    // Note a null event blocks until the fence reaches the value
+    Utils::AssertIfFailed(queue.m_fence->SetEventOnCompletion(value, nullptr));
+    ReleaseFinishedSteps(queue);
+}
+
+void OutOfCoreExecutor::ReleaseFinishedSteps(ExecutionQueue& queue)
+{
+    const uint64_t completedValue = queue.m_fence->GetCompletedValue();
+    const auto firstPending = std::find_if(queue.m_submittedSteps.begin(), queue.m_submittedSteps.end(),
+                                           [completedValue](const SubmittedStep& step)
+    {
+        return step.m_fenceValue > completedValue;
+    });
+
+    for (auto step = queue.m_submittedSteps.begin(); step != firstPending; ++step)
+        queue.m_cmdListPool.Release(step->m_cmdList);
+    queue.m_submittedSteps.erase(queue.m_submittedSteps.begin(), firstPending);
+}
\ No newline at end of file
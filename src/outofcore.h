@@ -0,0 +1,94 @@
+#pragma once
+
+#include "common.h"
+
+#include <functional>
+#include <vector>
+
+#include "gpumemory.h"
+#include "commandlistpool.h"
+#include "cpuoutofcore.h"
+
+namespace ComputeBasics
+{
+
+// Records the kernel of a chunk. input holds the elements of the chunk and output the space of its output elements,
+// a single one for reductions, as Reduction::EnqueueReduce writes it.
+// Note input is promoted to NON_PIXEL_SHADER_RESOURCE and output to UNORDERED_ACCESS by the first use, they dont
+// need barriers. Things that have to outlive the execution of the chunk, as descriptor heaps, are kept by the caller.
+using RecordOutOfCoreChunk = std::function<void(ID3D12GraphicsCommandList* cmdList, const GpuMemAllocation& input,
+                                                const GpuMemAllocation& output, const OutOfCoreStep& step)>;
+
+// Runs a kernel over an input in system memory bigger than the video memory budget, following the out of core
+// schedule of src/cpuoutofcore.h. Every chunk is uploaded through the copy queue to the default heap buffers of its
+// slot, dispatched in the compute queue and read back through the copy queue. The queues wait on each other through
+// a fence per queue, so the transfers of a chunk overlap the dispatches of the others.
+// The staging buffers are upload and readback memory, mapped for the whole life of the executor, and only the
+// default heap buffers count against the budget, as in src/residencypolicy.h.
+// Note a cmd list per step, taken from a pool per queue
+class OutOfCoreExecutor
+{
+public:
+    // Note the budget of desc can be ResidencyManager::QueryBudget or a part of it
+    OutOfCoreExecutor(ID3D12Device* device, ID3D12CommandQueue* computeCmdQueue, ID3D12CommandQueue* copyCmdQueue,
+                      const OutOfCoreDesc& desc);
+    ~OutOfCoreExecutor();
+    OutOfCoreExecutor(const OutOfCoreExecutor&) = delete;
+    OutOfCoreExecutor& operator=(const OutOfCoreExecutor&) = delete;
+
+    bool IsValid() const { return m_schedule.m_chunksCount > 0; }
+    const OutOfCoreSchedule& GetSchedule() const { return m_schedule; }
+
+    // output has the space of CalculateOutOfCoreOutputElementsCount elements
+    // Note it waits for the last chunk to be read back
+    void Execute(const void* input, void* output, const RecordOutOfCoreChunk& recordChunk);
+
+private:
+    struct ChunkBuffers
+    {
+        GpuMemAllocation    m_input;
+        GpuMemAllocation    m_output;
+        GpuMemAllocation    m_upload;
+        GpuMemAllocation    m_readback;
+        uint8_t*            m_uploadAddress;
+        const uint8_t*      m_readbackAddress;
+    };
+
+    struct SubmittedStep
+    {
+        uint64_t    m_fenceValue;
+        CommandList m_cmdList;
+    };
+
+    // Note the fence values of the steps of an execution are offset by the last value signaled in the fence
+    struct ExecutionQueue
+    {
+        ExecutionQueue(ID3D12Device* device, ID3D12CommandQueue* cmdQueue, const std::wstring& name);
+
+        ID3D12CommandQueue*         m_cmdQueue;
+        CommandListPool             m_cmdListPool;
+        ID3D12FenceComPtr           m_fence;
+        uint64_t                    m_fenceValue;
+        std::vector<SubmittedStep>  m_submittedSteps;
+    };
+
+    ID3D12Device*               m_device;
+    OutOfCoreDesc               m_desc;
+    OutOfCoreSchedule           m_schedule;
+
+    // Indexed by buffer
+    std::vector<ChunkBuffers>   m_chunkBuffers;
+
+    ExecutionQueue              m_computeQueue;
+    ExecutionQueue              m_copyQueue;
+
+    // Executes cmdList once the other queue reaches waitValue, 0 for no wait. Returns the value signaled after it.
+    uint64_t Submit(ExecutionQueue& queue, const CommandList& cmdList, const ExecutionQueue& waitQueue,
+                    uint64_t waitValue);
+    // Blocks until the fence of the queue reaches value
+    void Wait(ExecutionQueue& queue, uint64_t value);
+    // Gives the cmd lists of the steps done back to the pool
+    void ReleaseFinishedSteps(ExecutionQueue& queue);
+};
+
+}
\ No newline at end of file
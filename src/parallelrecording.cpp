@@ -0,0 +1,57 @@
+#include "parallelrecording.h"
+
+#include <cassert>
+#include <algorithm>
+#include <thread>
+
+using namespace ComputeBasics;
+
+std::vector<WorkSlice> ComputeBasics::SplitWork(uint32_t itemsCount, uint32_t threadsCount, uint32_t minItemsPerSlice)
+{
+    assert(minItemsPerSlice > 0);
+
+    if (itemsCount == 0)
+        return {};
+
+    if (threadsCount == 0)
+        threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    const uint32_t slicesCount = std::min(threadsCount, std::max(itemsCount / minItemsPerSlice, 1u));
+
+    // Note the remainder goes one item each to the first slices, so slices differ in one item at most
+    const uint32_t itemsPerSlice = itemsCount / slicesCount;
+    const uint32_t remainder = itemsCount % slicesCount;
+
+    std::vector<WorkSlice> slices(slicesCount);
+    uint32_t firstItem = 0;
+    for (uint32_t s = 0; s < slicesCount; ++s)
+    {
+        slices[s].m_firstItem = firstItem;
+        slices[s].m_itemsCount = itemsPerSlice + (s < remainder ? 1 : 0);
+        firstItem += slices[s].m_itemsCount;
+    }
+    assert(firstItem == itemsCount);
+
+    return slices;
+}
+
+void ComputeBasics::RecordInParallel(const std::vector<WorkSlice>& slices, const RecordWorkSlice& recordSlice)
+{
+    assert(recordSlice);
+
+    if (slices.empty())
+        return;
+
+    std::vector<std::thread> threads;
+    threads.reserve(slices.size() - 1);
+    for (uint32_t s = 1; s < slices.size(); ++s)
+    {
+        threads.emplace_back([&recordSlice, &slices, s]()
+        {
+            recordSlice(s, slices[s]);
+        });
+    }
+    recordSlice(0, slices[0]);
+
+    for (auto& thread : threads)
+        thread.join();
+}
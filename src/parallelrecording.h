@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Splits a batch of work items in contiguous slices and records them in parallel, a thread per slice.
+// Slice i always holds the items right after the ones of slice i - 1, so whatever is recorded per slice can be
+// submitted in slice order and keep the order of the items. It doesnt depend on d3d12, the gpu recording in
+// src/commandlistpool.h and the cpu one in src/cpucommandlist.h are both built on it.
+namespace ComputeBasics
+{
+
+struct WorkSlice
+{
+    uint32_t m_firstItem;
+    uint32_t m_itemsCount;
+};
+
+// Splits itemsCount items in up to threadsCount slices of at least minItemsPerSlice items, but for the last one.
+// threadsCount = 0 uses all the hardware threads. Note no slices for no items.
+std::vector<WorkSlice> SplitWork(uint32_t itemsCount, uint32_t threadsCount, uint32_t minItemsPerSlice);
+
+// Records the items of a slice. slice is the index of the slice, so results can be stored in order.
+using RecordWorkSlice = std::function<void(uint32_t slice, const WorkSlice& workSlice)>;
+
+// Calls recordSlice for every slice in a thread of its own. The first slice is recorded in the calling thread.
+// Note it returns once all the slices are recorded
+void RecordInParallel(const std::vector<WorkSlice>& slices, const RecordWorkSlice& recordSlice);
+
+}
@@ -0,0 +1,345 @@
+#include "pipelinestate.h"
+
+#include <d3dcompiler.h>
+#include <d3d12shader.h>
+#if !ENABLE_RGA_COMPATIBILITY
+#include <dxcapi.h>
+#endif
+#include <iostream>
+
+#include "utils.h"
+
+namespace
+{
+const char* g_rootSignatureTarget = "rootsig_1_1";
+const char* g_rootSignatureName = "SimpleRootSig";
+const char* g_computeShaderMain = "main";
+
+using ID3D12ShaderReflectionComPtr = Microsoft::WRL::ComPtr<ID3D12ShaderReflection>;
+#if ENABLE_RGA_COMPATIBILITY
+// Note 5.1 for the unbounded arrays of descriptors of data/shaders/bindless.hlsl, build_rga_data.bat uses the same
+const char* g_computeShaderTarget = "cs_5_1";
+const UINT g_compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+// Note shader model 6 (wave intrinsics) is only compiled by dxc
+const wchar_t* g_computeShaderTarget = L"cs_6_0";
+const wchar_t* g_computeShaderMainW = L"main";
+const wchar_t* g_compileArguments[] = { L"-Zi", L"-Qembed_debug", L"-Od" };
+
+using IDxcLibraryComPtr = Microsoft::WRL::ComPtr<IDxcLibrary>;
+using IDxcCompilerComPtr = Microsoft::WRL::ComPtr<IDxcCompiler>;
+using IDxcBlobComPtr = Microsoft::WRL::ComPtr<IDxcBlob>;
+using IDxcBlobEncodingComPtr = Microsoft::WRL::ComPtr<IDxcBlobEncoding>;
+using IDxcIncludeHandlerComPtr = Microsoft::WRL::ComPtr<IDxcIncludeHandler>;
+using IDxcOperationResultComPtr = Microsoft::WRL::ComPtr<IDxcOperationResult>;
+using IDxcContainerReflectionComPtr = Microsoft::WRL::ComPtr<IDxcContainerReflection>;
+#endif
+
+struct ShaderSource
+{
+    std::vector<char>               m_src;
+    std::string                     m_fileName;
+    std::vector<D3D_SHADER_MACRO>   m_macros;
+};
+
+// Note the macros point to the defines strings so they have to outlive the compilation
+std::vector<D3D_SHADER_MACRO> CreateShaderMacros(const ComputeBasics::ShaderDefines& defines)
+{
+    std::vector<D3D_SHADER_MACRO> macros;
+    macros.reserve(defines.size() + 1);
+    for (auto& define : defines)
+    {
+        macros.push_back({ define.m_name.c_str(), define.m_value.c_str() });
+    }
+    macros.push_back({ nullptr, nullptr });
+
+    return macros;
+}
+
+// Note rootSignatureBlob can be a shader with the root signature embedded
+ID3D12RootSignatureComPtr CreateComputeRootSignature(ID3D12Device* device, ID3DBlob* rootSignatureBlob,
+                                                     const std::wstring& name)
+{
+    assert(device);
+    assert(rootSignatureBlob);
+
+    ID3D12RootSignatureComPtr rootSignature;
+    if (FAILED(device->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(),
+                                           IID_PPV_ARGS(&rootSignature))))
+    {
+        std::wcout << g_outputTag << " [CreateComputeRootSignature] CreateRootSignature call failed\n";
+        return nullptr;
+    }
+
+    rootSignature->SetName(name.c_str());
+
+    return rootSignature;
+}
+
+#if ENABLE_RGA_COMPATIBILITY
+ID3DBlobComPtr CompileBlob(const ShaderSource& shaderSource, const char* target, const char* mainName, unsigned int flags,
+                           ID3DBlob** errors)
+{
+    assert(errors);
+
+    ID3DBlobComPtr blob;
+
+    const auto& src = shaderSource.m_src;
+    auto result = D3DCompile(&src[0], strlen(&src[0]), shaderSource.m_fileName.c_str(), &shaderSource.m_macros[0],
+                             D3D_COMPILE_STANDARD_FILE_INCLUDE, mainName, target, flags, 0, &blob, errors);
+    if (FAILED(result))
+    {
+        assert(*errors);
+
+        std::wcout << g_outputTag << " CompileBlob failed " << static_cast<const char*>((*errors)->GetBufferPointer());
+
+        return nullptr;
+    }
+
+    return blob;
+}
+
+ID3D12RootSignatureComPtr CreateComputeRootSignature(ID3D12Device* device, const ShaderSource& rootSignatureSrc,
+                                                     const char* rootSignatureMacro, const std::wstring& name)
+{
+    assert(device);
+    assert(rootSignatureSrc.m_src.size());
+
+    ID3DBlobComPtr errors;
+    auto rootSignatureBlob = CompileBlob(rootSignatureSrc, g_rootSignatureTarget, rootSignatureMacro, 0, &errors);
+    if (!rootSignatureBlob)
+    {
+        std::wcout << g_outputTag << " [CreateComputeRootSignature] Failed to compile blob ";
+        if (errors)
+            std::cout << static_cast<const char*>(errors->GetBufferPointer()) << "\n";
+        return nullptr;
+    }
+
+    return CreateComputeRootSignature(device, rootSignatureBlob.Get(), name);
+}
+
+ID3DBlobComPtr CreateComputeShader(ID3D12Device* device, const ShaderSource& computeShaderSrc)
+{
+    assert(device);
+    assert(!computeShaderSrc.m_src.empty());
+
+    ID3DBlobComPtr errors;
+    auto computeShader = CompileBlob(computeShaderSrc, g_computeShaderTarget, g_computeShaderMain, g_compileFlags, &errors);
+    if (!computeShader)
+    {
+        std::wcout << g_outputTag << " [CreateComputeShader] failed to compile blob ";
+        if (errors)
+            std::wcout << static_cast<const char*>(errors->GetBufferPointer()) << "\n";
+        return nullptr;
+    }
+
+    return computeShader;
+}
+#else
+// Compiles the main entry point with dxc embedding the root signature defined by rootSignatureMacro,
+// so the same blob creates both the root signature and the pso.
+ID3DBlobComPtr CreateComputeShader(ID3D12Device* device, const ShaderSource& computeShaderSrc,
+                                   const ComputeBasics::ShaderDefines& defines, const char* rootSignatureMacro)
+{
+    assert(device);
+    assert(!computeShaderSrc.m_src.empty());
+
+    IDxcLibraryComPtr library;
+    IDxcCompilerComPtr compiler;
+    if (FAILED(DxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(&library))) ||
+        FAILED(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler))))
+    {
+        std::wcout << g_outputTag << " [CreateComputeShader] dxcompiler.dll couldn't be loaded\n";
+        return nullptr;
+    }
+
+    const auto& src = computeShaderSrc.m_src;
+    IDxcBlobEncodingComPtr srcBlob;
+    Utils::AssertIfFailed(library->CreateBlobWithEncodingFromPinned(&src[0], static_cast<UINT32>(strlen(&src[0])),
+                                                                    CP_UTF8, &srcBlob));
+    IDxcIncludeHandlerComPtr includeHandler;
+    Utils::AssertIfFailed(library->CreateIncludeHandler(&includeHandler));
+
+    // Note the wide strings have to outlive the compilation
+    const std::wstring rootSignatureMacroW = Utils::ConvertFromUTF8ToUTF16(rootSignatureMacro);
+    std::vector<const wchar_t*> arguments(std::begin(g_compileArguments), std::end(g_compileArguments));
+    arguments.push_back(L"-rootsig-define");
+    arguments.push_back(rootSignatureMacroW.c_str());
+
+    std::vector<std::wstring> definesW;
+    definesW.reserve(defines.size() * 2);
+    std::vector<DxcDefine> dxcDefines;
+    for (auto& define : defines)
+    {
+        definesW.push_back(Utils::ConvertFromUTF8ToUTF16(define.m_name));
+        definesW.push_back(Utils::ConvertFromUTF8ToUTF16(define.m_value));
+        dxcDefines.push_back({ definesW[definesW.size() - 2].c_str(), definesW.back().c_str() });
+    }
+
+    const std::wstring fileNameW = Utils::ConvertFromUTF8ToUTF16(computeShaderSrc.m_fileName);
+    IDxcOperationResultComPtr result;
+    Utils::AssertIfFailed(compiler->Compile(srcBlob.Get(), fileNameW.c_str(), g_computeShaderMainW, g_computeShaderTarget,
+                                            &arguments[0], static_cast<UINT32>(arguments.size()),
+                                            dxcDefines.empty() ? nullptr : &dxcDefines[0],
+                                            static_cast<UINT32>(dxcDefines.size()), includeHandler.Get(), &result));
+
+    HRESULT status;
+    Utils::AssertIfFailed(result->GetStatus(&status));
+    if (FAILED(status))
+    {
+        IDxcBlobEncodingComPtr errors;
+        std::wcout << g_outputTag << " [CreateComputeShader] failed to compile blob ";
+        if (SUCCEEDED(result->GetErrorBuffer(&errors)) && errors)
+            std::cout << std::string(static_cast<const char*>(errors->GetBufferPointer()), errors->GetBufferSize()) << "\n";
+        return nullptr;
+    }
+
+    IDxcBlobComPtr blob;
+    Utils::AssertIfFailed(result->GetResult(&blob));
+
+    // Note IDxcBlob and ID3DBlob share the same interface
+    ID3DBlobComPtr computeShader;
+    Utils::AssertIfFailed(blob.As(&computeShader));
+
+    return computeShader;
+}
+#endif
+
+ComputeBasics::ShaderRegisterType GetShaderRegisterType(D3D_SHADER_INPUT_TYPE type)
+{
+    switch (type)
+    {
+    case D3D_SIT_CBUFFER:
+        return ComputeBasics::ShaderRegisterType::ConstantBuffer;
+    case D3D_SIT_TBUFFER:
+    case D3D_SIT_TEXTURE:
+    case D3D_SIT_STRUCTURED:
+    case D3D_SIT_BYTEADDRESS:
+        return ComputeBasics::ShaderRegisterType::ShaderResource;
+    case D3D_SIT_SAMPLER:
+        return ComputeBasics::ShaderRegisterType::Sampler;
+    default:
+        return ComputeBasics::ShaderRegisterType::UnorderedAccess;
+    }
+}
+
+// Returns the resources bound by the compute shader, the ones it doesnt use left out
+bool ReflectShaderBindings(ID3DBlob* computeShader, std::vector<ComputeBasics::ShaderBinding>& bindings)
+{
+    assert(computeShader);
+
+    ID3D12ShaderReflectionComPtr reflection;
+#if ENABLE_RGA_COMPATIBILITY
+    if (FAILED(D3DReflect(computeShader->GetBufferPointer(), computeShader->GetBufferSize(),
+                          IID_PPV_ARGS(&reflection))))
+        return false;
+#else
+    // Note D3DReflect doesnt read dxil, its reflection is a part of the dxc container
+    IDxcContainerReflectionComPtr containerReflection;
+    IDxcBlobComPtr blob;
+    UINT32 dxilPart;
+    if (FAILED(DxcCreateInstance(CLSID_DxcContainerReflection, IID_PPV_ARGS(&containerReflection))) ||
+        FAILED(computeShader->QueryInterface(IID_PPV_ARGS(&blob))) ||
+        FAILED(containerReflection->Load(blob.Get())) ||
+        FAILED(containerReflection->FindFirstPartKind(DXC_PART_DXIL, &dxilPart)) ||
+        FAILED(containerReflection->GetPartReflection(dxilPart, IID_PPV_ARGS(&reflection))))
+        return false;
+#endif
+
+    D3D12_SHADER_DESC shaderDesc;
+    Utils::AssertIfFailed(reflection->GetDesc(&shaderDesc));
+    bindings.clear();
+    for (UINT resource = 0; resource < shaderDesc.BoundResources; ++resource)
+    {
+        D3D12_SHADER_INPUT_BIND_DESC bindDesc;
+        Utils::AssertIfFailed(reflection->GetResourceBindingDesc(resource, &bindDesc));
+        bindings.push_back({ bindDesc.Name, GetShaderRegisterType(bindDesc.Type), bindDesc.BindPoint, bindDesc.Space });
+    }
+
+    return true;
+}
+
+// Maps the bindings of the compute shader to the root parameters of the root signature defined by
+// rootSignatureMacro. The bindings are reflected, or parsed from the source if the reflection fails.
+std::shared_ptr<const ComputeBasics::RootBindingMap> CreateRootBindingMap(const ShaderSource& shaderSrc,
+                                                                          ID3DBlob* computeShader,
+                                                                          const char* rootSignatureMacro)
+{
+    const std::string src(&shaderSrc.m_src[0]);
+
+    ComputeBasics::RootSignatureLayout layout;
+    if (!ComputeBasics::ParseRootSignature(ComputeBasics::FindRootSignature(src, rootSignatureMacro), layout))
+    {
+        std::wcout << g_outputTag << " [CreateRootBindingMap] root signature " << rootSignatureMacro
+                   << " not parsed, bindings by name not available\n";
+        return nullptr;
+    }
+
+    std::vector<ComputeBasics::ShaderBinding> bindings;
+    if (!ReflectShaderBindings(computeShader, bindings))
+        bindings = ComputeBasics::ParseShaderBindings(src);
+
+    return std::make_shared<ComputeBasics::RootBindingMap>(layout, bindings);
+}
+}
+
+ComputeBasics::PipelineState ComputeBasics::CreatePipelineState(ID3D12Device* device, const std::wstring& shaderFileName,
+                                                                const std::wstring& rootSignatureName,
+                                                                const std::wstring& pipelineStateName)
+{
+    PipelineState pipelineState = CreatePipelineState(device, shaderFileName, g_rootSignatureName, {}, pipelineStateName);
+    if (pipelineState.m_rootSignature)
+        pipelineState.m_rootSignature->SetName(rootSignatureName.c_str());
+
+    return pipelineState;
+}
+
+ComputeBasics::PipelineState ComputeBasics::CreatePipelineState(ID3D12Device* device, const std::wstring& shaderFileName,
+                                                                const char* rootSignatureMacro, const ShaderDefines& defines,
+                                                                const std::wstring& name)
+{
+    assert(device);
+    assert(!shaderFileName.empty());
+    assert(rootSignatureMacro);
+
+    ShaderSource shaderSrc;
+    shaderSrc.m_src = Utils::ReadFullFile(shaderFileName);
+    if (shaderSrc.m_src.empty())
+    {
+        std::wcout << g_outputTag << " [CreatePipelineState] ReadFullFile " << shaderFileName.c_str() << " failed\n";
+        return {};
+    }
+    shaderSrc.m_fileName = Utils::ConvertFromUTF16ToUTF8(shaderFileName);
+    shaderSrc.m_macros = CreateShaderMacros(defines);
+
+#if ENABLE_RGA_COMPATIBILITY
+    auto rootSignature = CreateComputeRootSignature(device, shaderSrc, rootSignatureMacro, name);
+    if (!rootSignature)
+        return {};
+
+    auto computeShader = CreateComputeShader(device, shaderSrc);
+    if (!computeShader)
+        return {};
+#else
+    auto computeShader = CreateComputeShader(device, shaderSrc, defines, rootSignatureMacro);
+    if (!computeShader)
+        return {};
+
+    auto rootSignature = CreateComputeRootSignature(device, computeShader.Get(), name);
+    if (!rootSignature)
+        return {};
+#endif
+
+    ID3D12PipelineStateComPtr pipelineState;
+    D3D12_COMPUTE_PIPELINE_STATE_DESC desc;
+    desc.pRootSignature = rootSignature.Get();
+    desc.CS             = { computeShader->GetBufferPointer(), computeShader->GetBufferSize() };
+    desc.NodeMask       = 0;
+    desc.CachedPSO      = {nullptr,0};
+    desc.Flags          = D3D12_PIPELINE_STATE_FLAG_NONE;
+
+    Utils::AssertIfFailed(device->CreateComputePipelineState(&desc, IID_PPV_ARGS(&pipelineState)));
+    pipelineState->SetName(name.c_str());
+
+    return { rootSignature, pipelineState, CreateRootBindingMap(shaderSrc, computeShader.Get(), rootSignatureMacro) };
+}
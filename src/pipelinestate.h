@@ -0,0 +1,42 @@
+#pragma once
+
+#include "common.h"
+
+#include <memory>
+#include <vector>
+
+#include "rootsignaturelayout.h"
+
+namespace ComputeBasics
+{
+
+struct PipelineState
+{
+    ID3D12RootSignatureComPtr m_rootSignature;
+    ID3D12PipelineStateComPtr m_pso;
+    // Root parameters of the shader bindings by name, null if the root signature couldnt be parsed.
+    // Note shared by the copies of the pipeline state, it is built once when compiled.
+    std::shared_ptr<const RootBindingMap> m_bindingMap;
+};
+
+// Preprocessor defines used to build permutations of the same shader file.
+// Note both the root signature and the compute shader are compiled with them.
+struct ShaderDefine
+{
+    std::string m_name;
+    std::string m_value;
+};
+using ShaderDefines = std::vector<ShaderDefine>;
+
+// Compiles the root signature defined by the SimpleRootSig macro and the main entry point
+PipelineState CreatePipelineState(ID3D12Device* device, const std::wstring& shaderFileName,
+                                  const std::wstring& rootSignatureName,
+                                  const std::wstring& pipelineStateName);
+
+// Compiles the root signature defined by the rootSignatureMacro macro and the main entry point.
+// The shader file can #include files relative to itself.
+PipelineState CreatePipelineState(ID3D12Device* device, const std::wstring& shaderFileName,
+                                  const char* rootSignatureMacro, const ShaderDefines& defines,
+                                  const std::wstring& name);
+
+}
@@ -0,0 +1,144 @@
+#include "prefixscan.h"
+
+#include <string>
+
+#include "utils.h"
+#include "cmdlists.h"
+
+namespace
+{
+const wchar_t* g_scanShaderFileName     = L"./data/shaders/scan.hlsl";
+const char* g_scanRootSignatureName     = "ScanRootSig";
+const uint32_t g_scanGroupSize          = 256;
+const uint32_t g_scanDescriptorsCount   = 3;
+// Note SCAN_LOOK_BACK_STATE_WORDS, a flag and two sums per partition
+const uint32_t g_scanLookBackStateWords = 3;
+
+// Root parameters as laid out in ScanRootSig
+enum ScanRootParameters
+{
+    ScanRootParameters_Constants = 0,
+    ScanRootParameters_Table
+};
+
+struct ScanConstants
+{
+    uint32_t m_elementsCount;
+    uint32_t m_partitionsCount;
+};
+
+uint32_t CalculatePartitionsCount(uint32_t elementsCount)
+{
+    return (elementsCount + ComputeBasics::PrefixScan::g_partitionSize - 1) / ComputeBasics::PrefixScan::g_partitionSize;
+}
+
+// Partitions counter plus a state per partition
+uint32_t CalculateStateWordsCount(ComputeBasics::ScanAlgorithm algorithm, uint32_t partitionsCount)
+{
+    const bool isLookBack = algorithm == ComputeBasics::ScanAlgorithm::DecoupledLookBack;
+    return 1 + partitionsCount * (isLookBack ? g_scanLookBackStateWords : 1);
+}
+}
+
+using namespace ComputeBasics;
+
+const uint32_t PrefixScan::g_partitionSize;
+
+PrefixScan::PrefixScan(ID3D12Device* device, ScanType type, ScanAlgorithm algorithm, uint32_t maxElementsCount) :
+    m_device(device), m_algorithm(algorithm), m_maxElementsCount(maxElementsCount)
+{
+    assert(m_device);
+    assert(m_maxElementsCount > 0);
+
+#if ENABLE_RGA_COMPATIBILITY
+    m_useWaveIntrinsics = false;
+#else
+    m_useWaveIntrinsics = Utils::CheckWaveIntrinsicsSupport(m_device);
+#endif
+
+    const ScanPass lookBackPasses[] = { ScanPass_ClearState, ScanPass_LookBack };
+    const ScanPass reduceThenScanPasses[] = { ScanPass_Reduce, ScanPass_ScanPartitions, ScanPass_Downsweep };
+    const bool isLookBack = m_algorithm == ScanAlgorithm::DecoupledLookBack;
+    const ScanPass* passes = isLookBack ? lookBackPasses : reduceThenScanPasses;
+    const size_t passesCount = isLookBack ? _countof(lookBackPasses) : _countof(reduceThenScanPasses);
+
+    for (size_t i = 0; i < passesCount; ++i)
+    {
+        const ShaderDefines defines
+        {
+            { "SCAN_PASS", std::to_string(passes[i]) },
+            { "SCAN_INCLUSIVE", type == ScanType::Inclusive ? "1" : "0" },
+            { "SCAN_USE_WAVE_INTRINSICS", m_useWaveIntrinsics ? "1" : "0" }
+        };
+        m_pipelineStates[passes[i]] = CreatePipelineState(m_device, g_scanShaderFileName, g_scanRootSignatureName, defines,
+                                                          L"Scan Pass " + std::to_wstring(passes[i]));
+    }
+
+    const uint64_t stateSizeBytes = CalculateStateWordsCount(m_algorithm, CalculatePartitionsCount(m_maxElementsCount)) *
+                                    sizeof(uint32_t);
+    m_state = Allocate(m_device, stateSizeBytes, true, L"Scan Partitions State");
+}
+
+bool PrefixScan::IsValid() const
+{
+    if (m_algorithm == ScanAlgorithm::DecoupledLookBack)
+        return m_pipelineStates[ScanPass_ClearState].m_pso && m_pipelineStates[ScanPass_LookBack].m_pso;
+
+    return m_pipelineStates[ScanPass_Reduce].m_pso && m_pipelineStates[ScanPass_ScanPartitions].m_pso &&
+           m_pipelineStates[ScanPass_Downsweep].m_pso;
+}
+
+DescriptorHeapPtr PrefixScan::EnqueueScan(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& input,
+                                          const GpuMemAllocation& output, uint32_t elementsCount)
+{
+    assert(IsValid());
+    assert(computeCmdList);
+    assert(input.m_resource);
+    assert(output.m_resource);
+    assert(elementsCount > 0 && elementsCount <= m_maxElementsCount);
+
+    const uint32_t partitionsCount = CalculatePartitionsCount(elementsCount);
+
+    auto descriptorHeap = std::make_unique<DescriptorHeap>(m_device, g_scanDescriptorsCount);
+    auto table = descriptorHeap->CreateBufferDescriptor(input, DXGI_FORMAT_R32_UINT, elementsCount, false);
+    descriptorHeap->CreateBufferDescriptor(output, DXGI_FORMAT_R32_UINT, elementsCount, true);
+    descriptorHeap->CreateByteBufferDescriptor(m_state, CalculateStateWordsCount(m_algorithm, partitionsCount), true);
+
+    ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { descriptorHeap->GetD3D12DescriptorHeap() };
+    computeCmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+
+    // Note every pass depends on the state written by the previous one
+    const auto stateBarrier = CreateUAVBarrier(m_state.m_resource.Get());
+    if (m_algorithm == ScanAlgorithm::DecoupledLookBack)
+    {
+        const uint32_t clearGroupsCount = (1 + partitionsCount + g_scanGroupSize - 1) / g_scanGroupSize;
+        EnqueuePass(computeCmdList, ScanPass_ClearState, table.m_gpuHandle, elementsCount, partitionsCount, clearGroupsCount);
+        computeCmdList->ResourceBarrier(1, &stateBarrier);
+        EnqueuePass(computeCmdList, ScanPass_LookBack, table.m_gpuHandle, elementsCount, partitionsCount, partitionsCount);
+    }
+    else
+    {
+        EnqueuePass(computeCmdList, ScanPass_Reduce, table.m_gpuHandle, elementsCount, partitionsCount, partitionsCount);
+        computeCmdList->ResourceBarrier(1, &stateBarrier);
+        EnqueuePass(computeCmdList, ScanPass_ScanPartitions, table.m_gpuHandle, elementsCount, partitionsCount, 1);
+        computeCmdList->ResourceBarrier(1, &stateBarrier);
+        EnqueuePass(computeCmdList, ScanPass_Downsweep, table.m_gpuHandle, elementsCount, partitionsCount, partitionsCount);
+    }
+    computeCmdList->ResourceBarrier(1, &stateBarrier);
+
+    return descriptorHeap;
+}
+
+void PrefixScan::EnqueuePass(ID3D12GraphicsCommandList* computeCmdList, ScanPass pass, D3D12_GPU_DESCRIPTOR_HANDLE table,
+                             uint32_t elementsCount, uint32_t partitionsCount, uint32_t groupsCount)
+{
+    const auto& pipelineState = m_pipelineStates[pass];
+    computeCmdList->SetComputeRootSignature(pipelineState.m_rootSignature.Get());
+    computeCmdList->SetPipelineState(pipelineState.m_pso.Get());
+
+    const ScanConstants constants = { elementsCount, partitionsCount };
+    computeCmdList->SetComputeRoot32BitConstants(ScanRootParameters_Constants, sizeof(constants) / sizeof(uint32_t),
+                                                 &constants, 0);
+    computeCmdList->SetComputeRootDescriptorTable(ScanRootParameters_Table, table);
+    computeCmdList->Dispatch(groupsCount, 1, 1);
+}
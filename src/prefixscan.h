@@ -0,0 +1,64 @@
+#pragma once
+
+#include "common.h"
+
+#include "gpumemory.h"
+#include "descriptors.h"
+#include "pipelinestate.h"
+#include "cpuprefixscan.h"
+
+namespace ComputeBasics
+{
+
+enum class ScanAlgorithm
+{
+    // Single pass over the input. Partitions wait for the sums of the previous ones.
+    DecoupledLookBack,
+    // Reduce, scan of the partitions sums and downsweep. Reads the input twice but groups never wait for others.
+    ReduceThenScan
+};
+
+// Prefix sum of uint buffers on the gpu using data/shaders/scan.hlsl.
+// Note both algorithms wrap the sums at 32 bits, as the cpu version does.
+class PrefixScan
+{
+public:
+    static const uint32_t g_partitionSize = 2048;
+
+    // maxElementsCount sizes the partitions state buffer
+    PrefixScan(ID3D12Device* device, ScanType type, ScanAlgorithm algorithm, uint32_t maxElementsCount);
+
+    bool IsValid() const;
+    bool UsesWaveIntrinsics() const { return m_useWaveIntrinsics; }
+
+    // Scans the first elementsCount elements of input into output, both R32_UINT.
+    // input has to be in NON_PIXEL_SHADER_RESOURCE state and output in UNORDERED_ACCESS state. They are left as they are.
+    // Note the descriptor heaps of the cmd list are replaced.
+    // Note calls share the partitions state buffer, so they have to execute in the order they were enqueued.
+    // Note returning the descriptor heap so it outlives the execution in the gpu
+    DescriptorHeapPtr EnqueueScan(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& input,
+                                  const GpuMemAllocation& output, uint32_t elementsCount);
+
+private:
+    enum ScanPass
+    {
+        ScanPass_ClearState = 0,
+        ScanPass_LookBack,
+        ScanPass_Reduce,
+        ScanPass_ScanPartitions,
+        ScanPass_Downsweep,
+        ScanPass_Count
+    };
+
+    ID3D12Device*       m_device;
+    ScanAlgorithm       m_algorithm;
+    bool                m_useWaveIntrinsics;
+    uint32_t            m_maxElementsCount;
+    PipelineState       m_pipelineStates[ScanPass_Count];
+    GpuMemAllocation    m_state;
+
+    void EnqueuePass(ID3D12GraphicsCommandList* computeCmdList, ScanPass pass, D3D12_GPU_DESCRIPTOR_HANDLE table,
+                     uint32_t elementsCount, uint32_t partitionsCount, uint32_t groupsCount);
+};
+
+}
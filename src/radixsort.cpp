@@ -0,0 +1,164 @@
+#include "radixsort.h"
+
+#include <algorithm>
+#include <string>
+
+#include "utils.h"
+#include "cmdlists.h"
+
+namespace
+{
+const wchar_t* g_radixSortShaderFileName    = L"./data/shaders/radixsort.hlsl";
+const char* g_radixSortRootSignatureName    = "RadixSortRootSig";
+const uint32_t g_digitBits                  = 8;
+const uint32_t g_digitsCount                = 1 << g_digitBits;
+// Keys in, keys out, values in, values out and counts
+const uint32_t g_descriptorsPerTable        = 5;
+const uint32_t g_tablesCount                = 2;
+
+// Root parameters as laid out in RadixSortRootSig
+enum RadixSortRootParameters
+{
+    RadixSortRootParameters_Constants = 0,
+    RadixSortRootParameters_Table
+};
+
+struct RadixSortConstants
+{
+    uint32_t m_keysCount;
+    uint32_t m_groupsCount;
+    uint32_t m_blockSize;
+    uint32_t m_shift;
+};
+}
+
+using namespace ComputeBasics;
+
+const uint32_t RadixSort::g_groupSize;
+const uint32_t RadixSort::g_tileSize;
+const uint32_t RadixSort::g_maxGroupsCount;
+
+RadixSort::RadixSort(ID3D12Device* device, RadixSortType type, uint32_t maxKeysCount) :
+    m_device(device), m_type(type), m_maxKeysCount(maxKeysCount)
+{
+    assert(m_device);
+    assert(m_maxKeysCount > 0);
+
+#if ENABLE_RGA_COMPATIBILITY
+    m_useWaveIntrinsics = false;
+#else
+    m_useWaveIntrinsics = Utils::CheckWaveIntrinsicsSupport(m_device);
+#endif
+
+    for (uint32_t pass = 0; pass < RadixSortPass_PassesCount; ++pass)
+    {
+        const ShaderDefines defines
+        {
+            { "RADIX_SORT_PASS", std::to_string(pass) },
+            { "RADIX_SORT_HAS_VALUES", m_type == RadixSortType::KeysValues ? "1" : "0" },
+            { "RADIX_SORT_USE_WAVE_INTRINSICS", m_useWaveIntrinsics ? "1" : "0" }
+        };
+        m_pipelineStates[pass] = CreatePipelineState(m_device, g_radixSortShaderFileName, g_radixSortRootSignatureName,
+                                                     defines, L"Radix Sort Pass " + std::to_wstring(pass));
+    }
+
+    const uint64_t keysSizeBytes = static_cast<uint64_t>(m_maxKeysCount) * sizeof(uint32_t);
+    m_tempKeys = Allocate(m_device, keysSizeBytes, true, L"Radix Sort Temp Keys");
+    if (m_type == RadixSortType::KeysValues)
+        m_tempValues = Allocate(m_device, keysSizeBytes, true, L"Radix Sort Temp Values");
+
+    // Counts of every digit and group followed by the digits totals
+    m_counts = Allocate(m_device, (g_maxGroupsCount + 1) * g_digitsCount * sizeof(uint32_t), true, L"Radix Sort Counts");
+}
+
+bool RadixSort::IsValid() const
+{
+    return m_pipelineStates[RadixSortPass_Count].m_pso && m_pipelineStates[RadixSortPass_Scan].m_pso &&
+           m_pipelineStates[RadixSortPass_Scatter].m_pso;
+}
+
+DescriptorHeapPtr RadixSort::EnqueueSort(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& keys,
+                                         uint32_t keysCount)
+{
+    assert(m_type == RadixSortType::KeysOnly);
+    return EnqueueSortPasses(computeCmdList, keys, keys, keysCount);
+}
+
+DescriptorHeapPtr RadixSort::EnqueueSort(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& keys,
+                                         const GpuMemAllocation& values, uint32_t keysCount)
+{
+    assert(m_type == RadixSortType::KeysValues);
+    assert(values.m_resource);
+    return EnqueueSortPasses(computeCmdList, keys, values, keysCount);
+}
+
+DescriptorHeapPtr RadixSort::EnqueueSortPasses(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& keys,
+                                               const GpuMemAllocation& values, uint32_t keysCount)
+{
+    assert(IsValid());
+    assert(computeCmdList);
+    assert(keys.m_resource);
+    assert(keysCount > 0 && keysCount <= m_maxKeysCount);
+
+    // Every group takes a block of whole tiles
+    const uint32_t tilesCount = (keysCount + g_tileSize - 1) / g_tileSize;
+    const uint32_t maxGroupsCount = std::min(tilesCount, g_maxGroupsCount);
+    const uint32_t blockSize = (tilesCount + maxGroupsCount - 1) / maxGroupsCount * g_tileSize;
+    const uint32_t groupsCount = (keysCount + blockSize - 1) / blockSize;
+
+    // Note keys only sorts bind the keys again in the values slots so all the descriptors are valid
+    const bool hasValues = m_type == RadixSortType::KeysValues;
+    const GpuMemAllocation& tempValues = hasValues ? m_tempValues : m_tempKeys;
+    const uint32_t countsCount = (groupsCount + 1) * g_digitsCount;
+    auto descriptorHeap = std::make_unique<DescriptorHeap>(m_device, g_tablesCount * g_descriptorsPerTable);
+    auto createTable = [&](const GpuMemAllocation& srcKeys, const GpuMemAllocation& dstKeys,
+                           const GpuMemAllocation& srcValues, const GpuMemAllocation& dstValues)
+    {
+        auto table = descriptorHeap->CreateStructuredBufferDescriptor(srcKeys, keysCount, sizeof(uint32_t), true);
+        descriptorHeap->CreateStructuredBufferDescriptor(dstKeys, keysCount, sizeof(uint32_t), true);
+        descriptorHeap->CreateStructuredBufferDescriptor(srcValues, keysCount, sizeof(uint32_t), true);
+        descriptorHeap->CreateStructuredBufferDescriptor(dstValues, keysCount, sizeof(uint32_t), true);
+        descriptorHeap->CreateStructuredBufferDescriptor(m_counts, countsCount, sizeof(uint32_t), true);
+        return table.m_gpuHandle;
+    };
+    const D3D12_GPU_DESCRIPTOR_HANDLE tables[g_tablesCount] =
+    {
+        createTable(keys, m_tempKeys, hasValues ? values : keys, tempValues),
+        createTable(m_tempKeys, keys, tempValues, hasValues ? values : keys)
+    };
+
+    ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { descriptorHeap->GetD3D12DescriptorHeap() };
+    computeCmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+
+    const D3D12_RESOURCE_BARRIER barriers[] =
+    {
+        CreateUAVBarrier(keys.m_resource.Get()),
+        CreateUAVBarrier(m_tempKeys.m_resource.Get()),
+        CreateUAVBarrier(m_counts.m_resource.Get()),
+        CreateUAVBarrier(values.m_resource.Get()),
+        CreateUAVBarrier(tempValues.m_resource.Get())
+    };
+    const uint32_t barriersCount = hasValues ? _countof(barriers) : 3;
+
+    const uint32_t dispatchGroupsCounts[RadixSortPass_PassesCount] = { groupsCount, g_digitsCount, groupsCount };
+    for (uint32_t shift = 0; shift < 32; shift += g_digitBits)
+    {
+        const RadixSortConstants constants = { keysCount, groupsCount, blockSize, shift };
+        const D3D12_GPU_DESCRIPTOR_HANDLE table = tables[(shift / g_digitBits) % g_tablesCount];
+
+        for (uint32_t pass = 0; pass < RadixSortPass_PassesCount; ++pass)
+        {
+            const auto& pipelineState = m_pipelineStates[pass];
+            computeCmdList->SetComputeRootSignature(pipelineState.m_rootSignature.Get());
+            computeCmdList->SetPipelineState(pipelineState.m_pso.Get());
+            computeCmdList->SetComputeRoot32BitConstants(RadixSortRootParameters_Constants,
+                                                         sizeof(constants) / sizeof(uint32_t), &constants, 0);
+            computeCmdList->SetComputeRootDescriptorTable(RadixSortRootParameters_Table, table);
+            computeCmdList->Dispatch(dispatchGroupsCounts[pass], 1, 1);
+
+            computeCmdList->ResourceBarrier(barriersCount, barriers);
+        }
+    }
+
+    return descriptorHeap;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "common.h"
+
+#include "gpumemory.h"
+#include "descriptors.h"
+#include "pipelinestate.h"
+#include "cpuradixsort.h"
+
+namespace ComputeBasics
+{
+
+enum class RadixSortType
+{
+    KeysOnly,
+    KeysValues
+};
+
+// Lsd radix sort of uint keys on the gpu using data/shaders/radixsort.hlsl. Every 8 bits digit runs a count,
+// a scan and a scatter dispatch with a bounded amount of groups. The passes ping-pong between the keys and
+// a temporary buffer, so the result ends in the keys buffer.
+class RadixSort
+{
+public:
+    static const uint32_t g_groupSize = 256;
+    static const uint32_t g_tileSize = 1024;
+    static const uint32_t g_maxGroupsCount = 1024;
+
+    // maxKeysCount sizes the temporary buffers
+    RadixSort(ID3D12Device* device, RadixSortType type, uint32_t maxKeysCount);
+
+    bool IsValid() const;
+    bool UsesWaveIntrinsics() const { return m_useWaveIntrinsics; }
+
+    // Sorts the first keysCount elements of keys, and of values for KeysValues sorts, in ascending order.
+    // The sort is stable. The buffers are structured buffers of uint and have to be in UNORDERED_ACCESS state.
+    // Note the descriptor heaps of the cmd list are replaced.
+    // Note calls share the temporary buffers, so they have to execute in the order they were enqueued.
+    // Note returning the descriptor heap so it outlives the execution in the gpu
+    DescriptorHeapPtr EnqueueSort(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& keys,
+                                  uint32_t keysCount);
+    DescriptorHeapPtr EnqueueSort(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& keys,
+                                  const GpuMemAllocation& values, uint32_t keysCount);
+
+private:
+    enum RadixSortPass
+    {
+        RadixSortPass_Count = 0,
+        RadixSortPass_Scan,
+        RadixSortPass_Scatter,
+        RadixSortPass_PassesCount
+    };
+
+    ID3D12Device*       m_device;
+    RadixSortType       m_type;
+    bool                m_useWaveIntrinsics;
+    uint32_t            m_maxKeysCount;
+    PipelineState       m_pipelineStates[RadixSortPass_PassesCount];
+    GpuMemAllocation    m_tempKeys;
+    GpuMemAllocation    m_tempValues;
+    GpuMemAllocation    m_counts;
+
+    DescriptorHeapPtr EnqueueSortPasses(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& keys,
+                                        const GpuMemAllocation& values, uint32_t keysCount);
+};
+
+}
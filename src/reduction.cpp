@@ -0,0 +1,125 @@
+#include "reduction.h"
+
+#include <algorithm>
+#include <string>
+
+#include "utils.h"
+#include "cmdlists.h"
+
+namespace
+{
+const wchar_t* g_reductionShaderFileName    = L"./data/shaders/reduction.hlsl";
+const char* g_reductionRootSignatureName    = "ReductionRootSig";
+// Note enough work per thread to hide the latency of the loads before adding more groups
+const uint32_t g_elementsPerThread          = 16;
+const uint32_t g_descriptorsPerDispatch     = 2;
+const D3D12_RESOURCE_STATES g_partialsReadState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+
+// Root parameters as laid out in ReductionRootSig
+enum ReductionRootParameters
+{
+    ReductionRootParameters_Constants = 0,
+    ReductionRootParameters_Table
+};
+
+struct ReductionConstants
+{
+    uint32_t m_elementsCount;
+    uint32_t m_groupsCount;
+};
+
+DXGI_FORMAT GetReductionFormat(ComputeBasics::ReductionDataType dataType)
+{
+    switch (dataType)
+    {
+    case ComputeBasics::ReductionDataType::UInt:
+        return DXGI_FORMAT_R32_UINT;
+    case ComputeBasics::ReductionDataType::Int:
+        return DXGI_FORMAT_R32_SINT;
+    default:
+        return DXGI_FORMAT_R32_FLOAT;
+    }
+}
+}
+
+using namespace ComputeBasics;
+
+const uint32_t Reduction::g_groupSize;
+const uint32_t Reduction::g_maxGroupsCount;
+
+Reduction::Reduction(ID3D12Device* device, ReductionOp op, ReductionDataType dataType) :
+    m_device(device), m_format(GetReductionFormat(dataType))
+{
+    assert(m_device);
+
+#if ENABLE_RGA_COMPATIBILITY
+    m_useWaveIntrinsics = false;
+#else
+    m_useWaveIntrinsics = Utils::CheckWaveIntrinsicsSupport(m_device);
+#endif
+
+    const ShaderDefines defines
+    {
+        { "REDUCTION_OP", std::to_string(static_cast<int>(op)) },
+        { "REDUCTION_DATA_TYPE", std::to_string(static_cast<int>(dataType)) },
+        { "REDUCTION_USE_WAVE_INTRINSICS", m_useWaveIntrinsics ? "1" : "0" }
+    };
+    m_pipelineState = CreatePipelineState(m_device, g_reductionShaderFileName, g_reductionRootSignatureName, defines,
+                                          L"Reduction");
+
+    m_partials = Allocate(m_device, g_maxGroupsCount * sizeof(uint32_t), true, L"Reduction Partials");
+}
+
+DescriptorHeapPtr Reduction::EnqueueReduce(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& input,
+                                           uint32_t elementsCount, const GpuMemAllocation& output)
+{
+    assert(IsValid());
+    assert(computeCmdList);
+    assert(input.m_resource);
+    assert(output.m_resource);
+    assert(elementsCount > 0);
+
+    const uint32_t elementsPerGroup = g_groupSize * g_elementsPerThread;
+    const uint32_t groupsCount = std::min((elementsCount + elementsPerGroup - 1) / elementsPerGroup, g_maxGroupsCount);
+
+    // Note a single group writes the result straight away
+    const uint32_t dispatchesCount = groupsCount > 1 ? 2 : 1;
+    auto descriptorHeap = std::make_unique<DescriptorHeap>(m_device, dispatchesCount * g_descriptorsPerDispatch);
+
+    ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { descriptorHeap->GetD3D12DescriptorHeap() };
+    computeCmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+    computeCmdList->SetComputeRootSignature(m_pipelineState.m_rootSignature.Get());
+    computeCmdList->SetPipelineState(m_pipelineState.m_pso.Get());
+
+    auto dispatch = [&](const GpuMemAllocation& src, uint32_t srcElementsCount, const GpuMemAllocation& dst,
+                        uint32_t dstElementsCount, uint32_t dispatchGroupsCount)
+    {
+        auto table = descriptorHeap->CreateBufferDescriptor(src, m_format, srcElementsCount, false);
+        descriptorHeap->CreateBufferDescriptor(dst, m_format, dstElementsCount, true);
+
+        const ReductionConstants constants = { srcElementsCount, dispatchGroupsCount };
+        computeCmdList->SetComputeRoot32BitConstants(ReductionRootParameters_Constants,
+                                                     sizeof(constants) / sizeof(uint32_t), &constants, 0);
+        computeCmdList->SetComputeRootDescriptorTable(ReductionRootParameters_Table, table.m_gpuHandle);
+        computeCmdList->Dispatch(dispatchGroupsCount, 1, 1);
+    };
+
+    if (groupsCount == 1)
+    {
+        dispatch(input, elementsCount, output, 1, 1);
+        return descriptorHeap;
+    }
+
+    ID3D12Resource* partials = m_partials.m_resource.Get();
+    dispatch(input, elementsCount, m_partials, groupsCount, groupsCount);
+
+    auto barrier = CreateTransition(partials, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, g_partialsReadState);
+    computeCmdList->ResourceBarrier(1, &barrier);
+
+    dispatch(m_partials, groupsCount, output, 1, 1);
+
+    barrier = CreateTransition(partials, g_partialsReadState, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    computeCmdList->ResourceBarrier(1, &barrier);
+
+    return descriptorHeap;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common.h"
+
+#include "gpumemory.h"
+#include "descriptors.h"
+#include "pipelinestate.h"
+#include "cpureduction.h"
+
+namespace ComputeBasics
+{
+
+enum class ReductionDataType
+{
+    Float,
+    UInt,
+    Int
+};
+
+// Sum/min/max of a typed buffer on the gpu using data/shaders/reduction.hlsl.
+// A first dispatch reduces the input to up to g_maxGroupsCount partial results and a second single group
+// dispatch reduces those. Uses the wave intrinsics permutation when the shaders are compiled with dxc and
+// the device supports them.
+class Reduction
+{
+public:
+    static const uint32_t g_groupSize = 256;
+    static const uint32_t g_maxGroupsCount = 1024;
+
+    Reduction(ID3D12Device* device, ReductionOp op, ReductionDataType dataType);
+
+    bool IsValid() const { return m_pipelineState.m_pso != nullptr; }
+    bool UsesWaveIntrinsics() const { return m_useWaveIntrinsics; }
+    DXGI_FORMAT GetFormat() const { return m_format; }
+
+    // Writes the reduction of the first elementsCount elements of input to the first element of output.
+    // input has to be in NON_PIXEL_SHADER_RESOURCE state and output in UNORDERED_ACCESS state. They are left as they are.
+    // Note the descriptor heaps of the cmd list are replaced.
+    // Note calls share the partial results buffer, so they have to execute in the order they were enqueued.
+    // Note returning the descriptor heap so it outlives the execution in the gpu
+    DescriptorHeapPtr EnqueueReduce(ID3D12GraphicsCommandList* computeCmdList, const GpuMemAllocation& input,
+                                    uint32_t elementsCount, const GpuMemAllocation& output);
+
+private:
+    ID3D12Device*       m_device;
+    PipelineState       m_pipelineState;
+    DXGI_FORMAT         m_format;
+    bool                m_useWaveIntrinsics;
+    GpuMemAllocation    m_partials;
+};
+
+}
@@ -0,0 +1,82 @@
+#include "residencymanager.h"
+
+#include "utils.h"
+
+using namespace ComputeBasics;
+
+ResidencyManager::ResidencyManager(ID3D12Device* device, IDXGIAdapter1* adapter, uint64_t standInBudgetBytes) :
+    m_device(device), m_standInBudgetBytes(standInBudgetBytes)
+{
+    assert(m_device);
+    assert(adapter || standInBudgetBytes > 0);
+
+    // Note QueryVideoMemoryInfo comes with IDXGIAdapter3
+    if (adapter)
+        Utils::AssertIfFailed(adapter->QueryInterface(IID_PPV_ARGS(&m_adapter)));
+}
+
+uint32_t ResidencyManager::Track(const GpuMemAllocation& allocation, ResidencyHeapType heapType)
+{
+    assert(allocation.m_resource);
+
+    const D3D12_RESOURCE_DESC desc = allocation.m_resource->GetDesc();
+    const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = m_device->GetResourceAllocationInfo(0, 1, &desc);
+
+    const uint32_t trackedAllocation = m_policy.Track(allocationInfo.SizeInBytes, heapType);
+    if (trackedAllocation >= m_resources.size())
+        m_resources.resize(trackedAllocation + 1);
+    m_resources[trackedAllocation] = allocation.m_resource;
+
+    return trackedAllocation;
+}
+
+void ResidencyManager::Untrack(uint32_t allocation)
+{
+    assert(allocation < m_resources.size());
+    assert(m_resources[allocation]);
+
+    m_policy.Untrack(allocation);
+    m_resources[allocation].Reset();
+}
+
+void ResidencyManager::Use(uint32_t allocation)
+{
+    m_policy.Use(allocation);
+}
+
+void ResidencyManager::PrepareJob()
+{
+    m_policy.PlanJob(QueryBudget(), m_plan);
+
+    // Note evicting first releases the memory the allocations made resident take
+    if (!m_plan.m_evict.empty())
+    {
+        m_pageables.clear();
+        for (uint32_t allocation : m_plan.m_evict)
+            m_pageables.push_back(m_resources[allocation].Get());
+        Utils::AssertIfFailed(m_device->Evict(static_cast<UINT>(m_pageables.size()), &m_pageables[0]));
+    }
+
+    // Note MakeResident blocks until the allocations are in video memory
+    if (!m_plan.m_makeResident.empty())
+    {
+        m_pageables.clear();
+        for (uint32_t allocation : m_plan.m_makeResident)
+            m_pageables.push_back(m_resources[allocation].Get());
+        Utils::AssertIfFailed(m_device->MakeResident(static_cast<UINT>(m_pageables.size()), &m_pageables[0]));
+    }
+}
+
+uint64_t ResidencyManager::QueryBudget() const
+{
+    if (m_standInBudgetBytes > 0)
+        return m_standInBudgetBytes;
+
+    DXGI_QUERY_VIDEO_MEMORY_INFO memoryInfo;
+    Utils::AssertIfFailed(m_adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &memoryInfo));
+
+    // Note the current usage counts the tracked allocations too, the rest of it is out of the manager hands
+    const uint64_t trackedBytes = m_policy.GetCounters().m_residentBytes;
+    const uint64_t untrackedBytes = memoryInfo.CurrentUsage > trackedBytes ? memoryInfo.CurrentUsage - trackedBytes : 0;
+    return memoryInfo.Budget > untrackedBytes ? memoryInfo.Budget - untrackedBytes : 0;
+}
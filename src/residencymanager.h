@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common.h"
+
+#include <vector>
+
+#include "gpumemory.h"
+#include "residencypolicy.h"
+
+namespace ComputeBasics
+{
+
+// Keeps the allocations of a sequence of jobs in the video memory budget of the process. Before every job,
+// PrepareJob makes resident the allocations the job uses and evicts the least recently used ones if the resident
+// allocations go over the budget, see src/residencypolicy.h.
+// The budget is the one QueryVideoMemoryInfo gives for the local segment minus what the process uses out of the
+// tracked allocations. A stand-in budget replaces it, to run the policy with less memory than the gpu has or with
+// no adapter at all.
+// Note evicted allocations cant be used by the gpu, PrepareJob has to be called once the jobs before are done with
+// the allocations it can evict, as between jobs waited for.
+class ResidencyManager
+{
+public:
+    // standInBudgetBytes = 0 uses the budget of the adapter, which is required then
+    ResidencyManager(ID3D12Device* device, IDXGIAdapter1* adapter, uint64_t standInBudgetBytes = 0);
+
+    // Note the manager keeps a reference to the resource until it is untracked
+    uint32_t Track(const GpuMemAllocation& allocation, ResidencyHeapType heapType);
+    // Note evicted allocations can be released as they are
+    void Untrack(uint32_t allocation);
+
+    // Adds the allocation to the next job
+    void Use(uint32_t allocation);
+    void PrepareJob();
+
+    // Bytes the tracked default heap allocations can take
+    uint64_t QueryBudget() const;
+    const ResidencyCounters& GetCounters() const { return m_policy.GetCounters(); }
+
+private:
+    ID3D12Device*                       m_device;
+    IDXGIAdapter3ComPtr                 m_adapter;
+    uint64_t                            m_standInBudgetBytes;
+
+    ResidencyPolicy                     m_policy;
+    // Indexed by the policy allocations
+    std::vector<ID3D12ResourceComPtr>   m_resources;
+    ResidencyPlan                       m_plan;
+    std::vector<ID3D12Pageable*>        m_pageables;
+};
+
+}
\ No newline at end of file
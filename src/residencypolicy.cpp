@@ -0,0 +1,160 @@
+#include "residencypolicy.h"
+
+#include <cassert>
+#include <algorithm>
+
+using namespace ComputeBasics;
+
+ResidencyPolicy::ResidencyPolicy() :
+    m_leastRecentlyUsed(g_invalidResidencyAllocation), m_mostRecentlyUsed(g_invalidResidencyAllocation), m_job(1),
+    m_counters{}
+{
+}
+
+uint32_t ResidencyPolicy::Track(uint64_t sizeBytes, ResidencyHeapType heapType)
+{
+    assert(sizeBytes > 0);
+    assert(heapType != ResidencyHeapType::Count);
+
+    uint32_t allocation;
+    if (m_freeAllocations.empty())
+    {
+        allocation = static_cast<uint32_t>(m_allocations.size());
+        m_allocations.emplace_back();
+    }
+    else
+    {
+        allocation = m_freeAllocations.back();
+        m_freeAllocations.pop_back();
+    }
+    m_allocations[allocation] = { sizeBytes, heapType, true, true, 0, g_invalidResidencyAllocation,
+                                  g_invalidResidencyAllocation };
+
+    const uint32_t heapIndex = static_cast<uint32_t>(heapType);
+    m_counters.m_currentBytes[heapIndex] += sizeBytes;
+    m_counters.m_peakBytes[heapIndex] = std::max(m_counters.m_peakBytes[heapIndex],
+                                                 m_counters.m_currentBytes[heapIndex]);
+    if (heapType == ResidencyHeapType::Default)
+    {
+        Link(allocation);
+        AddResidentBytes(sizeBytes);
+    }
+
+    return allocation;
+}
+
+void ResidencyPolicy::Untrack(uint32_t allocation)
+{
+    assert(allocation < m_allocations.size());
+
+    Allocation& entry = m_allocations[allocation];
+    assert(entry.m_isTracked);
+
+    m_counters.m_currentBytes[static_cast<uint32_t>(entry.m_heapType)] -= entry.m_sizeBytes;
+    if (entry.m_heapType == ResidencyHeapType::Default && entry.m_isResident)
+    {
+        Unlink(allocation);
+        m_counters.m_residentBytes -= entry.m_sizeBytes;
+    }
+
+    // Note it can still be in the job allocations, they skip the untracked ones
+    entry.m_isTracked = false;
+    m_freeAllocations.push_back(allocation);
+}
+
+void ResidencyPolicy::Use(uint32_t allocation)
+{
+    assert(allocation < m_allocations.size());
+
+    Allocation& entry = m_allocations[allocation];
+    assert(entry.m_isTracked);
+
+    if (entry.m_heapType != ResidencyHeapType::Default || entry.m_lastJob == m_job)
+        return;
+
+    entry.m_lastJob = m_job;
+    m_jobAllocations.push_back(allocation);
+}
+
+void ResidencyPolicy::PlanJob(uint64_t budgetBytes, ResidencyPlan& plan)
+{
+    plan.m_evict.clear();
+    plan.m_makeResident.clear();
+
+    // Note the job allocations become the most recently used ones, so the evictions below start with the rest
+    uint64_t makeResidentBytes = 0;
+    for (uint32_t allocation : m_jobAllocations)
+    {
+        Allocation& entry = m_allocations[allocation];
+        if (!entry.m_isTracked || entry.m_lastJob != m_job)
+            continue;
+
+        if (entry.m_isResident)
+            Unlink(allocation);
+        else
+        {
+            entry.m_isResident = true;
+            makeResidentBytes += entry.m_sizeBytes;
+            plan.m_makeResident.push_back(allocation);
+        }
+        Link(allocation);
+    }
+
+    uint64_t residentBytes = m_counters.m_residentBytes + makeResidentBytes;
+    while (residentBytes > budgetBytes && m_leastRecentlyUsed != g_invalidResidencyAllocation &&
+           m_allocations[m_leastRecentlyUsed].m_lastJob != m_job)
+    {
+        const uint32_t allocation = m_leastRecentlyUsed;
+        Allocation& entry = m_allocations[allocation];
+        Unlink(allocation);
+        entry.m_isResident = false;
+        residentBytes -= entry.m_sizeBytes;
+        m_counters.m_residentBytes -= entry.m_sizeBytes;
+        m_counters.m_evictedBytes += entry.m_sizeBytes;
+        plan.m_evict.push_back(allocation);
+    }
+
+    AddResidentBytes(makeResidentBytes);
+    m_counters.m_evictionsCount += plan.m_evict.size();
+    m_counters.m_makeResidentsCount += plan.m_makeResident.size();
+    m_counters.m_madeResidentBytes += makeResidentBytes;
+
+    m_jobAllocations.clear();
+    ++m_job;
+}
+
+void ResidencyPolicy::Link(uint32_t allocation)
+{
+    Allocation& entry = m_allocations[allocation];
+    entry.m_previous = m_mostRecentlyUsed;
+    entry.m_next = g_invalidResidencyAllocation;
+
+    if (m_mostRecentlyUsed != g_invalidResidencyAllocation)
+        m_allocations[m_mostRecentlyUsed].m_next = allocation;
+    else
+        m_leastRecentlyUsed = allocation;
+    m_mostRecentlyUsed = allocation;
+}
+
+void ResidencyPolicy::Unlink(uint32_t allocation)
+{
+    Allocation& entry = m_allocations[allocation];
+    if (entry.m_previous != g_invalidResidencyAllocation)
+        m_allocations[entry.m_previous].m_next = entry.m_next;
+    else
+        m_leastRecentlyUsed = entry.m_next;
+
+    if (entry.m_next != g_invalidResidencyAllocation)
+        m_allocations[entry.m_next].m_previous = entry.m_previous;
+    else
+        m_mostRecentlyUsed = entry.m_previous;
+
+    entry.m_previous = g_invalidResidencyAllocation;
+    entry.m_next = g_invalidResidencyAllocation;
+}
+
+void ResidencyPolicy::AddResidentBytes(uint64_t sizeBytes)
+{
+    m_counters.m_residentBytes += sizeBytes;
+    m_counters.m_peakResidentBytes = std::max(m_counters.m_peakResidentBytes, m_counters.m_residentBytes);
+}
\ No newline at end of file
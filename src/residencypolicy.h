@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Residency decisions for the allocations of a sequence of jobs: before every job the allocations it uses are made
+// resident and, if the resident ones go over the memory budget, the least recently used ones are evicted. The gpu
+// side, src/residencymanager.h, applies the decisions with MakeResident and Evict against the budget of the adapter,
+// and the policy can be run against any budget, as a simulated one. It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+// Same than the d3d12 heap types of src/gpumemory.h. Only the default heap counts against the budget, it is the
+// one in video memory in discrete gpus, upload and readback allocations are counted but never evicted.
+enum class ResidencyHeapType
+{
+    Default,
+    Upload,
+    Readback,
+    Count
+};
+
+const uint32_t g_residencyHeapTypesCount = static_cast<uint32_t>(ResidencyHeapType::Count);
+const uint32_t g_invalidResidencyAllocation = UINT32_MAX;
+
+struct ResidencyCounters
+{
+    // Indexed by ResidencyHeapType, the bytes of the allocations tracked whether they are resident or not
+    uint64_t m_currentBytes[g_residencyHeapTypesCount];
+    uint64_t m_peakBytes[g_residencyHeapTypesCount];
+    // Default heap bytes resident, the ones counted against the budget
+    uint64_t m_residentBytes;
+    uint64_t m_peakResidentBytes;
+    uint64_t m_evictionsCount;
+    uint64_t m_evictedBytes;
+    uint64_t m_makeResidentsCount;
+    uint64_t m_madeResidentBytes;
+};
+
+// Residency changes to apply before a job, in this order
+struct ResidencyPlan
+{
+    std::vector<uint32_t> m_evict;
+    std::vector<uint32_t> m_makeResident;
+};
+
+// Allocations are created resident, as committed resources are, and identified by the index Track returns.
+// Note the allocations of a job are never evicted for it, if they dont fit in the budget together the plan goes
+// over it. Evictions come first in the plan so the memory is released before making the job allocations resident.
+class ResidencyPolicy
+{
+public:
+    ResidencyPolicy();
+
+    // Note the index of an untracked allocation can be returned by the next Track
+    uint32_t Track(uint64_t sizeBytes, ResidencyHeapType heapType);
+    void Untrack(uint32_t allocation);
+
+    // Adds the allocation to the next job
+    void Use(uint32_t allocation);
+    // Plans the changes for the allocations used since the previous plan to be resident and the resident ones to
+    // fit in budgetBytes, the policy takes them as applied. Starts the next job.
+    void PlanJob(uint64_t budgetBytes, ResidencyPlan& plan);
+
+    bool IsResident(uint32_t allocation) const { return m_allocations[allocation].m_isResident; }
+    uint64_t GetSizeBytes(uint32_t allocation) const { return m_allocations[allocation].m_sizeBytes; }
+    const ResidencyCounters& GetCounters() const { return m_counters; }
+
+private:
+    // Note resident default heap allocations are linked from the least to the most recently used
+    struct Allocation
+    {
+        uint64_t            m_sizeBytes;
+        ResidencyHeapType   m_heapType;
+        bool                m_isTracked;
+        bool                m_isResident;
+        uint64_t            m_lastJob;
+        uint32_t            m_previous;
+        uint32_t            m_next;
+    };
+
+    std::vector<Allocation> m_allocations;
+    std::vector<uint32_t>   m_freeAllocations;
+    uint32_t                m_leastRecentlyUsed;
+    uint32_t                m_mostRecentlyUsed;
+
+    // Note the job being recorded, the first one is 1 so 0 means never used
+    uint64_t                m_job;
+    std::vector<uint32_t>   m_jobAllocations;
+    ResidencyCounters       m_counters;
+
+    void Link(uint32_t allocation);
+    void Unlink(uint32_t allocation);
+    void AddResidentBytes(uint64_t sizeBytes);
+};
+
+}
\ No newline at end of file
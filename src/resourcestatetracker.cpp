@@ -0,0 +1,284 @@
+#include "resourcestatetracker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+using namespace ComputeBasics;
+
+namespace
+{
+// Note the state of a subresource not used yet in a cmd list. It depends on the cmd lists executed before.
+const ResourceState g_unknownState = static_cast<ResourceState>(-1);
+
+bool IsTransitionOf(const ResourceBarrier& barrier, uint32_t resource)
+{
+    return barrier.m_type == ResourceBarrierType::Transition && barrier.m_resource == resource;
+}
+
+ResourceBarrier CreateTransitionBarrier(uint32_t resource, uint32_t subresource, ResourceState before,
+                                        ResourceState after)
+{
+    return ResourceBarrier{ ResourceBarrierType::Transition, resource, subresource, before, after };
+}
+
+ResourceBarrier CreateUAVBarrier(uint32_t resource)
+{
+    return ResourceBarrier{ ResourceBarrierType::UAV, resource, g_allSubresources, ResourceState::UnorderedAccess,
+                            ResourceState::UnorderedAccess };
+}
+}
+
+ResourceState SubresourceStates::Get(uint32_t subresource) const
+{
+    if (m_subresourceStates.empty())
+        return m_state;
+
+    assert(subresource < m_subresourceStates.size());
+    return m_subresourceStates[subresource];
+}
+
+void SubresourceStates::Set(uint32_t subresource, ResourceState state)
+{
+    if (subresource == g_allSubresources)
+    {
+        m_state = state;
+        m_subresourceStates.clear();
+        return;
+    }
+
+    assert(subresource < m_subresourcesCount);
+    if (m_subresourceStates.empty())
+    {
+        if (m_state == state)
+            return;
+        m_subresourceStates.assign(m_subresourcesCount, m_state);
+    }
+    m_subresourceStates[subresource] = state;
+
+    // Note back to a single state once all the subresources agree
+    if (std::all_of(m_subresourceStates.begin(), m_subresourceStates.end(),
+                    [state](ResourceState s) { return s == state; }))
+    {
+        m_state = state;
+        m_subresourceStates.clear();
+    }
+}
+
+void ResourceStates::Register(uint32_t resource, ResourceState initialState, uint32_t subresourcesCount,
+                              bool decaysToCommon)
+{
+    assert(resource != g_allResources);
+    assert(subresourcesCount > 0);
+
+    Entry entry;
+    entry.m_states.m_state = initialState;
+    entry.m_states.m_subresourcesCount = subresourcesCount;
+    entry.m_decaysToCommon = decaysToCommon;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const bool inserted = m_entries.emplace(resource, entry).second;
+    assert(inserted);
+    (void)inserted;
+}
+
+void ResourceStates::Unregister(uint32_t resource)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const size_t erasedCount = m_entries.erase(resource);
+    assert(erasedCount == 1);
+    (void)erasedCount;
+}
+
+ResourceStateTracker::ResourceStateTracker(ResourceStates& resourceStates) : m_resourceStates(resourceStates)
+{
+}
+
+void ResourceStateTracker::Transition(uint32_t resource, ResourceState state, uint32_t subresource)
+{
+    assert(resource != g_allResources);
+    assert(state != g_unknownState);
+
+    SubresourceStates& states = FindOrAddStates(resource);
+    if (subresource == g_allSubresources && !states.m_subresourceStates.empty())
+    {
+        // Note the subresources are in different states, so each one needs its own transition
+        for (uint32_t i = 0; i < states.m_subresourcesCount; ++i)
+            TransitionSubresource(resource, i, states.m_subresourceStates[i], state);
+    }
+    else
+    {
+        TransitionSubresource(resource, subresource, states.Get(subresource), state);
+    }
+    states.Set(subresource, state);
+}
+
+void ResourceStateTracker::UAVBarrier(uint32_t resource)
+{
+    for (const auto& barrier : m_barriers)
+    {
+        // Note an already queued uav barrier covering the resource, or a transition of the whole resource,
+        // orders the accesses as well
+        if (barrier.m_type == ResourceBarrierType::UAV &&
+            (barrier.m_resource == g_allResources || barrier.m_resource == resource))
+            return;
+        if (resource != g_allResources && IsTransitionOf(barrier, resource) &&
+            barrier.m_subresource == g_allSubresources)
+            return;
+    }
+
+    if (resource == g_allResources)
+    {
+        m_barriers.erase(std::remove_if(m_barriers.begin(), m_barriers.end(), [](const ResourceBarrier& barrier)
+        {
+            return barrier.m_type == ResourceBarrierType::UAV;
+        }), m_barriers.end());
+    }
+    m_barriers.push_back(CreateUAVBarrier(resource));
+}
+
+bool ResourceStateTracker::FindState(uint32_t resource, uint32_t subresource, ResourceState& state) const
+{
+    auto it = m_states.find(resource);
+    if (it == m_states.end())
+        return false;
+
+    // Note a whole resource query only has a state when all the subresources agree
+    if (subresource == g_allSubresources && !it->second.m_subresourceStates.empty())
+        return false;
+
+    state = it->second.Get(subresource);
+    return state != g_unknownState;
+}
+
+void ResourceStateTracker::FlushBarriers(std::vector<ResourceBarrier>& barriers)
+{
+    barriers.insert(barriers.end(), m_barriers.begin(), m_barriers.end());
+    m_barriers.clear();
+}
+
+void ResourceStateTracker::ResolvePendingBarriers(bool isCopyCmdList, std::vector<ResourceBarrier>& barriers)
+{
+    assert(m_barriers.empty() && "Barriers not flushed before submitting");
+
+    // Note resolving and committing at once, so the next cmd list resolved sees the states this one leaves
+    std::lock_guard<std::mutex> lock(m_resourceStates.m_mutex);
+
+    for (const auto& pending : m_pendingTransitions)
+    {
+        auto entryIt = m_resourceStates.m_entries.find(pending.m_resource);
+        assert(entryIt != m_resourceStates.m_entries.end() && "Resource not registered");
+        const ResourceStates::Entry& entry = entryIt->second;
+        const SubresourceStates& committed = entry.m_states;
+
+        const auto addTransition = [&](uint32_t subresource, ResourceState before)
+        {
+            const bool isPromotion = entry.m_decaysToCommon && before == ResourceState::Common;
+            if (before != pending.m_state && !isPromotion)
+                barriers.push_back(CreateTransitionBarrier(pending.m_resource, subresource, before, pending.m_state));
+        };
+
+        if (pending.m_subresource == g_allSubresources && !committed.m_subresourceStates.empty())
+        {
+            for (uint32_t i = 0; i < committed.m_subresourcesCount; ++i)
+                addTransition(i, committed.m_subresourceStates[i]);
+        }
+        else
+        {
+            addTransition(pending.m_subresource, committed.Get(pending.m_subresource));
+        }
+    }
+
+    for (const auto& resourceStates : m_states)
+    {
+        ResourceStates::Entry& entry = m_resourceStates.m_entries.at(resourceStates.first);
+        const SubresourceStates& states = resourceStates.second;
+
+        if (isCopyCmdList || entry.m_decaysToCommon)
+        {
+            entry.m_states.Set(g_allSubresources, ResourceState::Common);
+        }
+        else if (states.m_subresourceStates.empty())
+        {
+            if (states.m_state != g_unknownState)
+                entry.m_states.Set(g_allSubresources, states.m_state);
+        }
+        else
+        {
+            // Note the subresources not used by the cmd list keep their states
+            for (uint32_t i = 0; i < states.m_subresourcesCount; ++i)
+            {
+                if (states.m_subresourceStates[i] != g_unknownState)
+                    entry.m_states.Set(i, states.m_subresourceStates[i]);
+            }
+        }
+    }
+}
+
+void ResourceStateTracker::Reset()
+{
+    m_states.clear();
+    m_pendingTransitions.clear();
+    m_barriers.clear();
+}
+
+SubresourceStates& ResourceStateTracker::FindOrAddStates(uint32_t resource)
+{
+    auto it = m_states.find(resource);
+    if (it != m_states.end())
+        return it->second;
+
+    uint32_t subresourcesCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_resourceStates.m_mutex);
+        auto entryIt = m_resourceStates.m_entries.find(resource);
+        assert(entryIt != m_resourceStates.m_entries.end() && "Resource not registered");
+        subresourcesCount = entryIt->second.m_states.m_subresourcesCount;
+    }
+
+    SubresourceStates states;
+    states.m_state = g_unknownState;
+    states.m_subresourcesCount = subresourcesCount;
+    return m_states.emplace(resource, states).first->second;
+}
+
+void ResourceStateTracker::TransitionSubresource(uint32_t resource, uint32_t subresource, ResourceState before,
+                                                 ResourceState after)
+{
+    if (before == g_unknownState)
+    {
+        m_pendingTransitions.push_back({ resource, subresource, after });
+        return;
+    }
+    if (before == after)
+        return;
+
+    // Note merging with the last queued transition of the same subresource, unless a transition of an
+    // overlapping range of subresources went in between
+    for (auto it = m_barriers.rbegin(); it != m_barriers.rend(); ++it)
+    {
+        if (!IsTransitionOf(*it, resource))
+            continue;
+
+        if (it->m_subresource == subresource)
+        {
+            it->m_after = after;
+            if (it->m_before == after)
+                m_barriers.erase(std::next(it).base());
+            return;
+        }
+        if (it->m_subresource == g_allSubresources || subresource == g_allSubresources)
+            break;
+    }
+
+    // Note a transition out of the uav state already orders the previous accesses
+    if (before == ResourceState::UnorderedAccess)
+    {
+        m_barriers.erase(std::remove_if(m_barriers.begin(), m_barriers.end(), [resource](const ResourceBarrier& barrier)
+        {
+            return barrier.m_type == ResourceBarrierType::UAV && barrier.m_resource == resource;
+        }), m_barriers.end());
+    }
+
+    m_barriers.push_back(CreateTransitionBarrier(resource, subresource, before, after));
+}
\ No newline at end of file
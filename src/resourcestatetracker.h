@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// State tracking of resources across cmd lists. Resources are ids given by the caller and their states a portable
+// enum, so the merging of transitions, the cancelling of the ones going back to the state before and the elision of
+// uav barriers can run on any platform. ToD3D12Barrier in src/cmdlists.h translates the barriers to d3d12 ones.
+// It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+// Mirror the d3d12 states of resources used by compute and copy queues
+enum class ResourceState
+{
+    Common,
+    CopySource,
+    CopyDest,
+    ShaderResource,
+    UnorderedAccess
+};
+
+// Same than D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES
+const uint32_t g_allSubresources = UINT32_MAX;
+// Note the resource of a uav barrier ordering the accesses to all the uavs
+const uint32_t g_allResources = UINT32_MAX;
+
+enum class ResourceBarrierType
+{
+    Transition,
+    UAV
+};
+
+struct ResourceBarrier
+{
+    ResourceBarrierType m_type;
+    uint32_t            m_resource;
+    uint32_t            m_subresource;
+    ResourceState       m_before;
+    ResourceState       m_after;
+};
+
+// States of a resource, either one state for all its subresources or one per subresource.
+// Note the per subresource states are only allocated once a subresource diverges from the rest
+struct SubresourceStates
+{
+    ResourceState               m_state;
+    std::vector<ResourceState>  m_subresourceStates;
+    uint32_t                    m_subresourcesCount;
+
+    ResourceState Get(uint32_t subresource) const;
+    void Set(uint32_t subresource, ResourceState state);
+};
+
+// States of the resources in between executions of cmd lists. It is shared by all the trackers.
+// Note buffers and resources used in a copy queue decay to common after every execution, so thats
+// the state committed for them.
+class ResourceStates
+{
+public:
+    // decaysToCommon is true for buffers and simultaneous access textures, which are implicitly promoted from common
+    // to any state by their first use in a cmd list
+    void Register(uint32_t resource, ResourceState initialState, uint32_t subresourcesCount, bool decaysToCommon);
+    void Unregister(uint32_t resource);
+
+private:
+    friend class ResourceStateTracker;
+
+    struct Entry
+    {
+        SubresourceStates   m_states;
+        bool                m_decaysToCommon;
+    };
+
+    std::mutex                                  m_mutex;
+    std::unordered_map<uint32_t, Entry>         m_entries;
+};
+
+// Tracks the states of the resources used by a single cmd list.
+// Transitions are deferred and batched up until FlushBarriers, which is meant to be called right before
+// every dispatch or copy, so there is a single ResourceBarrier call per dispatch boundary. Queued
+// transitions of the same subresource are merged, and uav barriers already covered by a queued barrier
+// are dropped.
+// The first state a resource needs in the cmd list can not be known while recording, as other cmd lists
+// may execute before. Those are kept as pending and resolved at submit time.
+class ResourceStateTracker
+{
+public:
+    ResourceStateTracker(ResourceStates& resourceStates);
+
+    void Transition(uint32_t resource, ResourceState state, uint32_t subresource = g_allSubresources);
+
+    // Note g_allResources orders the accesses to all the uavs
+    void UAVBarrier(uint32_t resource);
+
+    // State of the subresource at the current point of the cmd list. False if the cmd list didnt use it yet.
+    bool FindState(uint32_t resource, uint32_t subresource, ResourceState& state) const;
+
+    // Moves the queued barriers to the end of barriers
+    void FlushBarriers(std::vector<ResourceBarrier>& barriers);
+
+    // Adds to barriers the transitions from the committed states to the first states needed by the cmd list,
+    // and commits the states the cmd list leaves the resources in. Implicit promotions from common dont need a
+    // barrier.
+    // Note the barriers have to execute right before the cmd list, and the cmd lists in the order they were
+    // resolved.
+    void ResolvePendingBarriers(bool isCopyCmdList, std::vector<ResourceBarrier>& barriers);
+
+    // Forgets the recorded states, so the tracker can be used for a new cmd list
+    void Reset();
+
+private:
+    struct PendingTransition
+    {
+        uint32_t        m_resource;
+        uint32_t        m_subresource;
+        ResourceState   m_state;
+    };
+
+    ResourceStates& m_resourceStates;
+
+    // States at the current point of the cmd list
+    std::unordered_map<uint32_t, SubresourceStates> m_states;
+    std::vector<PendingTransition>                  m_pendingTransitions;
+    std::vector<ResourceBarrier>                    m_barriers;
+
+    SubresourceStates& FindOrAddStates(uint32_t resource);
+    void TransitionSubresource(uint32_t resource, uint32_t subresource, ResourceState before, ResourceState after);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "rootbinder.h"
+
+using namespace ComputeBasics;
+
+RootBinder::RootBinder() : m_rootSignature(nullptr), m_pso(nullptr), m_stats{}
+{
+}
+
+void RootBinder::Reset()
+{
+    m_rootSignature = nullptr;
+    m_pso = nullptr;
+    m_applied = BindingBlock();
+}
+
+void RootBinder::Apply(ID3D12GraphicsCommandList* cmdList, const PipelineState& pipelineState,
+                       const BindingBlock& bindings)
+{
+    assert(cmdList);
+    assert(pipelineState.m_rootSignature && pipelineState.m_pso);
+    assert(!pipelineState.m_bindingMap ||
+           pipelineState.m_bindingMap->GetLayout().size() == bindings.GetRootParametersCount());
+
+    uint64_t changedMask;
+    if (m_rootSignature != pipelineState.m_rootSignature.Get())
+    {
+        m_rootSignature = pipelineState.m_rootSignature.Get();
+        cmdList->SetComputeRootSignature(m_rootSignature);
+        m_applied = bindings;
+        changedMask = bindings.GetSetMask();
+    }
+    else
+    {
+        changedMask = bindings.GetChangedMask(m_applied);
+        m_applied.Update(bindings, changedMask);
+    }
+
+    if (m_pso != pipelineState.m_pso.Get())
+    {
+        m_pso = pipelineState.m_pso.Get();
+        cmdList->SetPipelineState(m_pso);
+    }
+
+    const uint64_t setMask = bindings.GetSetMask();
+    for (uint32_t rootParameter = 0; rootParameter < bindings.GetRootParametersCount(); ++rootParameter)
+    {
+        const uint64_t bit = 1ull << rootParameter;
+        if (!(setMask & bit))
+            continue;
+        if (!(changedMask & bit))
+        {
+            ++m_stats.m_skippedSetsCount;
+            continue;
+        }
+
+        switch (bindings.GetType(rootParameter))
+        {
+        case RootParameterType::DescriptorTable:
+            cmdList->SetComputeRootDescriptorTable(rootParameter,
+                                                   D3D12_GPU_DESCRIPTOR_HANDLE{ bindings.GetAddress(rootParameter) });
+            break;
+        case RootParameterType::Constants:
+            cmdList->SetComputeRoot32BitConstants(rootParameter, bindings.GetConstantsCount(rootParameter),
+                                                  bindings.GetConstants(rootParameter), 0);
+            break;
+        case RootParameterType::ConstantBufferView:
+            cmdList->SetComputeRootConstantBufferView(rootParameter, bindings.GetAddress(rootParameter));
+            break;
+        case RootParameterType::ShaderResourceView:
+            cmdList->SetComputeRootShaderResourceView(rootParameter, bindings.GetAddress(rootParameter));
+            break;
+        case RootParameterType::UnorderedAccessView:
+            cmdList->SetComputeRootUnorderedAccessView(rootParameter, bindings.GetAddress(rootParameter));
+            break;
+        }
+        ++m_stats.m_setsCount;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "common.h"
+
+#include "pipelinestate.h"
+#include "rootsignaturelayout.h"
+
+namespace ComputeBasics
+{
+
+struct RootBinderStats
+{
+    // Root parameters set in the cmd list
+    uint64_t    m_setsCount;
+    // Root parameters of the blocks left out, their values already set
+    uint64_t    m_skippedSetsCount;
+};
+
+// Applies binding blocks to a compute cmd list with the fewest calls. The root signature and the pso are set only
+// when they change and the root parameters only when their values differ from the ones already set, so
+// consecutive dispatches pay just for what changes between them. A new root signature sets all the parameters of
+// the block again, as it unbinds them.
+// Note the binder cant see what is recorded without it, Reset has to be called when the cmd list is reset, when its
+// descriptor heaps change, as the tables are lost then, or when the root signature or parameters are set directly.
+class RootBinder
+{
+public:
+    RootBinder();
+
+    void Reset();
+    // Note the block has to have the layout of the root signature of the pipeline state
+    void Apply(ID3D12GraphicsCommandList* cmdList, const PipelineState& pipelineState, const BindingBlock& bindings);
+
+    const RootBinderStats& GetStats() const { return m_stats; }
+
+private:
+    ID3D12RootSignature*    m_rootSignature;
+    ID3D12PipelineState*    m_pso;
+    // Values set in the cmd list, with no parameters until a root signature is set
+    BindingBlock            m_applied;
+    RootBinderStats         m_stats;
+};
+
+}
\ No newline at end of file
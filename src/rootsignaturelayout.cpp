@@ -0,0 +1,588 @@
+#include "rootsignaturelayout.h"
+
+#include <cassert>
+#include <cstring>
+
+using namespace ComputeBasics;
+
+namespace
+{
+    bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    bool IsIdentifierChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    std::string Trim(const std::string& str)
+    {
+        size_t first = 0;
+        size_t last = str.size();
+        while (first < last && IsSpace(str[first]))
+            ++first;
+        while (last > first && IsSpace(str[last - 1]))
+            --last;
+        return str.substr(first, last - first);
+    }
+
+    // Splits str at the commas out of parentheses. Returns false if the parentheses dont match.
+    bool SplitArguments(const std::string& str, std::vector<std::string>& arguments)
+    {
+        arguments.clear();
+        int depth = 0;
+        size_t argumentStart = 0;
+        for (size_t i = 0; i <= str.size(); ++i)
+        {
+            const char c = i < str.size() ? str[i] : ',';
+            if (c == '(')
+                ++depth;
+            else if (c == ')' && --depth < 0)
+                return false;
+            else if (c == ',' && depth == 0)
+            {
+                // Note skips the empty ones, as the one after a trailing comma
+                const std::string argument = Trim(str.substr(argumentStart, i - argumentStart));
+                if (!argument.empty())
+                    arguments.push_back(argument);
+                argumentStart = i + 1;
+            }
+        }
+        return depth == 0;
+    }
+
+    // Splits "Name( arguments )"
+    bool ParseCall(const std::string& str, std::string& name, std::string& arguments)
+    {
+        const size_t open = str.find('(');
+        const size_t close = str.rfind(')');
+        if (open == std::string::npos || close == std::string::npos || close < open || close != str.size() - 1)
+            return false;
+
+        name = Trim(str.substr(0, open));
+        arguments = str.substr(open + 1, close - open - 1);
+        return !name.empty();
+    }
+
+    // Splits "key = value"
+    bool ParseKeyValue(const std::string& str, std::string& key, std::string& value)
+    {
+        const size_t equal = str.find('=');
+        if (equal == std::string::npos)
+            return false;
+
+        key = Trim(str.substr(0, equal));
+        value = Trim(str.substr(equal + 1));
+        return true;
+    }
+
+    bool ParseUInt(const std::string& str, uint32_t& value)
+    {
+        if (str.empty() || str.size() > 9)
+            return false;
+
+        value = 0;
+        for (char c : str)
+        {
+            if (c < '0' || c > '9')
+                return false;
+            value = value * 10 + static_cast<uint32_t>(c - '0');
+        }
+        return true;
+    }
+
+    bool ParseRegisterType(char c, ShaderRegisterType& type)
+    {
+        switch (c)
+        {
+        case 'b': type = ShaderRegisterType::ConstantBuffer; return true;
+        case 't': type = ShaderRegisterType::ShaderResource; return true;
+        case 'u': type = ShaderRegisterType::UnorderedAccess; return true;
+        case 's': type = ShaderRegisterType::Sampler; return true;
+        default: return false;
+        }
+    }
+
+    // Parses "t0", "u12"...
+    bool ParseRegister(const std::string& str, ShaderRegisterType& type, uint32_t& shaderRegister)
+    {
+        return !str.empty() && ParseRegisterType(str[0], type) && ParseUInt(str.substr(1), shaderRegister);
+    }
+
+    // Register type of the CBV, SRV, UAV and Sampler parameters and ranges
+    bool ParseRangeType(const std::string& name, ShaderRegisterType& type)
+    {
+        if (name == "CBV")
+            type = ShaderRegisterType::ConstantBuffer;
+        else if (name == "SRV")
+            type = ShaderRegisterType::ShaderResource;
+        else if (name == "UAV")
+            type = ShaderRegisterType::UnorderedAccess;
+        else if (name == "Sampler")
+            type = ShaderRegisterType::Sampler;
+        else
+            return false;
+        return true;
+    }
+
+    // Parses the arguments of root constants, root descriptors and table ranges, as "u0, numDescriptors = 2".
+    // Note isAppended is set unless an explicit offset is given
+    bool ParseRegisterArguments(const std::string& arguments, ShaderRegisterType type, ShaderRegisterRange& range,
+                                uint32_t& constantsCount, bool& isAppended)
+    {
+        std::vector<std::string> items;
+        if (!SplitArguments(arguments, items))
+            return false;
+
+        range = { type, 0, 0, 1, 0 };
+        constantsCount = 0;
+        isAppended = true;
+        bool hasRegister = false;
+        for (const std::string& item : items)
+        {
+            std::string key;
+            std::string value;
+            if (!ParseKeyValue(item, key, value))
+            {
+                ShaderRegisterType registerType;
+                if (hasRegister || !ParseRegister(item, registerType, range.m_register) || registerType != type)
+                    return false;
+                hasRegister = true;
+            }
+            else if (key == "space")
+            {
+                if (!ParseUInt(value, range.m_space))
+                    return false;
+            }
+            else if (key == "numDescriptors")
+            {
+                if (value == "unbounded")
+                    range.m_count = g_unboundedRegistersCount;
+                else if (!ParseUInt(value, range.m_count) || range.m_count == 0)
+                    return false;
+            }
+            else if (key == "offset")
+            {
+                isAppended = value == "DESCRIPTOR_RANGE_OFFSET_APPEND";
+                if (!isAppended && !ParseUInt(value, range.m_offset))
+                    return false;
+            }
+            else if (key == "num32BitConstants")
+            {
+                if (!ParseUInt(value, constantsCount))
+                    return false;
+            }
+            // Note the visibility and the flags dont change the layout
+            else if (key != "visibility" && key != "flags")
+                return false;
+        }
+        return hasRegister;
+    }
+
+    bool ParseDescriptorTable(const std::string& arguments, std::vector<ShaderRegisterRange>& ranges)
+    {
+        std::vector<std::string> items;
+        if (!SplitArguments(arguments, items))
+            return false;
+
+        uint32_t nextOffset = 0;
+        for (const std::string& item : items)
+        {
+            std::string key;
+            std::string value;
+            if (ParseKeyValue(item, key, value) && item.find('(') == std::string::npos)
+            {
+                if (key != "visibility")
+                    return false;
+                continue;
+            }
+
+            std::string name;
+            std::string rangeArguments;
+            ShaderRegisterType type;
+            if (!ParseCall(item, name, rangeArguments) || !ParseRangeType(name, type))
+                return false;
+
+            ShaderRegisterRange range;
+            uint32_t constantsCount;
+            bool isAppended;
+            if (!ParseRegisterArguments(rangeArguments, type, range, constantsCount, isAppended) || constantsCount > 0)
+                return false;
+            if (isAppended)
+            {
+                // Note nothing can be appended after an unbounded range
+                if (nextOffset == g_unboundedRegistersCount)
+                    return false;
+                range.m_offset = nextOffset;
+            }
+            nextOffset = range.m_count == g_unboundedRegistersCount ? g_unboundedRegistersCount :
+                                                                       range.m_offset + range.m_count;
+            ranges.push_back(range);
+        }
+        return !ranges.empty();
+    }
+
+    // Replaces the comments with spaces, keeping the new lines and the string literals
+    std::string StripComments(const std::string& source)
+    {
+        std::string stripped = source;
+        size_t i = 0;
+        while (i < stripped.size())
+        {
+            if (stripped[i] == '"')
+            {
+                for (++i; i < stripped.size() && stripped[i] != '"'; ++i)
+                {
+                    if (stripped[i] == '\\')
+                        ++i;
+                }
+                ++i;
+            }
+            else if (stripped.compare(i, 2, "//") == 0)
+            {
+                for (; i < stripped.size() && stripped[i] != '\n'; ++i)
+                    stripped[i] = ' ';
+            }
+            else if (stripped.compare(i, 2, "/*") == 0)
+            {
+                const size_t end = stripped.find("*/", i + 2);
+                const size_t commentEnd = end == std::string::npos ? stripped.size() : end + 2;
+                for (; i < commentEnd; ++i)
+                {
+                    if (stripped[i] != '\n')
+                        stripped[i] = ' ';
+                }
+            }
+            else
+                ++i;
+        }
+        return stripped;
+    }
+
+    // Returns the end of the keyword at position, or npos if it is part of a longer identifier
+    size_t MatchKeyword(const std::string& source, size_t position, const char* keyword)
+    {
+        const size_t end = position + strlen(keyword);
+        if (source.compare(position, end - position, keyword) != 0)
+            return std::string::npos;
+        if ((position > 0 && IsIdentifierChar(source[position - 1])) ||
+            (end < source.size() && IsIdentifierChar(source[end])))
+            return std::string::npos;
+        return end;
+    }
+
+    // Parses the ": register(xN[, spaceM])" at the end of a declaration, backwards from the register keyword
+    // to find the name
+    bool ParseRegisterDeclaration(const std::string& source, size_t keywordStart, size_t keywordEnd,
+                                  ShaderBinding& binding)
+    {
+        size_t i = keywordStart;
+        while (i > 0 && IsSpace(source[i - 1]))
+            --i;
+        if (i == 0 || source[i - 1] != ':')
+            return false;
+        --i;
+        while (i > 0 && IsSpace(source[i - 1]))
+            --i;
+        // Note skips the size of arrays, as "g_textures[4]"
+        if (i > 0 && source[i - 1] == ']')
+        {
+            const size_t open = source.rfind('[', i - 1);
+            if (open == std::string::npos)
+                return false;
+            i = open;
+            while (i > 0 && IsSpace(source[i - 1]))
+                --i;
+        }
+        const size_t nameEnd = i;
+        while (i > 0 && IsIdentifierChar(source[i - 1]))
+            --i;
+        if (i == nameEnd)
+            return false;
+        binding.m_name = source.substr(i, nameEnd - i);
+
+        size_t open = keywordEnd;
+        while (open < source.size() && IsSpace(source[open]))
+            ++open;
+        const size_t close = source.find(')', open);
+        if (open == source.size() || source[open] != '(' || close == std::string::npos)
+            return false;
+
+        std::vector<std::string> arguments;
+        if (!SplitArguments(source.substr(open + 1, close - open - 1), arguments) || arguments.empty() ||
+            arguments.size() > 2 || !ParseRegister(arguments[0], binding.m_type, binding.m_register))
+            return false;
+
+        binding.m_space = 0;
+        if (arguments.size() == 2)
+        {
+            const std::string& space = arguments[1];
+            if (space.compare(0, 5, "space") != 0 || !ParseUInt(space.substr(5), binding.m_space))
+                return false;
+        }
+        return true;
+    }
+
+    bool FindSlot(const RootSignatureLayout& layout, const ShaderBinding& binding, RootBindingSlot& slot)
+    {
+        for (uint32_t parameter = 0; parameter < layout.size(); ++parameter)
+        {
+            for (const ShaderRegisterRange& range : layout[parameter].m_ranges)
+            {
+                if (range.m_type != binding.m_type || range.m_space != binding.m_space ||
+                    binding.m_register < range.m_register || binding.m_register - range.m_register >= range.m_count)
+                    continue;
+
+                slot.m_rootParameter = parameter;
+                slot.m_offset = range.m_offset + binding.m_register - range.m_register;
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+bool ComputeBasics::ParseRootSignature(const std::string& rootSignature, RootSignatureLayout& layout)
+{
+    layout.clear();
+
+    std::vector<std::string> items;
+    if (!SplitArguments(rootSignature, items))
+        return false;
+
+    for (const std::string& item : items)
+    {
+        std::string name;
+        std::string arguments;
+        if (!ParseCall(item, name, arguments))
+            return false;
+        if (name == "RootFlags" || name == "StaticSampler")
+            continue;
+
+        RootParameterLayout parameter;
+        parameter.m_constantsCount = 0;
+        ShaderRegisterRange range;
+        uint32_t constantsCount;
+        bool isAppended;
+        if (name == "DescriptorTable")
+        {
+            parameter.m_type = RootParameterType::DescriptorTable;
+            if (!ParseDescriptorTable(arguments, parameter.m_ranges))
+                return false;
+        }
+        else if (name == "RootConstants")
+        {
+            parameter.m_type = RootParameterType::Constants;
+            if (!ParseRegisterArguments(arguments, ShaderRegisterType::ConstantBuffer, range, constantsCount,
+                                        isAppended) || constantsCount == 0)
+                return false;
+            parameter.m_constantsCount = constantsCount;
+            parameter.m_ranges.push_back(range);
+        }
+        else
+        {
+            ShaderRegisterType type;
+            if (!ParseRangeType(name, type) || type == ShaderRegisterType::Sampler ||
+                !ParseRegisterArguments(arguments, type, range, constantsCount, isAppended) || constantsCount > 0)
+                return false;
+
+            parameter.m_type = type == ShaderRegisterType::ConstantBuffer ? RootParameterType::ConstantBufferView :
+                               type == ShaderRegisterType::ShaderResource ? RootParameterType::ShaderResourceView :
+                                                                            RootParameterType::UnorderedAccessView;
+            // Note a root descriptor is always a single register
+            range.m_count = 1;
+            parameter.m_ranges.push_back(range);
+        }
+        layout.push_back(parameter);
+    }
+
+    return layout.size() <= g_maxRootParametersCount;
+}
+
+std::string ComputeBasics::FindRootSignature(const std::string& source, const char* rootSignatureMacro)
+{
+    assert(rootSignatureMacro);
+
+    const std::string src = StripComments(source);
+    for (size_t position = src.find("#define"); position != std::string::npos;
+         position = src.find("#define", position + 1))
+    {
+        size_t nameStart = position + strlen("#define");
+        while (nameStart < src.size() && (src[nameStart] == ' ' || src[nameStart] == '\t'))
+            ++nameStart;
+        const size_t nameEnd = MatchKeyword(src, nameStart, rootSignatureMacro);
+        if (nameEnd == std::string::npos)
+            continue;
+
+        // Concatenates the literals up to the first new line not escaped by a backslash
+        std::string rootSignature;
+        for (size_t i = nameEnd; i < src.size() && src[i] != '\n'; ++i)
+        {
+            if (src[i] == '\\')
+            {
+                while (i + 1 < src.size() && src[i + 1] != '\n')
+                    ++i;
+                ++i;
+            }
+            else if (src[i] == '"')
+            {
+                for (++i; i < src.size() && src[i] != '"'; ++i)
+                {
+                    if (src[i] == '\\' && i + 1 < src.size())
+                        ++i;
+                    rootSignature += src[i];
+                }
+            }
+        }
+        return rootSignature;
+    }
+    return std::string();
+}
+
+std::vector<ShaderBinding> ComputeBasics::ParseShaderBindings(const std::string& source)
+{
+    const std::string src = StripComments(source);
+
+    std::vector<ShaderBinding> bindings;
+    for (size_t position = src.find("register"); position != std::string::npos;
+         position = src.find("register", position + 1))
+    {
+        const size_t keywordEnd = MatchKeyword(src, position, "register");
+        ShaderBinding binding;
+        if (keywordEnd == std::string::npos || !ParseRegisterDeclaration(src, position, keywordEnd, binding))
+            continue;
+
+        bool isFound = false;
+        for (const ShaderBinding& previousBinding : bindings)
+            isFound = isFound || previousBinding.m_name == binding.m_name;
+        if (!isFound)
+            bindings.push_back(binding);
+    }
+    return bindings;
+}
+
+RootBindingMap::RootBindingMap(const RootSignatureLayout& layout, const std::vector<ShaderBinding>& bindings) :
+    m_layout(layout)
+{
+    for (const ShaderBinding& binding : bindings)
+    {
+        RootBindingSlot slot;
+        if (FindSlot(m_layout, binding, slot))
+            m_slots.emplace(binding.m_name, slot);
+    }
+}
+
+bool RootBindingMap::Find(const std::string& name, RootBindingSlot& slot) const
+{
+    const auto it = m_slots.find(name);
+    if (it == m_slots.end())
+        return false;
+
+    slot = it->second;
+    return true;
+}
+
+uint32_t RootBindingMap::GetRootParameter(const std::string& name) const
+{
+    RootBindingSlot slot;
+    return Find(name, slot) ? slot.m_rootParameter : g_invalidRootParameter;
+}
+
+BindingBlock::BindingBlock(const RootSignatureLayout& layout) : m_setMask(0)
+{
+    assert(layout.size() <= g_maxRootParametersCount);
+
+    m_parameters.reserve(layout.size());
+    uint32_t valuesCount = 0;
+    for (const RootParameterLayout& parameter : layout)
+    {
+        // Note addresses and descriptor handles take two values
+        const uint32_t parameterValuesCount = parameter.m_type == RootParameterType::Constants ?
+                                              parameter.m_constantsCount : 2;
+        m_parameters.push_back({ parameter.m_type, valuesCount, parameterValuesCount });
+        valuesCount += parameterValuesCount;
+    }
+    m_values.assign(valuesCount, 0);
+}
+
+void BindingBlock::SetAddress(uint32_t rootParameter, uint64_t address)
+{
+    assert(rootParameter < m_parameters.size());
+    assert(m_parameters[rootParameter].m_type != RootParameterType::Constants);
+
+    memcpy(&m_values[m_parameters[rootParameter].m_firstValue], &address, sizeof(address));
+    m_setMask |= 1ull << rootParameter;
+}
+
+uint64_t BindingBlock::GetAddress(uint32_t rootParameter) const
+{
+    assert(rootParameter < m_parameters.size());
+    assert(m_parameters[rootParameter].m_type != RootParameterType::Constants);
+
+    uint64_t address;
+    memcpy(&address, &m_values[m_parameters[rootParameter].m_firstValue], sizeof(address));
+    return address;
+}
+
+void BindingBlock::SetConstants(uint32_t rootParameter, const void* constants, uint32_t constantsCount,
+                                uint32_t firstConstant)
+{
+    assert(rootParameter < m_parameters.size());
+    assert(constants);
+
+    const Parameter& parameter = m_parameters[rootParameter];
+    assert(parameter.m_type == RootParameterType::Constants);
+    assert(firstConstant + constantsCount <= parameter.m_valuesCount);
+
+    memcpy(&m_values[parameter.m_firstValue + firstConstant], constants, constantsCount * sizeof(uint32_t));
+    m_setMask |= 1ull << rootParameter;
+}
+
+const uint32_t* BindingBlock::GetConstants(uint32_t rootParameter) const
+{
+    assert(rootParameter < m_parameters.size());
+    assert(m_parameters[rootParameter].m_type == RootParameterType::Constants);
+
+    return &m_values[m_parameters[rootParameter].m_firstValue];
+}
+
+uint64_t BindingBlock::GetChangedMask(const BindingBlock& applied) const
+{
+    assert(applied.m_parameters.size() == m_parameters.size());
+    assert(applied.m_values.size() == m_values.size());
+
+    uint64_t changedMask = 0;
+    for (uint32_t rootParameter = 0; rootParameter < m_parameters.size(); ++rootParameter)
+    {
+        const uint64_t bit = 1ull << rootParameter;
+        if (!(m_setMask & bit))
+            continue;
+
+        const Parameter& parameter = m_parameters[rootParameter];
+        if (!(applied.m_setMask & bit) ||
+            memcmp(&m_values[parameter.m_firstValue], &applied.m_values[parameter.m_firstValue],
+                   parameter.m_valuesCount * sizeof(uint32_t)) != 0)
+            changedMask |= bit;
+    }
+    return changedMask;
+}
+
+void BindingBlock::Update(const BindingBlock& block, uint64_t mask)
+{
+    assert(block.m_parameters.size() == m_parameters.size());
+    assert(block.m_values.size() == m_values.size());
+
+    mask &= block.m_setMask;
+    for (uint32_t rootParameter = 0; rootParameter < m_parameters.size(); ++rootParameter)
+    {
+        if (!(mask & (1ull << rootParameter)))
+            continue;
+
+        const Parameter& parameter = m_parameters[rootParameter];
+        memcpy(&m_values[parameter.m_firstValue], &block.m_values[parameter.m_firstValue],
+               parameter.m_valuesCount * sizeof(uint32_t));
+    }
+    m_setMask |= mask;
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Root parameters of a root signature and the shader bindings they feed, so dispatches bind buffers by name
+// instead of by root parameter index. The layout is parsed from the root signature strings of the shaders, as the
+// XxxRootSig macros in data/shaders, and the bindings are reflected from the compiled shader (see
+// src/pipelinestate.cpp) or parsed from its source. It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+// Note a root signature takes 64 DWORDs at most, so it cant have more parameters than that
+const uint32_t g_maxRootParametersCount = 64;
+const uint32_t g_unboundedRegistersCount = UINT32_MAX;
+const uint32_t g_invalidRootParameter = UINT32_MAX;
+
+enum class ShaderRegisterType
+{
+    ConstantBuffer,     // b
+    ShaderResource,     // t
+    UnorderedAccess,    // u
+    Sampler             // s
+};
+
+enum class RootParameterType
+{
+    DescriptorTable,
+    Constants,
+    ConstantBufferView,
+    ShaderResourceView,
+    UnorderedAccessView
+};
+
+struct ShaderRegisterRange
+{
+    ShaderRegisterType  m_type;
+    uint32_t            m_register;
+    uint32_t            m_space;
+    // g_unboundedRegistersCount for unbounded ranges
+    uint32_t            m_count;
+    // Descriptors from the start of the table, 0 out of tables
+    uint32_t            m_offset;
+};
+
+struct RootParameterLayout
+{
+    RootParameterType                   m_type;
+    // The ranges of a table, a single register for the rest
+    std::vector<ShaderRegisterRange>    m_ranges;
+    // Only for root constants
+    uint32_t                            m_constantsCount;
+};
+
+using RootSignatureLayout = std::vector<RootParameterLayout>;
+
+// Parses a root signature string as the ones compiled with the rootsig_1_1 target. The flags and the static
+// samplers are ignored, they arent root parameters. Returns false if the string is malformed.
+bool ParseRootSignature(const std::string& rootSignature, RootSignatureLayout& layout);
+
+// Returns the string the rootSignatureMacro #define of a shader source expands to, the concatenation of its string
+// literals, or an empty string if the source doesnt define it.
+// Note the macro has to be defined in the source itself, not in an included file
+std::string FindRootSignature(const std::string& source, const char* rootSignatureMacro);
+
+struct ShaderBinding
+{
+    std::string         m_name;
+    ShaderRegisterType  m_type;
+    uint32_t            m_register;
+    uint32_t            m_space;
+};
+
+// Returns the resources and cbuffers of a shader source declared with an explicit register, as
+// "Buffer<float> g_input : register(t0);" or "cbuffer Constants : register(b0)".
+// Note the source isnt preprocessed, so declarations in all the branches of an #if are found. Only the first one of
+// a name is kept.
+std::vector<ShaderBinding> ParseShaderBindings(const std::string& source);
+
+struct RootBindingSlot
+{
+    uint32_t m_rootParameter;
+    // Descriptors from the start of the table, 0 out of tables
+    uint32_t m_offset;
+};
+
+// Name to root parameter map of a pipeline state, built once when it is created
+class RootBindingMap
+{
+public:
+    // Note the bindings out of the root parameters of the layout are left out
+    RootBindingMap(const RootSignatureLayout& layout, const std::vector<ShaderBinding>& bindings);
+
+    const RootSignatureLayout& GetLayout() const { return m_layout; }
+
+    bool Find(const std::string& name, RootBindingSlot& slot) const;
+    // Returns g_invalidRootParameter if the name isnt bound
+    uint32_t GetRootParameter(const std::string& name) const;
+
+private:
+    RootSignatureLayout                                 m_layout;
+    std::unordered_map<std::string, RootBindingSlot>    m_slots;
+};
+
+// Values of the root parameters of a dispatch, packed in a single array of 32 bits values. Descriptor tables and
+// root descriptors take 64 bits, the gpu descriptor handle of the table start or the gpu virtual address of the
+// buffer. Root constants take their 32 bits values.
+// Note parameters are only applied once set, then they stay bound until set again
+class BindingBlock
+{
+public:
+    BindingBlock() : m_setMask(0) {}
+    explicit BindingBlock(const RootSignatureLayout& layout);
+
+    uint32_t GetRootParametersCount() const { return static_cast<uint32_t>(m_parameters.size()); }
+    RootParameterType GetType(uint32_t rootParameter) const { return m_parameters[rootParameter].m_type; }
+
+    // For descriptor tables and root descriptors
+    void SetAddress(uint32_t rootParameter, uint64_t address);
+    uint64_t GetAddress(uint32_t rootParameter) const;
+
+    // For root constants. Note the constants not written keep their previous values, zero at first.
+    void SetConstants(uint32_t rootParameter, const void* constants, uint32_t constantsCount,
+                      uint32_t firstConstant = 0);
+    const uint32_t* GetConstants(uint32_t rootParameter) const;
+    uint32_t GetConstantsCount(uint32_t rootParameter) const { return m_parameters[rootParameter].m_valuesCount; }
+
+    // Bit i is set if root parameter i is
+    uint64_t GetSetMask() const { return m_setMask; }
+    // Mask of the parameters set whose values differ from the ones of applied, or that applied doesnt set.
+    // Note applied has to have the same layout.
+    uint64_t GetChangedMask(const BindingBlock& applied) const;
+    // Copies the values of the parameters of mask from block, same layout too
+    void Update(const BindingBlock& block, uint64_t mask);
+
+private:
+    struct Parameter
+    {
+        RootParameterType   m_type;
+        uint32_t            m_firstValue;
+        uint32_t            m_valuesCount;
+    };
+
+    std::vector<Parameter>  m_parameters;
+    std::vector<uint32_t>   m_values;
+    uint64_t                m_setMask;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "sgemm.h"
+
+#include <string>
+
+#include "utils.h"
+#include "cmdlists.h"
+
+namespace
+{
+const wchar_t* g_sgemmShaderFileName    = L"./data/shaders/sgemm.hlsl";
+const char* g_sgemmRootSignatureName    = "SgemmRootSig";
+const uint32_t g_sgemmDescriptorsCount  = 3;
+const uint32_t g_sgemmMaxThreadsCount   = D3D12_CS_THREAD_GROUP_MAX_THREADS_PER_GROUP;
+const uint32_t g_sgemmMaxGroupsCount    = D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION;
+// Note in bytes
+const uint32_t g_sgemmMaxGroupSharedSize = D3D12_CS_TGSM_REGISTER_COUNT * sizeof(uint32_t);
+
+// Root parameters as laid out in SgemmRootSig
+enum SgemmRootParameters
+{
+    SgemmRootParameters_Constants = 0,
+    SgemmRootParameters_Table
+};
+
+struct SgemmConstants
+{
+    uint32_t    m_m;
+    uint32_t    m_n;
+    uint32_t    m_k;
+    float       m_alpha;
+    float       m_beta;
+};
+
+bool IsValidTileDesc(const ComputeBasics::SgemmTileDesc& desc)
+{
+    if (desc.m_threadM == 0 || desc.m_threadN == 0 || desc.m_tileK == 0 ||
+        desc.m_tileM % desc.m_threadM != 0 || desc.m_tileN % desc.m_threadN != 0)
+        return false;
+
+    const uint32_t threadsCount = (desc.m_tileM / desc.m_threadM) * (desc.m_tileN / desc.m_threadN);
+    const uint32_t groupSharedSize = (desc.m_tileM + desc.m_tileN) * desc.m_tileK * sizeof(float);
+    return threadsCount > 0 && threadsCount <= g_sgemmMaxThreadsCount && groupSharedSize <= g_sgemmMaxGroupSharedSize;
+}
+
+uint32_t DivideRoundingUp(uint32_t value, uint32_t divisor)
+{
+    return (value + divisor - 1) / divisor;
+}
+}
+
+using namespace ComputeBasics;
+
+Sgemm::Sgemm(ID3D12Device* device, const SgemmTileDesc& tileDesc) : m_device(device), m_tileDesc(tileDesc)
+{
+    assert(m_device);
+    assert(IsValidTileDesc(m_tileDesc));
+
+    // Note the float4 loads need the tiles to be made of whole float4s
+    const bool supportsVectorLoads = m_tileDesc.m_tileK % 4 == 0 && m_tileDesc.m_tileN % 4 == 0;
+    for (uint32_t loads = 0; loads < SgemmLoads_Count; ++loads)
+    {
+        if (loads == SgemmLoads_Vector && !supportsVectorLoads)
+            continue;
+
+        const ShaderDefines defines
+        {
+            { "SGEMM_TILE_M", std::to_string(m_tileDesc.m_tileM) },
+            { "SGEMM_TILE_N", std::to_string(m_tileDesc.m_tileN) },
+            { "SGEMM_TILE_K", std::to_string(m_tileDesc.m_tileK) },
+            { "SGEMM_THREAD_M", std::to_string(m_tileDesc.m_threadM) },
+            { "SGEMM_THREAD_N", std::to_string(m_tileDesc.m_threadN) },
+            { "SGEMM_VECTOR_LOADS", std::to_string(loads) }
+        };
+        m_pipelineStates[loads] = CreatePipelineState(m_device, g_sgemmShaderFileName, g_sgemmRootSignatureName, defines,
+                                                      L"Sgemm " + std::to_wstring(m_tileDesc.m_tileM) + L"x" +
+                                                      std::to_wstring(m_tileDesc.m_tileN) + L" Loads " +
+                                                      std::to_wstring(loads));
+    }
+}
+
+bool Sgemm::IsValid() const
+{
+    return m_pipelineStates[SgemmLoads_Scalar].m_pso != nullptr;
+}
+
+DescriptorHeapPtr Sgemm::EnqueueSgemm(ID3D12GraphicsCommandList* computeCmdList, uint32_t m, uint32_t n, uint32_t k,
+                                      float alpha, const GpuMemAllocation& a, const GpuMemAllocation& b, float beta,
+                                      const GpuMemAllocation& c)
+{
+    assert(IsValid());
+    assert(computeCmdList);
+    assert(a.m_resource);
+    assert(b.m_resource);
+    assert(c.m_resource);
+    assert(m > 0 && n > 0 && k > 0);
+
+    const uint32_t groupsCountX = DivideRoundingUp(n, m_tileDesc.m_tileN);
+    const uint32_t groupsCountY = DivideRoundingUp(m, m_tileDesc.m_tileM);
+    assert(groupsCountX <= g_sgemmMaxGroupsCount && groupsCountY <= g_sgemmMaxGroupsCount);
+
+    const bool useVectorLoads = m_pipelineStates[SgemmLoads_Vector].m_pso && k % 4 == 0 && n % 4 == 0;
+    const DXGI_FORMAT format = useVectorLoads ? DXGI_FORMAT_R32G32B32A32_FLOAT : DXGI_FORMAT_R32_FLOAT;
+    const uint32_t componentsCount = useVectorLoads ? 4 : 1;
+
+    auto descriptorHeap = std::make_unique<DescriptorHeap>(m_device, g_sgemmDescriptorsCount);
+    auto table = descriptorHeap->CreateBufferDescriptor(a, format, m * k / componentsCount, false);
+    descriptorHeap->CreateBufferDescriptor(b, format, k * n / componentsCount, false);
+    descriptorHeap->CreateBufferDescriptor(c, DXGI_FORMAT_R32_FLOAT, m * n, true);
+
+    ID3D12DescriptorHeap* d3d12DescriptorHeaps[] = { descriptorHeap->GetD3D12DescriptorHeap() };
+    computeCmdList->SetDescriptorHeaps(1, d3d12DescriptorHeaps);
+
+    const auto& pipelineState = m_pipelineStates[useVectorLoads ? SgemmLoads_Vector : SgemmLoads_Scalar];
+    computeCmdList->SetComputeRootSignature(pipelineState.m_rootSignature.Get());
+    computeCmdList->SetPipelineState(pipelineState.m_pso.Get());
+
+    const SgemmConstants constants = { m, n, k, alpha, beta };
+    computeCmdList->SetComputeRoot32BitConstants(SgemmRootParameters_Constants, sizeof(constants) / sizeof(uint32_t),
+                                                 &constants, 0);
+    computeCmdList->SetComputeRootDescriptorTable(SgemmRootParameters_Table, table.m_gpuHandle);
+    computeCmdList->Dispatch(groupsCountX, groupsCountY, 1);
+
+    return descriptorHeap;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "common.h"
+
+#include "gpumemory.h"
+#include "descriptors.h"
+#include "pipelinestate.h"
+#include "cpusgemm.h"
+
+namespace ComputeBasics
+{
+
+// Tiling of data/shaders/sgemm.hlsl. Every group computes a m_tileM x m_tileN tile of c stepping m_tileK along k
+// and every thread a m_threadM x m_threadN block of it, so groups have
+// (m_tileM / m_threadM) * (m_tileN / m_threadN) threads.
+struct SgemmTileDesc
+{
+    uint32_t m_tileM;
+    uint32_t m_tileN;
+    uint32_t m_tileK;
+    uint32_t m_threadM;
+    uint32_t m_threadN;
+};
+
+// Single precision matrix multiply on the gpu using data/shaders/sgemm.hlsl
+class Sgemm
+{
+public:
+    Sgemm(ID3D12Device* device, const SgemmTileDesc& tileDesc);
+
+    bool IsValid() const;
+    const SgemmTileDesc& GetTileDesc() const { return m_tileDesc; }
+
+    // c = alpha * a * b + beta * c with row major matrices, a is m x k, b is k x n and c is m x n.
+    // Same than Cpu::Sgemm. With k and n multiples of 4 a and b are loaded as float4.
+    // a and b have to be in NON_PIXEL_SHADER_RESOURCE state and c in UNORDERED_ACCESS state.
+    // They are left as they are.
+    // Note the descriptor heaps of the cmd list are replaced.
+    // Note returning the descriptor heap so it outlives the execution in the gpu
+    DescriptorHeapPtr EnqueueSgemm(ID3D12GraphicsCommandList* computeCmdList, uint32_t m, uint32_t n, uint32_t k,
+                                   float alpha, const GpuMemAllocation& a, const GpuMemAllocation& b, float beta,
+                                   const GpuMemAllocation& c);
+
+private:
+    enum SgemmLoads
+    {
+        SgemmLoads_Scalar = 0,
+        SgemmLoads_Vector,
+        SgemmLoads_Count
+    };
+
+    ID3D12Device*   m_device;
+    SgemmTileDesc   m_tileDesc;
+    PipelineState   m_pipelineStates[SgemmLoads_Count];
+};
+
+}
@@ -0,0 +1,123 @@
+#include "texturelayout.h"
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define TEXTURELAYOUT_SSE2 ( 1 )
+#include <emmintrin.h>
+#else
+#define TEXTURELAYOUT_SSE2 ( 0 )
+#endif
+
+namespace
+{
+    const uint8_t* SrcRow(const ComputeBasics::SubresourceData& src, uint32_t slice, uint32_t row)
+    {
+        return static_cast<const uint8_t*>(src.m_data) + slice * src.m_slicePitch + row * src.m_rowPitch;
+    }
+}
+
+uint32_t ComputeBasics::CalculateMipsCount(uint64_t width, uint32_t height, uint32_t depth)
+{
+    uint64_t maxDimension = std::max<uint64_t>(width, std::max(height, depth));
+    assert(maxDimension > 0);
+
+    uint32_t mipsCount = 1;
+    while (maxDimension > 1)
+    {
+        maxDimension >>= 1;
+        ++mipsCount;
+    }
+
+    return mipsCount;
+}
+
+void ComputeBasics::PackSubresource(void* dst, const SubresourceFootprint& footprint, const SubresourceData& src)
+{
+    assert(dst);
+    assert(src.m_data);
+    assert(src.m_rowPitch >= footprint.m_rowSizeBytes);
+
+    uint8_t* dstSubresource = static_cast<uint8_t*>(dst) + footprint.m_offset;
+    const uint64_t dstSlicePitch = static_cast<uint64_t>(footprint.m_rowPitch) * footprint.m_rowsCount;
+    for (uint32_t slice = 0; slice < footprint.m_depth; ++slice)
+    {
+        uint8_t* dstSlice = dstSubresource + slice * dstSlicePitch;
+        for (uint32_t row = 0; row < footprint.m_rowsCount; ++row)
+        {
+            CopyRowStreaming(dstSlice + row * footprint.m_rowPitch, SrcRow(src, slice, row),
+                             static_cast<size_t>(footprint.m_rowSizeBytes));
+        }
+    }
+}
+
+void ComputeBasics::PackSubresources(void* dst, const SubresourceFootprint* footprints, const SubresourceData* srcs,
+                                     uint32_t subresourcesCount)
+{
+    assert(dst);
+    assert(footprints);
+    assert(srcs);
+
+    for (uint32_t i = 0; i < subresourcesCount; ++i)
+        PackSubresource(dst, footprints[i], srcs[i]);
+
+    FlushStreamingStores();
+}
+
+void ComputeBasics::CopyRowStreaming(void* dst, const void* src, size_t sizeBytes)
+{
+    assert(dst);
+    assert(src);
+
+#if TEXTURELAYOUT_SSE2
+    uint8_t* dstBytes = static_cast<uint8_t*>(dst);
+    const uint8_t* srcBytes = static_cast<const uint8_t*>(src);
+
+    // Head until dst is 16 bytes aligned. Rows start at 256 bytes aligned pitches so
+    // this is usually empty.
+    const size_t misalignment = reinterpret_cast<uintptr_t>(dstBytes) & 15;
+    const size_t headBytes = std::min(sizeBytes, misalignment ? 16 - misalignment : 0);
+    memcpy(dstBytes, srcBytes, headBytes);
+    dstBytes += headBytes;
+    srcBytes += headBytes;
+    sizeBytes -= headBytes;
+
+    // 64 bytes per iteration so a full write combining buffer is filled at once
+    while (sizeBytes >= 64)
+    {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes + 16));
+        const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes + 32));
+        const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes), v0);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes + 16), v1);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes + 32), v2);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes + 48), v3);
+        dstBytes += 64;
+        srcBytes += 64;
+        sizeBytes -= 64;
+    }
+
+    while (sizeBytes >= 16)
+    {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes)));
+        dstBytes += 16;
+        srcBytes += 16;
+        sizeBytes -= 16;
+    }
+
+    memcpy(dstBytes, srcBytes, sizeBytes);
+#else
+    memcpy(dst, src, sizeBytes);
+#endif
+}
+
+void ComputeBasics::FlushStreamingStores()
+{
+#if TEXTURELAYOUT_SSE2
+    _mm_sfence();
+#endif
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Note this file doesnt depend on d3d12 on purpose. The footprints come from
+// GetCopyableFootprints through ToSubresourceFootprint, so the packing code
+// can be exercised on any platform.
+namespace ComputeBasics
+{
+
+// Placement of a subresource inside a linear (upload or readback) buffer
+struct SubresourceFootprint
+{
+    uint64_t m_offset;
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_depth;
+    uint32_t m_rowPitch;
+    uint32_t m_rowsCount;
+    uint64_t m_rowSizeBytes;
+};
+
+// Tightly or loosely packed texel data of a subresource as the application has it
+struct SubresourceData
+{
+    const void* m_data;
+    uint64_t    m_rowPitch;
+    uint64_t    m_slicePitch;
+};
+
+uint32_t CalculateMipsCount(uint64_t width, uint32_t height, uint32_t depth);
+
+// Copies the rows of src into dst following the footprint pitches. dst is the beginning of the
+// linear buffer, the footprint offset is applied inside.
+void PackSubresource(void* dst, const SubresourceFootprint& footprint, const SubresourceData& src);
+
+// Packs all the subresources in one go. Meant to be used to write into an upload heap.
+void PackSubresources(void* dst, const SubresourceFootprint* footprints, const SubresourceData* srcs,
+                      uint32_t subresourcesCount);
+
+// Row copy using non temporal stores when available. Upload heaps are write combined memory
+// so streaming the writes avoids reading back the destination cache lines.
+// Note the caller is responsible of issuing a store fence (FlushStreamingStores) once done.
+void CopyRowStreaming(void* dst, const void* src, size_t sizeBytes);
+
+void FlushStreamingStores();
+
+}
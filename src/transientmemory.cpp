@@ -0,0 +1,87 @@
+#include "transientmemory.h"
+
+#include <cassert>
+#include <algorithm>
+#include <numeric>
+
+using namespace ComputeBasics;
+
+namespace
+{
+struct Range
+{
+    uint64_t m_begin;
+    uint64_t m_end;
+};
+
+uint64_t AlignSize(uint64_t sizeBytes, uint64_t alignment)
+{
+    return (sizeBytes + alignment - 1) & ~(alignment - 1);
+}
+}
+
+TransientMemoryLayout ComputeBasics::PackTransientBuffers(const std::vector<uint64_t>& sizesBytes,
+                                                          const std::function<bool(uint32_t, uint32_t)>& areAliveTogether,
+                                                          uint64_t alignment)
+{
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    const uint32_t buffersCount = static_cast<uint32_t>(sizesBytes.size());
+
+    // Note the biggest buffers first, the small ones fill the gaps left in between
+    std::vector<uint32_t> order(buffersCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sizesBytes](uint32_t a, uint32_t b)
+    {
+        return sizesBytes[a] > sizesBytes[b];
+    });
+
+    TransientMemoryLayout layout;
+    layout.m_offsets.assign(buffersCount, 0);
+    layout.m_sizeBytes = 0;
+    layout.m_unaliasedSizeBytes = 0;
+
+    std::vector<Range> conflicts;
+    for (uint32_t i = 0; i < buffersCount; ++i)
+    {
+        const uint32_t buffer = order[i];
+        const uint64_t sizeBytes = AlignSize(sizesBytes[buffer], alignment);
+
+        conflicts.clear();
+        for (uint32_t j = 0; j < i; ++j)
+        {
+            const uint32_t placedBuffer = order[j];
+            if (areAliveTogether(buffer, placedBuffer))
+            {
+                const uint64_t begin = layout.m_offsets[placedBuffer];
+                conflicts.push_back(Range{ begin, begin + AlignSize(sizesBytes[placedBuffer], alignment) });
+            }
+        }
+        std::sort(conflicts.begin(), conflicts.end(), [](const Range& a, const Range& b)
+        {
+            return a.m_begin < b.m_begin;
+        });
+
+        uint64_t offset = 0;
+        for (const auto& conflict : conflicts)
+        {
+            if (offset + sizeBytes <= conflict.m_begin)
+                break;
+            offset = std::max(offset, conflict.m_end);
+        }
+
+        layout.m_offsets[buffer] = offset;
+        layout.m_sizeBytes = std::max(layout.m_sizeBytes, offset + sizeBytes);
+        layout.m_unaliasedSizeBytes += sizeBytes;
+    }
+
+    return layout;
+}
+
+bool ComputeBasics::AreTransientBuffersOverlapping(const TransientMemoryLayout& layout,
+                                                   const std::vector<uint64_t>& sizesBytes,
+                                                   uint32_t a, uint32_t b, uint64_t alignment)
+{
+    return layout.m_offsets[a] < layout.m_offsets[b] + AlignSize(sizesBytes[b], alignment) &&
+           layout.m_offsets[b] < layout.m_offsets[a] + AlignSize(sizesBytes[a], alignment);
+}
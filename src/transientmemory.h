@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Placement of transient buffers in a single range of memory, so buffers never alive at the same time share it.
+// Buffers are placed from the biggest to the smallest one, each at the lowest offset not overlapping the buffers
+// already placed that are alive at the same time. It doesnt depend on d3d12.
+namespace ComputeBasics
+{
+
+struct TransientMemoryLayout
+{
+    // Indexed by buffer
+    std::vector<uint64_t>   m_offsets;
+    uint64_t                m_sizeBytes;
+    // Note the memory the buffers would need on their own, the difference is the peak memory saved
+    uint64_t                m_unaliasedSizeBytes;
+};
+
+// areAliveTogether(a, b) tells whether buffers a and b may be used at the same time. It has to be symmetric.
+// Note sizes are aligned to alignment, which has to be a power of 2
+TransientMemoryLayout PackTransientBuffers(const std::vector<uint64_t>& sizesBytes,
+                                           const std::function<bool(uint32_t, uint32_t)>& areAliveTogether,
+                                           uint64_t alignment);
+
+// Tells whether the memory of two buffers overlaps in a layout
+bool AreTransientBuffersOverlapping(const TransientMemoryLayout& layout, const std::vector<uint64_t>& sizesBytes,
+                                    uint32_t a, uint32_t b, uint64_t alignment);
+
+}
@@ -3,6 +3,8 @@
 #include <cassert>
 #include <fstream>
 #include <algorithm>
+#include <mutex>
+#include <unordered_map>
 
 #ifdef max
 #undef max
@@ -13,16 +15,55 @@
 
 namespace
 {
-std::string ConvertFromUTF16ToUTF8(const std::wstring& str)
+// Note DXGI_FORMAT_V408 is the last format of the sdk this project targets
+const UINT g_formatsCount = DXGI_FORMAT_V408 + 1;
+
+struct FormatSupportTable
 {
-    auto outStrLength = WideCharToMultiByte(CP_UTF8, 0, str.c_str(), -1, 0, 0, 0, 0);
-    assert(outStrLength);
-    std::string outStr(outStrLength, 0);
-    auto result = WideCharToMultiByte(CP_UTF8, 0, str.c_str(), -1, &outStr[0], static_cast<int>(outStr.size()), 0, 0);
-    result;
-    assert(result == outStr.size());
+    std::vector<D3D12_FEATURE_DATA_FORMAT_SUPPORT>  m_formats;
+    bool                                            m_typedUAVLoadAdditionalFormats;
+};
 
-    return outStr;
+// Note CheckFeatureSupport is not cheap. The capabilities of every format are queried once
+// per device and looked up afterwards.
+std::mutex g_formatSupportTablesMutex;
+std::unordered_map<ID3D12Device*, FormatSupportTable> g_formatSupportTables;
+
+FormatSupportTable CreateFormatSupportTable(ID3D12Device* device)
+{
+    assert(device);
+
+    FormatSupportTable table;
+    table.m_formats.resize(g_formatsCount);
+    for (UINT i = 0; i < g_formatsCount; ++i)
+    {
+        auto& formatSupport = table.m_formats[i];
+        formatSupport = { static_cast<DXGI_FORMAT>(i), D3D12_FORMAT_SUPPORT1_NONE, D3D12_FORMAT_SUPPORT2_NONE };
+        // Note formats unknown to the device make the call fail. They are left as not supported.
+        if (FAILED(device->CheckFeatureSupport(D3D12_FEATURE_FORMAT_SUPPORT, &formatSupport, sizeof(formatSupport))))
+        {
+            formatSupport.Support1 = D3D12_FORMAT_SUPPORT1_NONE;
+            formatSupport.Support2 = D3D12_FORMAT_SUPPORT2_NONE;
+        }
+    }
+
+    D3D12_FEATURE_DATA_D3D12_OPTIONS featureData;
+    Utils::AssertIfFailed(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &featureData, sizeof(featureData)));
+    table.m_typedUAVLoadAdditionalFormats = featureData.TypedUAVLoadAdditionalFormats != FALSE;
+
+    return table;
+}
+
+const FormatSupportTable& GetFormatSupportTable(ID3D12Device* device)
+{
+    assert(device);
+
+    std::lock_guard<std::mutex> lock(g_formatSupportTablesMutex);
+    auto it = g_formatSupportTables.find(device);
+    if (it == g_formatSupportTables.end())
+        it = g_formatSupportTables.emplace(device, CreateFormatSupportTable(device)).first;
+
+    return it->second;
 }
 }
 
@@ -72,6 +113,30 @@ std::vector<char> Utils::ReadFullFile(const std::wstring& fileName, bool readAsB
     return buffer;
 }
 
+std::string Utils::ConvertFromUTF16ToUTF8(const std::wstring& str)
+{
+    auto outStrLength = WideCharToMultiByte(CP_UTF8, 0, str.c_str(), -1, 0, 0, 0, 0);
+    assert(outStrLength);
+    std::string outStr(outStrLength, 0);
+    auto result = WideCharToMultiByte(CP_UTF8, 0, str.c_str(), -1, &outStr[0], static_cast<int>(outStr.size()), 0, 0);
+    result;
+    assert(result == outStr.size());
+
+    return outStr;
+}
+
+std::wstring Utils::ConvertFromUTF8ToUTF16(const std::string& str)
+{
+    auto outStrLength = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, 0, 0);
+    assert(outStrLength);
+    std::wstring outStr(outStrLength, 0);
+    auto result = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &outStr[0], static_cast<int>(outStr.size()));
+    result;
+    assert(result == outStr.size());
+
+    return outStr;
+}
+
 Utils::TexRawDataPtr Utils::ReadTexRawDataFromFile(const std::wstring& fileName)
 {
     std::vector<char> inputData = ReadFullFile(fileName, true);
@@ -115,32 +180,71 @@ bool Utils::WriteTexRawDataToFile(const std::wstring& fileName, const TexRawData
     return true;
 }
 
-bool Utils::CheckFormatSupport(ID3D12Device* device, DXGI_FORMAT format, D3D12_FORMAT_SUPPORT1 inputFormatSupport1)
+DXGI_FORMAT Utils::GetExrChannelsFormat(ExrPixelType pixelType, size_t channelsCount)
 {
-    assert(device);
+    // Note there is no 3 channels half format
+    const DXGI_FORMAT halfFormats[]     = { DXGI_FORMAT_R16_FLOAT, DXGI_FORMAT_R16G16_FLOAT, DXGI_FORMAT_UNKNOWN, DXGI_FORMAT_R16G16B16A16_FLOAT };
+    const DXGI_FORMAT floatFormats[]    = { DXGI_FORMAT_R32_FLOAT, DXGI_FORMAT_R32G32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT };
+    const DXGI_FORMAT uintFormats[]     = { DXGI_FORMAT_R32_UINT, DXGI_FORMAT_R32G32_UINT, DXGI_FORMAT_R32G32B32_UINT, DXGI_FORMAT_R32G32B32A32_UINT };
+
+    if (channelsCount == 0 || channelsCount > 4)
+        return DXGI_FORMAT_UNKNOWN;
+
+    switch (pixelType)
+    {
+    case ExrPixelType::Half:
+        return halfFormats[channelsCount - 1];
+    case ExrPixelType::Float:
+        return floatFormats[channelsCount - 1];
+    case ExrPixelType::UInt:
+        return uintFormats[channelsCount - 1];
+    default:
+        return DXGI_FORMAT_UNKNOWN;
+    }
+}
 
-    D3D12_FEATURE_DATA_FORMAT_SUPPORT formatSupport = { format, D3D12_FORMAT_SUPPORT1_NONE, D3D12_FORMAT_SUPPORT2_NONE };
-    Utils::AssertIfFailed(device->CheckFeatureSupport(D3D12_FEATURE_FORMAT_SUPPORT, &formatSupport, sizeof(formatSupport)));
+void Utils::CacheFormatSupport(ID3D12Device* device)
+{
+    GetFormatSupportTable(device);
+}
+
+bool Utils::CheckFormatSupport(ID3D12Device* device, DXGI_FORMAT format, D3D12_FORMAT_SUPPORT1 inputFormatSupport1)
+{
+    assert(format < g_formatsCount);
+    const auto& formatSupport = GetFormatSupportTable(device).m_formats[format];
 
-    return formatSupport.Support1 & inputFormatSupport1;
+    return (formatSupport.Support1 & inputFormatSupport1) == inputFormatSupport1;
 }
 
 // https://docs.microsoft.com/en-us/windows/desktop/direct3d12/typed-unordered-access-view-loads
 bool Utils::CheckFormatSupport(ID3D12Device* device, DXGI_FORMAT format, D3D12_FORMAT_SUPPORT2 inputFormatSupport)
 {
-    assert(device);
-    // TODO add check support for other features
-    assert(inputFormatSupport == D3D12_FORMAT_SUPPORT2_UAV_TYPED_STORE || inputFormatSupport == D3D12_FORMAT_SUPPORT2_UAV_TYPED_LOAD);
-    if (inputFormatSupport != D3D12_FORMAT_SUPPORT2_NONE)
+    assert(format < g_formatsCount);
+    const auto& formatSupportTable = GetFormatSupportTable(device);
+    if ((inputFormatSupport & D3D12_FORMAT_SUPPORT2_UAV_TYPED_LOAD) && !formatSupportTable.m_typedUAVLoadAdditionalFormats)
     {
-        D3D12_FEATURE_DATA_D3D12_OPTIONS featureData;
-        Utils::AssertIfFailed(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &featureData, sizeof(featureData)));
-        if (!featureData.TypedUAVLoadAdditionalFormats)
+        // Only R32_FLOAT, R32_UINT and R32_SINT are guaranteed without the additional formats
+        if (format != DXGI_FORMAT_R32_FLOAT && format != DXGI_FORMAT_R32_UINT && format != DXGI_FORMAT_R32_SINT)
             return false;
     }
 
-    D3D12_FEATURE_DATA_FORMAT_SUPPORT formatSupport = { format, D3D12_FORMAT_SUPPORT1_NONE, D3D12_FORMAT_SUPPORT2_NONE };
-    Utils::AssertIfFailed(device->CheckFeatureSupport(D3D12_FEATURE_FORMAT_SUPPORT, &formatSupport, sizeof(formatSupport)));
+    const auto& formatSupport = formatSupportTable.m_formats[format];
+
+    return (formatSupport.Support2 & inputFormatSupport) == inputFormatSupport;
+}
+
+bool Utils::CheckWaveIntrinsicsSupport(ID3D12Device* device)
+{
+    assert(device);
+
+    D3D12_FEATURE_DATA_SHADER_MODEL shaderModel = { D3D_SHADER_MODEL_6_0 };
+    if (FAILED(device->CheckFeatureSupport(D3D12_FEATURE_SHADER_MODEL, &shaderModel, sizeof(shaderModel))) ||
+        shaderModel.HighestShaderModel < D3D_SHADER_MODEL_6_0)
+        return false;
+
+    D3D12_FEATURE_DATA_D3D12_OPTIONS1 options1;
+    if (FAILED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS1, &options1, sizeof(options1))))
+        return false;
 
-    return formatSupport.Support2 & inputFormatSupport;
-}
\ No newline at end of file
+    return options1.WaveOps != FALSE;
+}
@@ -6,10 +6,12 @@
 #include <memory>
 #include <d3d12.h>
 
+#include "exrloader.h"
+
 namespace Utils
 {
 
-// Assuming rgba channels
+// Assuming rgba channels. Use ReadExrChannelsFromFile to keep the channels and pixel types of the file.
 struct TexRawData
 {
     float* m_data;
@@ -36,14 +38,29 @@ size_t AlignToPowerof2(size_t value, size_t alignmentPower2);
 
 bool IsAlignedToPowerof2(size_t value, size_t alignmentPower2);
 
+std::string ConvertFromUTF16ToUTF8(const std::wstring& str);
+
+std::wstring ConvertFromUTF8ToUTF16(const std::string& str);
+
 std::vector<char> ReadFullFile(const std::wstring& fileName, bool readAsBinary = false);
 
 TexRawDataPtr ReadTexRawDataFromFile(const std::wstring& fileName);
 
 bool WriteTexRawDataToFile(const std::wstring& fileName, const TexRawData* texRawData);
 
+// Format to upload channelsCount interleaved channels of pixelType as they are.
+// Planar exr data uploads every plane with channelsCount = 1. Returns DXGI_FORMAT_UNKNOWN if there is no such format.
+DXGI_FORMAT GetExrChannelsFormat(ExrPixelType pixelType, size_t channelsCount);
+
+// Builds the format capabilities table of the device. Meant to be called once at startup,
+// otherwise the first CheckFormatSupport call pays for it.
+void CacheFormatSupport(ID3D12Device* device);
+
 bool CheckFormatSupport(ID3D12Device* device, DXGI_FORMAT format, D3D12_FORMAT_SUPPORT1 inputFormatSupport1);
 
 bool CheckFormatSupport(ID3D12Device* device, DXGI_FORMAT format, D3D12_FORMAT_SUPPORT2 inputFormatSupport);
 
+// True if the device runs shader model 6.0 and supports the wave intrinsics
+bool CheckWaveIntrinsicsSupport(ID3D12Device* device);
+
 }
@@ -0,0 +1,137 @@
+// Tests of the schedules of src/computegraph.h. It doesnt depend on d3d12, from the root of the repo:
+// g++ -std=c++14 -Isrc tests/computegraph.cpp src/computegraph.cpp src/transientmemory.cpp
+//     src/resourcestatetracker.cpp -lpthread && ./a.out
+#include "computegraph.h"
+
+#include <cassert>
+#include <iostream>
+
+using namespace ComputeBasics;
+
+namespace
+{
+const uint64_t g_bufferSizeBytes = 1024;
+
+bool IsTransition(const ComputeGraphBarrier& barrier, uint32_t buffer, ComputeGraphBufferState before,
+                  ComputeGraphBufferState after)
+{
+    return barrier.m_type == ComputeGraphBarrierType::Transition && barrier.m_buffer == buffer &&
+           barrier.m_before == before && barrier.m_after == after;
+}
+
+void TestUploadDispatchReadback()
+{
+    ComputeGraph graph;
+    const uint32_t input = graph.CreateTransientBuffer("Input", g_bufferSizeBytes);
+    const uint32_t output = graph.CreateTransientBuffer("Output", g_bufferSizeBytes);
+    const uint32_t readback = graph.ImportBuffer("Readback", g_bufferSizeBytes, ComputeGraphBufferState::CopyDest);
+
+    const uint32_t uploadPass = graph.AddPass("Upload", ComputeGraphPassType::Copy);
+    graph.WriteBuffer(uploadPass, input);
+    const uint32_t dispatchPass = graph.AddPass("Dispatch", ComputeGraphPassType::Dispatch);
+    graph.ReadBuffer(dispatchPass, input);
+    graph.WriteBuffer(dispatchPass, output);
+    const uint32_t readbackPass = graph.AddPass("Readback", ComputeGraphPassType::Copy);
+    graph.ReadBuffer(readbackPass, output);
+    graph.WriteBuffer(readbackPass, readback);
+    const uint32_t culledPass = graph.AddPass("Culled", ComputeGraphPassType::Dispatch);
+    graph.ReadBuffer(culledPass, output);
+    graph.WriteBuffer(culledPass, input);
+
+    const ComputeGraphSchedule schedule = graph.Compile();
+    assert(schedule.m_culledPasses.size() == 1 && schedule.m_culledPasses[0] == culledPass);
+
+    // Note the copies go to the copy queue, waiting on each other through the fences
+    assert(schedule.m_segments.size() == 3);
+    assert(schedule.m_segments[0].m_queue == ComputeGraphQueue::Copy);
+    assert(schedule.m_segments[1].m_queue == ComputeGraphQueue::Compute);
+    assert(schedule.m_segments[1].m_waitFenceValue == schedule.m_segments[0].m_signalFenceValue);
+    assert(schedule.m_segments[2].m_queue == ComputeGraphQueue::Copy);
+    assert(schedule.m_segments[2].m_waitFenceValue == schedule.m_segments[1].m_signalFenceValue);
+
+    // Note every buffer is promoted on its first use in a segment, the imported one is already in copy dest
+    for (const auto& segment : schedule.m_segments)
+    {
+        for (const auto& scheduledPass : segment.m_passes)
+        {
+            for (const auto& barrier : scheduledPass.m_barriers)
+                assert(barrier.m_type == ComputeGraphBarrierType::Aliasing);
+        }
+    }
+
+    // Note input and output are both used by the dispatch, so they cant share memory
+    assert(schedule.m_transientOffsets[input] != schedule.m_transientOffsets[output]);
+    assert(schedule.m_transientOffsets[readback] == g_computeGraphNoOffset);
+}
+
+void TestBarriersInSegment()
+{
+    ComputeGraph graph;
+    const uint32_t buffer = graph.ImportBuffer("Buffer", g_bufferSizeBytes);
+
+    const uint32_t firstPass = graph.AddPass("First", ComputeGraphPassType::Dispatch);
+    graph.WriteBuffer(firstPass, buffer);
+    const uint32_t secondPass = graph.AddPass("Second", ComputeGraphPassType::Dispatch);
+    graph.WriteBuffer(secondPass, buffer);
+    const uint32_t thirdPass = graph.AddPass("Third", ComputeGraphPassType::Dispatch);
+    graph.ReadBuffer(thirdPass, buffer);
+    graph.WriteBuffer(thirdPass, graph.ImportBuffer("Result", g_bufferSizeBytes));
+
+    const ComputeGraphSchedule schedule = graph.Compile();
+    assert(schedule.m_segments.size() == 1);
+    const auto& passes = schedule.m_segments[0].m_passes;
+    assert(passes.size() == 3);
+
+    // Note uav barrier in between the writes, and a transition for the read
+    assert(passes[0].m_barriers.empty());
+    assert(passes[1].m_barriers.size() == 1);
+    assert(passes[1].m_barriers[0].m_type == ComputeGraphBarrierType::UAV);
+    assert(passes[2].m_barriers.size() == 1);
+    assert(IsTransition(passes[2].m_barriers[0], buffer, ComputeGraphBufferState::UnorderedAccess,
+                        ComputeGraphBufferState::ShaderResource));
+}
+
+void TestImportedStatesOutOfTheCopyQueue()
+{
+    ComputeGraph graph;
+    const uint32_t source = graph.ImportBuffer("Source", g_bufferSizeBytes, ComputeGraphBufferState::UnorderedAccess);
+    const uint32_t copySource = graph.ImportBuffer("Copy Source", g_bufferSizeBytes,
+                                                   ComputeGraphBufferState::CopySource);
+    const uint32_t destination = graph.ImportBuffer("Destination", g_bufferSizeBytes);
+    const uint32_t otherDestination = graph.ImportBuffer("Other Destination", g_bufferSizeBytes);
+
+    const uint32_t copyPass = graph.AddPass("Copy", ComputeGraphPassType::Copy);
+    graph.ReadBuffer(copyPass, source);
+    graph.WriteBuffer(copyPass, destination);
+    const uint32_t otherCopyPass = graph.AddPass("Other Copy", ComputeGraphPassType::Copy);
+    graph.ReadBuffer(otherCopyPass, copySource);
+    graph.WriteBuffer(otherCopyPass, otherDestination);
+
+    const ComputeGraphSchedule schedule = graph.Compile();
+    assert(schedule.m_segments.size() == 2);
+
+    // Note the copy queue cant transition out of uav, so that copy goes to the compute queue
+    const ComputeGraphSegment& computeSegment = schedule.m_segments[0];
+    assert(computeSegment.m_queue == ComputeGraphQueue::Compute);
+    assert(computeSegment.m_passes.size() == 1 && computeSegment.m_passes[0].m_pass == copyPass);
+    assert(computeSegment.m_passes[0].m_barriers.size() == 1);
+    assert(IsTransition(computeSegment.m_passes[0].m_barriers[0], source, ComputeGraphBufferState::UnorderedAccess,
+                        ComputeGraphBufferState::CopySource));
+
+    // Note copy source is a state of the copy queue, it is already there
+    const ComputeGraphSegment& copySegment = schedule.m_segments[1];
+    assert(copySegment.m_queue == ComputeGraphQueue::Copy);
+    assert(copySegment.m_passes.size() == 1 && copySegment.m_passes[0].m_pass == otherCopyPass);
+    assert(copySegment.m_passes[0].m_barriers.empty());
+}
+}
+
+int main()
+{
+    TestUploadDispatchReadback();
+    TestBarriersInSegment();
+    TestImportedStatesOutOfTheCopyQueue();
+
+    std::cout << "computegraph tests passed\n";
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+// Tests of the chunking and the schedule of src/cpuoutofcore.h. It doesnt depend on d3d12, from the root of the repo:
+// g++ -std=c++14 -Isrc tests/outofcore.cpp src/cpuoutofcore.cpp -lpthread && ./a.out
+#include "cpuoutofcore.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+using namespace ComputeBasics;
+
+namespace
+{
+OutOfCoreDesc CreateDesc(OutOfCoreKernelType kernelType, uint64_t elementsCount, uint32_t chunkElementsCount,
+                         uint32_t buffersCount)
+{
+    OutOfCoreDesc desc = {};
+    desc.m_kernelType = kernelType;
+    desc.m_elementsCount = elementsCount;
+    desc.m_inputElementSizeBytes = sizeof(uint32_t);
+    desc.m_outputElementSizeBytes = kernelType == OutOfCoreKernelType::Elementwise ? sizeof(uint32_t) :
+                                                                                     sizeof(uint64_t);
+    desc.m_chunkAlignment = 64;
+    desc.m_buffersCount = buffersCount;
+    desc.m_budgetBytes = buffersCount * (CalculateOutOfCoreInputBytes(desc, chunkElementsCount) +
+                                         CalculateOutOfCoreOutputBytes(desc, chunkElementsCount));
+    return desc;
+}
+
+// Checks the rules any schedule has to follow
+void CheckSchedule(const OutOfCoreDesc& desc, const OutOfCoreSchedule& schedule)
+{
+    const uint32_t chunkElementsCount = schedule.m_chunkElementsCount;
+    assert(chunkElementsCount > 0 && chunkElementsCount % desc.m_chunkAlignment == 0);
+    assert(desc.m_buffersCount * (CalculateOutOfCoreInputBytes(desc, chunkElementsCount) +
+                                  CalculateOutOfCoreOutputBytes(desc, chunkElementsCount)) <= desc.m_budgetBytes);
+    assert(static_cast<uint64_t>(schedule.m_chunksCount) * chunkElementsCount >= desc.m_elementsCount);
+    assert(static_cast<uint64_t>(schedule.m_chunksCount - 1) * chunkElementsCount < desc.m_elementsCount);
+
+    const uint32_t buffersCount = desc.m_buffersCount;
+    assert(schedule.m_computeSteps.size() == schedule.m_chunksCount);
+    assert(schedule.m_copySteps.size() == 2 * schedule.m_chunksCount);
+
+    // Note the position of the upload and the readback of every chunk in the copy queue
+    std::vector<uint32_t> uploadSteps(schedule.m_chunksCount, g_invalidOutOfCoreStep);
+    std::vector<uint32_t> readbackSteps(schedule.m_chunksCount, g_invalidOutOfCoreStep);
+    uint64_t elementsCount = 0;
+    for (uint32_t i = 0; i < schedule.m_copySteps.size(); ++i)
+    {
+        const OutOfCoreStep& step = schedule.m_copySteps[i];
+        assert(step.m_buffer == step.m_chunk % buffersCount);
+        assert(step.m_firstElement == static_cast<uint64_t>(step.m_chunk) * chunkElementsCount);
+        if (step.m_type == OutOfCoreStepType::Upload)
+        {
+            uploadSteps[step.m_chunk] = i;
+            elementsCount += step.m_elementsCount;
+
+            // Note the buffer is free once the dispatch of the chunk buffersCount before read it and its readback is
+            // done
+            if (step.m_chunk >= buffersCount)
+            {
+                assert(step.m_waitStep == step.m_chunk - buffersCount);
+                assert(readbackSteps[step.m_chunk - buffersCount] < i);
+            }
+            else
+            {
+                assert(step.m_waitStep == g_invalidOutOfCoreStep);
+            }
+        }
+        else
+        {
+            assert(step.m_type == OutOfCoreStepType::Readback);
+            assert(step.m_waitStep == step.m_chunk);
+            assert(uploadSteps[step.m_chunk] < i);
+            readbackSteps[step.m_chunk] = i;
+        }
+    }
+    assert(elementsCount == desc.m_elementsCount);
+
+    for (uint32_t chunk = 0; chunk < schedule.m_chunksCount; ++chunk)
+    {
+        const OutOfCoreStep& step = schedule.m_computeSteps[chunk];
+        assert(step.m_type == OutOfCoreStepType::Dispatch && step.m_chunk == chunk);
+        assert(step.m_waitStep == uploadSteps[chunk]);
+        assert(step.m_elementsCount == schedule.m_copySteps[uploadSteps[chunk]].m_elementsCount);
+    }
+}
+
+void TestChunkElementsCount()
+{
+    // Note the chunk is rounded down to the alignment, and never above the aligned elements count
+    OutOfCoreDesc desc = CreateDesc(OutOfCoreKernelType::Elementwise, 1000, 256, 2);
+    assert(CalculateOutOfCoreChunkElementsCount(desc) == 256);
+    desc.m_budgetBytes -= 1;
+    assert(CalculateOutOfCoreChunkElementsCount(desc) == 192);
+    desc.m_elementsCount = 10;
+    assert(CalculateOutOfCoreChunkElementsCount(desc) == 64);
+
+    // Note not even the alignment fits, so there is no schedule
+    desc.m_budgetBytes = desc.m_buffersCount * 64 * 8 - 1;
+    assert(CalculateOutOfCoreChunkElementsCount(desc) == 0);
+    assert(CreateOutOfCoreSchedule(desc).m_chunksCount == 0);
+
+    // Note reductions have a single output element per buffer
+    desc = CreateDesc(OutOfCoreKernelType::Reduction, 1000, 128, 3);
+    assert(desc.m_budgetBytes == 3 * (128 * 4 + 8));
+    assert(CalculateOutOfCoreChunkElementsCount(desc) == 128);
+}
+
+void TestRandomSchedules()
+{
+    std::mt19937 random(42);
+    for (uint32_t test = 0; test < 1000; ++test)
+    {
+        const OutOfCoreKernelType kernelType = random() % 2 ? OutOfCoreKernelType::Elementwise :
+                                                              OutOfCoreKernelType::Reduction;
+        OutOfCoreDesc desc = CreateDesc(kernelType, 1 + random() % 100000, 64, 1 + random() % 4);
+        desc.m_chunkAlignment = 1 << (random() % 8);
+        desc.m_budgetBytes = desc.m_budgetBytes + random() % (1024 * 1024);
+
+        const OutOfCoreSchedule schedule = CreateOutOfCoreSchedule(desc);
+        if (schedule.m_chunksCount > 0)
+            CheckSchedule(desc, schedule);
+        else
+            assert(CalculateOutOfCoreChunkElementsCount(desc) == 0);
+    }
+}
+
+void TestExecutor()
+{
+    const OutOfCoreRates noRates = {};
+    for (uint32_t buffersCount = 1; buffersCount <= 3; ++buffersCount)
+    {
+        // Note 1000 elements in chunks of 256, the last one is short
+        std::vector<uint32_t> input(1000);
+        std::iota(input.begin(), input.end(), 0xfffffe00u);
+
+        const OutOfCoreDesc elementwiseDesc = CreateDesc(OutOfCoreKernelType::Elementwise, input.size(), 256,
+                                                         buffersCount);
+        Cpu::OutOfCoreExecutor elementwise(elementwiseDesc, noRates);
+        assert(elementwise.IsValid());
+        assert(elementwise.GetSchedule().m_chunksCount == 4);
+        CheckSchedule(elementwiseDesc, elementwise.GetSchedule());
+
+        std::vector<uint32_t> output(input.size());
+        elementwise.Execute(input.data(), output.data(), [](const void* chunkInput, void* chunkOutput,
+                                                            uint32_t elementsCount, const OutOfCoreStep&)
+        {
+            for (uint32_t i = 0; i < elementsCount; ++i)
+                static_cast<uint32_t*>(chunkOutput)[i] = static_cast<const uint32_t*>(chunkInput)[i] * 3 + 1;
+        });
+        for (size_t i = 0; i < input.size(); ++i)
+            assert(output[i] == input[i] * 3 + 1);
+
+        const OutOfCoreDesc reductionDesc = CreateDesc(OutOfCoreKernelType::Reduction, input.size(), 256,
+                                                       buffersCount);
+        Cpu::OutOfCoreExecutor reduction(reductionDesc, noRates);
+        assert(reduction.IsValid());
+        const OutOfCoreSchedule& schedule = reduction.GetSchedule();
+        assert(CalculateOutOfCoreOutputElementsCount(reductionDesc, schedule) == 4);
+
+        std::vector<uint64_t> sums(schedule.m_chunksCount);
+        reduction.Execute(input.data(), sums.data(), [](const void* chunkInput, void* chunkOutput,
+                                                        uint32_t elementsCount, const OutOfCoreStep&)
+        {
+            const uint32_t* values = static_cast<const uint32_t*>(chunkInput);
+            *static_cast<uint64_t*>(chunkOutput) = std::accumulate(values, values + elementsCount, uint64_t(0));
+        });
+        for (uint32_t chunk = 0; chunk < schedule.m_chunksCount; ++chunk)
+        {
+            const size_t first = chunk * schedule.m_chunkElementsCount;
+            const size_t last = std::min(input.size(), first + schedule.m_chunkElementsCount);
+            assert(sums[chunk] == std::accumulate(input.begin() + first, input.begin() + last, uint64_t(0)));
+        }
+    }
+}
+
+void TestSimulatedOverlap()
+{
+    // Note the transfers and the dispatch of a chunk take about the same time
+    const OutOfCoreRates rates = { 1e9, 1e9, 2.5e8 };
+    double seconds[3] = {};
+    for (uint32_t buffersCount = 1; buffersCount <= 3; ++buffersCount)
+    {
+        // Note the same budget for all of them, so more buffers means smaller chunks
+        OutOfCoreDesc desc = CreateDesc(OutOfCoreKernelType::Elementwise, 1 << 20, 1 << 16, 1);
+        desc.m_buffersCount = buffersCount;
+        const OutOfCoreSchedule schedule = CreateOutOfCoreSchedule(desc);
+        CheckSchedule(desc, schedule);
+
+        const OutOfCoreTimeline timeline = SimulateOutOfCoreSchedule(desc, schedule, rates);
+        const double copySeconds = (1 << 20) * 8 / 1e9;
+        const double computeSeconds = (1 << 20) / 2.5e8;
+        assert(std::abs(timeline.m_copySeconds - copySeconds) < 1e-9);
+        assert(std::abs(timeline.m_computeSeconds - computeSeconds) < 1e-9);
+        assert(timeline.m_seconds >= std::max(copySeconds, computeSeconds) - 1e-9);
+        assert(timeline.m_seconds <= copySeconds + computeSeconds + 1e-9);
+        seconds[buffersCount - 1] = timeline.m_seconds;
+    }
+
+    // Note a single buffer serializes the queues, double buffering overlaps them
+    assert(std::abs(seconds[0] - (1 << 20) * (8 / 1e9 + 1 / 2.5e8)) < 1e-9);
+    assert(seconds[1] < 0.75 * seconds[0]);
+    assert(seconds[2] <= seconds[1] + 1e-9);
+}
+}
+
+int main()
+{
+    TestChunkElementsCount();
+    TestRandomSchedules();
+    TestExecutor();
+    TestSimulatedOverlap();
+
+    std::cout << "outofcore tests passed\n";
+    return 0;
+}
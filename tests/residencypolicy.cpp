@@ -0,0 +1,251 @@
+// Tests of the residency decisions of src/residencypolicy.h against a simulated budget. It doesnt depend on d3d12,
+// from the root of the repo:
+// g++ -std=c++14 -Isrc tests/residencypolicy.cpp src/residencypolicy.cpp && ./a.out
+#include "residencypolicy.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+
+using namespace ComputeBasics;
+
+namespace
+{
+const uint64_t g_sizeBytes = 1024;
+
+bool Contains(const std::vector<uint32_t>& allocations, uint32_t allocation)
+{
+    return std::find(allocations.begin(), allocations.end(), allocation) != allocations.end();
+}
+
+void TestLeastRecentlyUsedEviction()
+{
+    ResidencyPolicy policy;
+    const uint32_t first = policy.Track(g_sizeBytes, ResidencyHeapType::Default);
+    const uint32_t second = policy.Track(g_sizeBytes, ResidencyHeapType::Default);
+    const uint32_t third = policy.Track(g_sizeBytes, ResidencyHeapType::Default);
+
+    // Note first is used after second, so second is the least recently used one
+    ResidencyPlan plan;
+    policy.Use(second);
+    policy.PlanJob(3 * g_sizeBytes, plan);
+    assert(plan.m_evict.empty() && plan.m_makeResident.empty());
+    policy.Use(first);
+    policy.PlanJob(3 * g_sizeBytes, plan);
+    assert(plan.m_evict.empty() && plan.m_makeResident.empty());
+
+    policy.Use(third);
+    policy.PlanJob(2 * g_sizeBytes, plan);
+    assert(plan.m_evict.size() == 1 && plan.m_evict[0] == second);
+    assert(!policy.IsResident(second));
+
+    // Note evicted allocations are made resident again once used, evicting the next least recently used one
+    policy.Use(second);
+    policy.PlanJob(2 * g_sizeBytes, plan);
+    assert(plan.m_makeResident.size() == 1 && plan.m_makeResident[0] == second);
+    assert(plan.m_evict.size() == 1 && plan.m_evict[0] == first);
+    assert(policy.IsResident(second) && policy.IsResident(third));
+}
+
+void TestJobAllocationsNeverEvicted()
+{
+    ResidencyPolicy policy;
+    const uint32_t first = policy.Track(g_sizeBytes, ResidencyHeapType::Default);
+    const uint32_t second = policy.Track(g_sizeBytes, ResidencyHeapType::Default);
+    const uint32_t other = policy.Track(g_sizeBytes, ResidencyHeapType::Default);
+
+    // Note the job doesnt fit in the budget, the rest is evicted and the job allocations go over it
+    ResidencyPlan plan;
+    policy.Use(first);
+    policy.Use(second);
+    policy.PlanJob(g_sizeBytes, plan);
+    assert(plan.m_evict.size() == 1 && plan.m_evict[0] == other);
+    assert(policy.IsResident(first) && policy.IsResident(second));
+    assert(policy.GetCounters().m_residentBytes == 2 * g_sizeBytes);
+
+    // Note the evicted allocation has to be made resident for its job, even with no budget at all
+    policy.Use(other);
+    policy.PlanJob(0, plan);
+    assert(plan.m_makeResident.size() == 1 && plan.m_makeResident[0] == other);
+    assert(!Contains(plan.m_evict, other));
+    assert(policy.IsResident(other) && !policy.IsResident(first) && !policy.IsResident(second));
+}
+
+void TestUploadAndReadbackNotEvicted()
+{
+    ResidencyPolicy policy;
+    const uint32_t upload = policy.Track(4 * g_sizeBytes, ResidencyHeapType::Upload);
+    const uint32_t readback = policy.Track(2 * g_sizeBytes, ResidencyHeapType::Readback);
+    const uint32_t buffer = policy.Track(g_sizeBytes, ResidencyHeapType::Default);
+
+    // Note only the default heap counts against the budget
+    const ResidencyCounters& counters = policy.GetCounters();
+    assert(counters.m_residentBytes == g_sizeBytes);
+    assert(counters.m_currentBytes[static_cast<uint32_t>(ResidencyHeapType::Upload)] == 4 * g_sizeBytes);
+    assert(counters.m_currentBytes[static_cast<uint32_t>(ResidencyHeapType::Readback)] == 2 * g_sizeBytes);
+
+    ResidencyPlan plan;
+    policy.Use(upload);
+    policy.Use(readback);
+    policy.PlanJob(0, plan);
+    assert(plan.m_evict.size() == 1 && plan.m_evict[0] == buffer);
+    assert(plan.m_makeResident.empty());
+    assert(policy.IsResident(upload) && policy.IsResident(readback));
+    assert(counters.m_residentBytes == 0);
+}
+
+void TestUntrackedIndexReused()
+{
+    ResidencyPolicy policy;
+    const uint32_t evicted = policy.Track(g_sizeBytes, ResidencyHeapType::Default);
+    const uint32_t buffer = policy.Track(g_sizeBytes, ResidencyHeapType::Default);
+
+    // Note used for the next job and untracked before planning it, the index goes to a new allocation
+    ResidencyPlan plan;
+    policy.Use(buffer);
+    policy.Untrack(buffer);
+    const uint32_t reused = policy.Track(2 * g_sizeBytes, ResidencyHeapType::Default);
+    assert(reused == buffer);
+    assert(policy.GetCounters().m_residentBytes == 3 * g_sizeBytes);
+
+    // Note the new allocation wasnt used by the job, so it can be evicted
+    policy.PlanJob(g_sizeBytes, plan);
+    assert(plan.m_makeResident.empty());
+    assert(plan.m_evict.size() == 2 && plan.m_evict[0] == evicted && plan.m_evict[1] == reused);
+    assert(policy.GetCounters().m_residentBytes == 0);
+
+    // Note queued twice for the same job, before and after the index is reused, it is made resident once
+    policy.Use(reused);
+    policy.Untrack(reused);
+    const uint32_t again = policy.Track(g_sizeBytes, ResidencyHeapType::Upload);
+    assert(again == reused);
+    policy.Untrack(again);
+    const uint32_t last = policy.Track(g_sizeBytes, ResidencyHeapType::Default);
+    assert(last == reused);
+    policy.Use(last);
+    policy.Use(evicted);
+    policy.PlanJob(2 * g_sizeBytes, plan);
+    assert(plan.m_evict.empty());
+    assert(plan.m_makeResident.size() == 1 && plan.m_makeResident[0] == evicted);
+    assert(policy.IsResident(last) && policy.IsResident(evicted));
+    assert(policy.GetCounters().m_residentBytes == 2 * g_sizeBytes);
+}
+
+void TestCounters()
+{
+    ResidencyPolicy policy;
+    const uint32_t first = policy.Track(g_sizeBytes, ResidencyHeapType::Default);
+    const uint32_t second = policy.Track(2 * g_sizeBytes, ResidencyHeapType::Default);
+    const uint32_t upload = policy.Track(g_sizeBytes, ResidencyHeapType::Upload);
+
+    const ResidencyCounters& counters = policy.GetCounters();
+    const uint32_t defaultIndex = static_cast<uint32_t>(ResidencyHeapType::Default);
+    const uint32_t uploadIndex = static_cast<uint32_t>(ResidencyHeapType::Upload);
+    assert(counters.m_currentBytes[defaultIndex] == 3 * g_sizeBytes);
+    assert(counters.m_peakResidentBytes == 3 * g_sizeBytes);
+
+    ResidencyPlan plan;
+    policy.Use(first);
+    policy.PlanJob(g_sizeBytes, plan);
+    assert(counters.m_evictionsCount == 1 && counters.m_evictedBytes == 2 * g_sizeBytes);
+    assert(counters.m_residentBytes == g_sizeBytes);
+    // Note the evicted allocations are still tracked
+    assert(counters.m_currentBytes[defaultIndex] == 3 * g_sizeBytes);
+
+    policy.Use(second);
+    policy.PlanJob(g_sizeBytes, plan);
+    assert(counters.m_makeResidentsCount == 1 && counters.m_madeResidentBytes == 2 * g_sizeBytes);
+    assert(counters.m_evictionsCount == 2 && counters.m_evictedBytes == 3 * g_sizeBytes);
+
+    // Note untracking lowers the current counters and keeps the peaks
+    policy.Untrack(second);
+    policy.Untrack(upload);
+    assert(counters.m_currentBytes[defaultIndex] == g_sizeBytes);
+    assert(counters.m_currentBytes[uploadIndex] == 0);
+    assert(counters.m_residentBytes == 0);
+    assert(counters.m_peakBytes[defaultIndex] == 3 * g_sizeBytes);
+    assert(counters.m_peakBytes[uploadIndex] == g_sizeBytes);
+    assert(counters.m_peakResidentBytes == 3 * g_sizeBytes);
+}
+
+void TestRandom()
+{
+    std::mt19937 random(42);
+    const uint64_t budgetBytes = 64 * g_sizeBytes;
+
+    ResidencyPolicy policy;
+    std::vector<uint32_t> allocations;
+    std::vector<ResidencyHeapType> heapTypes;
+    ResidencyPlan plan;
+    for (uint32_t job = 0; job < 10000; ++job)
+    {
+        // Note the allocations come and go in between the jobs
+        if (allocations.size() < 64 && random() % 2 == 0)
+        {
+            const ResidencyHeapType heapType = static_cast<ResidencyHeapType>(random() % g_residencyHeapTypesCount);
+            allocations.push_back(policy.Track((1 + random() % 8) * g_sizeBytes, heapType));
+            heapTypes.push_back(heapType);
+        }
+        if (!allocations.empty() && random() % 4 == 0)
+        {
+            const uint32_t i = random() % allocations.size();
+            policy.Untrack(allocations[i]);
+            allocations.erase(allocations.begin() + i);
+            heapTypes.erase(heapTypes.begin() + i);
+        }
+        if (allocations.empty())
+            continue;
+
+        std::vector<uint32_t> jobAllocations;
+        uint64_t jobBytes = 0;
+        const uint32_t usesCount = 1 + random() % 8;
+        for (uint32_t use = 0; use < usesCount; ++use)
+        {
+            const uint32_t i = random() % allocations.size();
+            policy.Use(allocations[i]);
+            if (heapTypes[i] == ResidencyHeapType::Default && !Contains(jobAllocations, allocations[i]))
+            {
+                jobAllocations.push_back(allocations[i]);
+                jobBytes += policy.GetSizeBytes(allocations[i]);
+            }
+        }
+
+        policy.PlanJob(budgetBytes, plan);
+        for (uint32_t allocation : jobAllocations)
+        {
+            assert(policy.IsResident(allocation));
+            assert(!Contains(plan.m_evict, allocation));
+        }
+        for (uint32_t allocation : plan.m_evict)
+            assert(!policy.IsResident(allocation));
+
+        uint64_t residentBytes = 0;
+        for (size_t i = 0; i < allocations.size(); ++i)
+        {
+            if (heapTypes[i] == ResidencyHeapType::Default && policy.IsResident(allocations[i]))
+                residentBytes += policy.GetSizeBytes(allocations[i]);
+            else
+                assert(heapTypes[i] == ResidencyHeapType::Default || policy.IsResident(allocations[i]));
+        }
+        assert(residentBytes == policy.GetCounters().m_residentBytes);
+        if (jobBytes <= budgetBytes)
+            assert(residentBytes <= budgetBytes);
+        else
+            assert(residentBytes == jobBytes);
+    }
+}
+}
+
+int main()
+{
+    TestLeastRecentlyUsedEviction();
+    TestJobAllocationsNeverEvicted();
+    TestUploadAndReadbackNotEvicted();
+    TestUntrackedIndexReused();
+    TestCounters();
+    TestRandom();
+
+    std::cout << "residencypolicy tests passed\n";
+    return 0;
+}
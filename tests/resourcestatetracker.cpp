@@ -0,0 +1,205 @@
+// Tests of the state tracking of src/resourcestatetracker.h. It doesnt depend on d3d12, from the root of the repo:
+// g++ -std=c++14 -Isrc tests/resourcestatetracker.cpp src/resourcestatetracker.cpp -lpthread && ./a.out
+#include "resourcestatetracker.h"
+
+#include <cassert>
+#include <iostream>
+
+using namespace ComputeBasics;
+
+namespace
+{
+const uint32_t g_buffer = 0;
+const uint32_t g_otherBuffer = 1;
+const uint32_t g_texture = 2;
+const uint32_t g_textureSubresourcesCount = 4;
+
+void RegisterResources(ResourceStates& resourceStates)
+{
+    resourceStates.Register(g_buffer, ResourceState::Common, 1, true);
+    resourceStates.Register(g_otherBuffer, ResourceState::Common, 1, true);
+    resourceStates.Register(g_texture, ResourceState::CopyDest, g_textureSubresourcesCount, false);
+}
+
+bool IsTransition(const ResourceBarrier& barrier, uint32_t resource, uint32_t subresource, ResourceState before,
+                  ResourceState after)
+{
+    return barrier.m_type == ResourceBarrierType::Transition && barrier.m_resource == resource &&
+           barrier.m_subresource == subresource && barrier.m_before == before && barrier.m_after == after;
+}
+
+bool IsUAVBarrier(const ResourceBarrier& barrier, uint32_t resource)
+{
+    return barrier.m_type == ResourceBarrierType::UAV && barrier.m_resource == resource;
+}
+
+void TestMergeAndCancel()
+{
+    ResourceStates resourceStates;
+    RegisterResources(resourceStates);
+    ResourceStateTracker tracker(resourceStates);
+
+    std::vector<ResourceBarrier> barriers;
+    tracker.Transition(g_buffer, ResourceState::ShaderResource);
+    tracker.FlushBarriers(barriers);
+    assert(barriers.empty());
+
+    // Note the transitions queued in between flushes end up in a single one
+    tracker.Transition(g_buffer, ResourceState::UnorderedAccess);
+    tracker.Transition(g_buffer, ResourceState::CopySource);
+    tracker.FlushBarriers(barriers);
+    assert(barriers.size() == 1);
+    assert(IsTransition(barriers[0], g_buffer, g_allSubresources, ResourceState::ShaderResource,
+                        ResourceState::CopySource));
+
+    // Note going back to the state before cancels the transition
+    barriers.clear();
+    tracker.Transition(g_buffer, ResourceState::CopyDest);
+    tracker.Transition(g_buffer, ResourceState::CopySource);
+    tracker.FlushBarriers(barriers);
+    assert(barriers.empty());
+
+    ResourceState state;
+    assert(tracker.FindState(g_buffer, g_allSubresources, state) && state == ResourceState::CopySource);
+    assert(!tracker.FindState(g_otherBuffer, g_allSubresources, state));
+}
+
+void TestUAVBarriers()
+{
+    ResourceStates resourceStates;
+    RegisterResources(resourceStates);
+    ResourceStateTracker tracker(resourceStates);
+
+    std::vector<ResourceBarrier> barriers;
+    tracker.Transition(g_buffer, ResourceState::UnorderedAccess);
+    tracker.Transition(g_otherBuffer, ResourceState::UnorderedAccess);
+
+    // Note a uav barrier already queued for the resource covers the next ones
+    tracker.UAVBarrier(g_buffer);
+    tracker.UAVBarrier(g_buffer);
+    tracker.FlushBarriers(barriers);
+    assert(barriers.size() == 1);
+    assert(IsUAVBarrier(barriers[0], g_buffer));
+
+    // Note a global uav barrier replaces the ones of the resources and covers the later ones
+    barriers.clear();
+    tracker.UAVBarrier(g_buffer);
+    tracker.UAVBarrier(g_otherBuffer);
+    tracker.UAVBarrier(g_allResources);
+    tracker.UAVBarrier(g_buffer);
+    tracker.FlushBarriers(barriers);
+    assert(barriers.size() == 1);
+    assert(IsUAVBarrier(barriers[0], g_allResources));
+
+    // Note a transition out of uav orders the accesses before it, so the queued uav barrier goes away
+    barriers.clear();
+    tracker.UAVBarrier(g_buffer);
+    tracker.Transition(g_buffer, ResourceState::ShaderResource);
+    tracker.FlushBarriers(barriers);
+    assert(barriers.size() == 1);
+    assert(IsTransition(barriers[0], g_buffer, g_allSubresources, ResourceState::UnorderedAccess,
+                        ResourceState::ShaderResource));
+
+    // Note a queued transition of the whole resource orders the accesses too
+    barriers.clear();
+    tracker.Transition(g_buffer, ResourceState::UnorderedAccess);
+    tracker.UAVBarrier(g_buffer);
+    tracker.FlushBarriers(barriers);
+    assert(barriers.size() == 1);
+    assert(barriers[0].m_type == ResourceBarrierType::Transition);
+}
+
+void TestPendingBarriers()
+{
+    ResourceStates resourceStates;
+    RegisterResources(resourceStates);
+
+    // Note the buffer is promoted from common, the texture needs a transition from its initial state
+    std::vector<ResourceBarrier> barriers;
+    ResourceStateTracker tracker(resourceStates);
+    tracker.Transition(g_buffer, ResourceState::UnorderedAccess);
+    tracker.Transition(g_texture, ResourceState::ShaderResource);
+    tracker.FlushBarriers(barriers);
+    assert(barriers.empty());
+    tracker.ResolvePendingBarriers(false, barriers);
+    assert(barriers.size() == 1);
+    assert(IsTransition(barriers[0], g_texture, g_allSubresources, ResourceState::CopyDest,
+                        ResourceState::ShaderResource));
+
+    // Note the texture keeps the state the cmd list left it in and the buffer decays to common
+    barriers.clear();
+    tracker.Reset();
+    tracker.Transition(g_buffer, ResourceState::CopySource);
+    tracker.Transition(g_texture, ResourceState::ShaderResource);
+    tracker.ResolvePendingBarriers(false, barriers);
+    assert(barriers.empty());
+
+    // Note a subresource diverges from the rest
+    tracker.Reset();
+    tracker.Transition(g_texture, ResourceState::UnorderedAccess, 1);
+    tracker.ResolvePendingBarriers(false, barriers);
+    assert(barriers.size() == 1);
+    assert(IsTransition(barriers[0], g_texture, 1, ResourceState::ShaderResource, ResourceState::UnorderedAccess));
+
+    // Note the whole texture needs a transition per subresource in a state of its own
+    barriers.clear();
+    tracker.Reset();
+    tracker.Transition(g_texture, ResourceState::ShaderResource);
+    tracker.ResolvePendingBarriers(false, barriers);
+    assert(barriers.size() == 1);
+    assert(IsTransition(barriers[0], g_texture, 1, ResourceState::UnorderedAccess, ResourceState::ShaderResource));
+
+    // Note copy cmd lists leave everything in common
+    barriers.clear();
+    tracker.Reset();
+    tracker.Transition(g_texture, ResourceState::CopySource);
+    tracker.ResolvePendingBarriers(true, barriers);
+    assert(barriers.size() == 1);
+    barriers.clear();
+    tracker.Reset();
+    tracker.Transition(g_texture, ResourceState::CopySource);
+    tracker.ResolvePendingBarriers(false, barriers);
+    assert(barriers.size() == 1);
+    assert(IsTransition(barriers[0], g_texture, g_allSubresources, ResourceState::Common, ResourceState::CopySource));
+}
+
+void TestSubresources()
+{
+    ResourceStates resourceStates;
+    RegisterResources(resourceStates);
+    ResourceStateTracker tracker(resourceStates);
+
+    std::vector<ResourceBarrier> barriers;
+    tracker.Transition(g_texture, ResourceState::CopyDest);
+    tracker.FlushBarriers(barriers);
+    tracker.Transition(g_texture, ResourceState::ShaderResource, 2);
+    tracker.FlushBarriers(barriers);
+    assert(barriers.size() == 1);
+    assert(IsTransition(barriers[0], g_texture, 2, ResourceState::CopyDest, ResourceState::ShaderResource));
+
+    ResourceState state;
+    assert(!tracker.FindState(g_texture, g_allSubresources, state));
+    assert(tracker.FindState(g_texture, 2, state) && state == ResourceState::ShaderResource);
+    assert(tracker.FindState(g_texture, 3, state) && state == ResourceState::CopyDest);
+
+    // Note the subresources in different states get a transition each, none for the one already there
+    barriers.clear();
+    tracker.Transition(g_texture, ResourceState::ShaderResource);
+    tracker.FlushBarriers(barriers);
+    assert(barriers.size() == g_textureSubresourcesCount - 1);
+    for (const auto& barrier : barriers)
+        assert(barrier.m_subresource != 2 && barrier.m_after == ResourceState::ShaderResource);
+    assert(tracker.FindState(g_texture, g_allSubresources, state) && state == ResourceState::ShaderResource);
+}
+}
+
+int main()
+{
+    TestMergeAndCancel();
+    TestUAVBarriers();
+    TestPendingBarriers();
+    TestSubresources();
+
+    std::cout << "resourcestatetracker tests passed\n";
+    return 0;
+}
\ No newline at end of file
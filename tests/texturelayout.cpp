@@ -0,0 +1,135 @@
+// Tests of the packing of src/texturelayout.h. It doesnt depend on d3d12, from the root of the repo:
+// g++ -std=c++14 -Isrc tests/texturelayout.cpp src/texturelayout.cpp && ./a.out
+#include "texturelayout.h"
+
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace ComputeBasics;
+
+namespace
+{
+// Same than D3D12_TEXTURE_DATA_PITCH_ALIGNMENT and D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+const uint32_t g_pitchAlignment = 256;
+const uint64_t g_placementAlignment = 512;
+const uint8_t g_untouchedByte = 0xcd;
+
+uint64_t AlignTo(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void TestMipsCount()
+{
+    assert(CalculateMipsCount(1, 1, 1) == 1);
+    assert(CalculateMipsCount(2, 1, 1) == 2);
+    assert(CalculateMipsCount(255, 1, 1) == 8);
+    assert(CalculateMipsCount(256, 1, 1) == 9);
+    assert(CalculateMipsCount(1920, 1080, 1) == 11);
+    assert(CalculateMipsCount(1, 1024, 1) == 11);
+    assert(CalculateMipsCount(4, 4, 1025) == 11);
+    // Note the width of a buffer goes beyond 32 bits
+    assert(CalculateMipsCount(1ull << 32, 1, 1) == 33);
+}
+
+void TestPackSubresources()
+{
+    std::mt19937 random(42);
+    for (uint32_t test = 0; test < 200; ++test)
+    {
+        const uint32_t subresourcesCount = 1 + random() % 6;
+        std::vector<SubresourceFootprint> footprints(subresourcesCount);
+        std::vector<SubresourceData> srcs(subresourcesCount);
+        std::vector<std::vector<uint8_t>> srcBytes(subresourcesCount);
+
+        // Note the first subresource doesnt start at the beginning of the buffer
+        uint64_t offset = g_placementAlignment * (1 + random() % 4);
+        for (uint32_t i = 0; i < subresourcesCount; ++i)
+        {
+            // Note odd row sizes and sizes not multiple of 16 or 64 bytes, so every tail of the copy runs
+            SubresourceFootprint& footprint = footprints[i];
+            footprint.m_offset = offset;
+            footprint.m_width = 1 + random() % 300;
+            footprint.m_height = 1 + random() % 8;
+            footprint.m_depth = 1 + random() % 4;
+            footprint.m_rowsCount = footprint.m_height;
+            footprint.m_rowSizeBytes = footprint.m_width * (1 + random() % 8);
+            footprint.m_rowPitch = static_cast<uint32_t>(AlignTo(footprint.m_rowSizeBytes, g_pitchAlignment));
+
+            // Note the application rows can have padding of their own
+            const uint64_t srcRowPitch = footprint.m_rowSizeBytes + random() % 32;
+            const uint64_t srcSlicePitch = srcRowPitch * footprint.m_rowsCount + random() % 32;
+            srcBytes[i].resize(static_cast<size_t>(srcSlicePitch * footprint.m_depth));
+            for (auto& byte : srcBytes[i])
+                byte = static_cast<uint8_t>(random() % g_untouchedByte);
+            srcs[i] = { srcBytes[i].data(), srcRowPitch, srcSlicePitch };
+
+            offset = AlignTo(offset + static_cast<uint64_t>(footprint.m_rowPitch) * footprint.m_rowsCount *
+                             footprint.m_depth, g_placementAlignment);
+        }
+
+        std::vector<uint8_t> dst(static_cast<size_t>(offset), g_untouchedByte);
+        PackSubresources(dst.data(), footprints.data(), srcs.data(), subresourcesCount);
+
+        // Note every byte of the buffer is either a texel of a row or untouched, as the pitch padding and the bytes
+        // before the offsets
+        std::vector<bool> isTexel(dst.size(), false);
+        for (uint32_t i = 0; i < subresourcesCount; ++i)
+        {
+            const SubresourceFootprint& footprint = footprints[i];
+            for (uint32_t slice = 0; slice < footprint.m_depth; ++slice)
+            {
+                for (uint32_t row = 0; row < footprint.m_rowsCount; ++row)
+                {
+                    const uint64_t dstRow = footprint.m_offset +
+                                            (static_cast<uint64_t>(slice) * footprint.m_rowsCount + row) *
+                                            footprint.m_rowPitch;
+                    const uint64_t srcRow = slice * srcs[i].m_slicePitch + row * srcs[i].m_rowPitch;
+                    for (uint64_t byte = 0; byte < footprint.m_rowSizeBytes; ++byte)
+                    {
+                        assert(dst[dstRow + byte] == srcBytes[i][srcRow + byte]);
+                        isTexel[dstRow + byte] = true;
+                    }
+                }
+            }
+        }
+        for (size_t byte = 0; byte < dst.size(); ++byte)
+            assert(isTexel[byte] || dst[byte] == g_untouchedByte);
+    }
+}
+
+void TestCopyRowStreaming()
+{
+    // Note a destination not aligned to 16 bytes runs the head of the copy as well
+    std::vector<uint8_t> src(1024);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = static_cast<uint8_t>(i % g_untouchedByte);
+
+    for (size_t dstOffset = 0; dstOffset < 32; ++dstOffset)
+    {
+        for (size_t sizeBytes = 0; sizeBytes < 200; ++sizeBytes)
+        {
+            std::vector<uint8_t> dst(dstOffset + sizeBytes + 16, g_untouchedByte);
+            CopyRowStreaming(dst.data() + dstOffset, src.data() + 1, sizeBytes);
+            FlushStreamingStores();
+            for (size_t i = 0; i < dst.size(); ++i)
+            {
+                const bool isCopied = i >= dstOffset && i < dstOffset + sizeBytes;
+                assert(dst[i] == (isCopied ? src[i - dstOffset + 1] : g_untouchedByte));
+            }
+        }
+    }
+}
+}
+
+int main()
+{
+    TestMipsCount();
+    TestPackSubresources();
+    TestCopyRowStreaming();
+
+    std::cout << "texturelayout tests passed\n";
+    return 0;
+}
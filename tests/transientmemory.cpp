@@ -0,0 +1,140 @@
+// Tests of the placement of src/transientmemory.h. It doesnt depend on d3d12, from the root of the repo:
+// g++ -std=c++14 -Isrc tests/transientmemory.cpp src/transientmemory.cpp && ./a.out
+#include "transientmemory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+
+using namespace ComputeBasics;
+
+namespace
+{
+const uint64_t g_alignment = 256;
+
+uint64_t AlignSize(uint64_t sizeBytes)
+{
+    return (sizeBytes + g_alignment - 1) & ~(g_alignment - 1);
+}
+
+// Checks the rules any layout has to follow
+void CheckLayout(const TransientMemoryLayout& layout, const std::vector<uint64_t>& sizesBytes,
+                 const std::function<bool(uint32_t, uint32_t)>& areAliveTogether)
+{
+    const uint32_t buffersCount = static_cast<uint32_t>(sizesBytes.size());
+    assert(layout.m_offsets.size() == buffersCount);
+
+    uint64_t endBytes = 0;
+    uint64_t unaliasedSizeBytes = 0;
+    for (uint32_t a = 0; a < buffersCount; ++a)
+    {
+        assert(layout.m_offsets[a] % g_alignment == 0);
+        endBytes = std::max(endBytes, layout.m_offsets[a] + AlignSize(sizesBytes[a]));
+        unaliasedSizeBytes += AlignSize(sizesBytes[a]);
+
+        for (uint32_t b = a + 1; b < buffersCount; ++b)
+        {
+            if (areAliveTogether(a, b))
+                assert(!AreTransientBuffersOverlapping(layout, sizesBytes, a, b, g_alignment));
+        }
+    }
+    assert(layout.m_sizeBytes == endBytes);
+    assert(layout.m_unaliasedSizeBytes == unaliasedSizeBytes);
+}
+
+void TestNoneAliveTogether()
+{
+    const std::vector<uint64_t> sizesBytes = { 1000, 5000, 1 };
+    const auto areAliveTogether = [](uint32_t, uint32_t) { return false; };
+    const TransientMemoryLayout layout = PackTransientBuffers(sizesBytes, areAliveTogether, g_alignment);
+    CheckLayout(layout, sizesBytes, areAliveTogether);
+
+    // Note all of them share the memory of the biggest one
+    assert(layout.m_sizeBytes == AlignSize(5000));
+    for (uint64_t offset : layout.m_offsets)
+        assert(offset == 0);
+}
+
+void TestAllAliveTogether()
+{
+    const std::vector<uint64_t> sizesBytes = { 1000, 5000, 1 };
+    const auto areAliveTogether = [](uint32_t, uint32_t) { return true; };
+    const TransientMemoryLayout layout = PackTransientBuffers(sizesBytes, areAliveTogether, g_alignment);
+    CheckLayout(layout, sizesBytes, areAliveTogether);
+
+    assert(layout.m_sizeBytes == layout.m_unaliasedSizeBytes);
+    // Note the biggest buffers go first
+    assert(layout.m_offsets[1] == 0);
+    assert(layout.m_offsets[0] == AlignSize(5000));
+}
+
+void TestChain()
+{
+    // Note buffers used one after the other, every one alive with the ones next to it
+    const std::vector<uint64_t> sizesBytes = { 4096, 4096, 4096, 4096 };
+    const auto areAliveTogether = [](uint32_t a, uint32_t b) { return a + 1 == b || b + 1 == a; };
+    const TransientMemoryLayout layout = PackTransientBuffers(sizesBytes, areAliveTogether, g_alignment);
+    CheckLayout(layout, sizesBytes, areAliveTogether);
+
+    assert(layout.m_sizeBytes == 2 * 4096);
+    assert(layout.m_offsets[0] == layout.m_offsets[2]);
+    assert(layout.m_offsets[1] == layout.m_offsets[3]);
+}
+
+void TestReuse()
+{
+    // Note the small buffer takes the memory of the one it is never alive with
+    const std::vector<uint64_t> sizesBytes = { 8192, 8192, 8192, 1024 };
+    const auto areAliveTogether = [](uint32_t a, uint32_t b)
+    {
+        const bool isFirstAndSecond = (a == 0 && b == 1) || (a == 1 && b == 0);
+        const bool isSecondAndThird = (a == 1 && b == 2) || (a == 2 && b == 1);
+        const bool isSmall = a == 3 || b == 3;
+        return isFirstAndSecond || isSecondAndThird || (isSmall && a != 1 && b != 1);
+    };
+    const TransientMemoryLayout layout = PackTransientBuffers(sizesBytes, areAliveTogether, g_alignment);
+    CheckLayout(layout, sizesBytes, areAliveTogether);
+
+    assert(layout.m_offsets[0] == 0 && layout.m_offsets[1] == 8192 && layout.m_offsets[2] == 0);
+    assert(layout.m_offsets[3] == 8192);
+    assert(layout.m_sizeBytes == 2 * 8192);
+}
+
+void TestRandom()
+{
+    std::mt19937 random(42);
+    for (uint32_t test = 0; test < 1000; ++test)
+    {
+        const uint32_t buffersCount = 1 + random() % 24;
+        std::vector<uint64_t> sizesBytes(buffersCount);
+        for (auto& sizeBytes : sizesBytes)
+            sizeBytes = 1 + random() % (64 * 1024);
+
+        // Note a symmetric relation, as the one of the compute graph
+        std::vector<std::vector<bool>> isAliveTogether(buffersCount, std::vector<bool>(buffersCount, false));
+        for (uint32_t a = 0; a < buffersCount; ++a)
+        {
+            for (uint32_t b = a + 1; b < buffersCount; ++b)
+                isAliveTogether[a][b] = isAliveTogether[b][a] = random() % 3 == 0;
+        }
+        const auto areAliveTogether = [&isAliveTogether](uint32_t a, uint32_t b) { return isAliveTogether[a][b]; };
+
+        const TransientMemoryLayout layout = PackTransientBuffers(sizesBytes, areAliveTogether, g_alignment);
+        CheckLayout(layout, sizesBytes, areAliveTogether);
+        assert(layout.m_sizeBytes <= layout.m_unaliasedSizeBytes);
+    }
+}
+}
+
+int main()
+{
+    TestNoneAliveTogether();
+    TestAllAliveTogether();
+    TestChain();
+    TestReuse();
+    TestRandom();
+
+    std::cout << "transientmemory tests passed\n";
+    return 0;
+}
\ No newline at end of file